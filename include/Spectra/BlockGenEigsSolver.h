@@ -0,0 +1,505 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_BLOCK_GEN_EIGS_SOLVER_H
+#define SPECTRA_BLOCK_GEN_EIGS_SOLVER_H
+
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>  // Eigen::HessenbergDecomposition
+#include <Eigen/QR>           // Eigen::HouseholderQR
+#include <vector>             // std::vector
+#include <cmath>              // std::abs
+#include <algorithm>          // std::min, std::max
+#include <complex>            // std::complex
+#include <stdexcept>          // std::invalid_argument
+
+#include "Util/Version.h"
+#include "Util/TypeTraits.h"
+#include "Util/SelectionRule.h"
+#include "Util/CompInfo.h"
+#include "Util/ConvergenceRule.h"
+#include "Util/SimpleRandom.h"
+#include "Util/Trace.h"
+#include "MatOp/DenseGenMatProd.h"
+#include "LinAlg/UpperHessenbergEigen.h"
+#include "LinAlg/BlockArnoldi.h"
+
+namespace Spectra {
+
+///
+/// \ingroup EigenSolver
+///
+/// This class implements the block Krylov-Schur method for general real matrices.
+///
+/// Compared with GenEigsSolver, which builds the Krylov subspace from a single vector,
+/// this solver expands the subspace by a block of `block_size` vectors at a time.
+/// This has two advantages:
+/// - The matrix is applied to a block of vectors in one matrix-matrix product, so
+///   each pass over \f$A\f$ produces several basis vectors, and the orthogonalization
+///   uses level-3 BLAS operations.
+/// - Eigenvalues of multiplicity up to `block_size`, and tightly clustered eigenvalues,
+///   are found reliably. In exact arithmetic, a single-vector Krylov method can find
+///   only one eigenvector of a multiple eigenvalue.
+///
+/// The solver is restarted by keeping an orthonormal basis of the invariant subspace
+/// associated with the wanted Ritz values, which brings the factorization to
+/// the Krylov-Schur form. The small projected eigenvalue problems are solved by reducing
+/// the projected matrix to upper Hessenberg form, and then using the same Hessenberg
+/// eigen solver as GenEigsSolver.
+///
+/// \tparam OpType  The name of the matrix operation class. Users could either
+///                 use the wrapper classes such as DenseGenMatProd and
+///                 SparseGenMatProd, or define their own that implements the type
+///                 definition `Scalar`, the member functions `rows()`, and the
+///                 matrix-matrix product `operator*` as in DenseGenMatProd.
+///
+/// Below is an example that demonstrates the usage of this class.
+///
+/// \code{.cpp}
+/// #include <Eigen/Core>
+/// #include <Spectra/BlockGenEigsSolver.h>
+/// #include <iostream>
+///
+/// using namespace Spectra;
+///
+/// int main()
+/// {
+///     // We are going to calculate the eigenvalues of M
+///     Eigen::MatrixXd M = Eigen::MatrixXd::Random(1000, 1000);
+///
+///     // Construct matrix operation object using the wrapper class DenseGenMatProd
+///     DenseGenMatProd<double> op(M);
+///
+///     // Construct eigen solver object with block size 4, requesting the largest
+///     // 10 eigenvalues, and using a subspace of dimension 40
+///     BlockGenEigsSolver<DenseGenMatProd<double>> eigs(op, 10, 40, 4);
+///
+///     // Initialize and compute
+///     eigs.init();
+///     int nconv = eigs.compute(SortRule::LargestMagn);
+///
+///     // Retrieve results
+///     Eigen::VectorXcd evalues;
+///     if (eigs.info() == CompInfo::Successful)
+///         evalues = eigs.eigenvalues();
+///
+///     std::cout << "Eigenvalues found:\n" << evalues << std::endl;
+///
+///     return 0;
+/// }
+/// \endcode
+///
+template <typename OpType = DenseGenMatProd<double>>
+class BlockGenEigsSolver
+{
+private:
+    using Scalar = typename OpType::Scalar;
+    using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using Array = Eigen::Array<Scalar, Eigen::Dynamic, 1>;
+    using BoolArray = Eigen::Array<bool, Eigen::Dynamic, 1>;
+    using MapConstMat = Eigen::Map<const Matrix>;
+
+    using Complex = std::complex<Scalar>;
+    using ComplexMatrix = Eigen::Matrix<Complex, Eigen::Dynamic, Eigen::Dynamic>;
+    using ComplexVector = Eigen::Matrix<Complex, Eigen::Dynamic, 1>;
+
+    using BlockArnoldiFac = BlockArnoldi<Scalar, OpType>;
+
+    // clang-format off
+    const Index   m_n;         // dimension of matrix A
+    const Index   m_nev;       // number of eigenvalues requested
+    const Index   m_ncv;       // maximum dimension of the Krylov subspace
+    const Index   m_b;         // block size
+    Index         m_nmatop;    // number of matrix operations called, counted by vectors
+    Index         m_niter;     // number of restarting iterations
+
+    BlockArnoldiFac m_fac;     // block Arnoldi factorization
+
+    ComplexVector m_ritz_val;  // Ritz values
+    ComplexMatrix m_ritz_vec;  // Ritz vectors, in the coordinates of the current basis
+    Array         m_ritz_res;  // residual norms of the Ritz pairs
+    BoolArray     m_ritz_conv; // indicator of the convergence of Ritz values
+    CompInfo      m_info;      // status of the computation
+    Scalar        m_op_norm;   // estimate of the operator norm, from the Ritz values
+    // clang-format on
+
+    // Real Ritz values calculated from UpperHessenbergEigen have exact zero imaginary part
+    // Complex Ritz values have exact conjugate pairs
+    static bool is_complex(const Complex& v) { return v.imag() != Scalar(0); }
+
+    // Sort the first len values according to the selection rule
+    static std::vector<Index> sort_values(SortRule rule, const ComplexVector& values, Index len)
+    {
+        std::vector<Index> ind;
+        switch (rule)
+        {
+            case SortRule::LargestMagn:
+            {
+                SortEigenvalue<Complex, SortRule::LargestMagn> sorting(values.data(), len);
+                sorting.swap(ind);
+                break;
+            }
+            case SortRule::LargestReal:
+            {
+                SortEigenvalue<Complex, SortRule::LargestReal> sorting(values.data(), len);
+                sorting.swap(ind);
+                break;
+            }
+            case SortRule::LargestImag:
+            {
+                SortEigenvalue<Complex, SortRule::LargestImag> sorting(values.data(), len);
+                sorting.swap(ind);
+                break;
+            }
+            case SortRule::SmallestMagn:
+            {
+                SortEigenvalue<Complex, SortRule::SmallestMagn> sorting(values.data(), len);
+                sorting.swap(ind);
+                break;
+            }
+            case SortRule::SmallestReal:
+            {
+                SortEigenvalue<Complex, SortRule::SmallestReal> sorting(values.data(), len);
+                sorting.swap(ind);
+                break;
+            }
+            case SortRule::SmallestImag:
+            {
+                SortEigenvalue<Complex, SortRule::SmallestImag> sorting(values.data(), len);
+                sorting.swap(ind);
+                break;
+            }
+            default:
+                throw std::invalid_argument("unsupported selection rule");
+        }
+        return ind;
+    }
+
+    // The largest subspace dimension that can be reached from dimension k by whole blocks
+    Index target_dim(Index k) const { return k + (m_ncv - k) / m_b * m_b; }
+
+    // Computes the Ritz pairs of the projected matrix, sorts them, and
+    // computes their residual norms
+    void retrieve_ritzpair(SortRule selection)
+    {
+        const Index k = m_fac.subspace_dim();
+        const Matrix& G = m_fac.matrix_G();
+
+        // H = P * Hh * P', where Hh is upper Hessenberg
+        Eigen::HessenbergDecomposition<Matrix> hess(G.topLeftCorner(k, k));
+        const Matrix Hh = hess.matrixH();
+        const Matrix P = hess.matrixQ();
+
+        UpperHessenbergEigen<Scalar> decomp(Hh);
+        const ComplexVector& evals = decomp.eigenvalues();
+        const ComplexMatrix evecs = P.template cast<Complex>() * decomp.eigenvectors();
+
+        // The residual of the Ritz pair (theta, Vy) is A * Vy - theta * Vy = U * (U'AV) * y
+        const ComplexMatrix resid = G.block(k, 0, m_b, k).template cast<Complex>() * evecs;
+
+        std::vector<Index> ind = sort_values(selection, evals, k);
+        m_ritz_val.resize(k);
+        m_ritz_vec.resize(k, k);
+        m_ritz_res.resize(k);
+        for (Index i = 0; i < k; i++)
+        {
+            m_ritz_val[i] = evals[ind[i]];
+            m_ritz_vec.col(i).noalias() = evecs.col(ind[i]);
+            m_ritz_res[i] = resid.col(ind[i]).norm();
+        }
+        // The largest magnitude of the Ritz values is a lower bound of the operator norm
+        m_op_norm = (std::max)(m_op_norm, Scalar(evals.cwiseAbs().maxCoeff()));
+    }
+
+    // Calculates the number of converged Ritz values
+    Index num_converged(const ConvergenceCriterion<Scalar>& criterion, const Scalar& tol)
+    {
+        m_ritz_conv = criterion.converged(m_ritz_val.head(m_nev).array().abs(),
+                                          m_ritz_res.head(m_nev), m_op_norm, tol);
+        return m_ritz_conv.count();
+    }
+
+    // Restarts the factorization with a basis of dimension about k, spanning the invariant
+    // subspace of the leading wanted Ritz values, completing the conjugate pairs
+    // The first nev Ritz values are always kept as long as the subspace dimension allows
+    void restart(Index k)
+    {
+        SPECTRA_TRACE_SCOPE("BlockGenEigs::restart");
+
+        const Index dim = m_fac.subspace_dim();
+        const Index kmax = m_ncv - m_b;
+
+        // Real basis of the invariant subspace: a real Ritz vector contributes one vector,
+        // and a conjugate pair contributes the real and imaginary parts
+        Matrix Y(dim, kmax);
+        Index ncol = 0;
+        std::vector<bool> used(dim, false);
+        for (Index i = 0; i < dim; i++)
+        {
+            if (used[i])
+                continue;
+            const bool cplx = is_complex(m_ritz_val[i]);
+            const Index ncol_new = ncol + (cplx ? 2 : 1);
+            if (ncol_new > kmax || (i >= m_nev && ncol_new > k))
+                break;
+
+            used[i] = true;
+            if (!cplx)
+            {
+                Y.col(ncol++).noalias() = m_ritz_vec.col(i).real();
+                continue;
+            }
+            Y.col(ncol++).noalias() = m_ritz_vec.col(i).real();
+            Y.col(ncol++).noalias() = m_ritz_vec.col(i).imag();
+            // Mark the conjugate value as used
+            for (Index j = i + 1; j < dim; j++)
+            {
+                if (!used[j] && m_ritz_val[j] == Eigen::numext::conj(m_ritz_val[i]))
+                {
+                    used[j] = true;
+                    break;
+                }
+            }
+        }
+
+        Eigen::HouseholderQR<Matrix> qr(Y.leftCols(ncol));
+        const Matrix Q = qr.householderQ() * Matrix::Identity(dim, ncol);
+        m_fac.restart(Q);
+        m_fac.factorize_from(ncol, target_dim(ncol), m_nmatop);
+    }
+
+    // Returns the adjusted number of Ritz values to keep in the restart
+    Index nev_adjusted(Index nconv) const
+    {
+        const Index kmax = m_ncv - m_b;
+        Index nev_new = m_nev + (std::min)(nconv, (kmax - m_nev) / 2);
+        return (std::min)(nev_new, kmax);
+    }
+
+    // Sorts the first nev Ritz pairs in the specified order
+    // This is used to return the final results
+    void sort_ritzpair(SortRule sort_rule)
+    {
+        std::vector<Index> ind = sort_values(sort_rule, m_ritz_val, m_nev);
+
+        ComplexVector new_ritz_val(m_nev);
+        ComplexMatrix new_ritz_vec(m_ritz_vec.rows(), m_nev);
+        BoolArray new_ritz_conv(m_nev);
+        for (Index i = 0; i < m_nev; i++)
+        {
+            new_ritz_val[i] = m_ritz_val[ind[i]];
+            new_ritz_vec.col(i).noalias() = m_ritz_vec.col(ind[i]);
+            new_ritz_conv[i] = m_ritz_conv[ind[i]];
+        }
+
+        m_ritz_val.swap(new_ritz_val);
+        m_ritz_vec.swap(new_ritz_vec);
+        m_ritz_conv.swap(new_ritz_conv);
+    }
+
+public:
+    ///
+    /// Constructor to create a solver object.
+    ///
+    /// \param op          The matrix operation object that implements
+    ///                    the matrix-matrix multiplication operation of \f$A\f$.
+    ///                    Users could either create the object from the wrapper classes
+    ///                    such as DenseGenMatProd, or define their own that implements all
+    ///                    the public members as in DenseGenMatProd.
+    /// \param nev         Number of eigenvalues requested. This should satisfy \f$1\le nev \le n-2\f$,
+    ///                    where \f$n\f$ is the size of matrix.
+    /// \param ncv         Maximum dimension of the Krylov subspace. This parameter must satisfy
+    ///                    \f$nev+b+1 \le ncv \le n-b\f$, where \f$b\f$ is the block size,
+    ///                    and is advised to take \f$ncv \ge 2\cdot nev + b\f$.
+    /// \param block_size  Number of vectors added to the subspace in each expansion step.
+    ///                    It should be at least the largest multiplicity of the wanted
+    ///                    eigenvalues.
+    ///
+    BlockGenEigsSolver(OpType& op, Index nev, Index ncv, Index block_size) :
+        m_n(op.rows()),
+        m_nev(nev),
+        m_ncv(ncv),
+        m_b(block_size),
+        m_nmatop(0),
+        m_niter(0),
+        m_fac(op, ncv, block_size),
+        m_info(CompInfo::NotComputed),
+        m_op_norm(0)
+    {
+        if (nev < 1 || nev > m_n - 2)
+            throw std::invalid_argument("nev must satisfy 1 <= nev <= n - 2, n is the size of matrix");
+
+        if (block_size < 1)
+            throw std::invalid_argument("block_size must be positive");
+
+        if (ncv < nev + block_size + 1 || ncv > m_n - block_size)
+            throw std::invalid_argument("ncv must satisfy nev + block_size + 1 <= ncv <= n - block_size, n is the size of matrix");
+    }
+
+    ///
+    /// Initializes the solver by providing an initial block of vectors.
+    ///
+    /// \param init_block Pointer to the initial block, an \f$n\times b\f$ matrix stored
+    ///                   in column-major order, where \f$b\f$ is the block size.
+    ///
+    void init(const Scalar* init_block)
+    {
+        m_nmatop = 0;
+        m_niter = 0;
+        m_op_norm = Scalar(0);
+        m_info = CompInfo::NotComputed;
+        m_ritz_val.resize(0);
+        m_ritz_conv.resize(0);
+
+        MapConstMat V0(init_block, m_n, m_b);
+        m_fac.init(V0);
+    }
+
+    ///
+    /// Initializes the solver by providing a random initial block.
+    ///
+    /// This overloaded function generates a random initial block
+    /// (with a fixed random seed) for the algorithm. Elements in the block
+    /// follow independent Uniform(-0.5, 0.5) distribution.
+    ///
+    void init()
+    {
+        SimpleRandom<Scalar> rng(0);
+        Matrix init_block(m_n, m_b);
+        for (Index j = 0; j < m_b; j++)
+            init_block.col(j).noalias() = rng.random_vec(m_n);
+        init(init_block.data());
+    }
+
+    ///
+    /// Conducts the major computation procedure.
+    ///
+    /// \param selection  An enumeration value indicating the selection rule of
+    ///                   the requested eigenvalues, with the same meaning as in GenEigsSolver.
+    /// \param maxit      Maximum number of iterations allowed in the algorithm.
+    /// \param tol        Precision parameter for the calculated eigenvalues.
+    /// \param sorting    Rule to sort the eigenvalues and eigenvectors, with the same
+    ///                   meaning as in GenEigsSolver.
+    /// \param criterion  Convergence criterion of the Ritz pairs, see ConvergenceCriterion.
+    ///                   The residual norms of the Ritz pairs are computed exactly from the
+    ///                   factorization.
+    ///
+    /// \return Number of converged eigenvalues.
+    ///
+    Index compute(SortRule selection = SortRule::LargestMagn, Index maxit = 1000,
+                  Scalar tol = 1e-10, SortRule sorting = SortRule::LargestMagn,
+                  const ConvergenceCriterion<Scalar>& criterion = ConvergenceRule::RitzValue)
+    {
+        SPECTRA_TRACE_SCOPE("BlockGenEigs::compute");
+
+        if (m_fac.matrix_V().cols() == 0)
+            init();
+
+        // The first factorization
+        const Index k0 = m_fac.subspace_dim();
+        m_fac.factorize_from(k0, target_dim(k0), m_nmatop);
+        retrieve_ritzpair(selection);
+
+        // Restarting
+        Index i, nconv = 0;
+        for (i = 0; i < maxit; i++)
+        {
+            nconv = num_converged(criterion, tol);
+            if (nconv >= m_nev)
+                break;
+
+            restart(nev_adjusted(nconv));
+            retrieve_ritzpair(selection);
+        }
+        // Sorting results
+        sort_ritzpair(sorting);
+
+        m_niter += i + 1;
+        m_info = (nconv >= m_nev) ? CompInfo::Successful : CompInfo::NotConverging;
+
+        return (std::min)(m_nev, nconv);
+    }
+
+    ///
+    /// Returns the status of the computation.
+    /// The full list of enumeration values can be found in \ref Enumerations.
+    ///
+    CompInfo info() const { return m_info; }
+
+    ///
+    /// Returns the number of iterations used in the computation.
+    ///
+    Index num_iterations() const { return m_niter; }
+
+    ///
+    /// Returns the number of matrix operations used in the computation, where
+    /// a product of \f$A\f$ with a block of \f$b\f$ vectors is counted as \f$b\f$ operations.
+    ///
+    Index num_operations() const { return m_nmatop; }
+
+    ///
+    /// Returns the converged eigenvalues.
+    ///
+    /// \return A complex-valued vector containing the eigenvalues.
+    ///
+    ComplexVector eigenvalues() const
+    {
+        const Index nconv = m_ritz_conv.template cast<Index>().sum();
+        ComplexVector res(nconv);
+
+        Index j = 0;
+        for (Index i = 0; i < m_ritz_conv.size(); i++)
+        {
+            if (m_ritz_conv[i])
+                res[j++] = m_ritz_val[i];
+        }
+
+        return res;
+    }
+
+    ///
+    /// Returns the eigenvectors associated with the converged eigenvalues.
+    ///
+    /// \param nvec The number of eigenvectors to return.
+    ///
+    /// \return A complex-valued matrix containing the eigenvectors.
+    ///
+    ComplexMatrix eigenvectors(Index nvec) const
+    {
+        const Index nconv = m_ritz_conv.template cast<Index>().sum();
+        nvec = (std::min)(nvec, nconv);
+        ComplexMatrix res(m_n, nvec);
+
+        if (!nvec)
+            return res;
+
+        ComplexMatrix ritz_vec_conv(m_ritz_vec.rows(), nvec);
+        Index j = 0;
+        for (Index i = 0; i < m_ritz_conv.size() && j < nvec; i++)
+        {
+            if (m_ritz_conv[i])
+                ritz_vec_conv.col(j++).noalias() = m_ritz_vec.col(i);
+        }
+
+        res.noalias() = m_fac.matrix_V().leftCols(m_ritz_vec.rows()) * ritz_vec_conv;
+
+        return res;
+    }
+
+    ///
+    /// Returns all converged eigenvectors.
+    ///
+    ComplexMatrix eigenvectors() const
+    {
+        return eigenvectors(m_nev);
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_BLOCK_GEN_EIGS_SOLVER_H
@@ -0,0 +1,493 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_CONTOUR_SYM_EIGS_SOLVER_H
+#define SPECTRA_CONTOUR_SYM_EIGS_SOLVER_H
+
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <complex>    // std::complex, std::polar
+#include <cmath>      // std::abs, std::sqrt, std::ceil
+#include <vector>     // std::vector
+#include <memory>     // std::unique_ptr
+#include <future>     // std::future
+#include <algorithm>  // std::min, std::max, std::find
+#include <stdexcept>  // std::invalid_argument
+
+#include "Util/Version.h"
+#include "Util/TypeTraits.h"
+#include "Util/CompInfo.h"
+#include "Util/ConvergenceRule.h"
+#include "Util/SimpleRandom.h"
+#include "Util/ThreadPool.h"
+#include "Util/Trace.h"
+#include "MatOp/SparseSymMatProd.h"
+#include "MatOp/SparseGenComplexShiftSolve.h"
+
+namespace Spectra {
+
+///
+/// \ingroup EigenSolver
+///
+/// This class implements a contour integral eigen solver (FEAST) for real symmetric
+/// matrices, which computes all the eigenvalues in an interval \f$[a,b]\f$ and the
+/// associated eigenvectors.
+///
+/// The spectral projector onto the eigenvectors with eigenvalues in \f$[a,b]\f$ is
+/// approximated by a rational filter, the quadrature of
+/// \f$\frac{1}{2\pi i}\oint(zI-A)^{-1}dz\f$ on the circle through \f$a\f$ and \f$b\f$.
+/// Since \f$A\f$ is real symmetric, only the nodes \f$z_j\f$ on the upper half circle are
+/// needed, which are the Gauss-Legendre points in the angle. In each iteration the filter
+/// is applied to a block of vectors, and the eigenpairs are extracted from the filtered
+/// subspace by the Rayleigh-Ritz procedure.
+///
+/// Each node needs the complex shift-solve \f$(A-z_jI)^{-1}Y\f$ on a block of vectors,
+/// and these solves are independent. They are run in parallel on a thread pool, split
+/// by nodes and by columns of the block, so the solver scales with the number of cores
+/// much better than the single-shift Krylov solvers. The factorizations of
+/// \f$A-z_jI\f$ are also computed in parallel.
+///
+/// The dimension of the subspace, `ncv`, should be at least 1.5 times the number of
+/// eigenvalues in the interval. Before the first iteration, this number is estimated
+/// from the filtered random block by a stochastic trace estimator, and `ncv` is
+/// increased if it is too small. `ncv` is also increased if all the Ritz values lie in
+/// the interval, which means that the subspace cannot contain all the wanted eigenvectors.
+///
+/// \tparam OpType       The name of the matrix operation class for the product
+///                      \f$Av\f$, for example DenseSymMatProd and SparseSymMatProd.
+/// \tparam ShiftOpType  The name of the complex shift-solve operation class, for example
+///                      DenseGenComplexShiftSolve and SparseGenComplexShiftSolve. It must
+///                      implement `set_shift(sigmar, sigmai)`, and
+///                      `perform_block_op(x_in, ncol, y_out)` that computes the complex
+///                      \f$(A-\sigma I)^{-1}X\f$ and can be called from several threads.
+///
+/// Example:
+/// \code{.cpp}
+/// // All eigenvalues in [1, 2], with 8 quadrature nodes
+/// SparseSymMatProd<double> op(A);
+/// std::vector<std::unique_ptr<SparseGenComplexShiftSolve<double>>> shift_ops;
+/// std::vector<SparseGenComplexShiftSolve<double>*> ptrs;
+/// for (int j = 0; j < 8; j++)
+/// {
+///     shift_ops.emplace_back(new SparseGenComplexShiftSolve<double>(A));
+///     ptrs.push_back(shift_ops.back().get());
+/// }
+/// ContourSymEigsSolver<SparseSymMatProd<double>, SparseGenComplexShiftSolve<double>>
+///     eigs(op, ptrs, 1.0, 2.0, 20);
+/// eigs.compute();
+/// Eigen::VectorXd evals = eigs.eigenvalues();  // increasing
+/// \endcode
+///
+template <typename OpType = SparseSymMatProd<double>,
+          typename ShiftOpType = SparseGenComplexShiftSolve<double>>
+class ContourSymEigsSolver
+{
+private:
+    using Scalar = typename OpType::Scalar;
+    using Index = Eigen::Index;
+    using Complex = std::complex<Scalar>;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using ComplexMatrix = Eigen::Matrix<Complex, Eigen::Dynamic, Eigen::Dynamic>;
+    using Array = Eigen::Array<Scalar, Eigen::Dynamic, 1>;
+    using BoolArray = Eigen::Array<bool, Eigen::Dynamic, 1>;
+
+    // clang-format off
+    OpType&                     m_op;         // object for A * v
+    std::vector<ShiftOpType*>   m_shift_ops;  // shift-solve operators, one per node
+    const Index                 m_n;          // dimension of matrix A
+    const Scalar                m_lower;      // lower end of the interval
+    const Scalar                m_upper;      // upper end of the interval
+    Index                       m_ncv;        // dimension of the subspace
+    int                         m_nthread;    // number of threads
+    std::unique_ptr<ThreadPool> m_pool;       // thread pool, created on demand
+    bool                        m_factorized; // whether the shifts have been set
+
+    std::vector<Complex>        m_nodes;      // quadrature nodes on the upper half circle
+    std::vector<Complex>        m_weights;    // quadrature weights of the filter
+
+    Matrix                      m_Y;          // block to be filtered in the next iteration
+    Scalar                      m_count_est;  // estimated number of eigenvalues in the interval
+    SimpleRandom<Scalar>        m_rng;        // random numbers for the initial and added vectors
+
+    Vector                      m_evals;      // converged eigenvalues, increasing
+    Matrix                      m_evecs;      // converged eigenvectors
+
+    Index                       m_nsolve;     // number of shift-solves, counted per vector
+    Index                       m_nmatop;     // number of products with A
+    Index                       m_niter;      // number of iterations
+    Scalar                      m_op_norm;    // estimate of the operator norm, from the Ritz values
+    CompInfo                    m_info;       // status of the computation
+    // clang-format on
+
+    Index num_nodes() const { return Index(m_shift_ops.size()); }
+
+    // Nodes and weights such that the filter of the projector is
+    // sum_j Re{ w_j * inv(z_j * I - A) }, where z_j = c + r * exp(i * t_j) on the upper
+    // half circle, and t_j are the Gauss-Legendre points on [0, pi]
+    void compute_quadrature()
+    {
+        using std::sqrt;
+
+        const Index nc = num_nodes();
+        // Gauss-Legendre rule on [-1, 1] by the Golub-Welsch algorithm
+        Matrix J = Matrix::Zero(nc, nc);
+        for (Index k = 1; k < nc; k++)
+        {
+            const Scalar kk = Scalar(k);
+            J(k, k - 1) = J(k - 1, k) = kk / sqrt(Scalar(4) * kk * kk - Scalar(1));
+        }
+        Eigen::SelfAdjointEigenSolver<Matrix> eig(J);
+
+        const Scalar pi = Scalar(EIGEN_PI);
+        const Scalar center = (m_lower + m_upper) / Scalar(2);
+        const Scalar radius = (m_upper - m_lower) / Scalar(2);
+        m_nodes.resize(nc);
+        m_weights.resize(nc);
+        for (Index j = 0; j < nc; j++)
+        {
+            const Scalar x = eig.eigenvalues()[j];
+            const Scalar w = Scalar(2) * eig.eigenvectors()(0, j) * eig.eigenvectors()(0, j);
+            const Complex e = std::polar(Scalar(1), pi * (x + Scalar(1)) / Scalar(2));
+            m_nodes[j] = center + radius * e;
+            // The integral on [0, pi] is pi/2 times the rule on [-1, 1], and the factor
+            // 1/pi comes from 1/(2 * pi * i) * dz and the conjugate half of the circle
+            m_weights[j] = w * radius * e / Scalar(2);
+        }
+    }
+
+    // Calls func(j) for j = 0, ..., ntask - 1, in parallel if more than one thread is used
+    template <typename Func>
+    void parallel_for(Index ntask, Func&& func)
+    {
+        if (m_nthread <= 1 || ntask <= 1)
+        {
+            for (Index j = 0; j < ntask; j++)
+                func(j);
+            return;
+        }
+
+        if (!m_pool)
+            m_pool.reset(new ThreadPool(m_nthread));
+        std::vector<std::future<void>> res;
+        res.reserve(ntask);
+        for (Index j = 0; j < ntask; j++)
+            res.push_back(m_pool->submit([&func, j]() { func(j); }));
+        // get() rethrows the exceptions of the tasks
+        for (auto& r : res)
+            r.get();
+    }
+
+    // Factorizes A - z_j * I for all nodes, in parallel
+    void factorize()
+    {
+        SPECTRA_TRACE_SCOPE("ContourSymEigs::factorize");
+
+        parallel_for(num_nodes(), [this](Index j) {
+            m_shift_ops[j]->set_shift(m_nodes[j].real(), m_nodes[j].imag());
+        });
+        m_factorized = true;
+    }
+
+    // Q = filter(A) * Y, where the solves with different nodes and different columns
+    // of Y are scheduled as separate tasks
+    Matrix filter(const Matrix& Y)
+    {
+        SPECTRA_TRACE_SCOPE("ContourSymEigs::filter");
+
+        const Index nc = num_nodes(), ncol = Y.cols();
+        // Split the columns so that there are about two tasks per thread
+        const Index nchunk = (std::max)(Index(1), (std::min)(ncol, (Index(2) * m_nthread + nc - 1) / nc));
+        const Index chunk = (ncol + nchunk - 1) / nchunk;
+
+        // Contributions of the nodes, reduced after all the solves
+        std::vector<Matrix> part(nc, Matrix(m_n, ncol));
+        parallel_for(nc * nchunk, [this, &Y, &part, nchunk, chunk, ncol](Index task) {
+            const Index j = task / nchunk;
+            const Index start = (task % nchunk) * chunk;
+            const Index len = (std::min)(chunk, ncol - start);
+            if (len <= 0)
+                return;
+            ComplexMatrix Z(m_n, len);
+            m_shift_ops[j]->perform_block_op(&Y(0, start), len, Z.data());
+            // inv(z_j * I - A) = -inv(A - z_j * I)
+            part[j].middleCols(start, len).noalias() = -(m_weights[j] * Z).real();
+        });
+        m_nsolve += nc * ncol;
+
+        Matrix Q = part[0];
+        for (Index j = 1; j < nc; j++)
+            Q.noalias() += part[j];
+        return Q;
+    }
+
+    // Random block with independent +1/-1 elements
+    Matrix rademacher(Index ncol)
+    {
+        Matrix Y(m_n, ncol);
+        for (Index j = 0; j < ncol; j++)
+            for (Index i = 0; i < m_n; i++)
+                Y(i, j) = (m_rng.random() < Scalar(0)) ? Scalar(-1) : Scalar(1);
+        return Y;
+    }
+
+    // Orthonormalizes the columns of Q in place by two passes of classical Gram-Schmidt,
+    // dropping the columns that are numerically dependent on the previous ones
+    // Returns the number of remaining columns
+    static Index orthonormalize(Matrix& Q)
+    {
+        using std::sqrt;
+
+        const Scalar thresh = sqrt(TypeTraits<Scalar>::epsilon());
+        Index k = 0;
+        Vector c;
+        for (Index j = 0; j < Q.cols(); j++)
+        {
+            Vector w = Q.col(j);
+            const Scalar wnorm0 = w.norm();
+            for (int pass = 0; pass < 2 && k > 0; pass++)
+            {
+                c.noalias() = Q.leftCols(k).transpose() * w;
+                w.noalias() -= Q.leftCols(k) * c;
+            }
+            const Scalar wnorm = w.norm();
+            if (wnorm > thresh * wnorm0 && wnorm > Scalar(0))
+                Q.col(k++).noalias() = w / wnorm;
+        }
+        Q.conservativeResize(Eigen::NoChange, k);
+        return k;
+    }
+
+public:
+    ///
+    /// Constructor to create a solver object.
+    ///
+    /// \param op         The matrix operation object that computes \f$Av\f$.
+    /// \param shift_ops  Pointers to the complex shift-solve operators, one for each
+    ///                   quadrature node on the upper half circle. The operators must be
+    ///                   distinct objects of the same matrix. Eight nodes give a filter
+    ///                   that is accurate enough for most problems.
+    /// \param lower      Lower end of the interval.
+    /// \param upper      Upper end of the interval.
+    /// \param ncv        Initial dimension of the subspace, which is increased during the
+    ///                   computation if it is too small. It must satisfy
+    ///                   \f$1\le ncv\le n\f$, where \f$n\f$ is the size of matrix.
+    ///
+    ContourSymEigsSolver(OpType& op, const std::vector<ShiftOpType*>& shift_ops,
+                         const Scalar& lower, const Scalar& upper, Index ncv) :
+        m_op(op),
+        m_shift_ops(shift_ops),
+        m_n(op.rows()),
+        m_lower(lower),
+        m_upper(upper),
+        m_ncv(ncv),
+        m_nthread(ThreadPool::default_num_threads()),
+        m_factorized(false),
+        m_count_est(0),
+        m_rng(0),
+        m_nsolve(0),
+        m_nmatop(0),
+        m_niter(0),
+        m_op_norm(0),
+        m_info(CompInfo::NotComputed)
+    {
+        if (shift_ops.empty())
+            throw std::invalid_argument("ContourSymEigsSolver: there must be at least one quadrature node");
+        for (std::size_t j = 0; j < shift_ops.size(); j++)
+        {
+            if (shift_ops[j] == nullptr || shift_ops[j]->rows() != m_n)
+                throw std::invalid_argument("ContourSymEigsSolver: the operators must have the same dimension");
+            if (std::find(shift_ops.begin(), shift_ops.begin() + j, shift_ops[j]) != shift_ops.begin() + j)
+                throw std::invalid_argument("ContourSymEigsSolver: the shift-solve operators must be distinct objects");
+        }
+        if (!(lower < upper))
+            throw std::invalid_argument("ContourSymEigsSolver: the lower end must be less than the upper end");
+        if (ncv < 1 || ncv > m_n)
+            throw std::invalid_argument("ncv must satisfy 1 <= ncv <= n, n is the size of matrix");
+
+        compute_quadrature();
+    }
+
+    ///
+    /// Sets the number of threads used to run the shift-solves and the factorizations.
+    /// If it is not positive, the number of hardware threads is used.
+    ///
+    void set_num_threads(int nthread)
+    {
+        nthread = (nthread > 0) ? nthread : ThreadPool::default_num_threads();
+        if (nthread != m_nthread)
+            m_pool.reset();
+        m_nthread = nthread;
+    }
+
+    ///
+    /// Conducts the major computation procedure.
+    ///
+    /// \param maxit      Maximum number of iterations allowed in the algorithm.
+    /// \param tol        Precision parameter for the calculated eigenvalues.
+    /// \param criterion  Convergence criterion of the Ritz pairs, with the same meaning
+    ///                   as in SymEigsSolver. The residual norms \f$\|Ax-\theta x\|\f$
+    ///                   are computed exactly in this solver.
+    ///
+    /// \return Number of converged eigenvalues in the interval.
+    ///
+    Index compute(Index maxit = 100, Scalar tol = 1e-10,
+                  const ConvergenceCriterion<Scalar>& criterion = ConvergenceRule::RitzValue)
+    {
+        using std::abs;
+        using std::ceil;
+
+        SPECTRA_TRACE_SCOPE("ContourSymEigs::compute");
+
+        if (!m_factorized)
+            factorize();
+
+        m_info = CompInfo::NotConverging;
+        bool first = (m_Y.cols() == 0);
+        if (first)
+            m_Y = rademacher(m_ncv);
+
+        Index i;
+        for (i = 0; i < maxit; i++)
+        {
+            Matrix Q = filter(m_Y);
+
+            if (first)
+            {
+                // Stochastic estimate of the trace of the projector, i.e., the number of
+                // eigenvalues in the interval, from the random block
+                Scalar trace = (m_Y.array() * Q.array()).sum();
+                m_count_est = trace / Scalar(m_Y.cols());
+                const Index target = (std::min)(m_n, Index(ceil(Scalar(1.5) * m_count_est)) + 1);
+                if (target > m_ncv)
+                {
+                    const Matrix Ynew = rademacher(target - m_ncv);
+                    const Matrix Qnew = filter(Ynew);
+                    trace += (Ynew.array() * Qnew.array()).sum();
+                    m_count_est = trace / Scalar(target);
+                    Q.conservativeResize(Eigen::NoChange, target);
+                    Q.rightCols(target - m_ncv).noalias() = Qnew;
+                    m_ncv = target;
+                }
+                first = false;
+            }
+
+            // Rayleigh-Ritz procedure on the filtered subspace
+            const Index k = orthonormalize(Q);
+            if (k < 1)
+                break;
+            Matrix AQ(m_n, k);
+            for (Index j = 0; j < k; j++)
+                m_op.perform_op(&Q(0, j), &AQ(0, j));
+            m_nmatop += k;
+            Matrix H = Q.transpose() * AQ;
+            H = (H + H.transpose()) / Scalar(2);
+            Eigen::SelfAdjointEigenSolver<Matrix> eig(H);
+            const Vector& theta = eig.eigenvalues();
+            const Matrix X = Q * eig.eigenvectors();
+            const Matrix AX = AQ * eig.eigenvectors();
+            m_op_norm = (std::max)(m_op_norm, theta.cwiseAbs().maxCoeff());
+
+            // Ritz pairs in the interval
+            std::vector<Index> inside;
+            for (Index j = 0; j < k; j++)
+            {
+                if (theta[j] >= m_lower && theta[j] <= m_upper)
+                    inside.push_back(j);
+            }
+            const Index nin = Index(inside.size());
+            Array theta_abs(nin), resid(nin);
+            for (Index l = 0; l < nin; l++)
+            {
+                const Index j = inside[l];
+                theta_abs[l] = abs(theta[j]);
+                resid[l] = (AX.col(j) - theta[j] * X.col(j)).norm();
+            }
+            // A zero residual means that the Ritz pair is exact
+            const BoolArray conv = criterion.converged(theta_abs, resid, m_op_norm, tol) || (resid == Scalar(0));
+
+            m_evals.resize(nin);
+            m_evecs.resize(m_n, nin);
+            for (Index l = 0; l < nin; l++)
+            {
+                m_evals[l] = theta[inside[l]];
+                m_evecs.col(l).noalias() = X.col(inside[l]);
+            }
+
+            // All the Ritz values are in the interval, so the subspace is too small
+            // to contain all the wanted eigenvectors
+            if (nin >= k && k < m_n)
+            {
+                const Index target = (std::min)(m_n, Index(ceil(Scalar(1.5) * Scalar(k))) + 1);
+                m_Y.resize(m_n, target);
+                m_Y.leftCols(k).noalias() = X;
+                m_Y.rightCols(target - k).noalias() = rademacher(target - k);
+                m_ncv = target;
+                continue;
+            }
+
+            if (conv.all())
+            {
+                m_info = CompInfo::Successful;
+                i++;
+                break;
+            }
+            m_Y = X;
+        }
+        m_niter += i;
+
+        // Keep the converged eigenpairs only
+        if (m_info != CompInfo::Successful)
+        {
+            m_evals.resize(0);
+            m_evecs.resize(m_n, 0);
+        }
+        return m_evals.size();
+    }
+
+    ///
+    /// Returns the status of the computation.
+    /// The full list of enumeration values can be found in \ref Enumerations.
+    ///
+    CompInfo info() const { return m_info; }
+
+    ///
+    /// Returns the number of iterations used in the computation.
+    ///
+    Index num_iterations() const { return m_niter; }
+
+    ///
+    /// Returns the number of shift-solve operations used in the computation, counted
+    /// per vector and summed over all nodes.
+    ///
+    Index num_operations() const { return m_nsolve; }
+
+    ///
+    /// Returns the estimated number of eigenvalues in the interval, computed from the
+    /// filtered random block before the first iteration.
+    ///
+    Scalar count_estimate() const { return m_count_est; }
+
+    ///
+    /// Returns the dimension of the subspace, after the adjustments during the computation.
+    ///
+    Index subspace_dim() const { return m_ncv; }
+
+    ///
+    /// Returns the eigenvalues in the interval in increasing order.
+    ///
+    Vector eigenvalues() const { return m_evals; }
+
+    ///
+    /// Returns the eigenvectors associated with the eigenvalues in the interval,
+    /// normalized to unit length and orthogonal to each other.
+    ///
+    Matrix eigenvectors() const { return m_evecs; }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_CONTOUR_SYM_EIGS_SOLVER_H
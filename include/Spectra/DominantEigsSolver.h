@@ -0,0 +1,430 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_DOMINANT_EIGS_SOLVER_H
+#define SPECTRA_DOMINANT_EIGS_SOLVER_H
+
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <cmath>      // std::abs, std::sqrt
+#include <algorithm>  // std::max
+#include <complex>    // std::complex
+#include <stdexcept>  // std::invalid_argument
+
+#include "Util/Version.h"
+#include "Util/TypeTraits.h"
+#include "Util/SelectionRule.h"
+#include "Util/CompInfo.h"
+#include "Util/ConvergenceRule.h"
+#include "Util/SimpleRandom.h"
+#include "Util/Trace.h"
+#include "MatOp/DenseSymMatProd.h"
+
+namespace Spectra {
+
+///
+/// \ingroup EigenSolver
+///
+/// This class implements a low-memory eigen solver for a single extreme eigenpair,
+/// for example the dominant eigenpair of a matrix. Typical applications are the
+/// stationary vector of a Markov chain, the spectral radius of a nonnegative matrix,
+/// and the leading principal component of a covariance matrix.
+///
+/// SymEigsSolver and GenEigsSolver keep a Krylov subspace of dimension `ncv`, which
+/// is inefficient in memory when only one eigenpair is needed. This solver instead uses
+/// the locally optimal three-term recurrence: in each iteration, the Rayleigh-Ritz
+/// procedure is applied to the subspace spanned by the current approximation \f$x\f$,
+/// its residual \f$r=Ax-\theta x\f$, and the previous search direction \f$p\f$, which
+/// is equivalent to a Krylov method restarted after every step with its last
+/// direction kept. Each iteration costs one matrix operation, and the solver only
+/// keeps five vectors of length \f$n\f$, independent of the convergence speed:
+/// \f$x\f$, \f$r\f$ and \f$p\f$, and the images of \f$r\f$ and \f$p\f$ under
+/// \f$A\f$, which save a second matrix operation per iteration.
+///
+/// The solver works for symmetric matrices, and for general real matrices whose wanted
+/// eigenvalue is real, for example the Perron root of a nonnegative irreducible
+/// matrix. The convergence test is the same as in the Krylov eigen solvers,
+/// see ConvergenceCriterion.
+///
+/// With `SortRule::LargestMagn`, the Ritz value of the largest magnitude is followed in
+/// each iteration. If \f$A\f$ is symmetric indefinite, and its largest and smallest
+/// eigenvalues have close magnitudes, the solver may converge to either of them.
+/// In this case, `SortRule::LargestAlge` and `SortRule::SmallestAlge` can be used
+/// to compute the two ends separately.
+///
+/// \tparam OpType  The name of the matrix operation class. Users could either
+///                 use the wrapper classes such as DenseSymMatProd, DenseGenMatProd,
+///                 SparseSymMatProd and SparseGenMatProd, or define their own that
+///                 implements the type definition `Scalar` and the public member
+///                 functions `rows()` and `perform_op()` as in DenseSymMatProd.
+///
+/// Below is an example that computes the leading eigenpair of a sparse matrix.
+///
+/// \code{.cpp}
+/// #include <Eigen/Core>
+/// #include <Eigen/SparseCore>
+/// #include <Spectra/DominantEigsSolver.h>
+/// #include <Spectra/MatOp/SparseSymMatProd.h>
+/// #include <iostream>
+///
+/// using namespace Spectra;
+///
+/// int main()
+/// {
+///     // A symmetric tridiagonal matrix with 1, 2, ..., n on the main diagonal
+///     // and 1 on the subdiagonals
+///     const int n = 10000;
+///     Eigen::SparseMatrix<double> M(n, n);
+///     M.reserve(Eigen::VectorXi::Constant(n, 3));
+///     for (int i = 0; i < n; i++)
+///     {
+///         M.insert(i, i) = i + 1.0;
+///         if (i > 0)
+///             M.insert(i - 1, i) = 1.0;
+///         if (i < n - 1)
+///             M.insert(i + 1, i) = 1.0;
+///     }
+///
+///     // Construct matrix operation object using the wrapper class SparseSymMatProd
+///     SparseSymMatProd<double> op(M);
+///
+///     // Construct eigen solver object
+///     DominantEigsSolver<SparseSymMatProd<double>> eigs(op);
+///
+///     // Initialize and compute
+///     eigs.init();
+///     eigs.compute(SortRule::LargestMagn);
+///
+///     // Retrieve results
+///     if (eigs.info() == CompInfo::Successful)
+///         std::cout << "Dominant eigenvalue found: " << eigs.eigenvalue() << std::endl;
+///
+///     return 0;
+/// }
+/// \endcode
+///
+template <typename OpType = DenseSymMatProd<double>>
+class DominantEigsSolver
+{
+private:
+    using Scalar = typename OpType::Scalar;
+    using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using Array = Eigen::Array<Scalar, Eigen::Dynamic, 1>;
+    using MapConstVec = Eigen::Map<const Vector>;
+
+    // clang-format off
+    const OpType& m_op;        // object to conduct matrix operation,
+                               // e.g. matrix-vector product
+    const Index   m_n;         // dimension of matrix A
+    Index         m_nmatop;    // number of matrix operations called
+    Index         m_niter;     // number of iterations
+
+    Vector        m_x;         // current approximation of the eigenvector, ||x|| = 1
+    Vector        m_r;         // residual vector, Ax - theta * x
+    Vector        m_Ar;        // A * w, where w is the normalized residual
+    Vector        m_p;         // previous search direction
+    Vector        m_Ap;        // A * p
+    bool          m_has_p;     // whether m_p is available
+
+    Scalar        m_theta;     // current approximation of the eigenvalue
+    Scalar        m_resid;     // residual norm ||Ax - theta * x||
+    Scalar        m_op_norm;   // estimate of the operator norm, from the Ritz values
+    CompInfo      m_info;      // status of the computation
+    // clang-format on
+
+    // Computes theta and the residual from x and Ax, where Ax is stored in m_r
+    void update_residual()
+    {
+        m_theta = m_x.dot(m_r);
+        m_r.noalias() -= m_theta * m_x;
+        m_resid = m_r.norm();
+        m_op_norm = (std::max)(m_op_norm, Scalar(std::abs(m_theta)));
+    }
+
+    // Selects the wanted eigenvalue of the small projected matrix, and returns its
+    // index, or -1 if the wanted eigenvalue is complex
+    static Index select_eigenvalue(const Eigen::Matrix<std::complex<Scalar>, Eigen::Dynamic, 1>& evals,
+                                   SortRule selection)
+    {
+        using std::abs;
+
+        Index ind = 0;
+        for (Index i = 1; i < evals.size(); i++)
+        {
+            const Scalar re = evals[i].real(), cur = evals[ind].real();
+            const bool better = (selection == SortRule::LargestMagn) ? (abs(evals[i]) > abs(evals[ind])) :
+                (selection == SortRule::LargestAlge)                 ? (re > cur) :
+                                                                       (re < cur);
+            if (better)
+                ind = i;
+        }
+
+        // For symmetric matrices, the projected matrix is symmetric up to rounding,
+        // so we allow a tiny imaginary part
+        const Scalar eps = TypeTraits<Scalar>::epsilon();
+        if (abs(evals[ind].imag()) > Scalar(100) * eps * abs(evals[ind]))
+            return -1;
+        return ind;
+    }
+
+    // One step of the locally optimal recurrence
+    // Returns false if the projected problem cannot be solved
+    bool iterate(SortRule selection)
+    {
+        SPECTRA_TRACE_SCOPE("DominantEigs::iterate");
+
+        using std::sqrt;
+
+        // Orthonormal basis [x, w, p], where w = r / ||r||
+        // Their images under A are [theta * x + ||r|| * w, Aw, Ap]
+        const Scalar rnorm = m_resid;
+        m_r /= rnorm;
+        m_op.perform_op(m_r.data(), m_Ar.data());
+        m_nmatop++;
+
+        if (m_has_p)
+        {
+            // Orthogonalize p against x and w, applying the same operations to Ap
+            // Two passes of classical Gram-Schmidt for numerical stability
+            const Scalar pnorm0 = m_p.norm();
+            for (int pass = 0; pass < 2; pass++)
+            {
+                const Scalar cx = m_x.dot(m_p), cw = m_r.dot(m_p);
+                m_p.noalias() -= cx * m_x + cw * m_r;
+                m_Ap.noalias() -= cx * (m_theta * m_x + rnorm * m_r) + cw * m_Ar;
+            }
+            const Scalar pnorm = m_p.norm();
+            // Drop p if it is numerically in the span of x and w
+            if (pnorm <= sqrt(TypeTraits<Scalar>::epsilon()) * pnorm0)
+            {
+                m_has_p = false;
+            }
+            else
+            {
+                m_p /= pnorm;
+                m_Ap /= pnorm;
+            }
+        }
+
+        // The projected matrix H = Q' * A * Q
+        const Index m = m_has_p ? 3 : 2;
+        Matrix H(m, m);
+        H(0, 0) = m_theta;
+        H(1, 0) = rnorm;
+        H(0, 1) = m_x.dot(m_Ar);
+        H(1, 1) = m_r.dot(m_Ar);
+        if (m_has_p)
+        {
+            H(2, 0) = Scalar(0);
+            H(2, 1) = m_p.dot(m_Ar);
+            H(0, 2) = m_x.dot(m_Ap);
+            H(1, 2) = m_r.dot(m_Ap);
+            H(2, 2) = m_p.dot(m_Ap);
+        }
+
+        Eigen::EigenSolver<Matrix> eig(H);
+        if (eig.info() != Eigen::Success)
+            return false;
+        const Index ind = select_eigenvalue(eig.eigenvalues(), selection);
+        Vector y(m);
+        if (ind < 0)
+        {
+            // The wanted Ritz value is complex, which may happen in the early iterations
+            // for general matrices. In this case we take a power step, x <- Ax
+            y.setZero();
+            y[0] = m_theta;
+            y[1] = rnorm;
+        }
+        else
+        {
+            y.noalias() = eig.eigenvectors().col(ind).real();
+        }
+        y /= y.norm();
+
+        // New direction p = y1 * w + y2 * p, and new x = y0 * x + p
+        // The new Ax is stored in m_r, which then becomes the new residual
+        const Scalar y0 = y[0];
+        if (m_has_p)
+        {
+            m_p = y[1] * m_r + y[2] * m_p;
+            m_Ap = y[1] * m_Ar + y[2] * m_Ap;
+        }
+        else
+        {
+            m_p.noalias() = y[1] * m_r;
+            m_Ap.noalias() = y[1] * m_Ar;
+        }
+        m_r = y0 * (m_theta * m_x + rnorm * m_r) + m_Ap;
+        m_x = y0 * m_x + m_p;
+        m_has_p = true;
+
+        // Normalize x, which drifts from one due to rounding
+        const Scalar xnorm = m_x.norm();
+        m_x /= xnorm;
+        m_r /= xnorm;
+        update_residual();
+
+        return true;
+    }
+
+public:
+    ///
+    /// Constructor to create a solver object.
+    ///
+    /// \param op  The matrix operation object that implements
+    ///            the matrix-vector multiplication operation of \f$A\f$:
+    ///            calculating \f$Av\f$ for any vector \f$v\f$. Users could either
+    ///            create the object from the wrapper classes such as DenseSymMatProd, or
+    ///            define their own that implements all the public members
+    ///            as in DenseSymMatProd.
+    ///
+    DominantEigsSolver(OpType& op) :
+        m_op(op),
+        m_n(op.rows()),
+        m_nmatop(0),
+        m_niter(0),
+        m_has_p(false),
+        m_theta(0),
+        m_resid(0),
+        m_op_norm(0),
+        m_info(CompInfo::NotComputed)
+    {
+        if (m_n < 2)
+            throw std::invalid_argument("DominantEigsSolver: the size of matrix must be at least 2");
+    }
+
+    ///
+    /// Initializes the solver by providing an initial vector.
+    ///
+    /// \param init_vec Pointer to the initial vector, which must be nonzero.
+    ///
+    /// A good approximation of the wanted eigenvector, for example the result
+    /// of a previous solve with a slightly different matrix, can reduce the number
+    /// of iterations significantly.
+    ///
+    void init(const Scalar* init_vec)
+    {
+        MapConstVec v0(init_vec, m_n);
+        const Scalar vnorm = v0.norm();
+        if (vnorm <= Scalar(0))
+            throw std::invalid_argument("DominantEigsSolver: initial vector cannot be zero");
+
+        m_x.noalias() = v0 / vnorm;
+        m_r.resize(m_n);
+        m_Ar.resize(m_n);
+        m_p.resize(m_n);
+        m_Ap.resize(m_n);
+        m_has_p = false;
+
+        m_nmatop = 0;
+        m_niter = 0;
+        m_op_norm = Scalar(0);
+        m_info = CompInfo::NotComputed;
+
+        m_op.perform_op(m_x.data(), m_r.data());
+        m_nmatop++;
+        update_residual();
+    }
+
+    ///
+    /// Initializes the solver by providing a random initial vector.
+    ///
+    /// This overloaded function generates a random initial vector
+    /// (with a fixed random seed) for the algorithm. Elements in the vector
+    /// follow independent Uniform(-0.5, 0.5) distribution.
+    ///
+    void init()
+    {
+        SimpleRandom<Scalar> rng(0);
+        Vector init_vec = rng.random_vec(m_n);
+        init(init_vec.data());
+    }
+
+    ///
+    /// Conducts the major computation procedure.
+    ///
+    /// \param selection  An enumeration value indicating the wanted eigenvalue.
+    ///                   Supported values are `SortRule::LargestMagn` for the dominant
+    ///                   eigenvalue, and `SortRule::LargestAlge` and `SortRule::SmallestAlge`
+    ///                   for the largest and smallest real eigenvalues.
+    /// \param maxit      Maximum number of iterations allowed in the algorithm.
+    /// \param tol        Precision parameter for the calculated eigenvalue.
+    /// \param criterion  Convergence criterion of the Ritz pair, with the same meaning
+    ///                   as in SymEigsSolver and GenEigsSolver. The residual norm
+    ///                   \f$\|Ax-\theta x\|\f$ is computed exactly in this solver.
+    ///
+    /// \return Number of converged eigenvalues, either 0 or 1.
+    ///
+    Index compute(SortRule selection = SortRule::LargestMagn, Index maxit = 1000,
+                  Scalar tol = 1e-10,
+                  const ConvergenceCriterion<Scalar>& criterion = ConvergenceRule::RitzValue)
+    {
+        SPECTRA_TRACE_SCOPE("DominantEigs::compute");
+
+        if (selection != SortRule::LargestMagn && selection != SortRule::LargestAlge &&
+            selection != SortRule::SmallestAlge)
+            throw std::invalid_argument("unsupported selection rule");
+
+        if (m_x.size() != m_n)
+            init();
+
+        Array theta_abs(1), resid(1);
+        bool conv = false;
+        Index i;
+        for (i = 0; i < maxit; i++)
+        {
+            theta_abs[0] = std::abs(m_theta);
+            resid[0] = m_resid;
+            conv = criterion.converged(theta_abs, resid, m_op_norm, tol)[0];
+            if (conv || m_resid == Scalar(0))
+                break;
+
+            if (!iterate(selection))
+                break;
+        }
+
+        m_niter += i;
+        m_info = conv ? CompInfo::Successful : CompInfo::NotConverging;
+        return conv ? 1 : 0;
+    }
+
+    ///
+    /// Returns the status of the computation.
+    /// The full list of enumeration values can be found in \ref Enumerations.
+    ///
+    CompInfo info() const { return m_info; }
+
+    ///
+    /// Returns the number of iterations used in the computation.
+    ///
+    Index num_iterations() const { return m_niter; }
+
+    ///
+    /// Returns the number of matrix operations used in the computation.
+    ///
+    Index num_operations() const { return m_nmatop; }
+
+    ///
+    /// Returns the computed eigenvalue.
+    ///
+    Scalar eigenvalue() const { return m_theta; }
+
+    ///
+    /// Returns the computed eigenvector, normalized to unit length.
+    ///
+    Vector eigenvector() const { return m_x; }
+
+    ///
+    /// Returns the residual norm \f$\|Ax-\theta x\|\f$ of the computed eigenpair.
+    ///
+    Scalar residual_norm() const { return m_resid; }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_DOMINANT_EIGS_SOLVER_H
@@ -8,21 +8,26 @@
 #define SPECTRA_GEN_EIGS_BASE_H
 
 #include <Eigen/Core>
+#include <Eigen/LU>  // Eigen::PartialPivLU
 #include <vector>     // std::vector
 #include <cmath>      // std::abs, std::pow, std::sqrt
-#include <algorithm>  // std::min, std::copy
+#include <algorithm>  // std::min, std::max, std::copy
 #include <complex>    // std::complex, std::conj, std::norm, std::abs
 #include <stdexcept>  // std::invalid_argument
+#include <utility>    // std::move
 
 #include "Util/Version.h"
 #include "Util/TypeTraits.h"
 #include "Util/SelectionRule.h"
 #include "Util/CompInfo.h"
+#include "Util/ConvergenceRule.h"
 #include "Util/SimpleRandom.h"
+#include "Util/Trace.h"
 #include "MatOp/internal/ArnoldiOp.h"
 #include "LinAlg/UpperHessenbergQR.h"
 #include "LinAlg/DoubleShiftQR.h"
 #include "LinAlg/UpperHessenbergEigen.h"
+#include "LinAlg/UpperHessenbergSchur.h"
 #include "LinAlg/Arnoldi.h"
 
 namespace Spectra {
@@ -57,6 +62,11 @@ private:
 
 protected:
     // clang-format off
+
+    // In most solvers the A operator is an lvalue provided by the user, and in
+    // GenEigsCayleySolver it is an rvalue. The scheme is the same as in SymEigsBase:
+    // an rvalue is moved to m_op_container, and m_op refers to m_op_container[0]
+    std::vector<OpType> m_op_container;
     OpType&       m_op;        // object to conduct matrix operation,
                                // e.g. matrix-vector product
     const Index   m_n;         // dimension of matrix A
@@ -74,6 +84,13 @@ protected:
 private:
     BoolArray     m_ritz_conv; // indicator of the convergence of Ritz values
     CompInfo      m_info;      // status of the computation
+    Scalar        m_op_norm;   // estimate of the operator norm, from the Ritz values
+    ConvergenceCriterion<Scalar> m_conv;  // convergence criterion used by compute()
+    ComplexVector m_conv_theta; // converged Ritz values of the operator, before the
+                                // transformation by sort_ritzpair()
+    mutable Matrix m_schur_Z;   // partial Schur vectors of H, computed on demand
+    mutable Matrix m_schur_T;   // partial Schur form of H, computed on demand
+    mutable bool  m_schur_ready; // whether m_schur_Z and m_schur_T are up to date
     // clang-format on
 
     // Real Ritz values calculated from UpperHessenbergEigen have exact zero imaginary part
@@ -82,9 +99,19 @@ private:
     static bool is_complex(const Complex& v) { return v.imag() != Scalar(0); }
     static bool is_conj(const Complex& v1, const Complex& v2) { return v1 == Eigen::numext::conj(v2); }
 
+    // Move rvalue object to the container
+    static std::vector<OpType> create_op_container(OpType&& rval)
+    {
+        std::vector<OpType> container;
+        container.emplace_back(std::move(rval));
+        return container;
+    }
+
     // Implicitly restarted Arnoldi factorization
     void restart(Index k, SortRule selection)
     {
+        SPECTRA_TRACE_SCOPE("GenEigs::restart");
+
         using std::norm;
 
         if (k >= m_ncv)
@@ -140,19 +167,9 @@ private:
     // Calculates the number of converged Ritz values
     Index num_converged(const Scalar& tol)
     {
-        using std::pow;
-
-        // The machine precision, ~= 1e-16 for the "double" type
-        const Scalar eps = TypeTraits<Scalar>::epsilon();
-        // std::pow() is not constexpr, so we do not declare eps23 to be constexpr
-        // But most compilers should be able to compute eps23 at compile time
-        const Scalar eps23 = pow(eps, Scalar(2) / 3);
-
-        // thresh = tol * max(eps23, abs(theta)), theta for Ritz value
-        Array thresh = tol * m_ritz_val.head(m_nev).array().abs().max(eps23);
-        Array resid = m_ritz_est.head(m_nev).array().abs() * m_fac.f_norm();
+        const Array resid = m_ritz_est.head(m_nev).array().abs() * m_fac.f_norm();
         // Converged "wanted" Ritz values
-        m_ritz_conv = (resid < thresh);
+        m_ritz_conv = m_conv.converged(m_ritz_val.head(m_nev).array().abs(), resid, m_op_norm, tol);
 
         return m_ritz_conv.count();
     }
@@ -197,7 +214,8 @@ private:
     {
         UpperHessenbergEigen<Scalar> decomp(m_fac.matrix_H());
         const ComplexVector& evals = decomp.eigenvalues();
-        ComplexMatrix evecs = decomp.eigenvectors();
+        // Only the last row of the eigenvectors is needed for the Ritz estimates
+        const ComplexVector last_row = decomp.last_row();
 
         // Sort Ritz values and put the wanted ones at the beginning
         std::vector<Index> ind;
@@ -247,15 +265,126 @@ private:
         for (Index i = 0; i < m_ncv; i++)
         {
             m_ritz_val[i] = evals[ind[i]];
-            m_ritz_est[i] = evecs(m_ncv - 1, ind[i]);
+            m_ritz_est[i] = last_row[ind[i]];
         }
-        for (Index i = 0; i < m_nev; i++)
+        // The largest magnitude of the Ritz values is a lower bound of the operator norm
+        m_op_norm = (std::max)(m_op_norm, Scalar(evals.cwiseAbs().maxCoeff()));
+        // Only the wanted Ritz vectors are back transformed
+        m_ritz_vec.noalias() = decomp.eigenvectors(std::vector<Index>(ind.begin(), ind.begin() + m_nev));
+    }
+
+    // Partial real Schur decomposition H * Z = Z * T associated with the converged
+    // Ritz values, where Z has orthonormal columns and T is quasi-upper-triangular
+    void partial_schur(Matrix& Z, Matrix& T) const
+    {
+        using std::abs;
+        using std::sqrt;
+
+        const Index nconv = m_conv_theta.size();
+        if (nconv < 1)
+        {
+            Z.resize(m_ncv, 0);
+            T.resize(0, 0);
+            return;
+        }
+
+        UpperHessenbergSchur<Scalar> decomp(m_fac.matrix_H());
+        const Matrix& TH = decomp.matrix_T();
+
+        // Eigenvalue with a nonnegative imaginary part of each diagonal block
+        std::vector<Index> block_start;
+        std::vector<Complex> block_val;
+        for (Index k = 0; k < m_ncv;)
+        {
+            block_start.push_back(k);
+            if (k + 1 < m_ncv && TH(k + 1, k) != Scalar(0))
+            {
+                const Scalar p = Scalar(0.5) * (TH(k, k) - TH(k + 1, k + 1));
+                const Scalar q = p * p + TH(k + 1, k) * TH(k, k + 1);
+                block_val.emplace_back(Scalar(0.5) * (TH(k, k) + TH(k + 1, k + 1)), sqrt(abs(q)));
+                k += 2;
+            }
+            else
+            {
+                block_val.emplace_back(TH(k, k), Scalar(0));
+                k++;
+            }
+        }
+
+        // Match each converged Ritz value with the closest diagonal block,
+        // and a conjugate pair is matched only once
+        std::vector<bool> select(m_ncv, false);
+        for (Index i = 0; i < nconv; i++)
         {
-            m_ritz_vec.col(i).noalias() = evecs.col(ind[i]);
+            const Complex theta(m_conv_theta[i].real(), abs(m_conv_theta[i].imag()));
+            bool matched = false;
+            for (Index j = 0; j < i; j++)
+                matched = matched || (is_complex(m_conv_theta[i]) && is_conj(m_conv_theta[i], m_conv_theta[j]));
+            if (matched)
+                continue;
+
+            Index best = -1;
+            Scalar best_dist = Scalar(0);
+            for (std::size_t b = 0; b < block_start.size(); b++)
+            {
+                const Scalar dist = abs(block_val[b] - theta);
+                if (!select[block_start[b]] && (best < 0 || dist < best_dist))
+                {
+                    best = Index(b);
+                    best_dist = dist;
+                }
+            }
+            // Every block may already be selected when a real Ritz value has been
+            // matched to a 2x2 block due to rounding errors
+            if (best < 0)
+                break;
+            select[block_start[best]] = true;
         }
+
+        decomp.reorder(select);
+        Index p = 0;
+        for (std::size_t b = 0; b < block_start.size(); b++)
+        {
+            if (select[block_start[b]])
+                p += is_complex(block_val[b]) ? 2 : 1;
+        }
+        Z.noalias() = decomp.matrix_U().leftCols(p);
+        T.noalias() = decomp.matrix_T().topLeftCorner(p, p);
+    }
+
+    // Computes the partial Schur form once after each compute(), and keeps it
+    // for schur_vectors() and schur_form()
+    void update_schur_cache() const
+    {
+        if (m_schur_ready)
+            return;
+        partial_schur(m_schur_Z, m_schur_T);
+        m_schur_ready = true;
     }
 
 protected:
+    // Transforms the Schur form T of the operator used in the Arnoldi iteration
+    // to that of the original problem
+    // Solvers with spectral transformations can override this function
+    virtual void transform_schur_form(Matrix& /* T */) const {}
+
+    // Inverse of a nonsingular quasi-upper-triangular matrix T, which has the same
+    // block structure as T
+    static Matrix quasi_triangular_inverse(const Matrix& T)
+    {
+        const Index p = T.rows();
+        Matrix res = T.partialPivLu().inverse();
+        for (Index j = 0; j < p; j++)
+        {
+            for (Index i = j + 1; i < p; i++)
+            {
+                if (i > j + 1 || T(i, j) == Scalar(0))
+                    res(i, j) = Scalar(0);
+            }
+        }
+        return res;
+    }
+
     // Sorts the first nev Ritz pairs in the specified order
     // This is used to return the final results
     virtual void sort_ritzpair(SortRule sort_rule)
@@ -322,6 +451,7 @@ protected:
 public:
     /// \cond
 
+    // If op is an lvalue
     GenEigsBase(OpType& op, const BOpType& Bop, Index nev, Index ncv) :
         m_op(op),
         m_n(m_op.rows()),
@@ -330,7 +460,30 @@ public:
         m_nmatop(0),
         m_niter(0),
         m_fac(ArnoldiOpType(op, Bop), m_ncv),
-        m_info(CompInfo::NotComputed)
+        m_info(CompInfo::NotComputed),
+        m_op_norm(0),
+        m_schur_ready(false)
+    {
+        if (nev < 1 || nev > m_n - 2)
+            throw std::invalid_argument("nev must satisfy 1 <= nev <= n - 2, n is the size of matrix");
+
+        if (ncv < nev + 2 || ncv > m_n)
+            throw std::invalid_argument("ncv must satisfy nev + 2 <= ncv <= n, n is the size of matrix");
+    }
+
+    // If op is an rvalue
+    GenEigsBase(OpType&& op, const BOpType& Bop, Index nev, Index ncv) :
+        m_op_container(create_op_container(std::move(op))),
+        m_op(m_op_container.front()),
+        m_n(m_op.rows()),
+        m_nev(nev),
+        m_ncv(ncv > m_n ? m_n : ncv),
+        m_nmatop(0),
+        m_niter(0),
+        m_fac(ArnoldiOpType(m_op, Bop), m_ncv),
+        m_info(CompInfo::NotComputed),
+        m_op_norm(0),
+        m_schur_ready(false)
     {
         if (nev < 1 || nev > m_n - 2)
             throw std::invalid_argument("nev must satisfy 1 <= nev <= n - 2, n is the size of matrix");
@@ -367,9 +520,12 @@ public:
         m_ritz_vec.setZero();
         m_ritz_est.setZero();
         m_ritz_conv.setZero();
+        m_conv_theta.resize(0);
+        m_schur_ready = false;
 
         m_nmatop = 0;
         m_niter = 0;
+        m_op_norm = Scalar(0);
 
         // Initialize the Arnoldi factorization
         MapConstVec v0(init_resid, m_n);
@@ -412,11 +568,23 @@ public:
     ///                   (e.g. selecting the largest or smallest eigenvalues in the
     ///                   full spectrum) is specified by the parameter `selection`.
     ///
+    /// \param criterion  Convergence criterion of the Ritz pairs. It can be a
+    ///                   ConvergenceRule value, or a ConvergenceCriterion object
+    ///                   holding a user function. The default
+    ///                   `ConvergenceRule::RitzValue` is the criterion of **ARPACK**.
+    ///                   For eigenvalues close to zero, `ConvergenceRule::OperatorNorm`
+    ///                   avoids computing them to an unnecessarily high relative accuracy.
+    ///
     /// \return Number of converged eigenvalues.
     ///
     Index compute(SortRule selection = SortRule::LargestMagn, Index maxit = 1000,
-                  Scalar tol = 1e-10, SortRule sorting = SortRule::LargestMagn)
+                  Scalar tol = 1e-10, SortRule sorting = SortRule::LargestMagn,
+                  const ConvergenceCriterion<Scalar>& criterion = ConvergenceRule::RitzValue)
     {
+        SPECTRA_TRACE_SCOPE("GenEigs::compute");
+
+        m_conv = criterion;
+
         // The m-step Arnoldi factorization
         m_fac.factorize_from(1, m_ncv, m_nmatop);
         retrieve_ritzpair(selection);
@@ -431,6 +599,14 @@ public:
             nev_adj = nev_adjusted(nconv);
             restart(nev_adj, selection);
         }
+        // The converged Ritz values of the operator, which identify the partial Schur form
+        m_conv_theta.resize(m_ritz_conv.count());
+        for (Index j = 0, k = 0; j < m_nev; j++)
+        {
+            if (m_ritz_conv[j])
+                m_conv_theta[k++] = m_ritz_val[j];
+        }
+        m_schur_ready = false;
         // Sorting results
         sort_ritzpair(sorting);
 
@@ -525,6 +701,45 @@ public:
     {
         return eigenvectors(m_nev);
     }
+
+    ///
+    /// Returns the Schur vectors associated with the converged eigenvalues.
+    ///
+    /// The columns of the returned real matrix \f$Q\f$ form an orthonormal basis of the
+    /// invariant subspace associated with the converged eigenvalues, such that
+    /// \f$AQ\approx QT\f$, where \f$T\f$ is given by schur_form(). If only one eigenvalue
+    /// of a conjugate pair has converged, both are included, so the number of columns
+    /// can be larger than the number of converged eigenvalues.
+    ///
+    /// Compared with eigenvectors(), this function uses real arithmetic and half of
+    /// the storage for complex eigenvalues, and the basis remains well-conditioned
+    /// when the matrix is close to defective.
+    ///
+    Matrix schur_vectors() const
+    {
+        update_schur_cache();
+        Matrix res(m_n, m_schur_Z.cols());
+        res.noalias() = m_fac.matrix_V() * m_schur_Z;
+        return res;
+    }
+
+    ///
+    /// Returns the quasi-upper-triangular matrix \f$T\f$ in the partial real Schur form
+    /// \f$AQ\approx QT\f$, where \f$Q\f$ is given by schur_vectors().
+    ///
+    /// Real eigenvalues appear on the diagonal of \f$T\f$, and each conjugate pair
+    /// of complex eigenvalues forms a \f$2\times 2\f$ diagonal block. For solvers with
+    /// spectral transformations, \f$T\f$ is transformed back to the original problem,
+    /// except for GenEigsComplexShiftSolver, where \f$T\f$ is the Schur form of the
+    /// operator used in the iteration, \f$\mathrm{Re}\{(A-\sigma I)^{-1}\}\f$.
+    ///
+    Matrix schur_form() const
+    {
+        update_schur_cache();
+        Matrix T = m_schur_T;
+        transform_schur_form(T);
+        return T;
+    }
 };
 
 }  // namespace Spectra
@@ -0,0 +1,175 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_GEN_EIGS_CAYLEY_SOLVER_H
+#define SPECTRA_GEN_EIGS_CAYLEY_SOLVER_H
+
+#include <Eigen/Core>
+#include <utility>    // std::move
+#include <stdexcept>  // std::invalid_argument
+
+#include "GenEigsBase.h"
+#include "Util/SelectionRule.h"
+#include "MatOp/DenseGenRealShiftSolve.h"
+#include "MatOp/internal/GenEigsCayleyOp.h"
+
+namespace Spectra {
+
+///
+/// \ingroup EigenSolver
+///
+/// This class implements the eigen solver for general real matrices in the
+/// **Cayley mode**, which is designed to find the rightmost eigenvalues,
+/// i.e., those with the largest real parts.
+///
+/// For large nonsymmetric matrices, for example the Jacobian matrices in stability
+/// analysis, the rightmost eigenvalues are usually not the largest in magnitude,
+/// and GenEigsSolver with `SortRule::LargestReal` may converge very slowly.
+/// The Cayley mode instead solves the transformed problem
+/// \f$(A-\sigma I)^{-1}(A-\mu I)x=\nu x\f$, where \f$\nu=(\lambda-\mu)/(\lambda-\sigma)\f$,
+/// and \f$\sigma>\mu\f$ are two real shifts.
+/// The transformation maps the half-plane \f$\mathrm{Re}(\lambda)>(\sigma+\mu)/2\f$ to
+/// the exterior of the unit circle, and the rest of the complex plane to its interior.
+/// Therefore, if the shifts are chosen such that the wanted eigenvalues lie to the right of
+/// \f$(\sigma+\mu)/2\f$, they become the dominant eigenvalues of the transformed problem,
+/// and can be found with `SortRule::LargestMagn` in a small number of iterations.
+/// The eigenvalues returned by the solver are already transformed back to
+/// \f$\lambda=(\sigma\nu-\mu)/(\nu-1)\f$.
+///
+/// Only \f$A-\sigma I\f$ needs to be factorized, since
+/// \f$(A-\sigma I)^{-1}(A-\mu I)x=x+(\sigma-\mu)(A-\sigma I)^{-1}x\f$.
+/// Hence this solver uses the same operator classes as GenEigsRealShiftSolver, and
+/// a SparseGenRealShiftSolve object can be reused across solvers and shifts,
+/// with its symbolic analysis computed only once.
+///
+/// \tparam OpType  The name of the matrix operation class. Users could either
+///                 use the wrapper classes such as DenseGenRealShiftSolve and
+///                 SparseGenRealShiftSolve, or define their own that implements the type
+///                 definition `Scalar` and all the public member functions as in
+///                 DenseGenRealShiftSolve.
+///
+/// Below is an example that finds the rightmost eigenvalues of a sparse matrix.
+///
+/// \code{.cpp}
+/// #include <Eigen/Core>
+/// #include <Eigen/SparseCore>
+/// #include <Spectra/GenEigsCayleySolver.h>
+/// #include <Spectra/MatOp/SparseGenRealShiftSolve.h>
+/// #include <iostream>
+///
+/// using namespace Spectra;
+///
+/// int main()
+/// {
+///     // A block diagonal matrix with 2x2 blocks [a, 1; -1, a], whose eigenvalues
+///     // a +/- i have real parts a = 0, -0.1, ..., -49.9
+///     const int n = 1000;
+///     Eigen::SparseMatrix<double> M(n, n);
+///     for (int i = 0; i < n; i += 2)
+///     {
+///         M.insert(i, i) = -0.05 * i;
+///         M.insert(i + 1, i + 1) = -0.05 * i;
+///         M.insert(i, i + 1) = 1.0;
+///         M.insert(i + 1, i) = -1.0;
+///     }
+///
+///     // Construct matrix operation object using the wrapper class SparseGenRealShiftSolve
+///     SparseGenRealShiftSolve<double> op(M);
+///
+///     // Construct eigen solver object with sigma = 1 and mu = -1.5, so that eigenvalues
+///     // to the right of -0.25 become dominant
+///     GenEigsCayleySolver<SparseGenRealShiftSolve<double>> eigs(op, 4, 20, 1.0, -1.5);
+///
+///     // Initialize and compute
+///     eigs.init();
+///     int nconv = eigs.compute(SortRule::LargestMagn, 1000, 1e-10, SortRule::LargestReal);
+///
+///     // Retrieve results
+///     Eigen::VectorXcd evalues;
+///     if (eigs.info() == CompInfo::Successful)
+///         evalues = eigs.eigenvalues();
+///
+///     std::cout << "Rightmost eigenvalues found:\n" << evalues << std::endl;
+///
+///     return 0;
+/// }
+/// \endcode
+///
+template <typename OpType = DenseGenRealShiftSolve<double>>
+class GenEigsCayleySolver : public GenEigsBase<GenEigsCayleyOp<OpType>, IdentityBOp>
+{
+private:
+    using Scalar = typename OpType::Scalar;
+    using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+
+    using ModeMatOp = GenEigsCayleyOp<OpType>;
+    using Base = GenEigsBase<ModeMatOp, IdentityBOp>;
+    using Base::m_nev;
+    using Base::m_ritz_val;
+
+    const Scalar m_sigma;
+    const Scalar m_mu;
+
+    // Set shifts and forward
+    static ModeMatOp set_shift_and_move(ModeMatOp&& op, const Scalar& sigma, const Scalar& mu)
+    {
+        if (sigma == mu)
+            throw std::invalid_argument("GenEigsCayleySolver: sigma and mu must be different");
+        op.set_shift(sigma, mu);
+        return std::move(op);
+    }
+
+    // First transform back the Ritz values, and then sort
+    void sort_ritzpair(SortRule sort_rule) override
+    {
+        // The eigenvalues we get from the iteration is nu = (lambda - mu) / (lambda - sigma)
+        // So the eigenvalues of the original problem is lambda = (sigma * nu - mu) / (nu - 1)
+        m_ritz_val.head(m_nev).array() = (m_sigma * m_ritz_val.head(m_nev).array() - m_mu) /
+            (m_ritz_val.head(m_nev).array() - Scalar(1));
+        Base::sort_ritzpair(sort_rule);
+    }
+
+    // The Schur form of the original problem is sigma * I + (sigma - mu) * inv(T - I)
+    void transform_schur_form(Matrix& T) const override
+    {
+        T.diagonal().array() -= Scalar(1);
+        T = (m_sigma - m_mu) * Base::quasi_triangular_inverse(T);
+        T.diagonal().array() += m_sigma;
+    }
+
+public:
+    ///
+    /// Constructor to create a eigen solver object using the Cayley mode.
+    ///
+    /// \param op     The matrix operation object that implements
+    ///               the shift-solve operation of \f$A\f$: calculating
+    ///               \f$(A-\sigma I)^{-1}v\f$ for any vector \f$v\f$. Users could either
+    ///               create the object from the wrapper class such as DenseGenRealShiftSolve, or
+    ///               define their own that implements all the public members
+    ///               as in DenseGenRealShiftSolve.
+    /// \param nev    Number of eigenvalues requested. This should satisfy \f$1\le nev \le n-2\f$,
+    ///               where \f$n\f$ is the size of matrix.
+    /// \param ncv    Parameter that controls the convergence speed of the algorithm.
+    ///               Typically a larger `ncv` means faster convergence, but it may
+    ///               also result in greater memory use and more matrix operations
+    ///               in each iteration. This parameter must satisfy \f$nev+2 \le ncv \le n\f$,
+    ///               and is advised to take \f$ncv \ge 2\cdot nev + 1\f$.
+    /// \param sigma  The pole of the transformation, which must not be an eigenvalue of \f$A\f$.
+    /// \param mu     The zero of the transformation, which must be different from \f$\sigma\f$.
+    ///               Typically \f$\mu<\sigma\f$, and the wanted eigenvalues have real
+    ///               parts larger than \f$(\sigma+\mu)/2\f$.
+    ///
+    GenEigsCayleySolver(OpType& op, Index nev, Index ncv, const Scalar& sigma, const Scalar& mu) :
+        Base(set_shift_and_move(ModeMatOp(op), sigma, mu), IdentityBOp(), nev, ncv),
+        m_sigma(sigma),
+        m_mu(mu)
+    {}
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_GEN_EIGS_CAYLEY_SOLVER_H
@@ -35,6 +35,7 @@ class GenEigsRealShiftSolver : public GenEigsBase<OpType, IdentityBOp>
 private:
     using Scalar = typename OpType::Scalar;
     using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
     using Complex = std::complex<Scalar>;
     using ComplexArray = Eigen::Array<Complex, Eigen::Dynamic, 1>;
 
@@ -53,6 +54,13 @@ private:
         Base::sort_ritzpair(sort_rule);
     }
 
+    // The Schur form of the original problem is inv(T) + sigma * I
+    void transform_schur_form(Matrix& T) const override
+    {
+        T = Base::quasi_triangular_inverse(T);
+        T.diagonal().array() += m_sigma;
+    }
+
 public:
     ///
     /// Constructor to create a eigen solver object using the shift-and-invert mode.
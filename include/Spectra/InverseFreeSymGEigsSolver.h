@@ -0,0 +1,496 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_INVERSE_FREE_SYM_GEIGS_SOLVER_H
+#define SPECTRA_INVERSE_FREE_SYM_GEIGS_SOLVER_H
+
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <cmath>       // std::abs, std::sqrt
+#include <functional>  // std::function
+#include <vector>      // std::vector
+#include <algorithm>   // std::max
+#include <stdexcept>   // std::invalid_argument
+
+#include "Util/Version.h"
+#include "Util/TypeTraits.h"
+#include "Util/CompInfo.h"
+#include "Util/ConvergenceRule.h"
+#include "Util/SimpleRandom.h"
+#include "Util/Trace.h"
+
+namespace Spectra {
+
+///
+/// \ingroup GEigenSolver
+///
+/// This class implements the inverse-free preconditioned Krylov subspace method
+/// of Golub and Ye (EIGIFP) for the smallest eigenvalues of the generalized problem
+/// \f$Ax=\lambda Bx\f$, where \f$A\f$ is symmetric and \f$B\f$ is positive definite.
+///
+/// Unlike SymGEigsShiftSolver, the solver never factorizes \f$A-\sigma B\f$ or \f$B\f$.
+/// It only needs the products \f$Av\f$ and \f$Bv\f$, and optionally a symmetric positive
+/// definite preconditioner \f$M\approx(A-\lambda_1B)^{-1}\f$, for example an incomplete
+/// Cholesky factorization of \f$A-\tau B\f$ with \f$\tau\f$ below the spectrum. This is
+/// suitable for large problems, such as 3D finite element models, whose factorizations
+/// do not fit in memory.
+///
+/// The solver works on a block of `block_size` approximate eigenvectors \f$x_i\f$ with
+/// Rayleigh quotients \f$\rho_i\f$. In each iteration, every unconverged \f$x_i\f$
+/// generates \f$m\f$ vectors of the preconditioned Krylov subspace of
+/// \f$M(A-\rho_iB)\f$ starting from the preconditioned residual, and the new block is
+/// obtained by the Rayleigh-Ritz procedure on the union of these subspaces, the current
+/// block, and the directions of the previous update. The basis is kept
+/// \f$B\f$-orthonormal by two passes of classical Gram-Schmidt, one vector at a time, so
+/// the block is never orthonormalized by an ill-conditioned Cholesky factorization.
+/// With `block_size = 1` the method reduces to the single-vector EIGIFP, and extra
+/// vectors in the block (`block_size > nev`) speed up the convergence when
+/// \f$\lambda_{nev}\f$ and \f$\lambda_{nev+1}\f$ are close.
+///
+/// \tparam OpType   The name of the matrix operation class for \f$A\f$. Users could either
+///                  use the wrapper classes such as DenseSymMatProd and
+///                  SparseSymMatProd, or define their own that implements the type
+///                  definition `Scalar` and all the public member functions as in
+///                  DenseSymMatProd.
+/// \tparam BOpType  The name of the matrix operation class for \f$B\f$, with the same
+///                  requirements as `OpType`.
+///
+/// Example:
+/// \code{.cpp}
+/// SparseSymMatProd<double> op(A), Bop(B);
+/// InverseFreeSymGEigsSolver<SparseSymMatProd<double>, SparseSymMatProd<double>>
+///     eigs(op, Bop, 4, 5, 4);
+/// // Incomplete Cholesky factorization of A as the preconditioner
+/// Eigen::IncompleteCholesky<double> ichol(A);
+/// eigs.set_preconditioner([&ichol](const double* x, double* y) {
+///     Eigen::Map<Eigen::VectorXd>(y, A.rows()) = ichol.solve(Eigen::Map<const Eigen::VectorXd>(x, A.rows()));
+/// });
+/// eigs.init();
+/// eigs.compute();
+/// Eigen::VectorXd evals = eigs.eigenvalues();  // the 4 smallest, increasing
+/// \endcode
+///
+template <typename OpType, typename BOpType>
+class InverseFreeSymGEigsSolver
+{
+public:
+    ///
+    /// Element type of the matrix.
+    ///
+    using Scalar = typename OpType::Scalar;
+
+    ///
+    /// Type of the preconditioner, which computes \f$y=Mx\f$ given the pointers
+    /// to \f$x\f$ and \f$y\f$. \f$M\f$ must be symmetric positive definite.
+    ///
+    using Preconditioner = std::function<void(const Scalar* x_in, Scalar* y_out)>;
+
+private:
+    using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using Array = Eigen::Array<Scalar, Eigen::Dynamic, 1>;
+    using BoolArray = Eigen::Array<bool, Eigen::Dynamic, 1>;
+    using MapConstMat = Eigen::Map<const Matrix>;
+
+    // clang-format off
+    OpType&        m_op;       // object for A * v
+    BOpType&       m_Bop;      // object for B * v
+    const Index    m_n;        // dimension of matrix A
+    const Index    m_nev;      // number of eigenvalues requested
+    const Index    m_bs;       // block size
+    const Index    m_m;        // number of Krylov vectors per block vector and iteration
+    Preconditioner m_precond;  // preconditioner, none if empty
+
+    Matrix         m_S;        // B-orthonormal basis of the search subspace
+    Matrix         m_AS;       // A * S
+    Matrix         m_BS;       // B * S
+    Index          m_k;        // current dimension of the search subspace
+
+    Matrix         m_X;        // current block of approximate eigenvectors, B-orthonormal
+    Matrix         m_AX;       // A * X
+    Matrix         m_BX;       // B * X
+    Matrix         m_P;        // directions of the previous update
+    Matrix         m_AP;       // A * P
+    Matrix         m_BP;       // B * P
+    Vector         m_theta;    // Rayleigh quotients of the block, increasing
+    Array          m_resid;    // residual norms of the block
+    BoolArray      m_conv;     // convergence of the first nev vectors
+
+    Index          m_nmatop;   // number of products with A, and also with B
+    Index          m_niter;    // number of iterations
+    Scalar         m_op_norm;  // estimate of the operator norm, from the Rayleigh quotients
+    CompInfo       m_info;     // status of the computation
+    // clang-format on
+
+    // Computes A * v and B * v
+    void apply_ops(const Vector& v, Vector& Av, Vector& Bv)
+    {
+        m_op.perform_op(v.data(), Av.data());
+        m_Bop.perform_op(v.data(), Bv.data());
+        m_nmatop++;
+    }
+
+    // y = M * x, or y = x without a preconditioner
+    void precond(const Vector& x, Vector& y) const
+    {
+        if (m_precond)
+            m_precond(x.data(), y.data());
+        else
+            y.noalias() = x;
+    }
+
+    // Orthogonalizes w against the current basis in the B-inner product, using two
+    // passes of classical Gram-Schmidt and S' * B * w = (B * S)' * w. The same operations
+    // are applied to Aw and Bw if they are given. Returns false if w is numerically in
+    // the subspace, or if the basis is full
+    bool orthogonalize(Vector& w, Vector* Aw, Vector* Bw)
+    {
+        using std::sqrt;
+
+        const Scalar wnorm0 = w.norm();
+        if (m_k >= m_S.cols() || !(wnorm0 > Scalar(0)))
+            return false;
+
+        Vector c(m_k);
+        for (int pass = 0; pass < 2 && m_k > 0; pass++)
+        {
+            c.noalias() = m_BS.leftCols(m_k).transpose() * w;
+            w.noalias() -= m_S.leftCols(m_k) * c;
+            if (Aw)
+                Aw->noalias() -= m_AS.leftCols(m_k) * c;
+            if (Bw)
+                Bw->noalias() -= m_BS.leftCols(m_k) * c;
+        }
+        return w.norm() > sqrt(TypeTraits<Scalar>::epsilon()) * wnorm0;
+    }
+
+    // Appends w, which is B-orthogonal to the current basis, with its products Aw and Bw
+    // after normalizing it in the B-norm
+    bool push(const Vector& w, const Vector& Aw, const Vector& Bw)
+    {
+        using std::sqrt;
+
+        const Scalar wnorm = sqrt((std::max)(w.dot(Bw), Scalar(0)));
+        if (!(wnorm > Scalar(0)))
+            return false;
+
+        m_S.col(m_k).noalias() = w / wnorm;
+        m_AS.col(m_k).noalias() = Aw / wnorm;
+        m_BS.col(m_k).noalias() = Bw / wnorm;
+        m_k++;
+        return true;
+    }
+
+    // Orthogonalizes a new vector w against the current basis, and appends it to the
+    // basis. The products with A and B are computed after the orthogonalization rather
+    // than updated along with it, which would lose accuracy when w is nearly contained
+    // in the subspace, and these rounding errors would be amplified over the iterations
+    bool append_new(Vector& w)
+    {
+        if (!orthogonalize(w, nullptr, nullptr))
+            return false;
+        Vector Aw(m_n), Bw(m_n);
+        apply_ops(w, Aw, Bw);
+        return push(w, Aw, Bw);
+    }
+
+    // Rayleigh-Ritz procedure on the search subspace, which updates the block, the
+    // directions of the update, and the residual norms
+    void rayleigh_ritz()
+    {
+        SPECTRA_TRACE_SCOPE("InverseFreeSymGEigs::rayleigh_ritz");
+
+        // Symmetrize the projected matrices to remove rounding errors
+        Matrix As = m_S.leftCols(m_k).transpose() * m_AS.leftCols(m_k);
+        As = (As + As.transpose()) / Scalar(2);
+        Matrix Bs = m_S.leftCols(m_k).transpose() * m_BS.leftCols(m_k);
+        Bs = (Bs + Bs.transpose()) / Scalar(2);
+        Eigen::GeneralizedSelfAdjointEigenSolver<Matrix> eig(As, Bs);
+        if (eig.info() != Eigen::Success)
+            throw std::runtime_error("InverseFreeSymGEigsSolver: the projected eigen problem failed");
+
+        // The eigenvectors satisfy U' * Bs * U = I, so the new block is B-orthonormal
+        const Matrix U = eig.eigenvectors().leftCols(m_bs);
+        m_theta.noalias() = eig.eigenvalues().head(m_bs);
+        m_X.noalias() = m_S.leftCols(m_k) * U;
+        m_AX.noalias() = m_AS.leftCols(m_k) * U;
+        m_BX.noalias() = m_BS.leftCols(m_k) * U;
+
+        // The part of the update outside the old block, as in LOBPCG
+        const Index nrest = m_k - m_bs;
+        if (nrest > 0)
+        {
+            m_P.noalias() = m_S.middleCols(m_bs, nrest) * U.bottomRows(nrest);
+            m_AP.noalias() = m_AS.middleCols(m_bs, nrest) * U.bottomRows(nrest);
+            m_BP.noalias() = m_BS.middleCols(m_bs, nrest) * U.bottomRows(nrest);
+        }
+
+        // Residual norms ||A * x - theta * B * x|| / ||B * x||
+        m_resid.resize(m_bs);
+        for (Index i = 0; i < m_bs; i++)
+            m_resid[i] = (m_AX.col(i) - m_theta[i] * m_BX.col(i)).norm() / m_BX.col(i).norm();
+        m_op_norm = (std::max)(m_op_norm, m_theta.cwiseAbs().maxCoeff());
+    }
+
+    // Convergence of the first nev vectors of the block
+    void check_convergence(const ConvergenceCriterion<Scalar>& criterion, const Scalar& tol)
+    {
+        const Array theta_abs = m_theta.head(m_nev).array().abs();
+        // A zero residual means that the eigen pair is exact
+        m_conv = criterion.converged(theta_abs, m_resid.head(m_nev), m_op_norm, tol) ||
+            (m_resid.head(m_nev) == Scalar(0));
+    }
+
+    // Builds the search subspace from the block, the previous directions, and the
+    // preconditioned Krylov vectors of the unconverged block vectors
+    // Returns the number of Krylov vectors added
+    Index expand()
+    {
+        SPECTRA_TRACE_SCOPE("InverseFreeSymGEigs::expand");
+
+        // The block is already B-orthonormal
+        m_S.leftCols(m_bs).noalias() = m_X;
+        m_AS.leftCols(m_bs).noalias() = m_AX;
+        m_BS.leftCols(m_bs).noalias() = m_BX;
+        m_k = m_bs;
+
+        // P is B-orthogonal to X in exact arithmetic, so its products can be updated
+        // along with the orthogonalization
+        Vector w(m_n), Aw(m_n), Bw(m_n);
+        for (Index i = 0; i < m_P.cols(); i++)
+        {
+            w.noalias() = m_P.col(i);
+            Aw.noalias() = m_AP.col(i);
+            Bw.noalias() = m_BP.col(i);
+            if (orthogonalize(w, &Aw, &Bw))
+                push(w, Aw, Bw);
+        }
+
+        // Krylov vectors of M * (A - rho_i * B), starting from the preconditioned residual
+        // M * r_i, generated one step at a time for all block vectors
+        // active[i] is the basis column of the last Krylov vector of x_i, or -1 if the
+        // chain has stopped
+        std::vector<Index> active(m_bs, -1);
+        Vector r(m_n);
+        Index added = 0;
+        for (Index j = 0; j < m_m; j++)
+        {
+            for (Index i = 0; i < m_bs; i++)
+            {
+                if (j == 0)
+                {
+                    if (i < m_nev && m_conv[i])
+                        continue;
+                    r.noalias() = m_AX.col(i) - m_theta[i] * m_BX.col(i);
+                }
+                else
+                {
+                    if (active[i] < 0)
+                        continue;
+                    r.noalias() = m_AS.col(active[i]) - m_theta[i] * m_BS.col(active[i]);
+                }
+                precond(r, w);
+                if (append_new(w))
+                {
+                    active[i] = m_k - 1;
+                    added++;
+                }
+                else
+                {
+                    active[i] = -1;
+                }
+            }
+        }
+
+        return added;
+    }
+
+public:
+    ///
+    /// Constructor to create a solver object.
+    ///
+    /// \param op          The \f$A\f$ matrix operation object that implements the
+    ///                    matrix-vector product \f$Av\f$.
+    /// \param Bop         The \f$B\f$ matrix operation object that implements the
+    ///                    matrix-vector product \f$Bv\f$.
+    /// \param nev         Number of smallest eigenvalues requested. This should satisfy
+    ///                    \f$1\le nev\le block\_size\f$.
+    /// \param block_size  Number of approximate eigenvectors updated together.
+    /// \param m           Number of preconditioned Krylov vectors generated by each
+    ///                    block vector in one iteration. Larger values reduce the number
+    ///                    of iterations, but each iteration is more expensive. The search
+    ///                    subspace has at most \f$block\_size\cdot(m+2)\f$ vectors, which
+    ///                    must not exceed the size of the matrix.
+    ///
+    InverseFreeSymGEigsSolver(OpType& op, BOpType& Bop, Index nev, Index block_size, Index m) :
+        m_op(op),
+        m_Bop(Bop),
+        m_n(op.rows()),
+        m_nev(nev),
+        m_bs(block_size),
+        m_m(m),
+        m_k(0),
+        m_nmatop(0),
+        m_niter(0),
+        m_op_norm(0),
+        m_info(CompInfo::NotComputed)
+    {
+        if (Bop.rows() != m_n)
+            throw std::invalid_argument("InverseFreeSymGEigsSolver: A and B must have the same dimension");
+        if (nev < 1 || nev > block_size)
+            throw std::invalid_argument("nev must satisfy 1 <= nev <= block_size");
+        if (m < 1)
+            throw std::invalid_argument("InverseFreeSymGEigsSolver: m must be greater than zero");
+        if (block_size * (m + 2) > m_n)
+            throw std::invalid_argument("block_size * (m + 2) must not exceed the size of matrix");
+    }
+
+    ///
+    /// Sets the preconditioner \f$M\f$, which approximates \f$(A-\lambda_1B)^{-1}\f$ and
+    /// must be symmetric positive definite. An empty function disables preconditioning,
+    /// which is the default.
+    ///
+    void set_preconditioner(const Preconditioner& precond) { m_precond = precond; }
+
+    ///
+    /// Initializes the solver by providing an initial block.
+    ///
+    /// \param init_block Pointer to the initial block, an \f$n\times block\_size\f$ matrix
+    ///                   stored in column-major order, whose columns must be linearly
+    ///                   independent.
+    ///
+    void init(const Scalar* init_block)
+    {
+        m_nmatop = 0;
+        m_niter = 0;
+        m_op_norm = Scalar(0);
+        m_info = CompInfo::NotComputed;
+
+        const Index kmax = m_bs * (m_m + 2);
+        m_S.resize(m_n, kmax);
+        m_AS.resize(m_n, kmax);
+        m_BS.resize(m_n, kmax);
+        m_k = 0;
+        m_P.resize(m_n, 0);
+        m_AP.resize(m_n, 0);
+        m_BP.resize(m_n, 0);
+
+        MapConstMat X0(init_block, m_n, m_bs);
+        Vector w(m_n);
+        for (Index i = 0; i < m_bs; i++)
+        {
+            w.noalias() = X0.col(i);
+            if (!append_new(w))
+                throw std::invalid_argument("InverseFreeSymGEigsSolver: the initial block must have linearly independent columns");
+        }
+        rayleigh_ritz();
+    }
+
+    ///
+    /// Initializes the solver by providing a random initial block.
+    ///
+    /// This overloaded function generates a random initial block
+    /// (with a fixed random seed) for the algorithm. Elements in the block
+    /// follow independent Uniform(-0.5, 0.5) distribution.
+    ///
+    void init()
+    {
+        SimpleRandom<Scalar> rng(0);
+        Matrix init_block(m_n, m_bs);
+        for (Index j = 0; j < m_bs; j++)
+            init_block.col(j).noalias() = rng.random_vec(m_n);
+        init(init_block.data());
+    }
+
+    ///
+    /// Conducts the major computation procedure.
+    ///
+    /// \param maxit      Maximum number of iterations allowed in the algorithm.
+    /// \param tol        Precision parameter for the calculated eigenvalues.
+    /// \param criterion  Convergence criterion of the eigen pairs, with the same meaning
+    ///                   as in SymEigsSolver. The residual norm of an approximate eigen
+    ///                   pair \f$(\theta,x)\f$ is \f$\|Ax-\theta Bx\|/\|Bx\|\f$, computed
+    ///                   exactly in each iteration.
+    ///
+    /// \return Number of converged eigenvalues.
+    ///
+    Index compute(Index maxit = 1000, Scalar tol = 1e-10,
+                  const ConvergenceCriterion<Scalar>& criterion = ConvergenceRule::RitzValue)
+    {
+        SPECTRA_TRACE_SCOPE("InverseFreeSymGEigs::compute");
+
+        if (m_X.cols() != m_bs)
+            init();
+
+        check_convergence(criterion, tol);
+        Index i;
+        for (i = 0; i < maxit && !m_conv.all(); i++)
+        {
+            // Stop if the subspace cannot be expanded further
+            if (expand() == 0)
+                break;
+            rayleigh_ritz();
+            check_convergence(criterion, tol);
+        }
+        m_niter += i;
+
+        m_info = m_conv.all() ? CompInfo::Successful : CompInfo::NotConverging;
+        return m_conv.count();
+    }
+
+    ///
+    /// Returns the status of the computation.
+    /// The full list of enumeration values can be found in \ref Enumerations.
+    ///
+    CompInfo info() const { return m_info; }
+
+    ///
+    /// Returns the number of iterations used in the computation.
+    ///
+    Index num_iterations() const { return m_niter; }
+
+    ///
+    /// Returns the number of matrix-vector products with \f$A\f$ used in the computation.
+    /// The number of products with \f$B\f$ is the same.
+    ///
+    Index num_operations() const { return m_nmatop; }
+
+    ///
+    /// Returns the converged eigenvalues in increasing order.
+    ///
+    Vector eigenvalues() const
+    {
+        const Index nconv = m_conv.count();
+        Vector res(nconv);
+        for (Index i = 0, j = 0; i < m_nev; i++)
+        {
+            if (m_conv[i])
+                res[j++] = m_theta[i];
+        }
+        return res;
+    }
+
+    ///
+    /// Returns the eigenvectors associated with the converged eigenvalues,
+    /// normalized such that \f$X'BX=I\f$.
+    ///
+    Matrix eigenvectors() const
+    {
+        const Index nconv = m_conv.count();
+        Matrix res(m_n, nconv);
+        for (Index i = 0, j = 0; i < m_nev; i++)
+        {
+            if (m_conv[i])
+                res.col(j++).noalias() = m_X.col(i);
+        }
+        return res;
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_INVERSE_FREE_SYM_GEIGS_SOLVER_H
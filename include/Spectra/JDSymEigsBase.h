@@ -16,6 +16,7 @@
 
 #include "Util/SelectionRule.h"
 #include "Util/CompInfo.h"
+#include "Util/Trace.h"
 #include "LinAlg/SearchSpace.h"
 #include "LinAlg/RitzPairs.h"
 
@@ -144,6 +145,8 @@ public:
                              Scalar tol = 100 * Eigen::NumTraits<Scalar>::dummy_precision())
 
     {
+        SPECTRA_TRACE_SCOPE("JDSymEigs::compute");
+
         m_search_space.initialize_search_space(initial_space);
         niter_ = 0;
         for (niter_ = 0; niter_ < maxit; niter_++)
@@ -10,11 +10,13 @@
 #include <Eigen/Core>
 #include <cmath>      // std::sqrt
 #include <utility>    // std::move
+#include <algorithm>  // std::min
 #include <stdexcept>  // std::invalid_argument
 
 #include "../MatOp/internal/ArnoldiOp.h"
 #include "../Util/TypeTraits.h"
 #include "../Util/SimpleRandom.h"
+#include "../Util/Trace.h"
 #include "UpperHessenbergQR.h"
 #include "DoubleShiftQR.h"
 
@@ -47,31 +49,51 @@ protected:
 
     ArnoldiOpType m_op;  // Operators for the Arnoldi factorization
     const Index m_n;     // dimension of A
-    const Index m_m;     // maximum dimension of subspace V
+    Index m_m;           // maximum dimension of subspace V
     Index m_k;           // current dimension of subspace V
     Matrix m_fac_V;      // V matrix in the Arnoldi factorization
     Matrix m_fac_H;      // H matrix in the Arnoldi factorization
     Vector m_fac_f;      // residual in the Arnoldi factorization
     Scalar m_beta;       // ||f||, B-norm of f
 
+    // Resizes a Krylov vector or basis, and lets the operator place its rows if new memory
+    // is allocated. Memory that is reused keeps its placement, since first touch has no
+    // effect on it
+    template <typename Derived>
+    void allocate(Eigen::PlainObjectBase<Derived>& x, Index rows, Index cols)
+    {
+        const bool realloc = (x.size() != rows * cols);
+        x.resize(rows, cols);
+        if (realloc)
+            m_op.first_touch(x.data(), rows, cols);
+    }
+
     // Given orthonormal basis V (w.r.t. B), find a nonzero vector f such that V'Bf = 0
     // With rounding errors, we hope V'B(f/||f||) < eps
     // Assume that f has been properly allocated
-    void expand_basis(MapConstMat& V, const Index seed, Vector& f, Scalar& fnorm, Index& op_counter)
+    // Returns true if the range of A is numerically contained in span(V), detected by
+    // the first try below, in which case f is a random vector orthogonal to V with A * f = 0
+    // op_norm is an estimate of ||A|| used to select the candidates of this case
+    bool expand_basis(MapConstMat& V, const Index seed, Vector& f, Scalar& fnorm, Index& op_counter,
+                      const Scalar& op_norm = Scalar(0))
     {
         using std::sqrt;
 
+        const Scalar thresh = m_eps * sqrt(Scalar(m_n));
         Vector v(m_n), Vf(V.cols());
+        bool range_in_V = false;
         for (Index iter = 0; iter < 5; iter++)
         {
             // Randomly generate a new vector and orthogonalize it against V
             SimpleRandom<Scalar> rng(seed + 123 * iter);
             // The first try forces f to be in the range of A
+            Scalar vnorm = Scalar(0);
             if (iter == 0)
             {
                 rng.random_vec(v);
                 m_op.perform_op(v.data(), f.data());
                 op_counter++;
+                vnorm = m_op.norm(v);
             }
             else
             {
@@ -83,6 +105,32 @@ protected:
             // fnorm <- ||f||
             fnorm = m_op.norm(f);
 
+            // If A * v is in span(V) up to rounding errors relative to ||A||, then the
+            // range of A may be contained in span(V), since v is random. This also
+            // happens if A has nonzero eigenvalues that are tiny compared with ||A||,
+            // so we verify it on a random unit vector v orthogonal to V, which must
+            // satisfy A * v = 0 in absolute terms. If the test fails, we continue with
+            // f from the first try
+            if (iter == 0 && fnorm <= thresh * op_norm * vnorm)
+            {
+                rng.random_vec(v);
+                for (int pass = 0; pass < 2; pass++)
+                {
+                    m_op.trans_product(V, v, Vf);
+                    v.noalias() -= V * Vf;
+                }
+                v /= m_op.norm(v);
+                Vector Av(m_n);
+                m_op.perform_op(v.data(), Av.data());
+                op_counter++;
+                range_in_V = (m_op.norm(Av) < thresh);
+                if (range_in_V)
+                {
+                    f.noalias() = v;
+                    fnorm = Scalar(1);
+                }
+            }
+
             // Compute V'Bf again
             m_op.trans_product(V, f, Vf);
             // Test whether V'B(f/||f||) < eps
@@ -104,8 +152,9 @@ protected:
             // If the condition is satisfied, simply return
             // Otherwise, go to the next iteration and try a new random vector
             if (ortho_err < m_eps * fnorm)
-                return;
+                return range_in_V;
         }
+        return range_in_V;
     }
 
 public:
@@ -127,13 +176,15 @@ public:
     Index subspace_dim() const { return m_k; }
 
     // Initialize with an operator and an initial vector
-    void init(MapConstVec& v0, Index& op_counter)
+    // If to_range is true, v0 is first multiplied by the operator, so that the initial
+    // vector is in the range of the operator
+    void init(MapConstVec& v0, Index& op_counter, bool to_range = true)
     {
         using std::abs;
 
-        m_fac_V.resize(m_n, m_m);
+        allocate(m_fac_V, m_n, m_m);
         m_fac_H.resize(m_m, m_m);
-        m_fac_f.resize(m_n);
+        allocate(m_fac_f, m_n, 1);
         m_fac_H.setZero();
 
         // Verify the initial vector
@@ -143,9 +194,16 @@ public:
 
         // Points to the first column of V
         MapVec v(m_fac_V.data(), m_n);
-        // Force v to be in the range of A, i.e., v = A * v0
-        m_op.perform_op(v0.data(), v.data());
-        op_counter++;
+        if (to_range)
+        {
+            // Force v to be in the range of A, i.e., v = A * v0
+            m_op.perform_op(v0.data(), v.data());
+            op_counter++;
+        }
+        else
+        {
+            v.noalias() = v0;
+        }
 
         // Normalize
         const Scalar vnorm = m_op.norm(v);
@@ -177,11 +235,60 @@ public:
         m_k = 1;
     }
 
+    // Restore a saved k-step factorization A * V = V * H + f * e'
+    // If k is larger than m, the leading m-step factorization is kept
+    void restore(const Matrix& V, const Matrix& H, const Vector& f)
+    {
+        const Index k = V.cols();
+        if (V.rows() != m_n || k < 1)
+            throw std::invalid_argument("Arnoldi: the saved factorization does not match the operator");
+
+        allocate(m_fac_V, m_n, m_m);
+        m_fac_H.resize(m_m, m_m);
+        allocate(m_fac_f, m_n, 1);
+
+        m_k = (std::min)(k, m_m);
+        m_fac_V.leftCols(m_k).noalias() = V.leftCols(m_k);
+        m_fac_H.setZero();
+        m_fac_H.topLeftCorner(m_k, m_k).noalias() = H.topLeftCorner(m_k, m_k);
+        // After truncation, the residual is the next basis vector scaled by H(k, k-1)
+        if (m_k == k)
+            m_fac_f.noalias() = f;
+        else
+            m_fac_f.noalias() = H(m_k, m_k - 1) * V.col(m_k);
+        m_beta = m_op.norm(m_fac_f);
+    }
+
+    // Change the maximum dimension of the subspace to m, keeping the current factorization
+    // if its dimension does not exceed m
+    void resize(Index m)
+    {
+        if (m < 1 || m > m_n)
+            throw std::invalid_argument("Arnoldi: the new subspace dimension must satisfy 1 <= m <= n");
+        // A factorization larger than m cannot be kept, and the object needs to be
+        // initialized again
+        if (m < m_k)
+            m_k = 0;
+
+        Matrix V(m_n, m);
+        m_op.first_touch(V.data(), m_n, m);
+        V.leftCols(m_k).noalias() = m_fac_V.leftCols(m_k);
+        m_fac_V.swap(V);
+
+        Matrix H = Matrix::Zero(m, m);
+        H.topLeftCorner(m_k, m_k).noalias() = m_fac_H.topLeftCorner(m_k, m_k);
+        m_fac_H.swap(H);
+
+        m_m = m;
+    }
+
     // Arnoldi factorization starting from step-k
     virtual void factorize_from(Index from_k, Index to_m, Index& op_counter)
     {
         using std::sqrt;
 
+        SPECTRA_TRACE_SCOPE("Arnoldi::factorize_from");
+
         if (to_m <= from_k)
             return;
 
@@ -34,9 +34,11 @@ private:
     using IntVector = Eigen::Matrix<Index, Eigen::Dynamic, 1>;
     using GenericVector = Eigen::Ref<Vector>;
     using ConstGenericVector = const Eigen::Ref<const Vector>;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
 
     Index m_n;
-    Vector m_data;                                 // storage for a lower-triangular matrix
+    Vector m_data;                                 // storage for a lower-triangular matrix, empty if the
+                                                   // factorization is computed in a user-provided matrix
     std::vector<Scalar*> m_colptr;                 // pointers to columns
     IntVector m_perm;                              // [-2, -1, 3, 1, 4, 5]: 0 <-> 2, 1 <-> 1, 2 <-> 3, 3 <-> 1, 4 <-> 4, 5 <-> 5
     std::vector<std::pair<Index, Index>> m_permc;  // compressed version of m_perm: [(0, 2), (2, 3), (3, 1)]
@@ -68,6 +70,16 @@ private:
         }
     }
 
+    // Compute column pointers for the lower triangular part of a
+    // column-major matrix with leading dimension ld
+    void compute_pointer(Scalar* data, Index ld)
+    {
+        m_colptr.clear();
+        m_colptr.reserve(m_n);
+        for (Index i = 0; i < m_n; i++)
+            m_colptr.push_back(data + i * ld + i);
+    }
+
     // Copy mat - shift * I to m_data
     template <typename Derived>
     void copy_data(const Eigen::MatrixBase<Derived>& mat, int uplo, const Scalar& shift)
@@ -132,7 +144,7 @@ private:
         std::swap(diag_coeff(k), diag_coeff(r));
 
         // A[(r+1):end, k] <-> A[(r+1):end, r]
-        std::swap_ranges(&coeff(r + 1, k), col_pointer(k + 1), &coeff(r + 1, r));
+        std::swap_ranges(&coeff(r + 1, k), col_pointer(k) + (m_n - k), &coeff(r + 1, r));
 
         // A[(k+1):(r-1), k] <-> A[r, (k+1):(r-1)]
         Scalar* src = &coeff(k + 1, k);
@@ -183,7 +195,7 @@ private:
         using std::abs;
 
         const Scalar* head = col_pointer(k);  // => A[k, k]
-        const Scalar* end = col_pointer(k + 1);
+        const Scalar* end = head + (m_n - k);
         // Start with r=k+1, lambda=A[k+1, k]
         r = k + 1;
         Scalar lambda = abs(head[1]);
@@ -376,36 +388,14 @@ private:
         return CompInfo::Successful;
     }
 
-public:
-    BKLDLT() :
-        m_n(0), m_computed(false), m_info(CompInfo::NotComputed)
-    {}
-
-    // Factorize mat - shift * I
-    template <typename Derived>
-    BKLDLT(const Eigen::MatrixBase<Derived>& mat, int uplo = Eigen::Lower, const Scalar& shift = Scalar(0)) :
-        m_n(mat.rows()), m_computed(false), m_info(CompInfo::NotComputed)
-    {
-        compute(mat, uplo, shift);
-    }
-
-    template <typename Derived>
-    void compute(const Eigen::MatrixBase<Derived>& mat, int uplo = Eigen::Lower, const Scalar& shift = Scalar(0))
+    // Factorize the matrix stored in m_colptr
+    void factorize()
     {
         using std::abs;
 
-        m_n = mat.rows();
-        if (m_n != mat.cols())
-            throw std::invalid_argument("BKLDLT: matrix must be square");
-
         m_perm.setLinSpaced(m_n, 0, m_n - 1);
         m_permc.clear();
 
-        // Copy data
-        m_data.resize((m_n * (m_n + 1)) / 2);
-        compute_pointer();
-        copy_data(mat, uplo, shift);
-
         const Scalar alpha = (1.0 + std::sqrt(17.0)) / 8.0;
         Index k = 0;
         for (k = 0; k < m_n - 1; k++)
@@ -443,6 +433,51 @@ public:
         m_computed = true;
     }
 
+public:
+    BKLDLT() :
+        m_n(0), m_computed(false), m_info(CompInfo::NotComputed)
+    {}
+
+    // Factorize mat - shift * I
+    template <typename Derived>
+    BKLDLT(const Eigen::MatrixBase<Derived>& mat, int uplo = Eigen::Lower, const Scalar& shift = Scalar(0)) :
+        m_n(mat.rows()), m_computed(false), m_info(CompInfo::NotComputed)
+    {
+        compute(mat, uplo, shift);
+    }
+
+    template <typename Derived>
+    void compute(const Eigen::MatrixBase<Derived>& mat, int uplo = Eigen::Lower, const Scalar& shift = Scalar(0))
+    {
+        m_n = mat.rows();
+        if (m_n != mat.cols())
+            throw std::invalid_argument("BKLDLT: matrix must be square");
+
+        // Copy data
+        m_data.resize((m_n * (m_n + 1)) / 2);
+        compute_pointer();
+        copy_data(mat, uplo, shift);
+
+        factorize();
+    }
+
+    // Factorize mat - shift * I in place, without copying the matrix
+    // Only the lower triangular part of the column-major matrix mat is referenced,
+    // and it is overwritten by the factorization, so mat must not be modified or
+    // destroyed while this object is used. The strictly upper triangular part is untouched
+    void compute_inplace(Eigen::Ref<Matrix> mat, const Scalar& shift = Scalar(0))
+    {
+        m_n = mat.rows();
+        if (m_n != mat.cols())
+            throw std::invalid_argument("BKLDLT: matrix must be square");
+
+        m_data.resize(0);
+        compute_pointer(mat.data(), mat.outerStride());
+        mat.diagonal().array() -= shift;
+
+        factorize();
+    }
+
     // Solve Ax=b
     void solve_inplace(GenericVector b) const
     {
@@ -529,6 +564,59 @@ public:
         return res;
     }
 
+    // Number of positive, negative, and zero eigenvalues of the factorized matrix,
+    // computed from the 1x1 and 2x2 blocks of D (Sylvester's law of inertia)
+    // The diagonal blocks are stored in inverted form, which preserves the signs
+    // of the eigenvalues
+    void inertia(Index& npos, Index& nneg, Index& nzero) const
+    {
+        if (!m_computed)
+            throw std::logic_error("BKLDLT: need to call compute() first");
+
+        npos = nneg = nzero = 0;
+        for (Index i = 0; i < m_n; i++)
+        {
+            const Scalar e11 = diag_coeff(i);
+            if (m_perm[i] >= 0)
+            {
+                if (e11 > Scalar(0))
+                    npos++;
+                else if (e11 < Scalar(0))
+                    nneg++;
+                else
+                    nzero++;
+            }
+            else
+            {
+                const Scalar e21 = coeff(i + 1, i), e22 = diag_coeff(i + 1);
+                const Scalar det = e11 * e22 - e21 * e21;
+                if (det < Scalar(0))
+                {
+                    npos++;
+                    nneg++;
+                }
+                else if (det > Scalar(0))
+                {
+                    if (e11 + e22 > Scalar(0))
+                        npos += 2;
+                    else
+                        nneg += 2;
+                }
+                else
+                {
+                    nzero++;
+                    if (e11 + e22 > Scalar(0))
+                        npos++;
+                    else if (e11 + e22 < Scalar(0))
+                        nneg++;
+                    else
+                        nzero++;
+                }
+                i++;
+            }
+        }
+    }
+
     CompInfo info() const { return m_info; }
 };
 
@@ -0,0 +1,218 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_BLOCK_ARNOLDI_H
+#define SPECTRA_BLOCK_ARNOLDI_H
+
+#include <Eigen/Core>
+#include <cmath>      // std::sqrt
+#include <string>     // std::string, std::to_string
+#include <stdexcept>  // std::invalid_argument
+
+#include "../Util/TypeTraits.h"
+#include "../Util/SimpleRandom.h"
+#include "../Util/Trace.h"
+
+namespace Spectra {
+
+// Block Arnoldi factorization A * V = W * G, where W = [V, U]
+// A: n x n
+// V: n x k, orthonormal
+// U: n x b, orthonormal and orthogonal to V, the next block of the basis
+// G: (k + b) x k, the projected matrix H = V'AV in the first k rows,
+//    and the coupling block U'AV in the last b rows
+// b is the block size. V and G are allocated of dimension m, so the maximum value of k is m
+//
+// Right after a block Arnoldi expansion, H is block upper Hessenberg, and U'AV is nonzero
+// only in its last b columns. After a restart by restart(), H and U'AV are general
+// matrices in the first k columns, which is the Krylov-Schur form of the factorization
+template <typename Scalar, typename OpType>
+class BlockArnoldi
+{
+private:
+    using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+    // A very small value, but 1.0 / m_near_0 does not overflow
+    // ~= 1e-307 for the "double" type
+    const Scalar m_near_0 = TypeTraits<Scalar>::min() * Scalar(10);
+    // The machine precision, ~= 1e-16 for the "double" type
+    const Scalar m_eps = TypeTraits<Scalar>::epsilon();
+
+    const OpType& m_op;  // object to conduct the matrix-matrix product A * X
+    const Index m_n;     // dimension of A
+    const Index m_m;     // maximum dimension of subspace V
+    const Index m_b;     // block size
+    Index m_k;           // current dimension of subspace V
+    Matrix m_fac_V;      // [V, U] in the factorization, n x (m + b)
+    Matrix m_fac_G;      // G in the factorization, (m + b) x m
+    Index m_nrand;       // number of random vectors generated, used as the seed
+
+    // Orthonormalize the columns of W against the first k columns of m_fac_V and
+    // among themselves, and write the result to the columns k, ..., k + b - 1 of m_fac_V
+    // On exit, W0 = V * C + Q * R, where W0 is the input W, V is the first k columns of
+    // m_fac_V, Q is the new block, C is stored in the first k rows of coef, and the
+    // upper triangular R is stored in the last b rows of coef
+    // If W is rank deficient, the missing directions of Q are generated randomly,
+    // with the corresponding diagonal elements of R set to zero
+    void orthonormalize_block(Index k, Matrix& W, Eigen::Ref<Matrix> coef)
+    {
+        using std::sqrt;
+
+        const Index b = W.cols();
+        Eigen::Ref<Matrix> C = coef.topRows(k);
+        Eigen::Ref<Matrix> R = coef.bottomRows(b);
+        C.setZero();
+        R.setZero();
+        const Vector wnorm0 = W.colwise().norm().transpose();
+
+        // Block classical Gram-Schmidt against V, twice is enough
+        if (k > 0)
+        {
+            const auto V = m_fac_V.leftCols(k);
+            for (int pass = 0; pass < 2; pass++)
+            {
+                const Matrix h = V.transpose() * W;
+                W.noalias() -= V * h;
+                C += h;
+            }
+        }
+
+        // Modified Gram-Schmidt with reorthogonalization within the block
+        const Scalar thresh = m_eps * sqrt(Scalar(m_n));
+        Vector h(b);
+        for (Index j = 0; j < b; j++)
+        {
+            auto w = W.col(j);
+            const auto Q = m_fac_V.middleCols(k, j);
+            for (int pass = 0; pass < 2; pass++)
+            {
+                h.head(j).noalias() = Q.transpose() * w;
+                w.noalias() -= Q * h.head(j);
+                R.col(j).head(j) += h.head(j);
+            }
+            const Scalar wnorm = w.norm();
+            if (wnorm > thresh * wnorm0[j] && wnorm > m_near_0)
+            {
+                R(j, j) = wnorm;
+                m_fac_V.col(k + j).noalias() = w / wnorm;
+                continue;
+            }
+
+            // W is rank deficient, so we generate a random direction that is orthogonal
+            // to the existing basis, and the diagonal element of R is zero
+            const auto Vq = m_fac_V.leftCols(k + j);
+            Vector v(m_n), c(k + j);
+            for (Index iter = 0; iter < 5; iter++)
+            {
+                SimpleRandom<Scalar> rng(123 * (m_nrand++) + 1);
+                rng.random_vec(v);
+                for (int pass = 0; pass < 2; pass++)
+                {
+                    c.noalias() = Vq.transpose() * v;
+                    v.noalias() -= Vq * c;
+                }
+                const Scalar vnorm = v.norm();
+                if (vnorm > thresh)
+                {
+                    m_fac_V.col(k + j).noalias() = v / vnorm;
+                    break;
+                }
+            }
+        }
+    }
+
+public:
+    BlockArnoldi(const OpType& op, Index m, Index b) :
+        m_op(op), m_n(op.rows()), m_m(m), m_b(b), m_k(0), m_nrand(0)
+    {}
+
+    // Const-reference to internal structures
+    // The first k columns of matrix_V() are V, and the next b columns are U
+    const Matrix& matrix_V() const { return m_fac_V; }
+    const Matrix& matrix_G() const { return m_fac_G; }
+    Index subspace_dim() const { return m_k; }
+    Index block_size() const { return m_b; }
+
+    // Initialize with the operator and an initial block V0, n x b
+    void init(const Matrix& V0)
+    {
+        m_fac_V.resize(m_n, m_m + m_b);
+        m_fac_G.resize(m_m + m_b, m_m);
+        m_fac_G.setZero();
+        m_nrand = 0;
+
+        if (V0.cwiseAbs().maxCoeff() < m_near_0)
+            throw std::invalid_argument("initial block cannot be zero");
+
+        Matrix W = V0;
+        Matrix coef(m_b, m_b);
+        orthonormalize_block(0, W, coef);
+
+        // Indicate that this is a step-0 factorization, with the first block as U
+        m_k = 0;
+    }
+
+    // Block Arnoldi factorization starting from step-k
+    // to_m - from_k must be a multiple of the block size
+    void factorize_from(Index from_k, Index to_m, Index& op_counter)
+    {
+        SPECTRA_TRACE_SCOPE("BlockArnoldi::factorize_from");
+
+        if (to_m <= from_k)
+            return;
+
+        if (from_k != m_k)
+        {
+            std::string msg = "BlockArnoldi: from_k (= " + std::to_string(from_k) +
+                ") is different from the current subspace dimension (= " + std::to_string(m_k) + ")";
+            throw std::invalid_argument(msg);
+        }
+        if (to_m > m_m || (to_m - from_k) % m_b != 0)
+            throw std::invalid_argument("BlockArnoldi: invalid target subspace dimension");
+
+        for (Index k = from_k; k < to_m; k += m_b)
+        {
+            // W <- A * U, which streams A once for the whole block
+            Matrix W = m_op * m_fac_V.middleCols(k, m_b);
+            op_counter += m_b;
+
+            // Orthonormalize W against [V, U], and the result becomes the next U
+            orthonormalize_block(k + m_b, W, m_fac_G.block(0, k, k + 2 * m_b, m_b));
+        }
+
+        m_k = to_m;
+    }
+
+    // Restart the factorization with a k-dimensional invariant subspace of H
+    // Q is an m x k matrix with orthonormal columns such that HQ = QS for some S,
+    // and then V <- VQ, H <- Q'HQ, and U'AV <- U'AVQ
+    void restart(const Matrix& Q)
+    {
+        const Index k = Q.cols();
+        if (Q.rows() != m_k || k + m_b > m_m)
+            throw std::invalid_argument("BlockArnoldi: invalid restarting basis");
+
+        const Matrix S = Q.transpose() * m_fac_G.topLeftCorner(m_k, m_k) * Q;
+        const Matrix B = m_fac_G.block(m_k, 0, m_b, m_k) * Q;
+
+        const Matrix Vk = m_fac_V.leftCols(m_k) * Q;
+        m_fac_V.leftCols(k).noalias() = Vk;
+        // Columns are moved to the left, so there is no overlap issue in the copy
+        for (Index j = 0; j < m_b; j++)
+            m_fac_V.col(k + j) = m_fac_V.col(m_k + j);
+
+        m_fac_G.setZero();
+        m_fac_G.topLeftCorner(k, k).noalias() = S;
+        m_fac_G.block(k, 0, m_b, k).noalias() = B;
+        m_k = k;
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_BLOCK_ARNOLDI_H
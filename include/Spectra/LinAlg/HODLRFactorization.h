@@ -0,0 +1,195 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_HODLR_FACTORIZATION_H
+#define SPECTRA_HODLR_FACTORIZATION_H
+
+#include <Eigen/Core>
+#include <Eigen/LU>   // Eigen::PartialPivLU
+#include <vector>     // std::vector
+#include <atomic>     // std::atomic
+#include <stdexcept>  // std::logic_error
+
+#include "../Util/CompInfo.h"
+#include "../Util/TypeTraits.h"
+#include "../Util/Trace.h"
+#include "HODLRMatrix.h"
+
+namespace Spectra {
+
+///
+/// \ingroup LinearAlgebra
+///
+/// Factorization of a shifted HODLR matrix \f$A-\sigma I\f$, for solving linear systems.
+///
+/// For a non-leaf node, write \f$A=D+WKW'\f$, where \f$D=\mathrm{diag}(A_{11},A_{22})\f$
+/// contains the diagonal blocks of the two children, \f$W=\mathrm{diag}(U,V)\f$, and
+/// \f$K=[0,I;I,0]\f$. By the Woodbury formula,
+/// \f[
+/// A^{-1}=D^{-1}-Y(K+W'Y)^{-1}W'D^{-1},\quad Y=D^{-1}W,
+/// \f]
+/// where \f$D^{-1}\f$ is applied recursively by the children. The factorization stores
+/// \f$Y\f$ and the LU decomposition of the small matrix \f$K+W'Y\f$ for each node, and
+/// the LU decompositions of the shifted dense blocks of the leaves. The shift only
+/// changes the leaves, and the matrix does not need to be positive definite.
+///
+/// With ranks bounded by \f$k\f$, the factorization costs \f$O(nk^2\log^2 n)\f$ and a solve
+/// costs \f$O(nk\log n)\f$. The tree is processed level by level from the leaves to the
+/// root, and the nodes on the same level are handled in parallel.
+///
+template <typename Scalar = double>
+class HODLRFactorization
+{
+private:
+    using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using RefMat = Eigen::Ref<Matrix>;
+    using LU = Eigen::PartialPivLU<Matrix>;
+    using HMatrix = HODLRMatrix<Scalar>;
+    using Node = typename HMatrix::Node;
+
+    const HMatrix* m_mat;      // the HODLR matrix
+    std::vector<Matrix> m_Y1;  // A11^{-1} * U for each non-leaf node
+    std::vector<Matrix> m_Y2;  // A22^{-1} * V for each non-leaf node
+    std::vector<LU> m_lu;      // LU of K + W'Y for non-leaf nodes, and of D - sigma * I for leaves
+    CompInfo m_info;           // status of the factorization
+
+    // Applies the Woodbury correction of a non-leaf node, Z <- Z - Y * (K + W'Y)^{-1} * W' * Z,
+    // where Z = D^{-1} * B on entry
+    void correct(const Node& node, Index id, RefMat Z) const
+    {
+        const Index k = node.U.cols();
+        if (k == 0)
+            return;
+
+        const Index s1 = m_mat->nodes()[node.left].size;
+        const Index s2 = node.size - s1;
+        Matrix T(2 * k, Z.cols());
+        T.topRows(k).noalias() = node.U.transpose() * Z.topRows(s1);
+        T.bottomRows(k).noalias() = node.V.transpose() * Z.bottomRows(s2);
+        const Matrix S = m_lu[id].solve(T);
+        Z.topRows(s1).noalias() -= m_Y1[id] * S.topRows(k);
+        Z.bottomRows(s2).noalias() -= m_Y2[id] * S.bottomRows(k);
+    }
+
+    // Solves with the sub-matrix of node id, sequentially
+    void solve_subtree(Index id, RefMat Z) const
+    {
+        const Node& node = m_mat->nodes()[id];
+        if (node.left < 0)
+        {
+            Z = m_lu[id].solve(Z);
+            return;
+        }
+
+        const Index s1 = m_mat->nodes()[node.left].size;
+        solve_subtree(node.left, Z.topRows(s1));
+        solve_subtree(node.right, Z.bottomRows(node.size - s1));
+        correct(node, id, Z);
+    }
+
+public:
+    HODLRFactorization() :
+        m_mat(nullptr), m_info(CompInfo::NotComputed)
+    {}
+
+    ///
+    /// Factorizes \f$A-\sigma I\f$. The matrix object must be kept alive
+    /// while the factorization is used.
+    ///
+    void compute(const HMatrix& mat, const Scalar& shift = Scalar(0))
+    {
+        SPECTRA_TRACE_SCOPE("HODLRFactorization::compute");
+
+        m_mat = &mat;
+        const auto& nodes = mat.nodes();
+        const Index nnode = nodes.size();
+        m_Y1.assign(nnode, Matrix());
+        m_Y2.assign(nnode, Matrix());
+        m_lu.assign(nnode, LU());
+
+        // A node only needs the factorizations of its descendants
+        const Scalar eps = TypeTraits<Scalar>::epsilon();
+        std::atomic<bool> singular(false);
+        const auto& levels = mat.levels();
+        for (auto level = levels.rbegin(); level != levels.rend(); ++level)
+        {
+            const auto& ids = *level;
+            mat.parallel_for(ids.size(), [this, &nodes, &ids, &shift, &singular, eps](Index k) {
+                const Index id = ids[k];
+                const Node& node = nodes[id];
+                if (node.left < 0)
+                {
+                    Matrix D = node.D;
+                    D.diagonal().array() -= shift;
+                    m_lu[id].compute(D);
+                    if (!(m_lu[id].rcond() > eps))
+                        singular = true;
+                    return;
+                }
+
+                const Index r = node.U.cols();
+                if (r == 0)
+                    return;
+                m_Y1[id] = node.U;
+                solve_subtree(node.left, m_Y1[id]);
+                m_Y2[id] = node.V;
+                solve_subtree(node.right, m_Y2[id]);
+
+                // K + W'Y = [U'Y1, I; I, V'Y2]
+                Matrix S(2 * r, 2 * r);
+                S.topLeftCorner(r, r).noalias() = node.U.transpose() * m_Y1[id];
+                S.bottomRightCorner(r, r).noalias() = node.V.transpose() * m_Y2[id];
+                S.topRightCorner(r, r).setIdentity();
+                S.bottomLeftCorner(r, r).setIdentity();
+                m_lu[id].compute(S);
+                if (!(m_lu[id].rcond() > eps))
+                    singular = true;
+            });
+        }
+
+        m_info = singular ? CompInfo::NumericalIssue : CompInfo::Successful;
+    }
+
+    ///
+    /// Returns the status of the factorization.
+    ///
+    CompInfo info() const { return m_info; }
+
+    ///
+    /// Solves \f$(A-\sigma I)X=B\f$ in place, where \f$B\f$ is overwritten by \f$X\f$.
+    ///
+    void solve_inplace(RefMat B) const
+    {
+        SPECTRA_TRACE_SCOPE("HODLRFactorization::solve");
+
+        if (m_info != CompInfo::Successful)
+            throw std::logic_error("HODLRFactorization: the factorization is not available");
+
+        // Leaves and corrections from the bottom level to the root, where the nodes
+        // on the same level work on disjoint rows of B
+        const auto& nodes = m_mat->nodes();
+        const auto& levels = m_mat->levels();
+        for (auto level = levels.rbegin(); level != levels.rend(); ++level)
+        {
+            const auto& ids = *level;
+            m_mat->parallel_for(ids.size(), [this, &nodes, &ids, &B](Index k) {
+                const Index id = ids[k];
+                const Node& node = nodes[id];
+                auto Z = B.middleRows(node.begin, node.size);
+                if (node.left < 0)
+                    Z = m_lu[id].solve(Z);
+                else
+                    correct(node, id, Z);
+            });
+        }
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_HODLR_FACTORIZATION_H
@@ -0,0 +1,379 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_HODLR_MATRIX_H
+#define SPECTRA_HODLR_MATRIX_H
+
+#include <Eigen/Core>
+#include <Eigen/QR>   // Eigen::HouseholderQR
+#include <Eigen/SVD>  // Eigen::JacobiSVD
+#include <vector>     // std::vector
+#include <memory>     // std::unique_ptr
+#include <future>     // std::future
+#include <cmath>      // std::abs
+#include <algorithm>  // std::max, std::min
+#include <utility>    // std::move
+#include <stdexcept>  // std::invalid_argument, std::logic_error
+
+#include "../Util/TypeTraits.h"
+#include "../Util/ThreadPool.h"
+#include "../Util/Trace.h"
+
+namespace Spectra {
+
+///
+/// \ingroup LinearAlgebra
+///
+/// Hierarchically off-diagonal low-rank (HODLR) representation of a dense symmetric matrix.
+///
+/// The index range is split recursively into two halves, until the blocks have at most
+/// `leaf_size` rows. The diagonal blocks of the leaves are stored densely, and for each
+/// non-leaf node with children \f$I_1\f$ and \f$I_2\f$, the off-diagonal block is stored
+/// as \f$A(I_1,I_2)=UV'\f$, with \f$A(I_2,I_1)=VU'\f$ by symmetry. This is efficient for
+/// data-sparse matrices such as kernel matrices of ordered points and discretized
+/// integral operators, whose off-diagonal blocks have low numerical ranks.
+///
+/// The low-rank blocks are built from an element evaluation function by the adaptive
+/// cross approximation (ACA) with partial pivoting, which only evaluates a few rows
+/// and columns of each block, followed by a recompression with truncated SVD. With
+/// ranks bounded by \f$k\f$, the storage and the matrix-vector product cost
+/// \f$O(nk\log n)\f$. The nodes on the same level of the tree cover disjoint index ranges,
+/// so they are processed in parallel on a thread pool.
+///
+/// The matrix can be used by the HODLRSymMatProd and HODLRSymShiftSolve operators.
+///
+template <typename Scalar = double>
+class HODLRMatrix
+{
+private:
+    using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+public:
+    ///
+    /// A node of the cluster tree.
+    ///
+    struct Node
+    {
+        Index begin;  // first index of the range
+        Index size;   // length of the range
+        Index left;   // index of the left child, -1 for leaves
+        Index right;  // index of the right child, -1 for leaves
+        Matrix U;     // A(left range, right range) = U * V', for non-leaf nodes
+        Matrix V;
+        Matrix D;     // dense diagonal block, for leaves
+    };
+
+private:
+    const Index m_leaf_size;                     // maximum size of the leaves
+    const Scalar m_tol;                          // relative tolerance of the low-rank blocks
+    Index m_n;                                   // dimension of the matrix
+    std::vector<Node> m_nodes;                   // nodes of the tree, root first
+    std::vector<std::vector<Index>> m_levels;    // node indices on each level, root level first
+    int m_nthread;                               // number of threads
+    mutable std::unique_ptr<ThreadPool> m_pool;  // thread pool, created on demand
+
+    // Creates the node for the range [begin, begin + size), and returns its index
+    Index build_tree(Index begin, Index size, Index level)
+    {
+        const Index id = m_nodes.size();
+        m_nodes.push_back(Node());
+        m_nodes[id].begin = begin;
+        m_nodes[id].size = size;
+        m_nodes[id].left = m_nodes[id].right = -1;
+        if (Index(m_levels.size()) <= level)
+            m_levels.resize(level + 1);
+        m_levels[level].push_back(id);
+
+        if (size > m_leaf_size)
+        {
+            const Index s1 = size / 2;
+            const Index left = build_tree(begin, s1, level + 1);
+            const Index right = build_tree(begin + s1, size - s1, level + 1);
+            m_nodes[id].left = left;
+            m_nodes[id].right = right;
+        }
+        return id;
+    }
+
+    // Adaptive cross approximation of the block A(r0:r0+m, c0:c0+p) ~= U * V'
+    template <typename Func>
+    void aca(const Func& entry, Index r0, Index m, Index c0, Index p, Matrix& U, Matrix& V) const
+    {
+        using std::abs;
+
+        // Number of consecutive zero rows tried before the block is considered exhausted
+        constexpr Index max_zero_rows = 8;
+
+        const Index kmax = (std::min)(m, p);
+        std::vector<Vector> us, vs;
+        std::vector<bool> row_used(m, false);
+        Scalar norm2 = Scalar(0);
+        Index i = 0, nzero = 0;
+        while (Index(us.size()) < kmax)
+        {
+            row_used[i] = true;
+            Vector row(p);
+            for (Index j = 0; j < p; j++)
+                row[j] = entry(r0 + i, c0 + j);
+            for (std::size_t l = 0; l < us.size(); l++)
+                row.noalias() -= us[l][i] * vs[l];
+
+            Index j;
+            const Scalar piv = row.cwiseAbs().maxCoeff(&j);
+            if (piv <= TypeTraits<Scalar>::min())
+            {
+                // The residual row is zero, so try the next unused row
+                if (++nzero >= max_zero_rows)
+                    break;
+                Index next = -1;
+                for (Index r = 1; r < m && next < 0; r++)
+                    if (!row_used[(i + r) % m])
+                        next = (i + r) % m;
+                if (next < 0)
+                    break;
+                i = next;
+                continue;
+            }
+            nzero = 0;
+
+            Vector v = row / row[j];
+            Vector u(m);
+            for (Index r = 0; r < m; r++)
+                u[r] = entry(r0 + r, c0 + j);
+            for (std::size_t l = 0; l < us.size(); l++)
+                u.noalias() -= vs[l][j] * us[l];
+
+            // Update the estimate of ||U * V'||_F^2
+            Scalar cross = Scalar(0);
+            for (std::size_t l = 0; l < us.size(); l++)
+                cross += us[l].dot(u) * vs[l].dot(v);
+            const Scalar uv2 = u.squaredNorm() * v.squaredNorm();
+            norm2 += Scalar(2) * cross + uv2;
+            us.push_back(std::move(u));
+            vs.push_back(std::move(v));
+            if (uv2 <= m_tol * m_tol * norm2)
+                break;
+
+            // The next row is the one with the largest element in the new column
+            Scalar best = Scalar(-1);
+            i = -1;
+            for (Index r = 0; r < m; r++)
+            {
+                const Scalar ur = abs(us.back()[r]);
+                if (!row_used[r] && ur > best)
+                {
+                    best = ur;
+                    i = r;
+                }
+            }
+            if (i < 0)
+                break;
+        }
+
+        const Index k = us.size();
+        U.resize(m, k);
+        V.resize(p, k);
+        for (Index l = 0; l < k; l++)
+        {
+            U.col(l).noalias() = us[l];
+            V.col(l).noalias() = vs[l];
+        }
+    }
+
+    // Recompresses U * V' to the smallest rank within the tolerance
+    void recompress(Matrix& U, Matrix& V) const
+    {
+        const Index k = U.cols();
+        if (k == 0)
+            return;
+
+        Eigen::HouseholderQR<Matrix> qru(U), qrv(V);
+        const Index ku = (std::min)(U.rows(), k), kv = (std::min)(V.rows(), k);
+        const Matrix Ru = qru.matrixQR().topRows(ku).template triangularView<Eigen::Upper>();
+        const Matrix Rv = qrv.matrixQR().topRows(kv).template triangularView<Eigen::Upper>();
+        const Matrix M = Ru * Rv.transpose();
+        Eigen::JacobiSVD<Matrix> svd(M, Eigen::ComputeThinU | Eigen::ComputeThinV);
+        const Vector& sv = svd.singularValues();
+
+        Index r = 0;
+        while (r < sv.size() && sv[r] > m_tol * sv[0])
+            r++;
+        const Matrix Qu = qru.householderQ() * Matrix::Identity(U.rows(), ku);
+        const Matrix Qv = qrv.householderQ() * Matrix::Identity(V.rows(), kv);
+        U.noalias() = Qu * (svd.matrixU().leftCols(r) * sv.head(r).asDiagonal());
+        V.noalias() = Qv * svd.matrixV().leftCols(r);
+    }
+
+public:
+    ///
+    /// Constructor to create an empty matrix.
+    ///
+    /// \param leaf_size  Maximum size of the dense diagonal blocks.
+    /// \param tol        Relative tolerance of the low-rank approximation of
+    ///                   each off-diagonal block.
+    ///
+    HODLRMatrix(Index leaf_size = 64, Scalar tol = Scalar(1e-10)) :
+        m_leaf_size(leaf_size), m_tol(tol), m_n(0),
+        m_nthread(ThreadPool::default_num_threads())
+    {
+        if (leaf_size < 1)
+            throw std::invalid_argument("HODLRMatrix: leaf_size must be positive");
+        if (tol <= Scalar(0))
+            throw std::invalid_argument("HODLRMatrix: tol must be positive");
+    }
+
+    ///
+    /// Set the number of threads used to build and apply the matrix.
+    /// If it is not positive, the number of hardware threads is used.
+    ///
+    void set_num_threads(int nthread)
+    {
+        nthread = (nthread > 0) ? nthread : ThreadPool::default_num_threads();
+        if (nthread != m_nthread)
+            m_pool.reset();
+        m_nthread = nthread;
+    }
+
+    ///
+    /// Builds the compressed representation of a symmetric matrix.
+    ///
+    /// \param n      Dimension of the matrix.
+    /// \param entry  A function object such that `entry(i, j)` returns the element \f$A_{ij}\f$.
+    ///               It is called concurrently from multiple threads.
+    ///
+    template <typename Func>
+    void compute(Index n, const Func& entry)
+    {
+        SPECTRA_TRACE_SCOPE("HODLRMatrix::compute");
+
+        if (n < 1)
+            throw std::invalid_argument("HODLRMatrix: matrix dimension must be positive");
+
+        m_n = n;
+        m_nodes.clear();
+        m_levels.clear();
+        build_tree(0, n, 0);
+
+        // The blocks of all nodes are independent
+        parallel_for(m_nodes.size(), [this, &entry](Index id) {
+            Node& node = m_nodes[id];
+            if (node.left < 0)
+            {
+                node.D.resize(node.size, node.size);
+                for (Index j = 0; j < node.size; j++)
+                    for (Index i = 0; i < node.size; i++)
+                        node.D(i, j) = entry(node.begin + i, node.begin + j);
+                const Matrix Dt = node.D.transpose();
+                node.D = Scalar(0.5) * (node.D + Dt);
+            }
+            else
+            {
+                const Node& left = m_nodes[node.left];
+                const Node& right = m_nodes[node.right];
+                aca(entry, left.begin, left.size, right.begin, right.size, node.U, node.V);
+                recompress(node.U, node.V);
+            }
+        });
+    }
+
+    ///
+    /// Calls `func(i)` for \f$i=0,\ldots,count-1\f$, in parallel if more than one thread is used.
+    ///
+    template <typename Func>
+    void parallel_for(Index count, Func&& func) const
+    {
+        if (m_nthread <= 1 || count <= 1)
+        {
+            for (Index i = 0; i < count; i++)
+                func(i);
+            return;
+        }
+
+        if (!m_pool)
+            m_pool.reset(new ThreadPool(m_nthread));
+        std::vector<std::future<void>> res;
+        res.reserve(count);
+        for (Index i = 0; i < count; i++)
+            res.push_back(m_pool->submit([&func, i]() { func(i); }));
+        // get() rethrows the exceptions of the tasks
+        for (auto& r : res)
+            r.get();
+    }
+
+    Index rows() const { return m_n; }
+    Index cols() const { return m_n; }
+
+    ///
+    /// Nodes of the cluster tree, with the root first.
+    ///
+    const std::vector<Node>& nodes() const { return m_nodes; }
+
+    ///
+    /// Indices of the nodes on each level of the tree, with the root level first.
+    ///
+    const std::vector<std::vector<Index>>& levels() const { return m_levels; }
+
+    ///
+    /// Maximum rank of the off-diagonal blocks.
+    ///
+    Index max_rank() const
+    {
+        Index k = 0;
+        for (const auto& node : m_nodes)
+            k = (std::max)(k, Index(node.U.cols()));
+        return k;
+    }
+
+    ///
+    /// Number of stored elements.
+    ///
+    Index storage_size() const
+    {
+        Index s = 0;
+        for (const auto& node : m_nodes)
+            s += node.U.size() + node.V.size() + node.D.size();
+        return s;
+    }
+
+    ///
+    /// Computes \f$Y=AX\f$ for a block of vectors \f$X\f$.
+    ///
+    void multiply(const Eigen::Ref<const Matrix>& X, Eigen::Ref<Matrix> Y) const
+    {
+        SPECTRA_TRACE_SCOPE("HODLRMatrix::multiply");
+
+        if (m_nodes.empty())
+            throw std::logic_error("HODLRMatrix: compute() must be called first");
+
+        Y.setZero();
+        // Nodes on the same level write to disjoint rows of Y
+        for (const auto& level : m_levels)
+        {
+            parallel_for(level.size(), [this, &level, &X, &Y](Index k) {
+                const Node& node = m_nodes[level[k]];
+                if (node.left < 0)
+                {
+                    Y.middleRows(node.begin, node.size).noalias() += node.D * X.middleRows(node.begin, node.size);
+                    return;
+                }
+                if (node.U.cols() == 0)
+                    return;
+                const Node& left = m_nodes[node.left];
+                const Node& right = m_nodes[node.right];
+                const Matrix tr = node.V.transpose() * X.middleRows(right.begin, right.size);
+                const Matrix tl = node.U.transpose() * X.middleRows(left.begin, left.size);
+                Y.middleRows(left.begin, left.size).noalias() += node.U * tr;
+                Y.middleRows(right.begin, right.size).noalias() += node.V * tl;
+            });
+        }
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_HODLR_MATRIX_H
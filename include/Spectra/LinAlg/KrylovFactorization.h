@@ -0,0 +1,179 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_KRYLOV_FACTORIZATION_H
+#define SPECTRA_KRYLOV_FACTORIZATION_H
+
+#include <Eigen/Core>
+#include <istream>    // std::istream
+#include <ostream>    // std::ostream
+#include <cstring>    // std::memcmp
+#include <cstdint>    // std::int64_t
+#include <vector>     // std::vector
+#include <algorithm>  // std::min
+#include <stdexcept>  // std::invalid_argument, std::runtime_error
+
+#include "../Util/SelectionRule.h"
+#include "TridiagEigen.h"
+
+namespace Spectra {
+
+///
+/// \ingroup LinearAlgebra
+///
+/// A saved Lanczos factorization \f$AV=VH+fe_k'\f$ of a symmetric operator, where
+/// \f$V\f$ is an \f$n\times k\f$ orthonormal basis of the Krylov subspace, \f$H\f$ is
+/// a \f$k\times k\f$ symmetric tridiagonal matrix, and \f$f\f$ is the residual vector.
+///
+/// It is obtained from SymEigsBase::factorization() after a computation, and can be
+/// used to
+///   - query Ritz pairs under any selection rule, without operator multiplications;
+///   - initialize another solver of the same operator with SymEigsBase::init(const KrylovFactorization&),
+///     for example with a different selection rule or `nev`, so that the computation
+///     continues from the existing Krylov information instead of starting over;
+///   - save the factorization to a stream and load it later.
+///
+template <typename Scalar = double>
+class KrylovFactorization
+{
+private:
+    using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+    Matrix m_V;  // Krylov basis, n x k
+    Matrix m_H;  // projected matrix, k x k
+    Vector m_f;  // residual vector, n x 1
+
+    static const char* magic() { return "SPECTRA-KRYLOV01"; }
+
+public:
+    ///
+    /// Constructor of an empty factorization.
+    ///
+    KrylovFactorization() {}
+
+    ///
+    /// Constructor from the matrices of the factorization.
+    ///
+    KrylovFactorization(const Matrix& V, const Matrix& H, const Vector& f) :
+        m_V(V), m_H(H), m_f(f)
+    {
+        if (H.rows() != V.cols() || H.cols() != V.cols() || f.size() != V.rows())
+            throw std::invalid_argument("KrylovFactorization: dimensions of V, H, and f do not match");
+    }
+
+    ///
+    /// Dimension of the operator, \f$n\f$.
+    ///
+    Index rows() const { return m_V.rows(); }
+
+    ///
+    /// Dimension of the Krylov subspace, \f$k\f$.
+    ///
+    Index subspace_dim() const { return m_V.cols(); }
+
+    const Matrix& matrix_V() const { return m_V; }
+    const Matrix& matrix_H() const { return m_H; }
+    const Vector& vector_f() const { return m_f; }
+
+    ///
+    /// Returns the first `nev` Ritz values under a selection rule, for example
+    /// `SortRule::SmallestAlge` for the smallest ones.
+    ///
+    Vector ritz_values(SortRule selection, Index nev) const
+    {
+        TridiagEigen<Scalar> decomp(m_H);
+        const Vector& evals = decomp.eigenvalues();
+        nev = (std::min)(nev, subspace_dim());
+        std::vector<Index> ind = argsort(selection, evals);
+        Vector res(nev);
+        for (Index i = 0; i < nev; i++)
+            res[i] = evals[ind[i]];
+        return res;
+    }
+
+    ///
+    /// Returns the Ritz vectors associated with ritz_values().
+    ///
+    Matrix ritz_vectors(SortRule selection, Index nev) const
+    {
+        TridiagEigen<Scalar> decomp(m_H);
+        const Vector& evals = decomp.eigenvalues();
+        const Matrix& evecs = decomp.eigenvectors();
+        nev = (std::min)(nev, subspace_dim());
+        std::vector<Index> ind = argsort(selection, evals);
+        Matrix Y(subspace_dim(), nev);
+        for (Index i = 0; i < nev; i++)
+            Y.col(i).noalias() = evecs.col(ind[i]);
+        return m_V * Y;
+    }
+
+    ///
+    /// Returns the residual norms \f$\|Ax-\theta x\|\f$ of the Ritz pairs associated
+    /// with ritz_values(), which are computed from the factorization as
+    /// \f$\|f\|\cdot|e_k'y|\f$ for an eigenvector \f$y\f$ of \f$H\f$.
+    ///
+    Vector ritz_residuals(SortRule selection, Index nev) const
+    {
+        using std::abs;
+
+        TridiagEigen<Scalar> decomp(m_H);
+        const Vector& evals = decomp.eigenvalues();
+        const Matrix& evecs = decomp.eigenvectors();
+        nev = (std::min)(nev, subspace_dim());
+        std::vector<Index> ind = argsort(selection, evals);
+        const Scalar fnorm = m_f.norm();
+        Vector res(nev);
+        for (Index i = 0; i < nev; i++)
+            res[i] = fnorm * abs(evecs(subspace_dim() - 1, ind[i]));
+        return res;
+    }
+
+    ///
+    /// Writes the factorization to a binary stream.
+    ///
+    void save(std::ostream& out) const
+    {
+        const std::int64_t header[3] = { std::int64_t(sizeof(Scalar)), std::int64_t(rows()),
+                                         std::int64_t(subspace_dim()) };
+        out.write(magic(), 16);
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(m_V.data()), sizeof(Scalar) * m_V.size());
+        out.write(reinterpret_cast<const char*>(m_H.data()), sizeof(Scalar) * m_H.size());
+        out.write(reinterpret_cast<const char*>(m_f.data()), sizeof(Scalar) * m_f.size());
+        if (!out)
+            throw std::runtime_error("KrylovFactorization: failed to write the factorization");
+    }
+
+    ///
+    /// Reads a factorization written by save() from a binary stream.
+    ///
+    void load(std::istream& in)
+    {
+        char tag[16];
+        std::int64_t header[3];
+        in.read(tag, 16);
+        in.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (!in || std::memcmp(tag, magic(), 16) != 0 || header[0] != std::int64_t(sizeof(Scalar)) ||
+            header[1] < 0 || header[2] < 0 || header[2] > header[1])
+            throw std::runtime_error("KrylovFactorization: invalid data");
+
+        const Index n = header[1], k = header[2];
+        m_V.resize(n, k);
+        m_H.resize(k, k);
+        m_f.resize(n);
+        in.read(reinterpret_cast<char*>(m_V.data()), sizeof(Scalar) * m_V.size());
+        in.read(reinterpret_cast<char*>(m_H.data()), sizeof(Scalar) * m_H.size());
+        in.read(reinterpret_cast<char*>(m_f.data()), sizeof(Scalar) * m_f.size());
+        if (!in)
+            throw std::runtime_error("KrylovFactorization: invalid data");
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_KRYLOV_FACTORIZATION_H
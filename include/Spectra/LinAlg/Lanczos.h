@@ -12,6 +12,7 @@
 #include <utility>    // std::forward
 #include <stdexcept>  // std::invalid_argument
 
+#include "../Util/SimpleRandom.h"
 #include "Arnoldi.h"
 
 namespace Spectra {
@@ -45,6 +46,33 @@ private:
     using Arnoldi<Scalar, ArnoldiOpType>::m_near_0;
     using Arnoldi<Scalar, ArnoldiOpType>::m_eps;
 
+    // Completes the factorization when the range of A is contained in the first i columns
+    // of V, and the (i+1)-th column has been set to a vector orthogonal to them
+    // Columns i+1 to m-1 are random vectors orthogonalized against the previous ones, and
+    // since they are in the null space of A, the corresponding parts of H and f are zero
+    void complete_null_space(Index i, Index to_m)
+    {
+        m_fac_H(i, i - 1) = m_fac_H(i - 1, i) = Scalar(0);
+
+        Vector q(m_n), Vf(to_m);
+        for (Index j = i + 1; j < to_m; j++)
+        {
+            MapConstMat Vj(m_fac_V.data(), m_n, j);  // The first j columns
+            SimpleRandom<Scalar> rng(3 * j + 1);
+            rng.random_vec(q);
+            // Two passes of classical Gram-Schmidt for numerical stability
+            for (int pass = 0; pass < 2; pass++)
+            {
+                m_op.trans_product(Vj, q, Vf.head(j));
+                q.noalias() -= Vj * Vf.head(j);
+            }
+            m_fac_V.col(j).noalias() = q / m_op.norm(q);
+        }
+
+        m_fac_f.setZero();
+        m_beta = Scalar(0);
+    }
+
 public:
     // Forward parameter `op` to the constructor of Arnoldi
     template <typename T>
@@ -58,6 +86,8 @@ public:
         using std::abs;
         using std::sqrt;
 
+        SPECTRA_TRACE_SCOPE("Lanczos::factorize_from");
+
         if (to_m <= from_k)
             return;
 
@@ -110,8 +140,21 @@ public:
             if (restart)
             {
                 MapConstMat V(m_fac_V.data(), m_n, i);  // The first i columns
-                this->expand_basis(V, 2 * i, m_fac_f, m_beta, op_counter);
+                // The largest element of H is a lower bound of ||A||
+                const Scalar op_norm = m_fac_H.topLeftCorner(i, i).cwiseAbs().maxCoeff();
+                const bool range_in_V = this->expand_basis(V, 2 * i, m_fac_f, m_beta, op_counter, op_norm);
                 v.noalias() = m_fac_f / m_beta;
+
+                // The range of A is contained in span(V), for example when the rank of A
+                // is less than m. Then for any v orthogonal to V, V'B(Av) = (AV)'Bv = 0,
+                // so Av = 0, and the remaining part of the factorization is known without
+                // further operations on A. expand_basis() has verified Av = 0 on the
+                // random vector v
+                if (range_in_V)
+                {
+                    complete_null_space(i, to_m);
+                    break;
+                }
             }
 
             // Whether there is a restart or not, right now the (i+1)-th column of V
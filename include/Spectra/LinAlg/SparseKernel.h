@@ -0,0 +1,485 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_SPARSE_KERNEL_H
+#define SPECTRA_SPARSE_KERNEL_H
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <vector>     // std::vector
+#include <deque>      // std::deque
+#include <memory>     // std::unique_ptr
+#include <future>     // std::future
+#include <algorithm>  // std::sort, std::stable_sort, std::max, std::reverse
+#include <string>     // std::string
+#include <stdexcept>  // std::invalid_argument
+
+#include "../Util/ThreadPool.h"
+
+namespace Spectra {
+
+///
+/// \ingroup Enumerations
+///
+/// The storage formats of the sparse matrix-vector multiplication kernels.
+///
+enum class SparseFormat
+{
+    CSR,        ///< Compressed sparse rows.
+    Pattern,    ///< Compressed sparse rows without the values, for matrices whose
+                ///< nonzero elements are all equal, such as adjacency matrices.
+    SELL,       ///< Sliced ELLPACK with sorting, SELL-C-\f$\sigma\f$, where chunks of
+                ///< \f$C\f$ rows of similar lengths are stored column by column.
+    Reordered,  ///< Compressed sparse rows after a reverse Cuthill-McKee permutation,
+                ///< which improves the locality of the accesses to \f$x\f$. Square matrices only.
+};
+
+///
+/// \ingroup Internals
+///
+/// Name of a sparse format, as used in the autotuning cache files.
+///
+inline std::string sparse_format_name(SparseFormat format)
+{
+    switch (format)
+    {
+        case SparseFormat::CSR:
+            return "CSR";
+        case SparseFormat::Pattern:
+            return "Pattern";
+        case SparseFormat::SELL:
+            return "SELL";
+        case SparseFormat::Reordered:
+            return "Reordered";
+    }
+    return "";
+}
+
+///
+/// \ingroup LinearAlgebra
+///
+/// A sparse matrix-vector multiplication kernel, \f$y=Ax\f$, in one of the formats
+/// of SparseFormat and with a given number of threads.
+///
+/// The matrix is copied into the chosen format. With more than one thread, the rows
+/// (or the chunks of rows for SELL) are split into contiguous ranges with balanced
+/// numbers of nonzero elements, and each range is processed by one task.
+///
+/// This class is used by SparseAutoMatProd, which chooses the fastest kernel for a
+/// matrix by timing the candidates.
+///
+template <typename Scalar = double>
+class SparseKernel
+{
+private:
+    using Index = Eigen::Index;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using RowMatrix = Eigen::SparseMatrix<Scalar, Eigen::RowMajor, int>;
+
+    // Number of rows in a SELL chunk, and the sorting window in chunks
+    static constexpr int SellChunk = 8;
+    static constexpr int SellWindow = 32;
+
+    SparseFormat m_format;                       // storage format
+    Index m_rows;                                // number of rows
+    Index m_cols;                                // number of columns
+    Index m_nnz;                                 // number of stored elements
+    std::vector<int> m_ptr;                      // CSR row pointers, or SELL chunk offsets
+    std::vector<int> m_ind;                      // column indices
+    std::vector<Scalar> m_val;                   // values, empty for Pattern
+    Scalar m_pattern_val;                        // common value of the elements for Pattern
+    std::vector<int> m_perm;                     // Reordered: new to old index; SELL: rows of the sorted order
+    std::vector<int> m_width;                    // SELL: width of each chunk
+    std::vector<int> m_len;                      // SELL: length of each row in the sorted order
+    std::vector<Index> m_part;                   // boundaries of the thread ranges
+    mutable Vector m_xp;                         // Reordered: permuted x
+    mutable Vector m_yp;                         // Reordered: permuted y
+    int m_nthread;                               // number of threads
+    mutable std::unique_ptr<ThreadPool> m_pool;  // thread pool, created on demand
+
+    // Splits count items into m_nthread ranges with roughly equal total cost,
+    // where cost(i) is the accumulated cost of the first i items
+    template <typename Cost>
+    void partition(Index count, Cost&& cost)
+    {
+        const Index nparts = std::max(Index(1), std::min(Index(m_nthread), count));
+        m_part.assign(1, 0);
+        const double total = double(cost(count));
+        Index i = 0;
+        for (Index k = 1; k < nparts; k++)
+        {
+            const double target = total * k / nparts;
+            while (i < count && double(cost(i)) < target)
+                i++;
+            if (i > m_part.back())
+                m_part.push_back(i);
+        }
+        m_part.push_back(count);
+    }
+
+    template <typename Func>
+    void parallel_for(Index count, Func&& func) const
+    {
+        if (count <= 1)
+        {
+            for (Index i = 0; i < count; i++)
+                func(i);
+            return;
+        }
+
+        if (!m_pool)
+            m_pool.reset(new ThreadPool(m_nthread));
+        std::vector<std::future<void>> res;
+        res.reserve(count);
+        for (Index i = 0; i < count; i++)
+            res.push_back(m_pool->submit([&func, i]() { func(i); }));
+        for (auto& r : res)
+            r.get();
+    }
+
+    // Reverse Cuthill-McKee ordering of the symmetrized pattern of a square matrix
+    static std::vector<int> rcm_order(const RowMatrix& mat)
+    {
+        const Index n = mat.rows();
+        const RowMatrix matt = mat.transpose();
+        std::vector<std::vector<int>> adj(n);
+        for (Index i = 0; i < n; i++)
+        {
+            for (typename RowMatrix::InnerIterator it(mat, i); it; ++it)
+                if (it.index() != i)
+                    adj[i].push_back(int(it.index()));
+            for (typename RowMatrix::InnerIterator it(matt, i); it; ++it)
+                if (it.index() != i)
+                    adj[i].push_back(int(it.index()));
+            std::sort(adj[i].begin(), adj[i].end());
+            adj[i].erase(std::unique(adj[i].begin(), adj[i].end()), adj[i].end());
+        }
+        auto degree = [&adj](int i) { return adj[i].size(); };
+
+        std::vector<int> order;
+        order.reserve(n);
+        std::vector<int> level(n, -1);
+        std::vector<char> visited(n, 0);
+
+        // Breadth-first search from root within an unvisited component, returns the last
+        // level reached and optionally appends the Cuthill-McKee order
+        auto bfs = [&](int root, std::vector<int>* out, int& last) {
+            std::vector<int> touched;
+            std::deque<int> queue(1, root);
+            level[root] = 0;
+            touched.push_back(root);
+            int height = 0;
+            last = root;
+            std::vector<int> nbr;
+            while (!queue.empty())
+            {
+                const int v = queue.front();
+                queue.pop_front();
+                if (out)
+                    out->push_back(v);
+                // Among the nodes of the last level, keep the one with the smallest degree
+                if (level[v] > height || (level[v] == height && degree(v) < degree(last)))
+                {
+                    height = level[v];
+                    last = v;
+                }
+                nbr.clear();
+                for (int w : adj[v])
+                    if (level[w] < 0 && !visited[w])
+                        nbr.push_back(w);
+                std::stable_sort(nbr.begin(), nbr.end(), [&degree](int a, int b) { return degree(a) < degree(b); });
+                for (int w : nbr)
+                {
+                    level[w] = level[v] + 1;
+                    touched.push_back(w);
+                    queue.push_back(w);
+                }
+            }
+            if (out)
+            {
+                for (int w : touched)
+                    visited[w] = 1;
+            }
+            for (int w : touched)
+                level[w] = -1;
+            return height;
+        };
+
+        std::vector<int> by_degree(n);
+        for (Index i = 0; i < n; i++)
+            by_degree[i] = int(i);
+        std::stable_sort(by_degree.begin(), by_degree.end(), [&degree](int a, int b) { return degree(a) < degree(b); });
+        for (int start : by_degree)
+        {
+            if (visited[start])
+                continue;
+            // Pseudo-peripheral root: move to the far end while the eccentricity grows
+            int root = start, last;
+            int height = bfs(root, nullptr, last);
+            for (int iter = 0; iter < 5 && last != root; iter++)
+            {
+                int next_last;
+                const int next_height = bfs(last, nullptr, next_last);
+                if (next_height <= height)
+                    break;
+                root = last;
+                height = next_height;
+                last = next_last;
+            }
+            bfs(root, &order, last);
+        }
+
+        std::reverse(order.begin(), order.end());
+        return order;
+    }
+
+    void build_csr(const RowMatrix& mat, bool values)
+    {
+        const Index n = mat.rows();
+        m_ptr.assign(mat.outerIndexPtr(), mat.outerIndexPtr() + n + 1);
+        m_ind.assign(mat.innerIndexPtr(), mat.innerIndexPtr() + m_nnz);
+        if (values)
+            m_val.assign(mat.valuePtr(), mat.valuePtr() + m_nnz);
+        const int* ptr = m_ptr.data();
+        partition(n, [ptr](Index i) { return ptr[i]; });
+    }
+
+    void build_sell(const RowMatrix& mat)
+    {
+        const Index n = mat.rows();
+        const int* outer = mat.outerIndexPtr();
+        auto row_len = [outer](int i) { return outer[i + 1] - outer[i]; };
+
+        // Sort the rows by decreasing length within each window
+        m_perm.resize(n);
+        for (Index i = 0; i < n; i++)
+            m_perm[i] = int(i);
+        const Index window = Index(SellChunk) * SellWindow;
+        for (Index begin = 0; begin < n; begin += window)
+        {
+            const Index end = std::min(n, begin + window);
+            std::stable_sort(m_perm.begin() + begin, m_perm.begin() + end,
+                             [&row_len](int a, int b) { return row_len(a) > row_len(b); });
+        }
+
+        // Chunks are stored column by column and padded to the longest row, and the
+        // padding is skipped in the product, so Inf or NaN in x does not leak into rows
+        // that do not reference it
+        m_len.resize(n);
+        for (Index r = 0; r < n; r++)
+            m_len[r] = row_len(m_perm[r]);
+        const Index nchunk = (n + SellChunk - 1) / SellChunk;
+        m_width.assign(nchunk, 0);
+        m_ptr.assign(nchunk + 1, 0);
+        for (Index c = 0; c < nchunk; c++)
+        {
+            int w = 0;
+            for (Index r = c * SellChunk; r < std::min(n, (c + 1) * SellChunk); r++)
+                w = std::max(w, m_len[r]);
+            m_width[c] = w;
+            m_ptr[c + 1] = m_ptr[c] + w * SellChunk;
+        }
+        m_ind.assign(m_ptr[nchunk], 0);
+        m_val.assign(m_ptr[nchunk], Scalar(0));
+        for (Index c = 0; c < nchunk; c++)
+        {
+            for (Index r = c * SellChunk; r < std::min(n, (c + 1) * SellChunk); r++)
+            {
+                const int row = m_perm[r];
+                const Index offset = m_ptr[c] + (r - c * SellChunk);
+                for (int k = outer[row], j = 0; k < outer[row + 1]; k++, j++)
+                {
+                    m_ind[offset + j * SellChunk] = mat.innerIndexPtr()[k];
+                    m_val[offset + j * SellChunk] = mat.valuePtr()[k];
+                }
+            }
+        }
+        const int* ptr = m_ptr.data();
+        partition(nchunk, [ptr](Index c) { return ptr[c]; });
+    }
+
+    // y[rows in range] = A * x for the CSR ranges, with the values or the common value
+    void csr_range(Index begin, Index end, const Scalar* x, Scalar* y) const
+    {
+        const int* ptr = m_ptr.data();
+        const int* ind = m_ind.data();
+        if (m_val.empty())
+        {
+            for (Index i = begin; i < end; i++)
+            {
+                Scalar s(0);
+                for (int k = ptr[i]; k < ptr[i + 1]; k++)
+                    s += x[ind[k]];
+                y[i] = m_pattern_val * s;
+            }
+        }
+        else
+        {
+            const Scalar* val = m_val.data();
+            for (Index i = begin; i < end; i++)
+            {
+                Scalar s(0);
+                for (int k = ptr[i]; k < ptr[i + 1]; k++)
+                    s += val[k] * x[ind[k]];
+                y[i] = s;
+            }
+        }
+    }
+
+    void sell_range(Index begin, Index end, const Scalar* x, Scalar* y) const
+    {
+        const int* ind = m_ind.data();
+        const Scalar* val = m_val.data();
+        const Index n = m_rows;
+        for (Index c = begin; c < end; c++)
+        {
+            Scalar s[SellChunk] = {};
+            const Index offset = m_ptr[c];
+            const Index r0 = c * SellChunk;
+            const int nr = int(std::min(Index(SellChunk), n - r0));
+            // Rows in a chunk have decreasing lengths, so the rows that still have
+            // elements in column j are the first nact ones
+            const int* len = m_len.data() + r0;
+            int nact = nr;
+            for (int j = 0; j < m_width[c]; j++)
+            {
+                while (len[nact - 1] <= j)
+                    nact--;
+                const Index base = offset + Index(j) * SellChunk;
+                for (int r = 0; r < nact; r++)
+                    s[r] += val[base + r] * x[ind[base + r]];
+            }
+            for (int r = 0; r < nr; r++)
+                y[m_perm[r0 + r]] = s[r];
+        }
+    }
+
+public:
+    SparseKernel() :
+        m_format(SparseFormat::CSR), m_rows(0), m_cols(0), m_nnz(0), m_pattern_val(0), m_nthread(1)
+    {}
+
+    SparseKernel(SparseKernel&&) = default;
+    SparseKernel& operator=(SparseKernel&&) = default;
+
+    ///
+    /// Returns whether all stored elements of the matrix are equal, so that
+    /// the SparseFormat::Pattern format can be used.
+    ///
+    template <int Flags, typename StorageIndex>
+    static bool is_pattern(const Eigen::SparseMatrix<Scalar, Flags, StorageIndex>& mat)
+    {
+        const Index nnz = mat.nonZeros();
+        if (nnz == 0 || !mat.isCompressed())
+            return false;
+        const Scalar* val = mat.valuePtr();
+        for (Index k = 1; k < nnz; k++)
+            if (val[k] != val[0])
+                return false;
+        return true;
+    }
+
+    ///
+    /// Copies the matrix into the given format.
+    ///
+    /// \param mat     The matrix in compressed row-major storage.
+    /// \param format  The storage format.
+    /// \param nthread Number of threads. If it is not positive, the number of
+    ///                hardware threads is used.
+    ///
+    void compute(const RowMatrix& mat, SparseFormat format, int nthread = 1)
+    {
+        if (!mat.isCompressed())
+            throw std::invalid_argument("SparseKernel: the matrix must be in compressed storage");
+        if (format == SparseFormat::Pattern && !is_pattern(mat))
+            throw std::invalid_argument("SparseKernel: the Pattern format requires all stored elements to be equal");
+        if (format == SparseFormat::Reordered && mat.rows() != mat.cols())
+            throw std::invalid_argument("SparseKernel: the Reordered format requires a square matrix");
+
+        m_format = format;
+        m_rows = mat.rows();
+        m_cols = mat.cols();
+        m_nnz = mat.nonZeros();
+        m_nthread = (nthread > 0) ? nthread : ThreadPool::default_num_threads();
+        m_pool.reset();
+        m_val.clear();
+        m_perm.clear();
+        m_width.clear();
+        m_len.clear();
+
+        switch (format)
+        {
+            case SparseFormat::CSR:
+                build_csr(mat, true);
+                break;
+            case SparseFormat::Pattern:
+                m_pattern_val = mat.valuePtr()[0];
+                build_csr(mat, false);
+                break;
+            case SparseFormat::SELL:
+                build_sell(mat);
+                break;
+            case SparseFormat::Reordered:
+            {
+                m_perm = rcm_order(mat);
+                Eigen::Matrix<int, Eigen::Dynamic, 1> inv(m_rows);
+                for (Index i = 0; i < m_rows; i++)
+                    inv[m_perm[i]] = int(i);
+                Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> P(inv);
+                RowMatrix B = P * mat * P.transpose();
+                B.makeCompressed();
+                build_csr(B, true);
+                m_xp.resize(m_cols);
+                m_yp.resize(m_rows);
+                break;
+            }
+        }
+    }
+
+    Index rows() const { return m_rows; }
+    Index cols() const { return m_cols; }
+
+    ///
+    /// Storage format of the kernel.
+    ///
+    SparseFormat format() const { return m_format; }
+
+    ///
+    /// Number of threads used by the kernel.
+    ///
+    int num_threads() const { return m_nthread; }
+
+    ///
+    /// Computes \f$y=Ax\f$.
+    ///
+    void multiply(const Scalar* x, Scalar* y) const
+    {
+        const Index nparts = Index(m_part.size()) - 1;
+        if (m_format == SparseFormat::SELL)
+        {
+            parallel_for(nparts, [this, x, y](Index p) { sell_range(m_part[p], m_part[p + 1], x, y); });
+            return;
+        }
+        if (m_format != SparseFormat::Reordered)
+        {
+            parallel_for(nparts, [this, x, y](Index p) { csr_range(m_part[p], m_part[p + 1], x, y); });
+            return;
+        }
+
+        // Reordered: y = P' * B * P * x
+        for (Index i = 0; i < m_cols; i++)
+            m_xp[i] = x[m_perm[i]];
+        const Scalar* xp = m_xp.data();
+        Scalar* yp = m_yp.data();
+        parallel_for(nparts, [this, xp, yp](Index p) { csr_range(m_part[p], m_part[p + 1], xp, yp); });
+        for (Index i = 0; i < m_rows; i++)
+            y[m_perm[i]] = m_yp[i];
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_SPARSE_KERNEL_H
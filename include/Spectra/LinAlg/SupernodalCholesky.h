@@ -0,0 +1,796 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_SUPERNODAL_CHOLESKY_H
+#define SPECTRA_SUPERNODAL_CHOLESKY_H
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/OrderingMethods>
+#include <Eigen/Cholesky>
+#include <vector>              // std::vector
+#include <algorithm>           // std::lower_bound, std::sort
+#include <functional>          // std::function
+#include <atomic>              // std::atomic
+#include <memory>              // std::unique_ptr
+#include <mutex>               // std::mutex, std::unique_lock
+#include <condition_variable>  // std::condition_variable
+#include <stdexcept>           // std::invalid_argument, std::logic_error, std::runtime_error
+
+#include "../Util/CompInfo.h"
+#include "../Util/FacTraits.h"
+#include "../Util/ThreadPool.h"
+#include "../Util/Trace.h"
+
+namespace Spectra {
+
+///
+/// \ingroup LinearAlgebra
+///
+/// Supernodal multifrontal Cholesky decomposition of a sparse symmetric positive
+/// definite matrix, \f$PAP'=LL'\f$, where \f$P\f$ is a fill-reducing permutation.
+///
+/// The symbolic analysis computes an AMD ordering, the elimination tree, and the
+/// column counts of \f$L\f$, and groups columns with (nearly) identical structure
+/// into supernodes, allowing a small number of explicit zeros to obtain larger
+/// supernodes. The numeric factorization processes the supernodes on a frontal
+/// matrix each, using dense blocked Cholesky, triangular solve, and symmetric
+/// rank-k update kernels. Independent subtrees of the assembly tree are
+/// factorized in parallel on a thread pool, and small subtrees are processed as
+/// a single task to limit the scheduling overhead. Triangular solves work
+/// supernode by supernode, so that solving with multiple right hand sides uses
+/// matrix-matrix products.
+///
+/// This class follows the interface of the **Eigen** sparse solvers, and can be
+/// used as the factorization backend of SparseCholesky and SparseSymShiftSolve
+/// (for positive definite shifted matrices). The symbolic analysis is reused as
+/// long as the sparsity pattern of the matrix does not change.
+///
+/// \tparam Scalar_      The element type of the matrix.
+/// \tparam Uplo         Either `Eigen::Lower` or `Eigen::Upper`, indicating which
+///                      triangular part of the matrix is used.
+/// \tparam StorageIndex The type of the indices for the sparse matrix.
+///
+template <typename Scalar_ = double, int Uplo = Eigen::Lower, typename StorageIndex = int>
+class SupernodalCholesky
+{
+public:
+    using Scalar = Scalar_;
+
+private:
+    using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using MapMat = Eigen::Map<Matrix>;
+    using MapConstMat = Eigen::Map<const Matrix>;
+    using SparseMatrix = Eigen::SparseMatrix<Scalar, Eigen::ColMajor, StorageIndex>;
+    using Permutation = Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, StorageIndex>;
+    using IndexArray = std::vector<Index>;
+
+    Index m_n;
+    Permutation m_perm;     // P, such that P * A * P' = L * L'
+    Permutation m_perminv;  // P'
+
+    // Supernode partition and assembly tree
+    IndexArray m_super;     // columns of supernode s are [m_super[s], m_super[s + 1])
+    IndexArray m_sparent;   // parent of supernode s in the assembly tree, -1 for roots
+    IndexArray m_childptr;  // children of supernode s are m_child[m_childptr[s] : m_childptr[s + 1]]
+    IndexArray m_child;
+    IndexArray m_rowptr;    // row structure of supernode s is m_rows[m_rowptr[s] : m_rowptr[s + 1]]
+    IndexArray m_rows;      // sorted, and begins with the columns of the supernode
+    IndexArray m_valptr;    // panel of supernode s starts at m_values[m_valptr[s]]
+    IndexArray m_subsize;   // number of supernodes in the subtree rooted at s
+    std::vector<double> m_subwork;  // estimated flops of the subtree rooted at s
+
+    // Numeric factorization
+    SparseMatrix m_ap;                // lower triangular part of P * A * P'
+    Vector m_values;                  // column-major panels [L11; L21] of the supernodes
+    std::vector<Matrix> m_update;     // update matrices passed to the parents
+    std::atomic<bool> m_failed;       // the matrix is not positive definite
+    std::atomic<bool> m_pattern_err;  // entries outside of the analyzed pattern
+
+    int m_nthread;
+    std::unique_ptr<ThreadPool> m_pool;
+
+    bool m_analyzed;
+    bool m_factorized;
+    CompInfo m_info;
+
+    Index num_supernodes() const { return Index(m_super.size()) - 1; }
+
+    // Elimination tree of the matrix whose upper triangular part is stored in apu
+    static void elimination_tree(const SparseMatrix& apu, IndexArray& parent)
+    {
+        const Index n = apu.cols();
+        IndexArray ancestor(n, -1);
+        parent.assign(n, -1);
+        for (Index k = 0; k < n; k++)
+        {
+            for (typename SparseMatrix::InnerIterator it(apu, k); it; ++it)
+            {
+                Index i = it.index();
+                // Follow the path from i to the root of its current subtree,
+                // compressing the path to k
+                while (i != -1 && i < k)
+                {
+                    const Index inext = ancestor[i];
+                    ancestor[i] = k;
+                    if (inext == -1)
+                        parent[i] = k;
+                    i = inext;
+                }
+            }
+        }
+    }
+
+    // Postorder of a forest, children being visited in increasing order
+    static void postorder(const IndexArray& parent, IndexArray& post)
+    {
+        const Index n = Index(parent.size());
+        IndexArray head(n, -1), next(n, -1), stack;
+        for (Index j = n - 1; j >= 0; j--)
+        {
+            if (parent[j] != -1)
+            {
+                next[j] = head[parent[j]];
+                head[parent[j]] = j;
+            }
+        }
+        post.clear();
+        post.reserve(n);
+        stack.reserve(n);
+        for (Index j = 0; j < n; j++)
+        {
+            if (parent[j] != -1)
+                continue;
+            stack.push_back(j);
+            while (!stack.empty())
+            {
+                const Index p = stack.back();
+                const Index c = head[p];
+                if (c == -1)
+                {
+                    stack.pop_back();
+                    post.push_back(p);
+                }
+                else
+                {
+                    head[p] = next[c];
+                    stack.push_back(c);
+                }
+            }
+        }
+    }
+
+    // Lower triangular part of P * A * P'
+    template <typename Derived>
+    void permute_matrix(const Eigen::SparseMatrixBase<Derived>& mat, SparseMatrix& ap) const
+    {
+        ap.resize(m_n, m_n);
+        ap.template selfadjointView<Eigen::Lower>() = mat.derived().template selfadjointView<Uplo>().twistedBy(m_perm);
+    }
+
+    // Relaxed amalgamation rule: merge two supernodes into one with w columns
+    // if the fraction of explicit zeros in the merged panel is small enough
+    static bool accept_merge(Index w, double zfrac)
+    {
+        return (w <= 4) || (w <= 16 && zfrac < 0.8) || (w <= 48 && zfrac < 0.1) || (zfrac < 0.05);
+    }
+
+    void symbolic(const IndexArray& parent, const SparseMatrix& apu)
+    {
+        const Index n = m_n;
+
+        // Column counts of L, computed from the row subtrees
+        IndexArray colcount(n, 1), mark(n, -1), nchild(n, 0);
+        for (Index k = 0; k < n; k++)
+        {
+            mark[k] = k;
+            for (typename SparseMatrix::InnerIterator it(apu, k); it; ++it)
+            {
+                for (Index j = it.index(); j < k && mark[j] != k; j = parent[j])
+                {
+                    colcount[j]++;
+                    mark[j] = k;
+                }
+            }
+            if (parent[k] != -1)
+                nchild[parent[k]]++;
+        }
+
+        // Fundamental supernodes: j joins the supernode of j - 1 if j is the
+        // only child of j - 1 and the structures of the two columns agree
+        IndexArray fund(1, 0);
+        for (Index j = 1; j < n; j++)
+        {
+            if (!(parent[j - 1] == j && nchild[j] == 1 && colcount[j - 1] == colcount[j] + 1))
+                fund.push_back(j);
+        }
+        fund.push_back(n);
+        const Index nfund = Index(fund.size()) - 1;
+
+        // Relaxed amalgamation, merging a supernode with its parent if the parent
+        // is the next supernode, i.e., the columns are contiguous
+        // The merged groups are represented by their first fundamental supernodes
+        IndexArray gw(nfund), grows(nfund);
+        std::vector<double> gnnz(nfund);
+        std::vector<bool> keep(nfund, true);
+        for (Index s = nfund - 1; s >= 0; s--)
+        {
+            const Index first = fund[s], last = fund[s + 1] - 1;
+            const Index w = last - first + 1;
+            double nnz = 0;
+            for (Index j = first; j <= last; j++)
+                nnz += double(colcount[j]);
+            gw[s] = w;
+            grows[s] = colcount[first];
+            gnnz[s] = nnz;
+
+            if (s < nfund - 1 && parent[last] == last + 1)
+            {
+                const Index mw = w + gw[s + 1];
+                const Index mrows = w + grows[s + 1];
+                const double total = double(mw) * double(mrows) - 0.5 * double(mw) * double(mw - 1);
+                const double zfrac = (total - nnz - gnnz[s + 1]) / total;
+                if (accept_merge(mw, zfrac))
+                {
+                    keep[s + 1] = false;
+                    gw[s] = mw;
+                    grows[s] = mrows;
+                    gnnz[s] = nnz + gnnz[s + 1];
+                }
+            }
+        }
+        m_super.clear();
+        for (Index s = 0; s < nfund; s++)
+        {
+            if (keep[s])
+                m_super.push_back(fund[s]);
+        }
+        m_super.push_back(n);
+        const Index ns = num_supernodes();
+
+        // Assembly tree
+        IndexArray snode(n);
+        for (Index s = 0; s < ns; s++)
+            for (Index j = m_super[s]; j < m_super[s + 1]; j++)
+                snode[j] = s;
+        m_sparent.assign(ns, -1);
+        m_childptr.assign(ns + 1, 0);
+        for (Index s = 0; s < ns; s++)
+        {
+            const Index p = parent[m_super[s + 1] - 1];
+            if (p != -1)
+            {
+                m_sparent[s] = snode[p];
+                m_childptr[snode[p] + 1]++;
+            }
+        }
+        for (Index s = 0; s < ns; s++)
+            m_childptr[s + 1] += m_childptr[s];
+        m_child.assign(m_childptr[ns], 0);
+        IndexArray pos(m_childptr.begin(), m_childptr.end() - 1);
+        for (Index s = 0; s < ns; s++)
+        {
+            if (m_sparent[s] != -1)
+                m_child[pos[m_sparent[s]]++] = s;
+        }
+
+        // Row structures, computed bottom-up
+        // struct(s) = columns of s + entries of A below s + struct(children) below s
+        mark.assign(n, -1);
+        m_rowptr.assign(1, 0);
+        m_rows.clear();
+        m_valptr.assign(1, 0);
+        IndexArray below;
+        for (Index s = 0; s < ns; s++)
+        {
+            const Index first = m_super[s], last = m_super[s + 1] - 1;
+            below.clear();
+            for (Index j = first; j <= last; j++)
+            {
+                // Column j of P * A * P', upper part, is row j of the lower part
+                // Here we use the lower part of the column, stored in m_ap
+                for (typename SparseMatrix::InnerIterator it(m_ap, j); it; ++it)
+                {
+                    const Index i = it.index();
+                    if (i > last && mark[i] != s)
+                    {
+                        mark[i] = s;
+                        below.push_back(i);
+                    }
+                }
+            }
+            for (Index k = m_childptr[s]; k < m_childptr[s + 1]; k++)
+            {
+                const Index c = m_child[k];
+                for (Index r = m_rowptr[c]; r < m_rowptr[c + 1]; r++)
+                {
+                    const Index i = m_rows[r];
+                    if (i > last && mark[i] != s)
+                    {
+                        mark[i] = s;
+                        below.push_back(i);
+                    }
+                }
+            }
+            std::sort(below.begin(), below.end());
+            for (Index j = first; j <= last; j++)
+                m_rows.push_back(j);
+            m_rows.insert(m_rows.end(), below.begin(), below.end());
+            m_rowptr.push_back(Index(m_rows.size()));
+
+            const Index w = last - first + 1;
+            const Index nrow = w + Index(below.size());
+            m_valptr.push_back(m_valptr[s] + nrow * w);
+        }
+
+        // Subtree sizes and work estimates, used by the parallel scheduler
+        m_subsize.assign(ns, 1);
+        m_subwork.assign(ns, 0.0);
+        for (Index s = 0; s < ns; s++)
+        {
+            const double w = double(m_super[s + 1] - m_super[s]);
+            const double nrow = double(m_rowptr[s + 1] - m_rowptr[s]);
+            m_subwork[s] += w * nrow * nrow + 1.0;
+            if (m_sparent[s] != -1)
+            {
+                m_subsize[m_sparent[s]] += m_subsize[s];
+                m_subwork[m_sparent[s]] += m_subwork[s];
+            }
+        }
+    }
+
+    // Assemble, factorize, and compute the update matrix of supernode s
+    // All children of s must have been processed
+    void factorize_supernode(Index s)
+    {
+        const Index first = m_super[s];
+        const Index w = m_super[s + 1] - first;
+        const Index nrow = m_rowptr[s + 1] - m_rowptr[s];
+        const Index nbelow = nrow - w;
+        const Index* rows = &m_rows[m_rowptr[s]];
+
+        MapMat L(&m_values[m_valptr[s]], nrow, w);
+        Matrix& U = m_update[s];
+        U.setZero(nbelow, nbelow);
+
+        // Assemble the columns of P * A * P'
+        for (Index j = 0; j < w; j++)
+        {
+            for (typename SparseMatrix::InnerIterator it(m_ap, first + j); it; ++it)
+            {
+                const Index i = it.index();
+                Index pos = i - first;
+                if (pos >= w)
+                {
+                    pos = Index(std::lower_bound(rows + w, rows + nrow, i) - rows);
+                    if (pos == nrow || rows[pos] != i)
+                    {
+                        m_pattern_err = true;
+                        continue;
+                    }
+                }
+                L(pos, j) += it.value();
+            }
+        }
+
+        // Extend-add the update matrices of the children
+        IndexArray relpos;
+        for (Index k = m_childptr[s]; k < m_childptr[s + 1]; k++)
+        {
+            const Index c = m_child[k];
+            const Index cw = m_super[c + 1] - m_super[c];
+            const Index* crows = &m_rows[m_rowptr[c] + cw];
+            const Index cbelow = m_rowptr[c + 1] - m_rowptr[c] - cw;
+            // Both row lists are sorted, and crows is a subset of rows
+            relpos.resize(cbelow);
+            for (Index a = 0, r = 0; a < cbelow; a++)
+            {
+                while (rows[r] != crows[a])
+                    r++;
+                relpos[a] = r;
+            }
+            const Matrix& Uc = m_update[c];
+            for (Index a = 0; a < cbelow; a++)
+            {
+                const Index pa = relpos[a];
+                if (pa < w)
+                {
+                    for (Index b = a; b < cbelow; b++)
+                        L(relpos[b], pa) += Uc(b, a);
+                }
+                else
+                {
+                    for (Index b = a; b < cbelow; b++)
+                        U(relpos[b] - w, pa - w) += Uc(b, a);
+                }
+            }
+            m_update[c].resize(0, 0);
+        }
+
+        // Dense partial factorization of the frontal matrix
+        // L11 * L11' = F11
+        Eigen::Ref<Matrix> L11 = L.topRows(w);
+        Eigen::LLT<Eigen::Ref<Matrix>, Eigen::Lower> llt(L11);
+        if (llt.info() != Eigen::Success)
+        {
+            m_failed = true;
+            return;
+        }
+        L11.template triangularView<Eigen::StrictlyUpper>().setZero();
+        if (nbelow > 0)
+        {
+            // L21 = F21 * inv(L11')
+            auto L21 = L.bottomRows(nbelow);
+            L11.template triangularView<Eigen::Lower>().transpose().template solveInPlace<Eigen::OnTheRight>(L21);
+            // U = F22 - L21 * L21'
+            U.template selfadjointView<Eigen::Lower>().rankUpdate(L21, Scalar(-1));
+        }
+    }
+
+    // Process the subtree rooted at s, whose supernodes are [s - size + 1, s] in postorder
+    void factorize_subtree(Index s)
+    {
+        for (Index t = s - m_subsize[s] + 1; t <= s; t++)
+            factorize_supernode(t);
+    }
+
+    void factorize_parallel()
+    {
+        const Index ns = num_supernodes();
+        double total = 0.0;
+        Index nroots = 0;
+        for (Index s = 0; s < ns; s++)
+        {
+            if (m_sparent[s] == -1)
+            {
+                total += m_subwork[s];
+                nroots++;
+            }
+        }
+        // Subtrees with less work than the cutoff are processed as one task
+        const double cutoff = total / (4.0 * m_nthread);
+
+        std::unique_ptr<std::atomic<Index>[]> pending(new std::atomic<Index>[ns]);
+        for (Index s = 0; s < ns; s++)
+            pending[s] = m_childptr[s + 1] - m_childptr[s];
+
+        std::mutex mutex;
+        std::condition_variable cond;
+        Index roots_done = 0;
+
+        // Called by the task that finishes supernode s
+        std::function<void(Index)> run;
+        auto finish = [&](Index s) {
+            const Index p = m_sparent[s];
+            if (p == -1)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                roots_done++;
+                cond.notify_all();
+            }
+            else if (pending[p].fetch_sub(1) == 1)
+            {
+                m_pool->post([&run, p]() { run(p); });
+            }
+        };
+        run = [&](Index s) {
+            factorize_supernode(s);
+            finish(s);
+        };
+
+        for (Index s = 0; s < ns; s++)
+        {
+            const Index p = m_sparent[s];
+            const bool small = m_subwork[s] <= cutoff;
+            const bool parent_small = (p != -1) && (m_subwork[p] <= cutoff);
+            if (small && !parent_small)
+            {
+                // The whole subtree is one task, and s becomes a leaf of the scheduled tree
+                m_pool->post([this, &finish, s]() {
+                    factorize_subtree(s);
+                    finish(s);
+                });
+            }
+            else if (!small && m_childptr[s + 1] == m_childptr[s])
+            {
+                // Leaves of the scheduled tree are posted here, and other supernodes
+                // are posted by the task finishing their last child
+                m_pool->post([&run, s]() { run(s); });
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&] { return roots_done == nroots; });
+    }
+
+public:
+    ///
+    /// Default constructor. The number of threads defaults to the number of
+    /// hardware threads.
+    ///
+    SupernodalCholesky() :
+        m_n(0), m_failed(false), m_pattern_err(false),
+        m_nthread(ThreadPool::default_num_threads()),
+        m_analyzed(false), m_factorized(false), m_info(CompInfo::NotComputed)
+    {}
+
+    ///
+    /// Constructor to analyze and factorize a matrix.
+    ///
+    template <typename Derived>
+    explicit SupernodalCholesky(const Eigen::SparseMatrixBase<Derived>& mat) :
+        SupernodalCholesky()
+    {
+        compute(mat);
+    }
+
+    ///
+    /// Set the number of threads used in the numeric factorization.
+    /// If it is not positive, the number of hardware threads is used.
+    ///
+    void set_num_threads(int nthread)
+    {
+        nthread = (nthread > 0) ? nthread : ThreadPool::default_num_threads();
+        if (nthread != m_nthread)
+            m_pool.reset();
+        m_nthread = nthread;
+    }
+
+    ///
+    /// Number of threads used in the numeric factorization.
+    ///
+    int num_threads() const { return m_nthread; }
+
+    Index rows() const { return m_n; }
+    Index cols() const { return m_n; }
+
+    ///
+    /// Number of supernodes, available after the symbolic analysis.
+    ///
+    Index supernodes() const { return m_analyzed ? num_supernodes() : 0; }
+
+    ///
+    /// Number of stored entries of \f$L\f$, including the explicit zeros introduced
+    /// by the supernode amalgamation, available after the symbolic analysis.
+    ///
+    Index nonzeros() const
+    {
+        Index nnz = 0;
+        for (Index s = 0; s < supernodes(); s++)
+        {
+            const Index w = m_super[s + 1] - m_super[s];
+            const Index nrow = m_rowptr[s + 1] - m_rowptr[s];
+            nnz += nrow * w - w * (w - 1) / 2;
+        }
+        return nnz;
+    }
+
+    ///
+    /// Symbolic analysis, only depending on the sparsity pattern of the matrix.
+    ///
+    template <typename Derived>
+    void analyzePattern(const Eigen::SparseMatrixBase<Derived>& mat)
+    {
+        SPECTRA_TRACE_SCOPE("SupernodalCholesky::analyze");
+
+        m_n = mat.rows();
+        if (m_n != mat.cols())
+            throw std::invalid_argument("SupernodalCholesky: matrix must be square");
+
+        // Fill-reducing ordering
+        SparseMatrix sym;
+        sym = mat.derived().template selfadjointView<Uplo>();
+        Permutation pinv;
+        Eigen::AMDOrdering<StorageIndex> ordering;
+        ordering(sym, pinv);
+        m_perm = pinv.inverse();
+        permute_matrix(mat, m_ap);
+
+        // Postorder the elimination tree, such that every subtree is a
+        // contiguous range of columns
+        IndexArray parent, post;
+        SparseMatrix apu = m_ap.transpose();
+        elimination_tree(apu, parent);
+        postorder(parent, post);
+        IndexArray ipost(m_n);
+        for (Index k = 0; k < m_n; k++)
+            ipost[post[k]] = k;
+        for (Index i = 0; i < m_n; i++)
+            m_perm.indices()[i] = StorageIndex(ipost[m_perm.indices()[i]]);
+        m_perminv = m_perm.inverse();
+
+        permute_matrix(mat, m_ap);
+        apu = m_ap.transpose();
+        elimination_tree(apu, parent);
+
+        symbolic(parent, apu);
+
+        m_analyzed = true;
+        m_factorized = false;
+        m_info = CompInfo::NotComputed;
+    }
+
+    ///
+    /// Numeric factorization, using the symbolic analysis of a matrix with the
+    /// same sparsity pattern.
+    ///
+    template <typename Derived>
+    void factorize(const Eigen::SparseMatrixBase<Derived>& mat)
+    {
+        SPECTRA_TRACE_SCOPE("SupernodalCholesky::factorize");
+
+        if (!m_analyzed)
+            throw std::logic_error("SupernodalCholesky: need to call analyzePattern() first");
+        if (mat.rows() != m_n || mat.cols() != m_n)
+            throw std::invalid_argument("SupernodalCholesky: matrix size does not match the analyzed pattern");
+
+        permute_matrix(mat, m_ap);
+        m_values.setZero(m_valptr.back());
+        m_update.assign(num_supernodes(), Matrix());
+        m_failed = false;
+        m_pattern_err = false;
+
+        if (m_nthread <= 1 || num_supernodes() <= 1)
+        {
+            for (Index s = 0; s < num_supernodes(); s++)
+                factorize_supernode(s);
+        }
+        else
+        {
+            if (!m_pool)
+                m_pool.reset(new ThreadPool(m_nthread));
+            factorize_parallel();
+        }
+        m_update.clear();
+
+        if (m_pattern_err)
+            throw std::invalid_argument("SupernodalCholesky: the sparsity pattern differs from the analyzed one");
+        m_factorized = true;
+        m_info = m_failed ? CompInfo::NumericalIssue : CompInfo::Successful;
+    }
+
+    ///
+    /// Symbolic analysis followed by numeric factorization.
+    ///
+    template <typename Derived>
+    void compute(const Eigen::SparseMatrixBase<Derived>& mat)
+    {
+        analyzePattern(mat);
+        factorize(mat);
+    }
+
+    ///
+    /// Returns the status of the factorization. `CompInfo::NumericalIssue` means
+    /// that the matrix is not positive definite.
+    ///
+    CompInfo info() const { return m_info; }
+
+    ///
+    /// The fill-reducing permutation \f$P\f$.
+    ///
+    const Permutation& permutationP() const { return m_perm; }
+    ///
+    /// The inverse permutation \f$P'\f$.
+    ///
+    const Permutation& permutationPinv() const { return m_perminv; }
+
+    ///
+    /// Solve \f$LX=B\f$ in place, where \f$B\f$ is a vector or a matrix.
+    ///
+    template <typename Derived>
+    void solve_lower_inplace(Eigen::MatrixBase<Derived>& X) const
+    {
+        if (!m_factorized)
+            throw std::logic_error("SupernodalCholesky: need to call factorize() first");
+
+        Matrix tmp;
+        for (Index s = 0; s < num_supernodes(); s++)
+        {
+            const Index first = m_super[s];
+            const Index w = m_super[s + 1] - first;
+            const Index nrow = m_rowptr[s + 1] - m_rowptr[s];
+            const Index* rows = &m_rows[m_rowptr[s]];
+            MapConstMat L(&m_values[m_valptr[s]], nrow, w);
+
+            auto Xs = X.middleRows(first, w);
+            L.topRows(w).template triangularView<Eigen::Lower>().solveInPlace(Xs);
+            if (nrow > w)
+            {
+                tmp.noalias() = L.bottomRows(nrow - w) * Xs;
+                for (Index k = 0; k < nrow - w; k++)
+                    X.row(rows[w + k]) -= tmp.row(k);
+            }
+        }
+    }
+
+    ///
+    /// Solve \f$L'X=B\f$ in place, where \f$B\f$ is a vector or a matrix.
+    ///
+    template <typename Derived>
+    void solve_upper_inplace(Eigen::MatrixBase<Derived>& X) const
+    {
+        if (!m_factorized)
+            throw std::logic_error("SupernodalCholesky: need to call factorize() first");
+
+        Matrix tmp;
+        for (Index s = num_supernodes() - 1; s >= 0; s--)
+        {
+            const Index first = m_super[s];
+            const Index w = m_super[s + 1] - first;
+            const Index nrow = m_rowptr[s + 1] - m_rowptr[s];
+            const Index* rows = &m_rows[m_rowptr[s]];
+            MapConstMat L(&m_values[m_valptr[s]], nrow, w);
+
+            auto Xs = X.middleRows(first, w);
+            if (nrow > w)
+            {
+                tmp.resize(nrow - w, X.cols());
+                for (Index k = 0; k < nrow - w; k++)
+                    tmp.row(k) = X.row(rows[w + k]);
+                Xs.noalias() -= L.bottomRows(nrow - w).transpose() * tmp;
+            }
+            L.topRows(w).transpose().template triangularView<Eigen::Upper>().solveInPlace(Xs);
+        }
+    }
+
+    ///
+    /// Solve \f$AX=B\f$, where \f$B\f$ is a vector or a matrix.
+    ///
+    template <typename Derived>
+    Eigen::Matrix<Scalar, Eigen::Dynamic, Derived::ColsAtCompileTime> solve(const Eigen::MatrixBase<Derived>& b) const
+    {
+        Eigen::Matrix<Scalar, Eigen::Dynamic, Derived::ColsAtCompileTime> x = m_perm * b;
+        solve_lower_inplace(x);
+        solve_upper_inplace(x);
+        x = m_perminv * x;
+        return x;
+    }
+};
+
+/// \cond
+
+template <typename Scalar, int Uplo, typename StorageIndex>
+class FacTraits<SupernodalCholesky<Scalar, Uplo, StorageIndex>> :
+    public FacTraitsBase<SupernodalCholesky<Scalar, Uplo, StorageIndex>>
+{
+private:
+    using Index = Eigen::Index;
+    using FacType = SupernodalCholesky<Scalar, Uplo, StorageIndex>;
+
+public:
+    template <typename Rhs, typename Dest>
+    static void lower_triangular_solve(const FacType& fac, const Rhs& b, Dest& x)
+    {
+        x.noalias() = fac.permutationP() * b;
+        fac.solve_lower_inplace(x);
+    }
+
+    template <typename Rhs, typename Dest>
+    static void upper_triangular_solve(const FacType& fac, const Rhs& b, Dest& x)
+    {
+        x.noalias() = b;
+        fac.solve_upper_inplace(x);
+        x = fac.permutationPinv() * x;
+    }
+
+    static void inertia(const FacType& fac, Index& npos, Index& nneg, Index& nzero)
+    {
+        // A failed factorization only shows that the matrix is not positive definite
+        if (fac.info() != CompInfo::Successful)
+            throw std::runtime_error("SupernodalCholesky: the inertia is unknown after a failed factorization");
+        npos = fac.rows();
+        nneg = 0;
+        nzero = 0;
+    }
+};
+
+/// \endcond
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_SUPERNODAL_CHOLESKY_H
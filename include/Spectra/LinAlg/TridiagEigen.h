@@ -13,9 +13,12 @@
 
 #include <Eigen/Core>
 #include <Eigen/Jacobi>
+#include <vector>
+#include <algorithm>  // std::sort
 #include <stdexcept>
 
 #include "../Util/TypeTraits.h"
+#include "../Util/SimpleRandom.h"
 
 namespace Spectra {
 
@@ -35,14 +38,19 @@ private:
     Vector m_main_diag;  // Main diagonal elements of the matrix
     Vector m_sub_diag;   // Sub-diagonal elements of the matrix
     Matrix m_evecs;      // To store eigenvectors
+    Vector m_last_row;   // Last row of the eigenvector matrix
+    Vector m_diag0;      // Scaled main diagonal elements of the original matrix,
+    Vector m_sub0;       // and sub-diagonal elements, used by inverse iteration
+    Scalar m_scale;      // Scaling factor of the matrix
     bool m_computed;
+    bool m_full;         // Whether all eigenvectors have been computed
 
     // Adapted from Eigen/src/Eigenvaleus/SelfAdjointEigenSolver.h
     // Francis implicit QR step.
     static void tridiagonal_qr_step(RealScalar* diag,
                                     RealScalar* subdiag, Index start,
                                     Index end, Scalar* matrixQ,
-                                    Index n)
+                                    Index rows, Index n)
     {
         using std::abs;
 
@@ -69,7 +77,8 @@ private:
 
         RealScalar x = diag[start] - mu;
         RealScalar z = subdiag[start];
-        Eigen::Map<Matrix> q(matrixQ, n, n);
+        // Only the leading rows of Q may be accumulated, e.g. the last row
+        Eigen::Map<Matrix> q(matrixQ, rows, n);
         // If z ever becomes zero, the Givens rotation will be the identity and
         // z will stay zero for all future iterations.
         for (Index k = start; k < end && z != RealScalar(0); ++k)
@@ -105,18 +114,9 @@ private:
         }
     }
 
-public:
-    TridiagEigen() :
-        m_n(0), m_computed(false)
-    {}
-
-    TridiagEigen(ConstGenericMatrix& mat) :
-        m_n(mat.rows()), m_computed(false)
-    {
-        compute(mat);
-    }
-
-    void compute(ConstGenericMatrix& mat)
+    // Scales the matrix and runs the QR iterations, where Q is accumulated on the
+    // first "rows" rows of the matrix pointed to by matrixQ
+    void decompose(ConstGenericMatrix& mat, Scalar* matrixQ, Index rows)
     {
         using std::abs;
 
@@ -124,14 +124,8 @@ public:
         // ~= 1e-307 for the "double" type
         const Scalar near_0 = TypeTraits<Scalar>::min() * Scalar(10);
 
-        m_n = mat.rows();
-        if (m_n != mat.cols())
-            throw std::invalid_argument("TridiagEigen: matrix must be square");
-
         m_main_diag.resize(m_n);
         m_sub_diag.resize(m_n - 1);
-        m_evecs.resize(m_n, m_n);
-        m_evecs.setIdentity();
 
         // Scale matrix to improve stability
         const Scalar scale = (std::max)(mat.diagonal().cwiseAbs().maxCoeff(),
@@ -141,13 +135,18 @@ public:
         {
             // m_main_diag contains eigenvalues
             m_main_diag.setZero();
-            // m_evecs has been set identity
-            // m_evecs.setIdentity();
+            m_diag0.setZero(m_n);
+            m_sub0.setZero(m_n - 1);
+            m_scale = Scalar(1);
+            // Q has been set identity
             m_computed = true;
             return;
         }
         m_main_diag.noalias() = mat.diagonal() / scale;
         m_sub_diag.noalias() = mat.diagonal(-1) / scale;
+        m_diag0 = m_main_diag;
+        m_sub0 = m_sub_diag;
+        m_scale = scale;
 
         Scalar* diag = m_main_diag.data();
         Scalar* subdiag = m_sub_diag.data();
@@ -195,7 +194,7 @@ public:
             while (start > 0 && subdiag[start - 1] != Scalar(0))
                 start--;
 
-            tridiagonal_qr_step(diag, subdiag, start, end, m_evecs.data(), m_n);
+            tridiagonal_qr_step(diag, subdiag, start, end, matrixQ, rows, m_n);
         }
 
         if (info > 0)
@@ -207,6 +206,142 @@ public:
         m_computed = true;
     }
 
+    // LU decomposition with partial pivoting of T - shift * I, where T is the scaled
+    // original matrix, similar to LAPACK's dlagtf. U has three diagonals u1, u2, and u3,
+    // and pivots smaller than tol in magnitude are replaced by +/-tol
+    void shifted_lu(const Scalar& shift, const Scalar& tol, Vector& l, Vector& u1, Vector& u2, Vector& u3,
+                    std::vector<bool>& perm) const
+    {
+        using std::abs;
+
+        l.resize(m_n);
+        u1.noalias() = m_diag0;
+        u1.array() -= shift;
+        u2.setZero(m_n);
+        u2.head(m_n - 1).noalias() = m_sub0;
+        u3.setZero(m_n);
+        perm.assign(m_n, false);
+
+        for (Index k = 0; k < m_n - 1; k++)
+        {
+            const Scalar sub = m_sub0[k];
+            if (abs(u1[k]) >= abs(sub))
+            {
+                l[k] = (u1[k] == Scalar(0)) ? Scalar(0) : sub / u1[k];
+                u1[k + 1] -= l[k] * u2[k];
+            }
+            else
+            {
+                // Swap rows k and k+1
+                const Scalar a1 = u1[k + 1], b1 = u2[k + 1];
+                perm[k] = true;
+                l[k] = u1[k] / sub;
+                u1[k] = sub;
+                u1[k + 1] = u2[k] - l[k] * a1;
+                u2[k] = a1;
+                u3[k] = b1;
+                u2[k + 1] = -l[k] * b1;
+            }
+        }
+        for (Index k = 0; k < m_n; k++)
+        {
+            if (abs(u1[k]) < tol)
+                u1[k] = (u1[k] < Scalar(0)) ? -tol : tol;
+        }
+    }
+
+    // Solves (T - shift * I) y = x in place using the decomposition above
+    void shifted_solve(const Vector& l, const Vector& u1, const Vector& u2, const Vector& u3,
+                       const std::vector<bool>& perm, Vector& x) const
+    {
+        for (Index k = 0; k < m_n - 1; k++)
+        {
+            if (perm[k])
+                std::swap(x[k], x[k + 1]);
+            x[k + 1] -= l[k] * x[k];
+        }
+        x[m_n - 1] /= u1[m_n - 1];
+        if (m_n > 1)
+            x[m_n - 2] = (x[m_n - 2] - u2[m_n - 2] * x[m_n - 1]) / u1[m_n - 2];
+        for (Index k = m_n - 3; k >= 0; k--)
+            x[k] = (x[k] - u2[k] * x[k + 1] - u3[k] * x[k + 2]) / u1[k];
+    }
+
+    // ||(T - lambda * I) x||, where T is the scaled original matrix
+    Scalar tridiag_residual(const Scalar& lambda, const Vector& x) const
+    {
+        Vector r = (m_diag0.array() - lambda).matrix().cwiseProduct(x);
+        if (m_n > 1)
+        {
+            r.head(m_n - 1).noalias() += m_sub0.cwiseProduct(x.tail(m_n - 1));
+            r.tail(m_n - 1).noalias() += m_sub0.cwiseProduct(x.head(m_n - 1));
+        }
+        return r.norm();
+    }
+
+    // Selected eigenvectors computed by the QR iterations with all eigenvectors
+    // accumulated, with signs matching the last row
+    Matrix qr_eigenvectors(const std::vector<Index>& ind) const
+    {
+        // The scaled matrix gives the same sequence of QR iterations, so the order
+        // of the eigenvalues is the same
+        Matrix T = Matrix::Zero(m_n, m_n);
+        T.diagonal().noalias() = m_diag0;
+        if (m_n > 1)
+            T.diagonal(-1).noalias() = m_sub0;
+        TridiagEigen<Scalar> full(T);
+
+        const Index k = ind.size();
+        Matrix res(m_n, k);
+        for (Index j = 0; j < k; j++)
+        {
+            res.col(j).noalias() = full.eigenvectors().col(ind[j]);
+            if (res(m_n - 1, j) * m_last_row[ind[j]] < Scalar(0))
+                res.col(j) = -res.col(j);
+        }
+        return res;
+    }
+
+public:
+    TridiagEigen() :
+        m_n(0), m_scale(1), m_computed(false), m_full(false)
+    {}
+
+    TridiagEigen(ConstGenericMatrix& mat) :
+        m_n(mat.rows()), m_scale(1), m_computed(false), m_full(false)
+    {
+        compute(mat);
+    }
+
+    void compute(ConstGenericMatrix& mat)
+    {
+        m_n = mat.rows();
+        if (m_n != mat.cols())
+            throw std::invalid_argument("TridiagEigen: matrix must be square");
+
+        m_evecs.resize(m_n, m_n);
+        m_evecs.setIdentity();
+        m_full = true;
+        decompose(mat, m_evecs.data(), m_n);
+        m_last_row.noalias() = m_evecs.row(m_n - 1).transpose();
+    }
+
+    // Computes all the eigenvalues, but only the last row of the eigenvector matrix,
+    // which costs O(n^2) instead of O(n^3) operations. Selected eigenvectors can be
+    // computed afterwards by eigenvectors(ind)
+    void compute_last_row(ConstGenericMatrix& mat)
+    {
+        m_n = mat.rows();
+        if (m_n != mat.cols())
+            throw std::invalid_argument("TridiagEigen: matrix must be square");
+
+        m_evecs.resize(0, 0);
+        m_last_row.setZero(m_n);
+        m_last_row[m_n - 1] = Scalar(1);
+        m_full = false;
+        decompose(mat, m_last_row.data(), 1);
+    }
+
     const Vector& eigenvalues() const
     {
         if (!m_computed)
@@ -220,9 +355,130 @@ public:
     {
         if (!m_computed)
             throw std::logic_error("TridiagEigen: need to call compute() first");
+        if (!m_full)
+            throw std::logic_error("TridiagEigen: only selected eigenvectors are available after compute_last_row()");
 
         return m_evecs;
     }
+
+    // The last row of the eigenvector matrix, as a column vector
+    const Vector& last_row() const
+    {
+        if (!m_computed)
+            throw std::logic_error("TridiagEigen: need to call compute() first");
+
+        return m_last_row;
+    }
+
+    // Eigenvectors associated with eigenvalues()[ind[0]], eigenvalues()[ind[1]], ...
+    // After compute_last_row(), they are obtained by inverse iteration as in LAPACK's
+    // dstein, and vectors of close eigenvalues are reorthogonalized against each other
+    Matrix eigenvectors(const std::vector<Index>& ind) const
+    {
+        using std::abs;
+        using std::sqrt;
+
+        if (!m_computed)
+            throw std::logic_error("TridiagEigen: need to call compute() first");
+
+        const Index k = ind.size();
+        Matrix res(m_n, k);
+        if (m_full)
+        {
+            for (Index j = 0; j < k; j++)
+                res.col(j).noalias() = m_evecs.col(ind[j]);
+            return res;
+        }
+
+        const Scalar eps = Eigen::NumTraits<Scalar>::epsilon();
+        // 1-norm of the scaled matrix, which is at least one unless it is zero
+        Scalar onenrm = Scalar(1);
+        for (Index i = 0; i < m_n; i++)
+        {
+            Scalar rowsum = abs(m_diag0[i]);
+            if (i > 0)
+                rowsum += abs(m_sub0[i - 1]);
+            if (i < m_n - 1)
+                rowsum += abs(m_sub0[i]);
+            onenrm = (std::max)(onenrm, rowsum);
+        }
+        const Scalar tol = eps * onenrm;                  // replacement of tiny pivots
+        const Scalar pertol = Scalar(10) * eps * onenrm;  // minimum distance between shifts
+        const Scalar ortol = Scalar(1e-3) * onenrm;       // close eigenvalues form a cluster
+        const Scalar growth_tol = Scalar(1) / (sqrt(eps * Scalar(m_n)) * onenrm);
+        const int maxit = 5;
+
+        // Process the eigenvalues in increasing order, so that clusters are contiguous
+        std::vector<Index> order(k);
+        for (Index j = 0; j < k; j++)
+            order[j] = j;
+        std::sort(order.begin(), order.end(), [this, &ind](Index a, Index b) {
+            return m_main_diag[ind[a]] < m_main_diag[ind[b]];
+        });
+
+        SimpleRandom<Scalar> rng(1);
+        Vector x(m_n), l, u1, u2, u3;
+        std::vector<bool> perm;
+        Scalar prev_lambda = Scalar(0), prev_shift = Scalar(0);
+        Index cluster_start = 0;
+        for (Index jj = 0; jj < k; jj++)
+        {
+            const Index j = order[jj];
+            const Scalar lambda = m_main_diag[ind[j]] / m_scale;
+            Scalar shift = lambda;
+            if (jj > 0)
+            {
+                if (lambda - prev_lambda > ortol)
+                    cluster_start = jj;
+                // Separate the shifts of (nearly) equal eigenvalues
+                if (shift - prev_shift < pertol)
+                    shift = prev_shift + pertol;
+            }
+            prev_lambda = lambda;
+            prev_shift = shift;
+
+            shifted_lu(shift, tol, l, u1, u2, u3, perm);
+            rng.random_vec(x);
+            x.normalize();
+            // Stop one iteration after the solution has grown enough
+            bool grown = false;
+            for (int iter = 0; iter < maxit; iter++)
+            {
+                shifted_solve(l, u1, u2, u3, perm, x);
+                // Reorthogonalize against the vectors of the same cluster, twice
+                for (int rep = 0; rep < 2; rep++)
+                {
+                    for (Index c = cluster_start; c < jj; c++)
+                        x.noalias() -= res.col(order[c]).dot(x) * res.col(order[c]);
+                }
+                const Scalar growth = x.norm();
+                x /= growth;
+                if (grown)
+                    break;
+                grown = (growth >= growth_tol);
+            }
+
+            // Use the sign of the last row computed by the QR iterations
+            if (x[m_n - 1] * m_last_row[ind[j]] < Scalar(0))
+                x = -x;
+            res.col(j).noalias() = x;
+
+            // The error of x is bounded by ||(T - lambda * I) x|| / gap, where gap is the
+            // distance from lambda to the other eigenvalues. If the iterations have not
+            // converged, or the gap is too small for inverse iteration to separate the
+            // eigenvectors, we fall back to the QR iterations
+            Scalar gap = Eigen::NumTraits<Scalar>::highest();
+            for (Index i = 0; i < m_n; i++)
+            {
+                if (i != ind[j])
+                    gap = (std::min)(gap, abs(m_main_diag[i] / m_scale - lambda));
+            }
+            if (tridiag_residual(lambda, x) > sqrt(eps) * gap)
+                return qr_eigenvectors(ind);
+        }
+
+        return res;
+    }
 };
 
 }  // namespace Spectra
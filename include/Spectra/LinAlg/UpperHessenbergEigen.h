@@ -12,6 +12,7 @@
 #define SPECTRA_UPPER_HESSENBERG_EIGEN_H
 
 #include <Eigen/Core>
+#include <vector>
 #include <stdexcept>
 
 #include "UpperHessenbergSchur.h"
@@ -35,7 +36,8 @@ private:
     Index m_n;                             // Size of the matrix
     UpperHessenbergSchur<Scalar> m_schur;  // Schur decomposition solver
     Matrix m_matT;                         // Schur T matrix
-    Matrix m_eivec;                        // Storing eigenvectors
+    Matrix m_eivec;                        // Schur vectors U, such that the eigenvectors
+                                           // are U * X, where X is stored in m_matT
     ComplexVector m_eivalues;              // Eigenvalues
     bool m_computed;
 
@@ -55,7 +57,10 @@ private:
 
         // Backsubstitute to find vectors of upper triangular form
         if (norm == Scalar(0))
+        {
+            m_matT.setIdentity();
             return;
+        }
 
         for (Index n = size - 1; n >= 0; n--)
         {
@@ -187,15 +192,34 @@ private:
             }
         }
 
-        // Back transformation to get eigenvectors of original matrix
-        Vector m_tmp(size);
-        for (Index j = size - 1; j >= 0; j--)
+        // The back transformation U * X is deferred until the eigenvectors are
+        // requested, so that only the selected ones need to be computed
+    }
+
+    // The columns of U * X that form the j-th eigenvector as re + i * im, where
+    // im = -1 if the eigenvector is real, and conj = true if the imaginary part is negated
+    void vector_columns(Index j, Index& re, Index& im, bool& conj) const
+    {
+        const Scalar q = Eigen::numext::imag(m_eivalues.coeff(j));
+        re = j;
+        im = -1;
+        conj = false;
+        if (q > Scalar(0) && j + 1 < m_n)
+            im = j + 1;
+        else if (q < Scalar(0) && j > 0)
         {
-            m_tmp.noalias() = m_eivec.leftCols(j + 1) * m_matT.col(j).segment(0, j + 1);
-            m_eivec.col(j) = m_tmp;
+            re = j - 1;
+            im = j;
+            conj = true;
         }
     }
 
+    // Column j of U * X, noting that X is upper triangular
+    Vector transformed_col(Index j) const
+    {
+        return m_eivec.leftCols(j + 1) * m_matT.col(j).head(j + 1);
+    }
+
 public:
     UpperHessenbergEigen() :
         m_n(0), m_computed(false)
@@ -273,6 +297,63 @@ public:
         return m_eivalues;
     }
 
+    // The last row of the eigenvector matrix, as a column vector, which costs O(n^2)
+    // operations instead of O(n^3) for the full eigenvectors
+    ComplexVector last_row() const
+    {
+        using std::sqrt;
+
+        if (!m_computed)
+            throw std::logic_error("UpperHessenbergEigen: need to call compute() first");
+
+        ComplexVector res(m_n);
+        Index re, im;
+        bool conj;
+        for (Index j = 0; j < m_n; j++)
+        {
+            vector_columns(j, re, im, conj);
+            // U is orthogonal, so the norm of U * x is the norm of x
+            const Scalar xr = m_eivec.row(m_n - 1).head(re + 1).dot(m_matT.col(re).head(re + 1));
+            Scalar nrm2 = m_matT.col(re).head(re + 1).squaredNorm();
+            Scalar xi = Scalar(0);
+            if (im >= 0)
+            {
+                xi = m_eivec.row(m_n - 1).head(im + 1).dot(m_matT.col(im).head(im + 1));
+                nrm2 += m_matT.col(im).head(im + 1).squaredNorm();
+            }
+            res[j] = Complex(xr, conj ? -xi : xi) / sqrt(nrm2);
+        }
+
+        return res;
+    }
+
+    // Eigenvectors associated with eigenvalues()[ind[0]], eigenvalues()[ind[1]], ...
+    ComplexMatrix eigenvectors(const std::vector<Index>& ind) const
+    {
+        if (!m_computed)
+            throw std::logic_error("UpperHessenbergEigen: need to call compute() first");
+
+        const Index k = ind.size();
+        ComplexMatrix res(m_n, k);
+        Index re, im;
+        bool conj;
+        for (Index l = 0; l < k; l++)
+        {
+            vector_columns(ind[l], re, im, conj);
+            if (im < 0)
+                res.col(l) = transformed_col(re).template cast<Complex>();
+            else
+            {
+                const Vector xr = transformed_col(re), xi = transformed_col(im);
+                for (Index i = 0; i < m_n; i++)
+                    res.coeffRef(i, l) = Complex(xr[i], conj ? -xi[i] : xi[i]);
+            }
+            res.col(l).normalize();
+        }
+
+        return res;
+    }
+
     ComplexMatrix eigenvectors()
     {
         using std::abs;
@@ -280,6 +361,9 @@ public:
         if (!m_computed)
             throw std::logic_error("UpperHessenbergEigen: need to call compute() first");
 
+        // Back transformation to get eigenvectors of original matrix
+        const Matrix eivec = m_eivec * m_matT.template triangularView<Eigen::Upper>();
+
         Index n = m_eivec.cols();
         ComplexMatrix matV(n, n);
         for (Index j = 0; j < n; ++j)
@@ -288,7 +372,7 @@ public:
             if (Eigen::numext::imag(m_eivalues.coeff(j)) == Scalar(0) || j + 1 == n)
             {
                 // we have a real eigen value
-                matV.col(j) = m_eivec.col(j).template cast<Complex>();
+                matV.col(j) = eivec.col(j).template cast<Complex>();
                 matV.col(j).normalize();
             }
             else
@@ -296,8 +380,8 @@ public:
                 // we have a pair of complex eigen values
                 for (Index i = 0; i < n; ++i)
                 {
-                    matV.coeffRef(i, j) = Complex(m_eivec.coeff(i, j), m_eivec.coeff(i, j + 1));
-                    matV.coeffRef(i, j + 1) = Complex(m_eivec.coeff(i, j), -m_eivec.coeff(i, j + 1));
+                    matV.coeffRef(i, j) = Complex(eivec.coeff(i, j), eivec.coeff(i, j + 1));
+                    matV.coeffRef(i, j + 1) = Complex(eivec.coeff(i, j), -eivec.coeff(i, j + 1));
                 }
                 matV.col(j).normalize();
                 matV.col(j + 1).normalize();
@@ -14,6 +14,9 @@
 #include <Eigen/Core>
 #include <Eigen/Jacobi>
 #include <Eigen/Householder>
+#include <Eigen/LU>
+#include <Eigen/QR>
+#include <vector>
 #include <stdexcept>
 
 #include "../Util/TypeTraits.h"
@@ -334,6 +337,56 @@ private:
         }
     }
 
+    // Size of the diagonal block of T starting at index k, either 1 or 2
+    Index block_size_at(Index k) const
+    {
+        return (k + 1 < m_n && m_T.coeff(k + 1, k) != Scalar(0)) ? 2 : 1;
+    }
+
+    // Swap the adjacent diagonal blocks T11 = T[i:i+p, i:i+p] and T22 = T[i+p:i+p+q, i+p:i+p+q],
+    // p, q in {1, 2}, by an orthogonal similarity transformation
+    void swap_blocks(Index i, Index p, Index q)
+    {
+        const Index s = p + q;
+        const Index pq = p * q;
+
+        // Solve the Sylvester equation T11 * X - X * T22 = T12 through its Kronecker form
+        // (I (x) T11 - T22' (x) I) * vec(X) = vec(T12)
+        Matrix K = Matrix::Zero(pq, pq);
+        for (Index c = 0; c < q; c++)
+        {
+            for (Index r = 0; r < q; r++)
+            {
+                if (r == c)
+                    K.block(r * p, c * p, p, p).noalias() += m_T.block(i, i, p, p);
+                K.block(r * p, c * p, p, p).diagonal().array() -= m_T.coeff(i + p + c, i + p + r);
+            }
+        }
+        Vector rhs(pq);
+        for (Index c = 0; c < q; c++)
+            rhs.segment(c * p, p).noalias() = m_T.col(i + p + c).segment(i, p);
+        const Vector x = K.fullPivLu().solve(rhs);
+
+        // [-X; I] spans the invariant subspace associated with T22, and
+        // its QR decomposition gives the orthogonal transformation
+        Matrix M(s, q);
+        M.setZero();
+        for (Index c = 0; c < q; c++)
+        {
+            M.col(c).head(p).noalias() = -x.segment(c * p, p);
+            M(p + c, c) = Scalar(1);
+        }
+        Eigen::HouseholderQR<Matrix> qr(M);
+        const Matrix Q = qr.householderQ();
+
+        m_T.block(i, i, s, m_n - i) = Q.transpose() * m_T.block(i, i, s, m_n - i);
+        m_T.block(0, i, i + s, s) = m_T.block(0, i, i + s, s) * Q;
+        m_U.middleCols(i, s) = m_U.middleCols(i, s) * Q;
+
+        // T22 is now in the upper left corner, and the lower left block vanishes
+        m_T.block(i + q, i, p, q).setZero();
+    }
+
 public:
     UpperHessenbergSchur() :
         m_n(0), m_computed(false)
@@ -418,6 +471,38 @@ public:
         m_computed = true;
     }
 
+    // Reorder the Schur decomposition such that the selected eigenvalues appear in
+    // the leading diagonal blocks of T, keeping their relative order
+    // select[k] indicates whether the diagonal block starting at index k is selected
+    // Then the leading columns of U span the invariant subspace associated with
+    // the selected eigenvalues
+    void reorder(const std::vector<bool>& select)
+    {
+        if (!m_computed)
+            throw std::logic_error("UpperHessenbergSchur: need to call compute() first");
+        if (Index(select.size()) != m_n)
+            throw std::invalid_argument("UpperHessenbergSchur: select must have the same size as the matrix");
+
+        // The selected blocks are moved to index ks, ks + 1, ...
+        Index ks = 0;
+        for (Index k = 0; k < m_n;)
+        {
+            const Index nb = block_size_at(k);
+            if (select[k])
+            {
+                // Move the block up by swapping it with the preceding blocks
+                for (Index here = k; here > ks;)
+                {
+                    const Index nbp = (here >= 2 && m_T.coeff(here - 1, here - 2) != Scalar(0)) ? 2 : 1;
+                    swap_blocks(here - nbp, nbp, nb);
+                    here -= nbp;
+                }
+                ks += nb;
+            }
+            k += nb;
+        }
+    }
+
     const Matrix& matrix_T() const
     {
         if (!m_computed)
@@ -12,6 +12,7 @@
 #include <stdexcept>
 
 #include "../Util/CompInfo.h"
+#include "../Util/Trace.h"
 
 namespace Spectra {
 
@@ -70,6 +71,7 @@ public:
         if (m_n != mat.cols())
             throw std::invalid_argument("DenseCholesky: matrix must be square");
 
+        SPECTRA_TRACE_SCOPE("DenseCholesky::factorize");
         m_decomp.compute(mat);
         m_info = (m_decomp.info() == Eigen::Success) ?
             CompInfo::Successful :
@@ -11,6 +11,8 @@
 #include <Eigen/LU>
 #include <stdexcept>
 
+#include "../Util/Trace.h"
+
 namespace Spectra {
 
 ///
@@ -92,6 +94,8 @@ public:
     ///
     void set_shift(const Scalar& sigmar, const Scalar& sigmai)
     {
+        SPECTRA_TRACE_SCOPE("DenseGenComplexShiftSolve::set_shift");
+
         m_solver.compute(m_mat.template cast<Complex>() - Complex(sigmar, sigmai) * ComplexMatrix::Identity(m_n, m_n));
         m_x_cache.resize(m_n);
         m_x_cache.setZero();
@@ -111,6 +115,25 @@ public:
         MapVec y(y_out, m_n);
         y.noalias() = m_solver.solve(m_x_cache).real();
     }
+
+    ///
+    /// Perform the complex shift-solve operation on a block of real vectors,
+    /// \f$Y=(A-\sigma I)^{-1}X\f$, keeping both the real and imaginary parts.
+    /// Unlike perform_op(), this function does not use the internal caches, so it
+    /// can be called from several threads at the same time.
+    ///
+    /// \param x_in  Pointer to the \f$X\f$ matrix, with `ncol` columns stored
+    ///              in column-major order.
+    /// \param ncol  Number of columns of \f$X\f$.
+    /// \param y_out Pointer to the complex \f$Y\f$ matrix, with the same layout as \f$X\f$.
+    ///
+    void perform_block_op(const Scalar* x_in, Index ncol, std::complex<Scalar>* y_out) const
+    {
+        using BlockMatrix = Eigen::Matrix<Complex, Eigen::Dynamic, Eigen::Dynamic>;
+        const BlockMatrix X = Eigen::Map<const Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>>(x_in, m_n, ncol).template cast<Complex>();
+        Eigen::Map<BlockMatrix> Y(y_out, m_n, ncol);
+        Y.noalias() = m_solver.solve(X);
+    }
 };
 
 }  // namespace Spectra
@@ -10,6 +10,10 @@
 #include <Eigen/Core>
 #include <Eigen/LU>
 #include <stdexcept>
+#include <future>  // std::shared_future
+
+#include "../Util/Trace.h"
+#include "internal/AsyncShift.h"
 
 namespace Spectra {
 
@@ -46,6 +50,16 @@ private:
     const Index m_n;
     Eigen::PartialPivLU<Matrix> m_solver;
 
+    AsyncShift<Scalar> m_async;  // must be the last data member
+
+    // Factorize A - sigma * I
+    void factorize(const Scalar& sigma)
+    {
+        SPECTRA_TRACE_SCOPE("DenseGenRealShiftSolve::set_shift");
+
+        m_solver.compute(m_mat - sigma * Matrix::Identity(m_n, m_n));
+    }
+
 public:
     ///
     /// Constructor to create the matrix operation object.
@@ -81,7 +95,25 @@ public:
     ///
     void set_shift(const Scalar& sigma)
     {
-        m_solver.compute(m_mat - sigma * Matrix::Identity(m_n, m_n));
+        // The factorization may have been launched by set_shift_async()
+        if (m_async.consume(sigma))
+            return;
+        m_async.wait();
+        factorize(sigma);
+    }
+
+    ///
+    /// Start factorizing \f$A-\sigma I\f$ on a background thread and return immediately.
+    /// The returned future becomes ready when the factorization finishes, and
+    /// rethrows the exception of a failed factorization in `get()`.
+    ///
+    /// A following call of set_shift() with the same \f$\sigma\f$, for example in the
+    /// constructor of the eigen solver, waits for this factorization instead of
+    /// computing it again. The operator must not be used in other ways until then.
+    ///
+    std::shared_future<void> set_shift_async(const Scalar& sigma)
+    {
+        return m_async.launch(sigma, [this, sigma]() { factorize(sigma); });
     }
 
     ///
@@ -9,9 +9,13 @@
 
 #include <Eigen/Core>
 #include <stdexcept>
+#include <algorithm>  // std::min
+#include <future>     // std::shared_future
 
 #include "../LinAlg/BKLDLT.h"
 #include "../Util/CompInfo.h"
+#include "../Util/Trace.h"
+#include "internal/AsyncShift.h"
 
 namespace Spectra {
 
@@ -22,6 +26,11 @@ namespace Spectra {
 /// i.e., calculating \f$y=(A-\sigma I)^{-1}x\f$ for any real \f$\sigma\f$ and
 /// vector \f$x\f$. It is mainly used in the SymEigsShiftSolver eigen solver.
 ///
+/// By default the matrix is copied in each factorization. For very large matrices,
+/// the operator can instead be constructed in the in-place mode, where the
+/// factorization overwrites the storage of the input matrix, so no additional
+/// \f$O(n^2)\f$ memory is needed.
+///
 /// \tparam Scalar_ The element type of the matrix, for example,
 ///                 `float`, `double`, and `long double`.
 /// \tparam Uplo    Either `Eigen::Lower` or `Eigen::Upper`, indicating which
@@ -45,10 +54,69 @@ private:
     using MapConstVec = Eigen::Map<const Vector>;
     using MapVec = Eigen::Map<Vector>;
     using ConstGenericMatrix = const Eigen::Ref<const Matrix>;
+    using ColMatrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using MapColMatrix = Eigen::Map<ColMatrix, 0, Eigen::OuterStride<>>;
 
     ConstGenericMatrix m_mat;
     const Index m_n;
     BKLDLT<Scalar> m_solver;
+    // In the in-place mode, the input matrix viewed as a column-major matrix,
+    // whose strictly upper triangular part keeps a copy of A, and whose lower
+    // triangular part stores the factorization
+    Scalar* m_work;
+    Index m_ld;
+    Vector m_diag;  // diagonal of A in the in-place mode
+
+    AsyncShift<Scalar> m_async;  // must be the last data member
+
+    // W[i, j] = W[j, i] for the (strictly) lower triangular part of W if to_lower
+    // is true, and for the upper triangular part otherwise
+    static void copy_triangle(MapColMatrix& W, bool to_lower)
+    {
+        // Work on blocks to keep the transposed reads in cache
+        constexpr Index bs = 64;
+        const Index n = W.rows();
+        for (Index j0 = 0; j0 < n; j0 += bs)
+        {
+            const Index jb = (std::min)(bs, n - j0);
+            for (Index i0 = j0; i0 < n; i0 += bs)
+            {
+                const Index ib = (std::min)(bs, n - i0);
+                for (Index j = j0; j < j0 + jb; j++)
+                {
+                    const Index istart = (i0 == j0) ? (j + 1) : i0;
+                    for (Index i = istart; i < i0 + ib; i++)
+                    {
+                        if (to_lower)
+                            W(i, j) = W(j, i);
+                        else
+                            W(j, i) = W(i, j);
+                    }
+                }
+            }
+        }
+    }
+
+    // Factorize A - sigma * I
+    void factorize(const Scalar& sigma)
+    {
+        SPECTRA_TRACE_SCOPE("DenseSymShiftSolve::set_shift");
+
+        if (m_work)
+        {
+            // Restore A in the lower triangular part from the copy in the upper part
+            MapColMatrix W(m_work, m_n, m_n, Eigen::OuterStride<>(m_ld));
+            copy_triangle(W, true);
+            W.diagonal().noalias() = m_diag;
+            m_solver.compute_inplace(W, sigma);
+        }
+        else
+        {
+            m_solver.compute(m_mat, Uplo, sigma);
+        }
+        if (m_solver.info() != CompInfo::Successful)
+            throw std::invalid_argument("DenseSymShiftSolve: factorization failed with the given shift");
+    }
 
 public:
     ///
@@ -61,7 +129,7 @@ public:
     ///
     template <typename Derived>
     DenseSymShiftSolve(const Eigen::MatrixBase<Derived>& mat) :
-        m_mat(mat), m_n(mat.rows())
+        m_mat(mat), m_n(mat.rows()), m_work(nullptr), m_ld(0)
     {
         static_assert(
             static_cast<int>(Derived::PlainObject::IsRowMajor) == static_cast<int>(Matrix::IsRowMajor),
@@ -71,6 +139,42 @@ public:
             throw std::invalid_argument("DenseSymShiftSolve: matrix must be square");
     }
 
+    ///
+    /// Constructor to create the matrix operation object in the in-place mode.
+    ///
+    /// \param mat     An **Eigen** matrix object that can be modified, e.g. `Eigen::MatrixXd`,
+    ///                `Eigen::Map<Eigen::MatrixXd>`, or a block of them whose columns
+    ///                (rows for `Eigen::RowMajor`) are contiguous.
+    /// \param inplace If `true`, the factorizations of \f$A-\sigma I\f$ are computed in
+    ///                the storage of `mat` instead of a copy, which saves
+    ///                \f$n(n+1)/2\f$ elements of memory. The triangular part of `mat`
+    ///                specified by `Uplo` is read once, and a copy of it is kept in the
+    ///                other triangular part. The same storage is reused by all shifts.
+    ///                If `false`, the operator behaves as the usual constructor.
+    ///
+    /// In the in-place mode, **the content of `mat` is destroyed**, and `mat` must not be
+    /// read, modified, or destroyed while the operator is in use.
+    ///
+    DenseSymShiftSolve(Eigen::Ref<Matrix> mat, bool inplace) :
+        m_mat(mat), m_n(mat.rows()), m_work(nullptr), m_ld(0)
+    {
+        if (m_n != mat.cols())
+            throw std::invalid_argument("DenseSymShiftSolve: matrix must be square");
+        if (!inplace)
+            return;
+
+        // A row-major matrix is the transpose of a column-major one, so the
+        // referenced triangle is flipped when viewed as column-major
+        const bool lower = (Uplo == Eigen::Lower) != static_cast<bool>(Matrix::IsRowMajor);
+        m_work = mat.data();
+        m_ld = mat.outerStride();
+        MapColMatrix W(m_work, m_n, m_n, Eigen::OuterStride<>(m_ld));
+        m_diag.noalias() = W.diagonal();
+        // Keep A in the strictly upper triangular part
+        if (lower)
+            copy_triangle(W, false);
+    }
+
     ///
     /// Return the number of rows of the underlying matrix.
     ///
@@ -85,9 +189,25 @@ public:
     ///
     void set_shift(const Scalar& sigma)
     {
-        m_solver.compute(m_mat, Uplo, sigma);
-        if (m_solver.info() != CompInfo::Successful)
-            throw std::invalid_argument("DenseSymShiftSolve: factorization failed with the given shift");
+        // The factorization may have been launched by set_shift_async()
+        if (m_async.consume(sigma))
+            return;
+        m_async.wait();
+        factorize(sigma);
+    }
+
+    ///
+    /// Start factorizing \f$A-\sigma I\f$ on a background thread and return immediately.
+    /// The returned future becomes ready when the factorization finishes, and
+    /// rethrows the exception of a failed factorization in `get()`.
+    ///
+    /// A following call of set_shift() with the same \f$\sigma\f$, for example in the
+    /// constructor of the eigen solver, waits for this factorization instead of
+    /// computing it again. The operator must not be used in other ways until then.
+    ///
+    std::shared_future<void> set_shift_async(const Scalar& sigma)
+    {
+        return m_async.launch(sigma, [this, sigma]() { factorize(sigma); });
     }
 
     ///
@@ -0,0 +1,91 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_HODLR_SYM_MAT_PROD_H
+#define SPECTRA_HODLR_SYM_MAT_PROD_H
+
+#include <Eigen/Core>
+
+#include "../LinAlg/HODLRMatrix.h"
+
+namespace Spectra {
+
+///
+/// \ingroup MatOp
+///
+/// This class defines the matrix-vector multiplication operation on a
+/// symmetric matrix \f$A\f$ stored in the HODLR format, i.e., calculating \f$y=Ax\f$
+/// for any vector \f$x\f$, in \f$O(nk\log n)\f$ operations for off-diagonal ranks
+/// bounded by \f$k\f$. It is mainly used in the SymEigsSolver eigen solver.
+///
+/// \tparam Scalar_ The element type of the matrix, for example,
+///                 `float`, `double`, and `long double`.
+///
+template <typename Scalar_>
+class HODLRSymMatProd
+{
+public:
+    ///
+    /// Element type of the matrix.
+    ///
+    using Scalar = Scalar_;
+
+private:
+    using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using MapConstMat = Eigen::Map<const Matrix>;
+    using MapMat = Eigen::Map<Matrix>;
+
+    const HODLRMatrix<Scalar>& m_mat;
+
+public:
+    ///
+    /// Constructor to create the matrix operation object.
+    ///
+    /// \param mat A HODLRMatrix object whose compute() function has been called.
+    ///            It must be kept alive while the operator is in use.
+    ///
+    HODLRSymMatProd(const HODLRMatrix<Scalar>& mat) :
+        m_mat(mat)
+    {}
+
+    ///
+    /// Return the number of rows of the underlying matrix.
+    ///
+    Index rows() const { return m_mat.rows(); }
+    ///
+    /// Return the number of columns of the underlying matrix.
+    ///
+    Index cols() const { return m_mat.cols(); }
+
+    ///
+    /// Perform the matrix-vector multiplication operation \f$y=Ax\f$.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    // y_out = A * x_in
+    void perform_op(const Scalar* x_in, Scalar* y_out) const
+    {
+        MapConstMat x(x_in, m_mat.rows(), 1);
+        MapMat y(y_out, m_mat.rows(), 1);
+        m_mat.multiply(x, y);
+    }
+
+    ///
+    /// Perform the matrix-matrix multiplication operation \f$y=Ax\f$.
+    ///
+    Matrix operator*(const Eigen::Ref<const Matrix>& mat_in) const
+    {
+        Matrix res(mat_in.rows(), mat_in.cols());
+        m_mat.multiply(mat_in, res);
+        return res;
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_HODLR_SYM_MAT_PROD_H
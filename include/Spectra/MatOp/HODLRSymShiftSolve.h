@@ -0,0 +1,100 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_HODLR_SYM_SHIFT_SOLVE_H
+#define SPECTRA_HODLR_SYM_SHIFT_SOLVE_H
+
+#include <Eigen/Core>
+#include <stdexcept>
+
+#include "../LinAlg/HODLRMatrix.h"
+#include "../LinAlg/HODLRFactorization.h"
+#include "../Util/CompInfo.h"
+
+namespace Spectra {
+
+///
+/// \ingroup MatOp
+///
+/// This class defines the shift-solve operation on a symmetric matrix \f$A\f$
+/// stored in the HODLR format, i.e., calculating \f$y=(A-\sigma I)^{-1}x\f$ for any
+/// real \f$\sigma\f$ and vector \f$x\f$. It is mainly used in the SymEigsShiftSolver
+/// eigen solver.
+///
+/// Each shift is factorized by HODLRFactorization in \f$O(nk^2\log^2 n)\f$ operations,
+/// instead of the \f$O(n^3)\f$ cost of DenseSymShiftSolve, and each solve costs
+/// \f$O(nk\log n)\f$, where \f$k\f$ bounds the ranks of the off-diagonal blocks.
+///
+/// \tparam Scalar_ The element type of the matrix, for example,
+///                 `float`, `double`, and `long double`.
+///
+template <typename Scalar_>
+class HODLRSymShiftSolve
+{
+public:
+    ///
+    /// Element type of the matrix.
+    ///
+    using Scalar = Scalar_;
+
+private:
+    using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using MapConstMat = Eigen::Map<const Matrix>;
+    using MapMat = Eigen::Map<Matrix>;
+
+    const HODLRMatrix<Scalar>& m_mat;
+    HODLRFactorization<Scalar> m_solver;
+
+public:
+    ///
+    /// Constructor to create the matrix operation object.
+    ///
+    /// \param mat A HODLRMatrix object whose compute() function has been called.
+    ///            It must be kept alive while the operator is in use.
+    ///
+    HODLRSymShiftSolve(const HODLRMatrix<Scalar>& mat) :
+        m_mat(mat)
+    {}
+
+    ///
+    /// Return the number of rows of the underlying matrix.
+    ///
+    Index rows() const { return m_mat.rows(); }
+    ///
+    /// Return the number of columns of the underlying matrix.
+    ///
+    Index cols() const { return m_mat.cols(); }
+
+    ///
+    /// Set the real shift \f$\sigma\f$.
+    ///
+    void set_shift(const Scalar& sigma)
+    {
+        m_solver.compute(m_mat, sigma);
+        if (m_solver.info() != CompInfo::Successful)
+            throw std::invalid_argument("HODLRSymShiftSolve: factorization failed with the given shift");
+    }
+
+    ///
+    /// Perform the shift-solve operation \f$y=(A-\sigma I)^{-1}x\f$.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    // y_out = inv(A - sigma * I) * x_in
+    void perform_op(const Scalar* x_in, Scalar* y_out) const
+    {
+        MapConstMat x(x_in, m_mat.rows(), 1);
+        MapMat y(y_out, m_mat.rows(), 1);
+        y.noalias() = x;
+        m_solver.solve_inplace(y);
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_HODLR_SYM_SHIFT_SOLVE_H
@@ -0,0 +1,453 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_ITERATIVE_SYM_SHIFT_SOLVE_H
+#define SPECTRA_ITERATIVE_SYM_SHIFT_SOLVE_H
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/Cholesky>  // Eigen::LDLT
+#include <cmath>           // std::sqrt
+#include <functional>      // std::function
+#include <algorithm>       // std::min
+#include <stdexcept>       // std::invalid_argument
+
+#include "../Util/CompInfo.h"
+#include "../Util/Trace.h"
+
+namespace Spectra {
+
+///
+/// \ingroup Enumerations
+///
+/// The enumeration of Krylov methods used by IterativeSymShiftSolve to solve
+/// the shifted linear systems.
+///
+enum class IterativeMethod
+{
+    MINRES,  ///< Preconditioned MINRES, valid for any shift.
+
+    CG  ///< Preconditioned conjugate gradient, only valid if \f$A-\sigma I\f$
+        ///< is positive definite, i.e., \f$\sigma\f$ is below the spectrum of \f$A\f$.
+};
+
+///
+/// \ingroup MatOp
+///
+/// This class defines the shift-solve operation on a sparse real symmetric matrix \f$A\f$,
+/// i.e., calculating \f$y=(A-\sigma I)^{-1}x\f$, without factorizing \f$A-\sigma I\f$.
+/// Each operation solves the linear system with preconditioned MINRES or CG, so the
+/// memory cost is a few vectors in addition to \f$A\f$. It is meant for large problems,
+/// e.g. from 3D models, where the fill of a sparse factorization does not fit in memory.
+/// Like SparseSymShiftSolve, it is mainly used in the SymEigsShiftSolver eigen solver.
+///
+/// The linear systems are solved inexactly. When this operator is used in
+/// SymEigsShiftSolver, the eigen solver controls the accuracy of the inner solves
+/// through set_inner_tolerance(): the early outer iterations use loose solves until
+/// the Ritz pairs are roughly as accurate as \f$\sqrt{\mathrm{tol}}\f$, and the
+/// solver then restarts from the Ritz vectors with solves as accurate as the
+/// requested eigenvalue tolerance. Each solve is started from the Galerkin
+/// projection of the right hand side onto a few previous solutions.
+///
+/// \tparam Scalar_      The element type of the matrix, for example,
+///                      `float`, `double`, and `long double`.
+/// \tparam Uplo         Either `Eigen::Lower` or `Eigen::Upper`, indicating which
+///                      triangular part of the matrix is used.
+/// \tparam Flags        Either `Eigen::ColMajor` or `Eigen::RowMajor`, indicating
+///                      the storage format of the input matrix.
+/// \tparam StorageIndex The type of the indices for the sparse matrix.
+///
+template <typename Scalar_, int Uplo = Eigen::Lower, int Flags = Eigen::ColMajor, typename StorageIndex = int>
+class IterativeSymShiftSolve
+{
+public:
+    ///
+    /// Element type of the matrix.
+    ///
+    using Scalar = Scalar_;
+
+    ///
+    /// Type of the preconditioner, which computes \f$y=M^{-1}x\f$ given the pointers
+    /// to \f$x\f$ and \f$y\f$. \f$M\f$ must be symmetric positive definite.
+    ///
+    using Preconditioner = std::function<void(const Scalar* x_in, Scalar* y_out)>;
+
+private:
+    using Index = Eigen::Index;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using MapConstVec = Eigen::Map<const Vector>;
+    using MapVec = Eigen::Map<Vector>;
+    using SparseMatrix = Eigen::SparseMatrix<Scalar, Flags, StorageIndex>;
+    using ConstGenericSparseMatrix = const Eigen::Ref<const SparseMatrix>;
+
+    ConstGenericSparseMatrix m_mat;
+    const Index m_n;
+    IterativeMethod m_method;
+    Scalar m_sigma;
+    Preconditioner m_precond;
+    Index m_maxit;            // maximum number of iterations of each solve
+    Scalar m_user_tol;        // tolerance set by the user
+    bool m_adaptive;          // whether the eigen solver may change the tolerance
+    Index m_nwarm;            // maximum number of previous solutions kept for the warm start
+    mutable Scalar m_tol;     // relative tolerance of the current solves
+    mutable Matrix m_prev_x;  // previous solutions, as a circular buffer
+    mutable Matrix m_prev_b;  // previous right hand sides
+    mutable Index m_nprev;    // number of stored solutions
+    mutable Index m_next;     // position of the next stored solution
+    mutable Index m_nsolve;   // number of solves
+    mutable Index m_niter;    // total number of iterations of the solves
+    mutable CompInfo m_info;  // status of the last solve
+
+    // y = (A - sigma * I) * x
+    void shifted_prod(const Vector& x, Vector& y) const
+    {
+        y.noalias() = m_mat.template selfadjointView<Uplo>() * x;
+        y.noalias() -= m_sigma * x;
+    }
+
+    // y = inv(M) * x
+    void precond(const Vector& x, Vector& y) const
+    {
+        if (m_precond)
+            m_precond(x.data(), y.data());
+        else
+            y.noalias() = x;
+    }
+
+    // Initial guess from the Galerkin projection onto the previous solutions X,
+    // using (A - sigma * I) * X ~= B to avoid extra matrix products
+    void warm_start(const Vector& b, Vector& x) const
+    {
+        x.setZero();
+        if (m_nprev < 1)
+            return;
+
+        const auto X = m_prev_x.leftCols(m_nprev);
+        const auto B = m_prev_b.leftCols(m_nprev);
+        Matrix G = X.transpose() * B;
+        G = Scalar(0.5) * (G + G.transpose()).eval();
+        const Vector c = X.transpose() * b;
+        Eigen::LDLT<Matrix> ldlt(G);
+        if (ldlt.info() != Eigen::Success)
+            return;
+        const Vector coef = ldlt.solve(c);
+        if (!coef.allFinite())
+            return;
+        x.noalias() = X * coef;
+    }
+
+    void store_solution(const Vector& b, const Vector& x) const
+    {
+        if (m_nwarm < 1)
+            return;
+        m_prev_x.col(m_next).noalias() = x;
+        m_prev_b.col(m_next).noalias() = b;
+        m_next = (m_next + 1) % m_nwarm;
+        m_nprev = (std::min)(m_nprev + 1, m_nwarm);
+    }
+
+    // Preconditioned MINRES, following the implementation in Eigen's unsupported module
+    // Returns the number of iterations
+    Index minres(const Vector& b, Vector& x, Vector& r) const
+    {
+        using std::sqrt;
+
+        const Scalar thresh2 = m_tol * m_tol * b.squaredNorm();
+        Scalar resid2 = r.squaredNorm();
+        if (resid2 <= thresh2)
+            return 0;
+
+        Vector v = Vector::Zero(m_n), v_old(m_n), v_new = r;
+        Vector w(m_n), w_new(m_n);
+        precond(v_new, w_new);
+        Scalar beta_new2 = v_new.dot(w_new);
+        if (beta_new2 <= Scalar(0))
+            throw std::invalid_argument("IterativeSymShiftSolve: the preconditioner must be positive definite");
+        Scalar beta_new = sqrt(beta_new2);
+        const Scalar beta_one = beta_new;
+
+        Scalar c = Scalar(1), c_old = Scalar(1), s = Scalar(0), s_old = Scalar(0), eta = Scalar(1);
+        Vector p = Vector::Zero(m_n), p_old = Vector::Zero(m_n), p_oold(m_n);
+
+        Index iter = 0;
+        while (iter < m_maxit)
+        {
+            iter++;
+            const Scalar beta = beta_new;
+            v_old.swap(v);
+            v_new /= beta_new;
+            w_new /= beta_new;
+            v.swap(v_new);
+            w.swap(w_new);
+
+            // Lanczos step
+            shifted_prod(w, v_new);
+            v_new.noalias() -= beta * v_old;
+            const Scalar alpha = v_new.dot(w);
+            v_new.noalias() -= alpha * v;
+            precond(v_new, w_new);
+            beta_new2 = v_new.dot(w_new);
+            if (beta_new2 < Scalar(0))
+                throw std::invalid_argument("IterativeSymShiftSolve: the preconditioner must be positive definite");
+            beta_new = sqrt(beta_new2);
+
+            // QR factorization of the tridiagonal matrix by Givens rotations
+            const Scalar c_oold = c_old;
+            c_old = c;
+            const Scalar s_oold = s_old;
+            s_old = s;
+            const Scalar r1_hat = c_old * alpha - c_oold * s_old * beta;
+            const Scalar r1 = sqrt(r1_hat * r1_hat + beta_new * beta_new);
+            const Scalar r2 = s_old * alpha + c_oold * c_old * beta;
+            const Scalar r3 = s_oold * beta;
+            if (r1 == Scalar(0))
+                break;
+            c = r1_hat / r1;
+            s = beta_new / r1;
+
+            // Update the solution
+            p_oold.swap(p_old);
+            p_old.swap(p);
+            p.noalias() = (w - r2 * p_old - r3 * p_oold) / r1;
+            x.noalias() += beta_one * c * eta * p;
+
+            resid2 *= s * s;
+            if (resid2 <= thresh2 || beta_new == Scalar(0))
+                break;
+            eta = -s * eta;
+        }
+        m_info = (resid2 <= thresh2 || beta_new == Scalar(0)) ? CompInfo::Successful : CompInfo::NotConverging;
+        return iter;
+    }
+
+    // Preconditioned conjugate gradient
+    // Returns the number of iterations
+    Index cg(const Vector& b, Vector& x, Vector& r) const
+    {
+        const Scalar thresh2 = m_tol * m_tol * b.squaredNorm();
+        Scalar resid2 = r.squaredNorm();
+        if (resid2 <= thresh2)
+            return 0;
+
+        Vector z(m_n), p(m_n), q(m_n);
+        precond(r, z);
+        p.noalias() = z;
+        Scalar rz = r.dot(z);
+
+        Index iter = 0;
+        while (iter < m_maxit)
+        {
+            iter++;
+            shifted_prod(p, q);
+            const Scalar pq = p.dot(q);
+            if (pq <= Scalar(0))
+                throw std::invalid_argument("IterativeSymShiftSolve: the shifted matrix is not positive definite, use MINRES instead");
+            const Scalar alpha = rz / pq;
+            x.noalias() += alpha * p;
+            r.noalias() -= alpha * q;
+            resid2 = r.squaredNorm();
+            if (resid2 <= thresh2)
+                break;
+
+            precond(r, z);
+            const Scalar rz_new = r.dot(z);
+            p = z + (rz_new / rz) * p;
+            rz = rz_new;
+        }
+        m_info = (resid2 <= thresh2) ? CompInfo::Successful : CompInfo::NotConverging;
+        return iter;
+    }
+
+public:
+    ///
+    /// Constructor to create the matrix operation object.
+    ///
+    /// \param mat    An **Eigen** sparse matrix object, whose type can be
+    ///               `Eigen::SparseMatrix<Scalar, ...>` or its mapped version
+    ///               `Eigen::Map<Eigen::SparseMatrix<Scalar, ...> >`.
+    /// \param method The Krylov method for the linear systems. The default is
+    ///               `IterativeMethod::MINRES`, which works for any shift.
+    ///
+    template <typename Derived>
+    IterativeSymShiftSolve(const Eigen::SparseMatrixBase<Derived>& mat, IterativeMethod method = IterativeMethod::MINRES) :
+        m_mat(mat), m_n(mat.rows()), m_method(method), m_sigma(0),
+        m_maxit(10 * mat.rows()), m_user_tol(Scalar(1e-12)), m_adaptive(true), m_nwarm(4),
+        m_tol(m_user_tol), m_prev_x(mat.rows(), 4), m_prev_b(mat.rows(), 4),
+        m_nprev(0), m_next(0), m_nsolve(0), m_niter(0), m_info(CompInfo::NotComputed)
+    {
+        static_assert(
+            static_cast<int>(Derived::PlainObject::IsRowMajor) == static_cast<int>(SparseMatrix::IsRowMajor),
+            "IterativeSymShiftSolve: the \"Flags\" template parameter does not match the input matrix (Eigen::ColMajor/Eigen::RowMajor)");
+
+        if (mat.rows() != mat.cols())
+            throw std::invalid_argument("IterativeSymShiftSolve: matrix must be square");
+    }
+
+    ///
+    /// Return the number of rows of the underlying matrix.
+    ///
+    Index rows() const { return m_n; }
+    ///
+    /// Return the number of columns of the underlying matrix.
+    ///
+    Index cols() const { return m_n; }
+
+    ///
+    /// Set the preconditioner, which approximates \f$|A-\sigma I|^{-1}\f$ and must be
+    /// symmetric positive definite, for example an incomplete Cholesky factorization
+    /// of \f$A-\tau I\f$ with \f$\tau\f$ below the spectrum. An empty function
+    /// disables preconditioning, which is the default.
+    ///
+    void set_preconditioner(const Preconditioner& precond) { m_precond = precond; }
+
+    ///
+    /// Set the relative tolerance \f$\|b-(A-\sigma I)y\|\le \mathrm{tol}\cdot\|b\|\f$
+    /// of the linear solves, 1e-12 by default. If adaptive tolerances are enabled,
+    /// this is the tolerance of solves that are not controlled by an eigen solver.
+    ///
+    void set_tolerance(const Scalar& tol)
+    {
+        if (tol <= Scalar(0))
+            throw std::invalid_argument("IterativeSymShiftSolve: tolerance must be positive");
+        m_user_tol = tol;
+        m_tol = tol;
+    }
+
+    ///
+    /// Set the maximum number of iterations of each linear solve,
+    /// \f$10n\f$ by default.
+    ///
+    void set_max_iterations(Index maxit)
+    {
+        if (maxit < 1)
+            throw std::invalid_argument("IterativeSymShiftSolve: maxit must be positive");
+        m_maxit = maxit;
+    }
+
+    ///
+    /// Set whether the eigen solver may adjust the tolerance of the linear solves
+    /// through set_inner_tolerance(), which is enabled by default. If disabled,
+    /// all solves use the tolerance given by set_tolerance().
+    ///
+    void set_adaptive_tolerance(bool adaptive)
+    {
+        m_adaptive = adaptive;
+        m_tol = m_user_tol;
+    }
+
+    ///
+    /// Set the number of previous solutions used to compute the initial guess
+    /// of each solve, 4 by default. Zero means starting from the zero vector.
+    ///
+    void set_warm_start(Index nprev)
+    {
+        if (nprev < 0)
+            throw std::invalid_argument("IterativeSymShiftSolve: nprev must be nonnegative");
+        m_nwarm = nprev;
+        m_prev_x.resize(m_n, nprev);
+        m_prev_b.resize(m_n, nprev);
+        m_nprev = 0;
+        m_next = 0;
+    }
+
+    ///
+    /// Set the real shift \f$\sigma\f$. No factorization is computed, so this is cheap.
+    ///
+    void set_shift(const Scalar& sigma)
+    {
+        m_sigma = sigma;
+        // Previous solutions belong to another matrix
+        m_nprev = 0;
+        m_next = 0;
+        m_tol = m_user_tol;
+    }
+
+    ///
+    /// Set the relative tolerance of the following solves. This is called by the
+    /// eigen solvers during the iterations, and is ignored if adaptive tolerances
+    /// are disabled. A nonpositive value restores the tolerance given by
+    /// set_tolerance(), which the eigen solvers do before `compute()` returns.
+    ///
+    /// \return Whether the tolerance is accepted.
+    ///
+    bool set_inner_tolerance(const Scalar& tol) const
+    {
+        if (m_adaptive)
+            m_tol = (tol > Scalar(0)) ? tol : m_user_tol;
+        return m_adaptive;
+    }
+
+    ///
+    /// Return the status of the last linear solve. `CompInfo::NotConverging`
+    /// means that the maximum number of iterations was reached.
+    ///
+    CompInfo info() const { return m_info; }
+
+    ///
+    /// Return the number of linear solves.
+    ///
+    Index num_solves() const { return m_nsolve; }
+
+    ///
+    /// Return the total number of iterations of the linear solves.
+    ///
+    Index num_iterations() const { return m_niter; }
+
+    ///
+    /// Reset the counters of solves and iterations.
+    ///
+    void reset_counters()
+    {
+        m_nsolve = 0;
+        m_niter = 0;
+    }
+
+    ///
+    /// Perform the shift-solve operation \f$y=(A-\sigma I)^{-1}x\f$ approximately.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    // y_out ~= inv(A - sigma * I) * x_in
+    void perform_op(const Scalar* x_in, Scalar* y_out) const
+    {
+        SPECTRA_TRACE_SCOPE("IterativeSymShiftSolve::perform_op");
+
+        const Vector b = MapConstVec(x_in, m_n);
+        Vector x(m_n), r(m_n);
+
+        // Warm start, falling back to zero if the residual does not decrease
+        warm_start(b, x);
+        if (m_nprev > 0)
+        {
+            shifted_prod(x, r);
+            r = b - r;
+            if (r.squaredNorm() >= b.squaredNorm())
+            {
+                x.setZero();
+                r.noalias() = b;
+            }
+        }
+        else
+        {
+            r.noalias() = b;
+        }
+
+        const Index iter = (m_method == IterativeMethod::CG) ? cg(b, x, r) : minres(b, x, r);
+        if (iter == 0)
+            m_info = CompInfo::Successful;
+        m_nsolve++;
+        m_niter += iter;
+
+        store_solution(b, x);
+        MapVec(y_out, m_n).noalias() = x;
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_ITERATIVE_SYM_SHIFT_SOLVE_H
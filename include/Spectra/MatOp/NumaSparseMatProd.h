@@ -0,0 +1,214 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_NUMA_SPARSE_MAT_PROD_H
+#define SPECTRA_NUMA_SPARSE_MAT_PROD_H
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <vector>       // std::vector
+#include <memory>       // std::unique_ptr
+#include <algorithm>    // std::fill
+#include <type_traits>  // std::integral_constant
+
+#include "../Util/NumaExecutor.h"
+
+namespace Spectra {
+
+///
+/// \ingroup MatOp
+///
+/// This class defines the matrix-vector multiplication operation on a sparse
+/// real matrix \f$A\f$, i.e., calculating \f$y=Ax\f$ for any vector \f$x\f$,
+/// with the matrix distributed over the NUMA nodes of the machine.
+///
+/// The rows are split into one block per thread, with balanced numbers of nonzero
+/// elements. The threads are pinned to CPUs by a NumaExecutor, and each block is
+/// copied by the thread that later multiplies it, so that the operating system
+/// places its memory on the node of that thread (first-touch placement). The
+/// block of \f$y\f$ computed by a thread is node-local as well.
+///
+/// The operator also provides the `first_touch()` member function, which the
+/// Arnoldi and Lanczos factorizations call on their Krylov basis and residual
+/// vector when new memory is allocated for them. The rows of these vectors are then
+/// placed with the same partition as the matrix, so that each thread writes its block
+/// of \f$y\f$ to node-local memory. Memory reused by a later initialization of the
+/// same size keeps its placement. The orthogonalization steps run on the calling
+/// thread, and do not benefit from the partition.
+///
+/// \tparam Scalar_ The element type of the matrix, for example,
+///                 `float`, `double`, and `long double`.
+/// \tparam Uplo    Either 0 for a general matrix, or `Eigen::Lower` or `Eigen::Upper`
+///                 for a symmetric matrix of which only the lower or upper triangular
+///                 part is referenced, as in SparseSymMatProd.
+///
+template <typename Scalar_, int Uplo = 0>
+class NumaSparseMatProd
+{
+public:
+    ///
+    /// Element type of the matrix.
+    ///
+    using Scalar = Scalar_;
+
+private:
+    using Index = Eigen::Index;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using MapConstVec = Eigen::Map<const Vector>;
+    using MapVec = Eigen::Map<Vector>;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using RowMatrix = Eigen::SparseMatrix<Scalar, Eigen::RowMajor, int>;
+
+    Index m_rows;                          // number of rows
+    Index m_cols;                          // number of columns
+    std::unique_ptr<NumaExecutor> m_exec;  // pinned worker threads
+    std::vector<Index> m_part;             // row boundaries of the blocks
+    std::vector<RowMatrix> m_blocks;       // row blocks, each allocated by its thread
+
+    template <typename Derived>
+    static RowMatrix full_matrix(const Eigen::SparseMatrixBase<Derived>& mat, std::false_type)
+    {
+        return mat;
+    }
+
+    template <typename Derived>
+    static RowMatrix full_matrix(const Eigen::SparseMatrixBase<Derived>& mat, std::true_type)
+    {
+        RowMatrix res = mat.template selfadjointView<Uplo>();
+        return res;
+    }
+
+    template <typename Derived>
+    void distribute(const Eigen::SparseMatrixBase<Derived>& mat)
+    {
+        // The input is converted once, and the blocks are copied from it in parallel
+        RowMatrix full = full_matrix(mat, std::integral_constant<bool, Uplo != 0>());
+        full.makeCompressed();
+        m_rows = full.rows();
+        m_cols = full.cols();
+
+        // Blocks with balanced numbers of nonzero elements
+        const int nblock = m_exec->num_threads();
+        const int* outer = full.outerIndexPtr();
+        const double total = double(full.nonZeros());
+        m_part.assign(nblock + 1, m_rows);
+        m_part[0] = 0;
+        Index i = 0;
+        for (int k = 1; k < nblock; k++)
+        {
+            const double target = total * k / nblock;
+            while (i < m_rows && double(outer[i]) < target)
+                i++;
+            m_part[k] = i;
+        }
+
+        m_blocks.resize(nblock);
+        m_exec->run([this, &full](int k) {
+            m_blocks[k] = full.middleRows(m_part[k], m_part[k + 1] - m_part[k]);
+            m_blocks[k].makeCompressed();
+        });
+    }
+
+public:
+    ///
+    /// Constructor to create the matrix operation object.
+    ///
+    /// \param mat     An **Eigen** sparse matrix object, whose type can be
+    ///                `Eigen::SparseMatrix<Scalar, ...>` or its mapped version
+    ///                `Eigen::Map<Eigen::SparseMatrix<Scalar, ...> >`. It is copied,
+    ///                and does not need to be kept alive.
+    /// \param nthread Number of threads, pinned to CPUs \f$0,1,\ldots,n-1\f$. If it is not
+    ///                positive, the number of hardware threads is used.
+    ///
+    template <typename Derived>
+    NumaSparseMatProd(const Eigen::SparseMatrixBase<Derived>& mat, int nthread = 0) :
+        m_exec(new NumaExecutor(nthread))
+    {
+        distribute(mat);
+    }
+
+    ///
+    /// Constructor to create the matrix operation object, with one thread for each
+    /// CPU in a given list. CPUs of the same node should be listed next to each other.
+    ///
+    template <typename Derived>
+    NumaSparseMatProd(const Eigen::SparseMatrixBase<Derived>& mat, const std::vector<int>& cpus) :
+        m_exec(new NumaExecutor(cpus))
+    {
+        distribute(mat);
+    }
+
+    ///
+    /// Return the number of rows of the underlying matrix.
+    ///
+    Index rows() const { return m_rows; }
+    ///
+    /// Return the number of columns of the underlying matrix.
+    ///
+    Index cols() const { return m_cols; }
+
+    ///
+    /// Number of threads, which is also the number of row blocks.
+    ///
+    int num_threads() const { return m_exec->num_threads(); }
+
+    ///
+    /// Row boundaries of the blocks, where block \f$k\f$ contains the rows
+    /// \f$[p_k, p_{k+1})\f$.
+    ///
+    const std::vector<Index>& partition() const { return m_part; }
+
+    ///
+    /// Zeros the rows of a column-major array on the threads that own them, so that
+    /// the memory of each block of rows is placed on the node of its thread. This only
+    /// has an effect on memory that has not been written before.
+    ///
+    /// \param data Pointer to the array.
+    /// \param rows Number of rows, which must be equal to `rows()`.
+    /// \param cols Number of columns.
+    ///
+    void first_touch(Scalar* data, Index rows, Index cols) const
+    {
+        if (rows != m_rows)
+            return;
+        m_exec->run([this, data, rows, cols](int k) {
+            for (Index j = 0; j < cols; j++)
+                std::fill(data + j * rows + m_part[k], data + j * rows + m_part[k + 1], Scalar(0));
+        });
+    }
+
+    ///
+    /// Perform the matrix-vector multiplication operation \f$y=Ax\f$.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    // y_out = A * x_in
+    void perform_op(const Scalar* x_in, Scalar* y_out) const
+    {
+        MapConstVec x(x_in, m_cols);
+        m_exec->run([this, &x, y_out](int k) {
+            MapVec y(y_out + m_part[k], m_part[k + 1] - m_part[k]);
+            y.noalias() = m_blocks[k] * x;
+        });
+    }
+
+    ///
+    /// Perform the matrix-matrix multiplication operation \f$y=Ax\f$.
+    ///
+    Matrix operator*(const Eigen::Ref<const Matrix>& mat_in) const
+    {
+        Matrix res(m_rows, mat_in.cols());
+        m_exec->run([this, &mat_in, &res](int k) {
+            res.middleRows(m_part[k], m_part[k + 1] - m_part[k]).noalias() = m_blocks[k] * mat_in;
+        });
+        return res;
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_NUMA_SPARSE_MAT_PROD_H
@@ -0,0 +1,599 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_OP_ALGEBRA_H
+#define SPECTRA_OP_ALGEBRA_H
+
+#include <Eigen/Core>
+#include <type_traits>  // std::is_base_of, std::conditional, std::integral_constant
+#include <algorithm>    // std::max
+#include <stdexcept>    // std::invalid_argument
+
+namespace Spectra {
+
+///
+/// \defgroup OpAlgebra Operator Algebra
+///
+/// Combinators that build new matrix operation classes from existing ones, for example
+/// \f$\alpha A+\beta B\f$, \f$AB\f$, \f$A'A\f$, \f$D_1AD_2\f$, \f$A-\sigma I\f$, and
+/// \f$(I-YY')A(I-YY')\f$. The results implement `rows()`, `cols()`, `perform_op()`, and
+/// the block product `operator*()`, so they can be used as the `OpType` of the eigen
+/// solvers, and they can be nested arbitrarily.
+///
+/// The expressions are composed as templates without virtual functions. Internally each
+/// expression evaluates the fused update \f$y\leftarrow aMx+by\f$, so scalings and sums
+/// are passed down to the operands instead of being applied in separate passes, and the
+/// shifts, diagonal scalings, and projections are applied in a single pass over the
+/// result of the operand. The intermediate vectors are kept in scratch buffers that are
+/// allocated once and reused in all calls, so an expression object must not be used
+/// by multiple threads at the same time.
+///
+/// User-defined operators can be used as operands if they implement the type definition
+/// `Scalar`, and the member functions `rows()`, `cols()`, and `perform_op()` as in
+/// DenseGenMatProd. The transpose of an operator additionally requires
+/// `transpose_perform_op()`, which computes \f$y=A'x\f$.
+///
+/// Plain operators are stored in the expressions by reference, so they must be kept alive
+/// while the expressions are in use. Sub-expressions are stored by value.
+///
+
+///
+/// \ingroup OpAlgebra
+///
+/// Base class of all operator expressions.
+///
+struct OpExprTag
+{};
+
+// Storage type of an operand: expressions are stored by value, and other operators by reference
+template <typename Op>
+using OpNested = typename std::conditional<std::is_base_of<OpExprTag, Op>::value, const Op, const Op&>::type;
+
+// Evaluates y <- a * M * x + b * y, where M is op, or its transpose if Transpose is true
+// If b is zero, y is not read
+// For plain operators, `work` is used as a scratch buffer if b is nonzero
+// Only the direction that is used is instantiated, so plain operators need not
+// implement transpose_perform_op() unless their transposes are used
+template <typename Op, bool IsExpr = std::is_base_of<OpExprTag, Op>::value>
+class OpEval
+{
+private:
+    using Scalar = typename Op::Scalar;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using MapVec = Eigen::Map<Vector>;
+
+    static void call(const Op& op, const Scalar* x, Scalar* y, std::false_type) { op.perform_op(x, y); }
+    static void call(const Op& op, const Scalar* x, Scalar* y, std::true_type) { op.transpose_perform_op(x, y); }
+
+public:
+    template <bool Transpose>
+    static void eval(const Op& op, const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b, Vector& work)
+    {
+        using Dir = std::integral_constant<bool, Transpose>;
+        const Eigen::Index n = Transpose ? op.cols() : op.rows();
+        MapVec yvec(y, n);
+        if (b == Scalar(0))
+        {
+            call(op, x, y, Dir());
+            if (a != Scalar(1))
+                yvec *= a;
+            return;
+        }
+        work.resize(n);
+        call(op, x, work.data(), Dir());
+        yvec = a * work + b * yvec;
+    }
+};
+
+template <typename Op>
+class OpEval<Op, true>
+{
+private:
+    using Scalar = typename Op::Scalar;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+    static void call(const Op& op, const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b, std::false_type)
+    {
+        op.apply(x, y, a, b);
+    }
+    static void call(const Op& op, const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b, std::true_type)
+    {
+        op.apply_transpose(x, y, a, b);
+    }
+
+public:
+    template <bool Transpose>
+    static void eval(const Op& op, const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b, Vector&)
+    {
+        call(op, x, y, a, b, std::integral_constant<bool, Transpose>());
+    }
+};
+
+///
+/// \ingroup OpAlgebra
+///
+/// Common interface of the operator expressions. `Derived` implements the fused updates
+/// `apply(x, y, a, b)` and `apply_transpose(x, y, a, b)`, which compute
+/// \f$y\leftarrow aMx+by\f$ and \f$y\leftarrow aM'x+by\f$, respectively.
+///
+template <typename Derived, typename Scalar_>
+class OpExpr : public OpExprTag
+{
+public:
+    ///
+    /// Element type of the operator.
+    ///
+    using Scalar = Scalar_;
+
+private:
+    using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+
+    const Derived& derived() const { return static_cast<const Derived&>(*this); }
+
+public:
+    ///
+    /// Perform the matrix-vector multiplication operation \f$y=Mx\f$.
+    ///
+    void perform_op(const Scalar* x_in, Scalar* y_out) const
+    {
+        derived().apply(x_in, y_out, Scalar(1), Scalar(0));
+    }
+
+    ///
+    /// Perform the transposed multiplication operation \f$y=M'x\f$.
+    ///
+    void transpose_perform_op(const Scalar* x_in, Scalar* y_out) const
+    {
+        derived().apply_transpose(x_in, y_out, Scalar(1), Scalar(0));
+    }
+
+    ///
+    /// Perform the matrix-matrix multiplication operation \f$Y=MX\f$.
+    ///
+    Matrix operator*(const Eigen::Ref<const Matrix>& mat_in) const
+    {
+        const Index ncol = mat_in.cols();
+        Matrix res(derived().rows(), ncol);
+        // Copy each column in case mat_in is not contiguous
+        Eigen::Matrix<Scalar, Eigen::Dynamic, 1> x(mat_in.rows());
+        for (Index j = 0; j < ncol; j++)
+        {
+            x.noalias() = mat_in.col(j);
+            derived().apply(x.data(), res.col(j).data(), Scalar(1), Scalar(0));
+        }
+        return res;
+    }
+};
+
+///
+/// \ingroup OpAlgebra
+///
+/// The operator \f$\alpha A\f$. Created by op_scale().
+///
+template <typename OpA>
+class OpScale : public OpExpr<OpScale<OpA>, typename OpA::Scalar>
+{
+public:
+    using Scalar = typename OpA::Scalar;
+
+private:
+    using Index = Eigen::Index;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+    OpNested<OpA> m_a;
+    const Scalar m_alpha;
+    mutable Vector m_work;
+
+public:
+    OpScale(const OpA& a, const Scalar& alpha) :
+        m_a(a), m_alpha(alpha)
+    {}
+
+    Index rows() const { return m_a.rows(); }
+    Index cols() const { return m_a.cols(); }
+
+    void apply(const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b) const
+    {
+        OpEval<OpA>::template eval<false>(m_a, x, y, a * m_alpha, b, m_work);
+    }
+    void apply_transpose(const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b) const
+    {
+        OpEval<OpA>::template eval<true>(m_a, x, y, a * m_alpha, b, m_work);
+    }
+};
+
+///
+/// \ingroup OpAlgebra
+///
+/// The operator \f$\alpha A+\beta B\f$. Created by op_sum().
+///
+template <typename OpA, typename OpB>
+class OpSum : public OpExpr<OpSum<OpA, OpB>, typename OpA::Scalar>
+{
+public:
+    using Scalar = typename OpA::Scalar;
+
+private:
+    using Index = Eigen::Index;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+    OpNested<OpA> m_a;
+    OpNested<OpB> m_b;
+    const Scalar m_alpha;
+    const Scalar m_beta;
+    mutable Vector m_work;
+
+public:
+    OpSum(const OpA& a, const OpB& b, const Scalar& alpha, const Scalar& beta) :
+        m_a(a), m_b(b), m_alpha(alpha), m_beta(beta)
+    {
+        if (a.rows() != b.rows() || a.cols() != b.cols())
+            throw std::invalid_argument("OpSum: operators must have the same dimensions");
+    }
+
+    Index rows() const { return m_a.rows(); }
+    Index cols() const { return m_a.cols(); }
+
+    // Both terms accumulate into y, so no temporary vector is needed for expressions
+    void apply(const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b) const
+    {
+        OpEval<OpA>::template eval<false>(m_a, x, y, a * m_alpha, b, m_work);
+        OpEval<OpB>::template eval<false>(m_b, x, y, a * m_beta, Scalar(1), m_work);
+    }
+    void apply_transpose(const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b) const
+    {
+        OpEval<OpA>::template eval<true>(m_a, x, y, a * m_alpha, b, m_work);
+        OpEval<OpB>::template eval<true>(m_b, x, y, a * m_beta, Scalar(1), m_work);
+    }
+};
+
+///
+/// \ingroup OpAlgebra
+///
+/// The operator \f$A-\sigma I\f$. Created by op_shift().
+///
+template <typename OpA>
+class OpShift : public OpExpr<OpShift<OpA>, typename OpA::Scalar>
+{
+public:
+    using Scalar = typename OpA::Scalar;
+
+private:
+    using Index = Eigen::Index;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using MapConstVec = Eigen::Map<const Vector>;
+    using MapVec = Eigen::Map<Vector>;
+
+    OpNested<OpA> m_a;
+    const Scalar m_sigma;
+    mutable Vector m_work;
+
+public:
+    OpShift(const OpA& a, const Scalar& sigma) :
+        m_a(a), m_sigma(sigma)
+    {
+        if (a.rows() != a.cols())
+            throw std::invalid_argument("OpShift: operator must be square");
+    }
+
+    Index rows() const { return m_a.rows(); }
+    Index cols() const { return m_a.cols(); }
+
+    void apply(const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b) const
+    {
+        OpEval<OpA>::template eval<false>(m_a, x, y, a, b, m_work);
+        MapVec(y, rows()) -= (a * m_sigma) * MapConstVec(x, rows());
+    }
+    void apply_transpose(const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b) const
+    {
+        OpEval<OpA>::template eval<true>(m_a, x, y, a, b, m_work);
+        MapVec(y, rows()) -= (a * m_sigma) * MapConstVec(x, rows());
+    }
+};
+
+///
+/// \ingroup OpAlgebra
+///
+/// The operator \f$AB\f$. Created by op_product().
+///
+template <typename OpA, typename OpB>
+class OpProduct : public OpExpr<OpProduct<OpA, OpB>, typename OpA::Scalar>
+{
+public:
+    using Scalar = typename OpA::Scalar;
+
+private:
+    using Index = Eigen::Index;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+    OpNested<OpA> m_a;
+    OpNested<OpB> m_b;
+    mutable Vector m_mid;  // B * x or A' * x
+    mutable Vector m_work;
+
+public:
+    OpProduct(const OpA& a, const OpB& b) :
+        m_a(a), m_b(b), m_mid(a.cols())
+    {
+        if (a.cols() != b.rows())
+            throw std::invalid_argument("OpProduct: operators have incompatible dimensions");
+    }
+
+    Index rows() const { return m_a.rows(); }
+    Index cols() const { return m_b.cols(); }
+
+    void apply(const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b) const
+    {
+        OpEval<OpB>::template eval<false>(m_b, x, m_mid.data(), Scalar(1), Scalar(0), m_work);
+        OpEval<OpA>::template eval<false>(m_a, m_mid.data(), y, a, b, m_work);
+    }
+    // (AB)' = B'A'
+    void apply_transpose(const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b) const
+    {
+        OpEval<OpA>::template eval<true>(m_a, x, m_mid.data(), Scalar(1), Scalar(0), m_work);
+        OpEval<OpB>::template eval<true>(m_b, m_mid.data(), y, a, b, m_work);
+    }
+};
+
+///
+/// \ingroup OpAlgebra
+///
+/// The operator \f$A'\f$. Created by op_transpose().
+///
+template <typename OpA>
+class OpTranspose : public OpExpr<OpTranspose<OpA>, typename OpA::Scalar>
+{
+public:
+    using Scalar = typename OpA::Scalar;
+
+private:
+    using Index = Eigen::Index;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+    OpNested<OpA> m_a;
+    mutable Vector m_work;
+
+public:
+    OpTranspose(const OpA& a) :
+        m_a(a)
+    {}
+
+    Index rows() const { return m_a.cols(); }
+    Index cols() const { return m_a.rows(); }
+
+    void apply(const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b) const
+    {
+        OpEval<OpA>::template eval<true>(m_a, x, y, a, b, m_work);
+    }
+    void apply_transpose(const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b) const
+    {
+        OpEval<OpA>::template eval<false>(m_a, x, y, a, b, m_work);
+    }
+};
+
+///
+/// \ingroup OpAlgebra
+///
+/// The operator \f$D_1AD_2\f$, where \f$D_1\f$ and \f$D_2\f$ are diagonal matrices.
+/// Created by op_diag_scale().
+///
+template <typename OpA>
+class OpDiagScale : public OpExpr<OpDiagScale<OpA>, typename OpA::Scalar>
+{
+public:
+    using Scalar = typename OpA::Scalar;
+
+private:
+    using Index = Eigen::Index;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using MapConstVec = Eigen::Map<const Vector>;
+    using MapVec = Eigen::Map<Vector>;
+
+    OpNested<OpA> m_a;
+    const Vector m_dl;     // diagonal of D1
+    const Vector m_dr;     // diagonal of D2
+    mutable Vector m_in;   // D2 * x or D1 * x
+    mutable Vector m_out;  // A * D2 * x or A' * D1 * x
+    mutable Vector m_work;
+
+    // y <- a * dout .* (M * (din .* x)) + b * y, where M is A or A'
+    template <bool Transpose>
+    void apply_impl(const Vector& din, const Vector& dout, const Scalar* x, Scalar* y,
+                    const Scalar& a, const Scalar& b) const
+    {
+        const Index nin = din.size(), nout = dout.size();
+        m_in.head(nin).noalias() = din.cwiseProduct(MapConstVec(x, nin));
+        OpEval<OpA>::template eval<Transpose>(m_a, m_in.data(), m_out.data(), Scalar(1), Scalar(0), m_work);
+        MapVec yvec(y, nout);
+        if (b == Scalar(0))
+            yvec.noalias() = a * dout.cwiseProduct(m_out.head(nout));
+        else
+            yvec = a * dout.cwiseProduct(m_out.head(nout)) + b * yvec;
+    }
+
+public:
+    OpDiagScale(const OpA& a, const Vector& dl, const Vector& dr) :
+        m_a(a), m_dl(dl), m_dr(dr)
+    {
+        if (dl.size() != a.rows() || dr.size() != a.cols())
+            throw std::invalid_argument("OpDiagScale: diagonal matrices have incompatible dimensions");
+        // The buffers are shared by A and A'
+        m_in.resize((std::max)(a.rows(), a.cols()));
+        m_out.resize((std::max)(a.rows(), a.cols()));
+    }
+
+    Index rows() const { return m_a.rows(); }
+    Index cols() const { return m_a.cols(); }
+
+    void apply(const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b) const
+    {
+        apply_impl<false>(m_dr, m_dl, x, y, a, b);
+    }
+    // (D1 * A * D2)' = D2 * A' * D1
+    void apply_transpose(const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b) const
+    {
+        apply_impl<true>(m_dl, m_dr, x, y, a, b);
+    }
+};
+
+///
+/// \ingroup OpAlgebra
+///
+/// The operator \f$PAP\f$, where \f$P=I-YY'\f$ is the orthogonal projection onto the
+/// complement of the columns of \f$Y\f$, which should be orthonormal.
+/// Created by op_project().
+///
+template <typename OpA>
+class OpProject : public OpExpr<OpProject<OpA>, typename OpA::Scalar>
+{
+public:
+    using Scalar = typename OpA::Scalar;
+
+private:
+    using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using MapConstVec = Eigen::Map<const Vector>;
+    using MapVec = Eigen::Map<Vector>;
+    using ConstGenericMatrix = const Eigen::Ref<const Matrix>;
+
+    OpNested<OpA> m_a;
+    ConstGenericMatrix m_y;
+    mutable Vector m_in;    // P * x
+    mutable Vector m_out;   // A * P * x
+    mutable Vector m_coef;  // Y' * v
+    mutable Vector m_work;
+
+    template <bool Transpose>
+    void apply_impl(const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b) const
+    {
+        const Index n = m_y.rows();
+        MapConstVec xvec(x, n);
+        m_coef.noalias() = m_y.transpose() * xvec;
+        m_in.noalias() = xvec - m_y * m_coef;
+        OpEval<OpA>::template eval<Transpose>(m_a, m_in.data(), m_out.data(), Scalar(1), Scalar(0), m_work);
+        m_coef.noalias() = m_y.transpose() * m_out;
+        m_out.noalias() -= m_y * m_coef;
+        MapVec yvec(y, n);
+        if (b == Scalar(0))
+            yvec.noalias() = a * m_out;
+        else
+            yvec = a * m_out + b * yvec;
+    }
+
+public:
+    ///
+    /// \param a  The operator \f$A\f$, which must be square.
+    /// \param y  A matrix with orthonormal columns. It is stored by reference.
+    ///
+    OpProject(const OpA& a, ConstGenericMatrix& y) :
+        m_a(a), m_y(y), m_in(y.rows()), m_out(y.rows()), m_coef(y.cols())
+    {
+        if (a.rows() != a.cols() || y.rows() != a.rows())
+            throw std::invalid_argument("OpProject: operator and projection have incompatible dimensions");
+    }
+
+    Index rows() const { return m_a.rows(); }
+    Index cols() const { return m_a.cols(); }
+
+    void apply(const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b) const
+    {
+        apply_impl<false>(x, y, a, b);
+    }
+    void apply_transpose(const Scalar* x, Scalar* y, const Scalar& a, const Scalar& b) const
+    {
+        apply_impl<true>(x, y, a, b);
+    }
+};
+
+///
+/// \ingroup OpAlgebra
+///
+/// Returns the operator \f$\alpha A\f$.
+///
+template <typename OpA>
+OpScale<OpA> op_scale(const OpA& a, const typename OpA::Scalar& alpha)
+{
+    return OpScale<OpA>(a, alpha);
+}
+
+///
+/// \ingroup OpAlgebra
+///
+/// Returns the operator \f$\alpha A+\beta B\f$.
+///
+template <typename OpA, typename OpB>
+OpSum<OpA, OpB> op_sum(const OpA& a, const OpB& b,
+                       const typename OpA::Scalar& alpha = 1, const typename OpA::Scalar& beta = 1)
+{
+    return OpSum<OpA, OpB>(a, b, alpha, beta);
+}
+
+///
+/// \ingroup OpAlgebra
+///
+/// Returns the operator \f$A-\sigma I\f$.
+///
+template <typename OpA>
+OpShift<OpA> op_shift(const OpA& a, const typename OpA::Scalar& sigma)
+{
+    return OpShift<OpA>(a, sigma);
+}
+
+///
+/// \ingroup OpAlgebra
+///
+/// Returns the operator \f$AB\f$.
+///
+template <typename OpA, typename OpB>
+OpProduct<OpA, OpB> op_product(const OpA& a, const OpB& b)
+{
+    return OpProduct<OpA, OpB>(a, b);
+}
+
+///
+/// \ingroup OpAlgebra
+///
+/// Returns the operator \f$A'\f$.
+///
+template <typename OpA>
+OpTranspose<OpA> op_transpose(const OpA& a)
+{
+    return OpTranspose<OpA>(a);
+}
+
+///
+/// \ingroup OpAlgebra
+///
+/// Returns the operator \f$D_1AD_2\f$, where `dl` and `dr` are the diagonal elements
+/// of \f$D_1\f$ and \f$D_2\f$. For example, \f$D^{-1/2}AD^{-1/2}\f$ is obtained with
+/// `dl = dr = d.cwiseSqrt().cwiseInverse()`.
+///
+template <typename OpA>
+OpDiagScale<OpA> op_diag_scale(const OpA& a,
+                               const Eigen::Matrix<typename OpA::Scalar, Eigen::Dynamic, 1>& dl,
+                               const Eigen::Matrix<typename OpA::Scalar, Eigen::Dynamic, 1>& dr)
+{
+    return OpDiagScale<OpA>(a, dl, dr);
+}
+
+///
+/// \ingroup OpAlgebra
+///
+/// Returns the operator \f$(I-YY')A(I-YY')\f$, where \f$Y\f$ has orthonormal columns.
+/// \f$Y\f$ is stored by reference.
+///
+template <typename OpA>
+OpProject<OpA> op_project(const OpA& a,
+                          const Eigen::Ref<const Eigen::Matrix<typename OpA::Scalar, Eigen::Dynamic, Eigen::Dynamic>>& y)
+{
+    return OpProject<OpA>(a, y);
+}
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_OP_ALGEBRA_H
@@ -0,0 +1,155 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_SHIFT_SOLVE_PIPELINE_H
+#define SPECTRA_SHIFT_SOLVE_PIPELINE_H
+
+#include <Eigen/Core>
+#include <vector>     // std::vector
+#include <memory>     // std::unique_ptr
+#include <future>     // std::shared_future
+#include <algorithm>  // std::min
+#include <stdexcept>  // std::invalid_argument, std::logic_error
+
+namespace Spectra {
+
+///
+/// \ingroup MatOp
+///
+/// This class pipelines the factorizations of a shift-solve operator over a
+/// sequence of shifts \f$\sigma_0,\sigma_1,\ldots\f$, as in spectrum slicing and
+/// frequency sweeps. While the eigen solver runs with \f$\sigma_k\f$, the
+/// factorizations of the next shifts are computed on background threads.
+///
+/// The pipeline owns `depth` operator objects, and each of them holds one
+/// factorization, so at most `depth` factorizations are kept in memory at the
+/// same time, and at most `depth - 1` are computed in the background.
+///
+/// \tparam OpType The shift-solve operator, which must provide `set_shift_async()`,
+///                for example DenseSymShiftSolve, SparseSymShiftSolve,
+///                DenseGenRealShiftSolve, SparseGenRealShiftSolve, and SymShiftInvert.
+///
+/// Example:
+/// \code{.cpp}
+/// std::vector<double> shifts{0.1, 0.2, 0.3, 0.4};
+/// // Factorize up to two shifts ahead of the running solver
+/// ShiftSolvePipeline<SparseSymShiftSolve<double>> pipeline(shifts, 3, A);
+/// while (pipeline.has_next())
+/// {
+///     SparseSymShiftSolve<double>& op = pipeline.next();
+///     // The constructor waits for the factorization of the current shift
+///     SymEigsShiftSolver<SparseSymShiftSolve<double>> eigs(op, 5, 20, pipeline.shift());
+///     eigs.init();
+///     eigs.compute(SortRule::LargestMagn);
+/// }
+/// \endcode
+///
+template <typename OpType>
+class ShiftSolvePipeline
+{
+public:
+    using Scalar = typename OpType::Scalar;
+
+private:
+    using Index = Eigen::Index;
+
+    std::vector<Scalar> m_shifts;
+    std::vector<std::unique_ptr<OpType>> m_ops;  // m_ops[k % depth] is used by shift k
+    std::vector<std::shared_future<void>> m_futures;
+    Index m_current;   // index of the current shift, -1 before the first call of next()
+    Index m_launched;  // number of shifts whose factorizations have been launched
+
+    Index depth() const { return Index(m_ops.size()); }
+
+    // Launch the factorizations of the shifts that fit into the free slots
+    void launch()
+    {
+        // The slot of shift k is reused by shift k + depth, after the caller
+        // has moved to shift k + 1
+        const Index end = (std::min)(Index(m_shifts.size()), m_current + depth());
+        for (; m_launched < end; m_launched++)
+        {
+            const Index slot = m_launched % depth();
+            m_futures[slot] = m_ops[slot]->set_shift_async(m_shifts[m_launched]);
+        }
+    }
+
+public:
+    ///
+    /// Constructor to create the pipeline and start the first factorizations.
+    ///
+    /// \param shifts The sequence of shifts.
+    /// \param depth  Number of operator objects, at least 1. The factorizations of
+    ///               the next `depth - 1` shifts are computed ahead of the current one.
+    /// \param args   Arguments passed to the constructor of `OpType`, typically
+    ///               the matrix or matrices.
+    ///
+    template <typename... Args>
+    ShiftSolvePipeline(const std::vector<Scalar>& shifts, Index depth, const Args&... args) :
+        m_shifts(shifts), m_current(-1), m_launched(0)
+    {
+        if (depth < 1)
+            throw std::invalid_argument("ShiftSolvePipeline: depth must be at least 1");
+
+        depth = (std::min)(depth, (std::max)(Index(1), Index(shifts.size())));
+        for (Index i = 0; i < depth; i++)
+            m_ops.emplace_back(new OpType(args...));
+        m_futures.resize(depth);
+        // Start the factorizations of the first shifts
+        m_current = 0;
+        launch();
+        m_current = -1;
+    }
+
+    ///
+    /// Number of shifts.
+    ///
+    Index size() const { return Index(m_shifts.size()); }
+
+    ///
+    /// Whether there are shifts left.
+    ///
+    bool has_next() const { return m_current + 1 < size(); }
+
+    ///
+    /// Move to the next shift. This launches the factorizations of the following
+    /// shifts, waits for the factorization of the current one, and returns its
+    /// operator. The operator returned by the previous call must no longer be used.
+    ///
+    /// If the factorization of the current shift failed, its exception is rethrown.
+    /// The pipeline can still move on to the following shifts.
+    ///
+    OpType& next()
+    {
+        if (!has_next())
+            throw std::logic_error("ShiftSolvePipeline: no shift left");
+
+        m_current++;
+        launch();
+        const Index slot = m_current % depth();
+        m_futures[slot].get();
+        return *m_ops[slot];
+    }
+
+    ///
+    /// The current shift, i.e., the shift of the operator returned by next().
+    ///
+    Scalar shift() const
+    {
+        if (m_current < 0)
+            throw std::logic_error("ShiftSolvePipeline: need to call next() first");
+        return m_shifts[m_current];
+    }
+
+    ///
+    /// Index of the current shift in the sequence.
+    ///
+    Index index() const { return m_current; }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_SHIFT_SOLVE_PIPELINE_H
@@ -0,0 +1,346 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_SPARSE_AUTO_MAT_PROD_H
+#define SPECTRA_SPARSE_AUTO_MAT_PROD_H
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <vector>     // std::vector
+#include <string>     // std::string
+#include <fstream>    // std::ifstream, std::ofstream
+#include <sstream>    // std::istringstream
+#include <chrono>     // std::chrono::steady_clock
+#include <cstdint>    // std::uint64_t
+#include <cstdio>     // std::snprintf
+#include <algorithm>  // std::min
+#include <utility>    // std::move
+
+#include "../LinAlg/SparseKernel.h"
+#include "../Util/ThreadPool.h"
+#include "../Util/Trace.h"
+
+namespace Spectra {
+
+///
+/// \ingroup MatOp
+///
+/// This class defines the matrix-vector multiplication operation on a sparse
+/// real matrix \f$A\f$, i.e., calculating \f$y=Ax\f$ for any vector \f$x\f$,
+/// using the fastest kernel for the matrix and the machine. It can be used
+/// in place of SparseGenMatProd and SparseSymMatProd.
+///
+/// At construction, the candidate formats of SparseFormat are combined with
+/// 1, 2, 4, ... threads up to a maximum, and each candidate is timed on a few
+/// sample products within a total time budget. The fastest one is kept. The
+/// SparseFormat::Pattern candidate is only tried if all stored elements are equal,
+/// and SparseFormat::Reordered only for square matrices.
+///
+/// The decision can be cached in a text file, with one line per matrix holding
+/// a fingerprint of the sparsity pattern and the machine, the format, and the
+/// number of threads. Later constructions with the same cache file and a matrix
+/// with the same fingerprint skip the timing. The cache is optional, and a file
+/// that cannot be read or written is ignored.
+///
+/// Unlike SparseGenMatProd, the matrix is copied into the chosen format, so the
+/// original matrix does not need to be kept alive.
+///
+/// \tparam Scalar_ The element type of the matrix, for example,
+///                 `float`, `double`, and `long double`.
+///
+template <typename Scalar_>
+class SparseAutoMatProd
+{
+public:
+    ///
+    /// Element type of the matrix.
+    ///
+    using Scalar = Scalar_;
+
+    ///
+    /// Timing result of one candidate kernel.
+    ///
+    struct Candidate
+    {
+        SparseFormat format;  ///< Storage format.
+        int nthread;          ///< Number of threads.
+        double seconds;       ///< Best time of a matrix-vector product, in seconds.
+    };
+
+private:
+    using Index = Eigen::Index;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using RowMatrix = Eigen::SparseMatrix<Scalar, Eigen::RowMajor, int>;
+    using Clock = std::chrono::steady_clock;
+
+    SparseKernel<Scalar> m_kernel;        // the chosen kernel
+    std::uint64_t m_fingerprint;          // fingerprint of the matrix and the machine
+    bool m_from_cache;                    // whether the decision was read from the cache
+    std::vector<Candidate> m_candidates;  // timings of the candidates
+
+    // FNV-1a hash of a block of memory
+    static void hash_bytes(std::uint64_t& h, const void* data, std::size_t size)
+    {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; i++)
+        {
+            h ^= p[i];
+            h *= 1099511628211ULL;
+        }
+    }
+
+    static std::uint64_t compute_fingerprint(const RowMatrix& mat, bool pattern, int max_threads)
+    {
+        std::uint64_t h = 14695981039346656037ULL;
+        const std::int64_t header[] = {
+            std::int64_t(mat.rows()), std::int64_t(mat.cols()), std::int64_t(mat.nonZeros()),
+            std::int64_t(sizeof(Scalar)), std::int64_t(pattern), std::int64_t(max_threads),
+            std::int64_t(ThreadPool::default_num_threads())
+        };
+        hash_bytes(h, header, sizeof(header));
+        hash_bytes(h, mat.outerIndexPtr(), sizeof(int) * (mat.rows() + 1));
+        hash_bytes(h, mat.innerIndexPtr(), sizeof(int) * mat.nonZeros());
+        return h;
+    }
+
+    static std::string hex(std::uint64_t h)
+    {
+        char buf[17];
+        std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(h));
+        return std::string(buf);
+    }
+
+    // Looks up the fingerprint in the cache file, where later lines take precedence
+    bool read_cache(const std::string& file, SparseFormat& format, int& nthread) const
+    {
+        std::ifstream in(file);
+        if (!in)
+            return false;
+
+        const std::string key = hex(m_fingerprint);
+        const SparseFormat formats[] = { SparseFormat::CSR, SparseFormat::Pattern,
+                                         SparseFormat::SELL, SparseFormat::Reordered };
+        bool found = false;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            std::istringstream fields(line);
+            std::string fp, name;
+            int nt = 0;
+            if (!(fields >> fp >> name >> nt) || fp != key || nt <= 0)
+                continue;
+            for (SparseFormat f : formats)
+            {
+                if (sparse_format_name(f) == name)
+                {
+                    format = f;
+                    nthread = nt;
+                    found = true;
+                }
+            }
+        }
+        return found;
+    }
+
+    void write_cache(const std::string& file) const
+    {
+        std::ofstream out(file, std::ios::app);
+        if (out)
+            out << hex(m_fingerprint) << ' ' << sparse_format_name(m_kernel.format()) << ' '
+                << m_kernel.num_threads() << '\n';
+    }
+
+    // Best time of a product over repeated runs within the time limit
+    static double time_kernel(const SparseKernel<Scalar>& kernel, const Vector& x, Vector& y, double limit)
+    {
+        // Warm-up run that also starts the threads
+        kernel.multiply(x.data(), y.data());
+
+        double best = -1.0;
+        const Clock::time_point start = Clock::now();
+        for (int rep = 0;; rep++)
+        {
+            const Clock::time_point t0 = Clock::now();
+            kernel.multiply(x.data(), y.data());
+            const Clock::time_point t1 = Clock::now();
+            const double t = std::chrono::duration<double>(t1 - t0).count();
+            best = (best < 0.0) ? t : std::min(best, t);
+            if (rep >= 2 && std::chrono::duration<double>(t1 - start).count() >= limit)
+                break;
+        }
+        return best;
+    }
+
+    void tune(const RowMatrix& mat, bool pattern, double time_budget, int max_threads)
+    {
+        SPECTRA_TRACE_SCOPE("SparseAutoMatProd::tune");
+
+        std::vector<SparseFormat> formats(1, SparseFormat::CSR);
+        if (pattern)
+            formats.push_back(SparseFormat::Pattern);
+        formats.push_back(SparseFormat::SELL);
+        if (mat.rows() == mat.cols())
+            formats.push_back(SparseFormat::Reordered);
+        std::vector<int> threads(1, 1);
+        for (int nt = 2; nt < max_threads; nt *= 2)
+            threads.push_back(nt);
+        if (max_threads > 1)
+            threads.push_back(max_threads);
+
+        // The serial CSR kernel is always timed, and the remaining candidates
+        // share the budget as long as it lasts
+        const double limit = time_budget / double(formats.size() * threads.size());
+        const Clock::time_point start = Clock::now();
+        Vector x = Vector::Ones(mat.cols()), y(mat.rows());
+        double best = -1.0;
+        for (SparseFormat format : formats)
+        {
+            for (int nt : threads)
+            {
+                if (best >= 0.0 && std::chrono::duration<double>(Clock::now() - start).count() >= time_budget)
+                    return;
+
+                SparseKernel<Scalar> kernel;
+                kernel.compute(mat, format, nt);
+                const double t = time_kernel(kernel, x, y, limit);
+                m_candidates.push_back(Candidate{ format, nt, t });
+                if (best < 0.0 || t < best)
+                {
+                    best = t;
+                    m_kernel = std::move(kernel);
+                }
+            }
+        }
+    }
+
+    template <typename Derived>
+    static RowMatrix row_major_copy(const Eigen::SparseMatrixBase<Derived>& mat)
+    {
+        RowMatrix res = mat;
+        res.makeCompressed();
+        return res;
+    }
+
+public:
+    ///
+    /// Constructor to choose the fastest kernel for a matrix.
+    ///
+    /// \param mat         An **Eigen** sparse matrix object, whose type can be
+    ///                    `Eigen::SparseMatrix<Scalar, ...>` or its mapped version
+    ///                    `Eigen::Map<Eigen::SparseMatrix<Scalar, ...> >`.
+    /// \param time_budget Approximate time limit of the timing runs, in seconds.
+    /// \param cache_file  Path of the cache file. If empty, no cache is used.
+    /// \param max_threads Maximum number of threads of the candidates. If it is not
+    ///                    positive, the number of hardware threads is used.
+    ///
+    template <typename Derived>
+    SparseAutoMatProd(const Eigen::SparseMatrixBase<Derived>& mat, double time_budget = 0.1,
+                      const std::string& cache_file = "", int max_threads = 0) :
+        m_from_cache(false)
+    {
+        if (time_budget < 0.0)
+            throw std::invalid_argument("SparseAutoMatProd: time_budget must be nonnegative");
+        max_threads = (max_threads > 0) ? max_threads : ThreadPool::default_num_threads();
+
+        const RowMatrix rmat = row_major_copy(mat);
+        const bool pattern = SparseKernel<Scalar>::is_pattern(rmat);
+        m_fingerprint = compute_fingerprint(rmat, pattern, max_threads);
+
+        SparseFormat format;
+        int nthread;
+        if (!cache_file.empty() && read_cache(cache_file, format, nthread) &&
+            (format != SparseFormat::Pattern || pattern) &&
+            (format != SparseFormat::Reordered || rmat.rows() == rmat.cols()))
+        {
+            m_kernel.compute(rmat, format, nthread);
+            m_from_cache = true;
+            return;
+        }
+
+        tune(rmat, pattern, time_budget, max_threads);
+        if (!cache_file.empty())
+            write_cache(cache_file);
+    }
+
+    ///
+    /// Constructor to use a given format and number of threads, without timing.
+    ///
+    /// \param mat     An **Eigen** sparse matrix object.
+    /// \param format  The storage format.
+    /// \param nthread Number of threads. If it is not positive, the number of
+    ///                hardware threads is used.
+    ///
+    template <typename Derived>
+    SparseAutoMatProd(const Eigen::SparseMatrixBase<Derived>& mat, SparseFormat format, int nthread = 1) :
+        m_from_cache(false)
+    {
+        const RowMatrix rmat = row_major_copy(mat);
+        m_fingerprint = compute_fingerprint(rmat, SparseKernel<Scalar>::is_pattern(rmat), nthread);
+        m_kernel.compute(rmat, format, nthread);
+    }
+
+    ///
+    /// Return the number of rows of the underlying matrix.
+    ///
+    Index rows() const { return m_kernel.rows(); }
+    ///
+    /// Return the number of columns of the underlying matrix.
+    ///
+    Index cols() const { return m_kernel.cols(); }
+
+    ///
+    /// The chosen storage format.
+    ///
+    SparseFormat format() const { return m_kernel.format(); }
+
+    ///
+    /// The chosen number of threads.
+    ///
+    int num_threads() const { return m_kernel.num_threads(); }
+
+    ///
+    /// Whether the decision was read from the cache file.
+    ///
+    bool from_cache() const { return m_from_cache; }
+
+    ///
+    /// Fingerprint of the sparsity pattern and the machine, used as the key of the cache.
+    ///
+    std::uint64_t fingerprint() const { return m_fingerprint; }
+
+    ///
+    /// Timings of the candidates, empty if the decision was not made by timing.
+    ///
+    const std::vector<Candidate>& candidates() const { return m_candidates; }
+
+    ///
+    /// Perform the matrix-vector multiplication operation \f$y=Ax\f$.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    // y_out = A * x_in
+    void perform_op(const Scalar* x_in, Scalar* y_out) const
+    {
+        m_kernel.multiply(x_in, y_out);
+    }
+
+    ///
+    /// Perform the matrix-matrix multiplication operation \f$y=Ax\f$.
+    ///
+    Matrix operator*(const Eigen::Ref<const Matrix>& mat_in) const
+    {
+        Matrix res(rows(), mat_in.cols());
+        for (Index j = 0; j < mat_in.cols(); j++)
+            m_kernel.multiply(mat_in.col(j).data(), res.col(j).data());
+        return res;
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_SPARSE_AUTO_MAT_PROD_H
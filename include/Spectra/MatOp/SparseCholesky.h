@@ -13,6 +13,8 @@
 #include <stdexcept>
 
 #include "../Util/CompInfo.h"
+#include "../Util/FacTraits.h"
+#include "../Util/Trace.h"
 
 namespace Spectra {
 
@@ -31,8 +33,14 @@ namespace Spectra {
 /// \tparam Flags        Either `Eigen::ColMajor` or `Eigen::RowMajor`, indicating
 ///                      the storage format of the input matrix.
 /// \tparam StorageIndex The type of the indices for the sparse matrix.
+/// \tparam FacType      The sparse Cholesky factorization backend, which defaults to
+///                      `Eigen::SimplicialLLT`. Other backends need to provide the
+///                      permutation and the triangular factors, see FacTraits.
+///                      For large matrices, e.g. from 3D finite element models,
+///                      the multithreaded SupernodalCholesky is usually much faster.
 ///
-template <typename Scalar_, int Uplo = Eigen::Lower, int Flags = Eigen::ColMajor, typename StorageIndex = int>
+template <typename Scalar_, int Uplo = Eigen::Lower, int Flags = Eigen::ColMajor, typename StorageIndex = int,
+          typename FacType = Eigen::SimplicialLLT<Eigen::SparseMatrix<Scalar_, Flags, StorageIndex>, Uplo>>
 class SparseCholesky
 {
 public:
@@ -47,9 +55,10 @@ private:
     using MapConstVec = Eigen::Map<const Vector>;
     using MapVec = Eigen::Map<Vector>;
     using SparseMatrix = Eigen::SparseMatrix<Scalar, Flags, StorageIndex>;
+    using Fac = FacTraits<FacType>;
 
     const Index m_n;
-    Eigen::SimplicialLLT<SparseMatrix, Uplo> m_decomp;
+    FacType m_decomp;
     CompInfo m_info;  // status of the decomposition
 
 public:
@@ -71,8 +80,10 @@ public:
         if (mat.rows() != mat.cols())
             throw std::invalid_argument("SparseCholesky: matrix must be square");
 
-        m_decomp.compute(mat);
-        m_info = (m_decomp.info() == Eigen::Success) ?
+        SPECTRA_TRACE_SCOPE("SparseCholesky::factorize");
+        Fac::analyze(m_decomp, mat);
+        Fac::factorize(m_decomp, mat);
+        m_info = Fac::success(m_decomp) ?
             CompInfo::Successful :
             CompInfo::NumericalIssue;
     }
@@ -103,8 +114,7 @@ public:
     {
         MapConstVec x(x_in, m_n);
         MapVec y(y_out, m_n);
-        y.noalias() = m_decomp.permutationP() * x;
-        m_decomp.matrixL().solveInPlace(y);
+        Fac::lower_triangular_solve(m_decomp, x, y);
     }
 
     ///
@@ -118,8 +128,7 @@ public:
     {
         MapConstVec x(x_in, m_n);
         MapVec y(y_out, m_n);
-        y.noalias() = m_decomp.matrixU().solve(x);
-        y = m_decomp.permutationPinv() * y;
+        Fac::upper_triangular_solve(m_decomp, x, y);
     }
 };
 
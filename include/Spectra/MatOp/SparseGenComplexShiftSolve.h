@@ -12,6 +12,9 @@
 #include <Eigen/SparseLU>
 #include <stdexcept>
 
+#include "../Util/FacTraits.h"
+#include "../Util/Trace.h"
+
 namespace Spectra {
 
 ///
@@ -27,8 +30,12 @@ namespace Spectra {
 /// \tparam Flags        Either `Eigen::ColMajor` or `Eigen::RowMajor`, indicating
 ///                      the storage format of the input matrix.
 /// \tparam StorageIndex The type of the indices for the sparse matrix.
+/// \tparam FacType      The sparse factorization backend for the complex matrix
+///                      \f$A-\sigma I\f$, which defaults to `Eigen::SparseLU`.
+///                      See FacTraits for the requirements on the backend.
 ///
-template <typename Scalar_, int Flags = Eigen::ColMajor, typename StorageIndex = int>
+template <typename Scalar_, int Flags = Eigen::ColMajor, typename StorageIndex = int,
+          typename FacType = Eigen::SparseLU<Eigen::SparseMatrix<std::complex<Scalar_>, Flags, StorageIndex>>>
 class SparseGenComplexShiftSolve
 {
 public:
@@ -49,12 +56,14 @@ private:
     using ComplexVector = Eigen::Matrix<Complex, Eigen::Dynamic, 1>;
     using SparseComplexMatrix = Eigen::SparseMatrix<Complex, Flags, StorageIndex>;
 
-    using ComplexSolver = Eigen::SparseLU<SparseComplexMatrix>;
+    using Fac = FacTraits<FacType>;
 
     ConstGenericSparseMatrix m_mat;
     const Index m_n;
-    ComplexSolver m_solver;
+    FacType m_solver;
+    bool m_analyzed;  // whether the symbolic analysis has been done
     mutable ComplexVector m_x_cache;
+    mutable ComplexVector m_y_cache;
 
 public:
     ///
@@ -66,7 +75,7 @@ public:
     ///
     template <typename Derived>
     SparseGenComplexShiftSolve(const Eigen::SparseMatrixBase<Derived>& mat) :
-        m_mat(mat), m_n(mat.rows())
+        m_mat(mat), m_n(mat.rows()), m_analyzed(false)
     {
         static_assert(
             static_cast<int>(Derived::PlainObject::IsRowMajor) == static_cast<int>(SparseMatrix::IsRowMajor),
@@ -93,14 +102,23 @@ public:
     ///
     void set_shift(const Scalar& sigmar, const Scalar& sigmai)
     {
+        SPECTRA_TRACE_SCOPE("SparseGenComplexShiftSolve::set_shift");
+
         // Create a sparse idendity matrix (1 + 0i on diagonal)
         SparseComplexMatrix I(m_n, m_n);
         I.setIdentity();
-        // Sparse LU decomposition
-        m_solver.compute(m_mat.template cast<Complex>() - Complex(sigmar, sigmai) * I);
+        // Sparse LU decomposition, reusing the symbolic analysis of the previous shifts
+        SparseComplexMatrix mat = m_mat.template cast<Complex>() - Complex(sigmar, sigmai) * I;
+        if (!m_analyzed)
+        {
+            Fac::analyze(m_solver, mat);
+            m_analyzed = true;
+        }
+        Fac::factorize(m_solver, mat);
         // Set cache to zero
         m_x_cache.resize(m_n);
         m_x_cache.setZero();
+        m_y_cache.resize(m_n);
     }
 
     ///
@@ -115,7 +133,27 @@ public:
     {
         m_x_cache.real() = MapConstVec(x_in, m_n);
         MapVec y(y_out, m_n);
-        y.noalias() = m_solver.solve(m_x_cache).real();
+        Fac::solve(m_solver, m_x_cache, m_y_cache);
+        y.noalias() = m_y_cache.real();
+    }
+
+    ///
+    /// Perform the complex shift-solve operation on a block of real vectors,
+    /// \f$Y=(A-\sigma I)^{-1}X\f$, keeping both the real and imaginary parts.
+    /// Unlike perform_op(), this function does not use the internal caches, so it
+    /// can be called from several threads at the same time.
+    ///
+    /// \param x_in  Pointer to the \f$X\f$ matrix, with `ncol` columns stored
+    ///              in column-major order.
+    /// \param ncol  Number of columns of \f$X\f$.
+    /// \param y_out Pointer to the complex \f$Y\f$ matrix, with the same layout as \f$X\f$.
+    ///
+    void perform_block_op(const Scalar* x_in, Index ncol, std::complex<Scalar>* y_out) const
+    {
+        using BlockMatrix = Eigen::Matrix<Complex, Eigen::Dynamic, Eigen::Dynamic>;
+        const BlockMatrix X = Eigen::Map<const Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>>(x_in, m_n, ncol).template cast<Complex>();
+        Eigen::Map<BlockMatrix> Y(y_out, m_n, ncol);
+        Fac::solve(m_solver, X, Y);
     }
 };
 
@@ -85,6 +85,20 @@ public:
         y.noalias() = m_mat * x;
     }
 
+    ///
+    /// Perform the transposed multiplication operation \f$y=A'x\f$.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    // y_out = A' * x_in
+    void transpose_perform_op(const Scalar* x_in, Scalar* y_out) const
+    {
+        MapConstVec x(x_in, m_mat.rows());
+        MapVec y(y_out, m_mat.cols());
+        y.noalias() = m_mat.transpose() * x;
+    }
+
     ///
     /// Perform the matrix-matrix multiplication operation \f$y=Ax\f$.
     ///
@@ -11,6 +11,11 @@
 #include <Eigen/SparseCore>
 #include <Eigen/SparseLU>
 #include <stdexcept>
+#include <future>  // std::shared_future
+
+#include "../Util/FacTraits.h"
+#include "../Util/Trace.h"
+#include "internal/AsyncShift.h"
 
 namespace Spectra {
 
@@ -26,8 +31,12 @@ namespace Spectra {
 /// \tparam Flags        Either `Eigen::ColMajor` or `Eigen::RowMajor`, indicating
 ///                      the storage format of the input matrix.
 /// \tparam StorageIndex The type of the indices for the sparse matrix.
+/// \tparam FacType      The sparse factorization backend for \f$A-\sigma I\f$, which
+///                      defaults to `Eigen::SparseLU`. See FacTraits for the
+///                      requirements on the backend.
 ///
-template <typename Scalar_, int Flags = Eigen::ColMajor, typename StorageIndex = int>
+template <typename Scalar_, int Flags = Eigen::ColMajor, typename StorageIndex = int,
+          typename FacType = Eigen::SparseLU<Eigen::SparseMatrix<Scalar_, Flags, StorageIndex>>>
 class SparseGenRealShiftSolve
 {
 public:
@@ -43,10 +52,33 @@ private:
     using MapVec = Eigen::Map<Vector>;
     using SparseMatrix = Eigen::SparseMatrix<Scalar, Flags, StorageIndex>;
     using ConstGenericSparseMatrix = const Eigen::Ref<const SparseMatrix>;
+    using Fac = FacTraits<FacType>;
 
     ConstGenericSparseMatrix m_mat;
     const Index m_n;
-    Eigen::SparseLU<SparseMatrix> m_solver;
+    FacType m_solver;
+    bool m_analyzed;  // whether the symbolic analysis has been done
+
+    AsyncShift<Scalar> m_async;  // must be the last data member
+
+    // Factorize A - sigma * I
+    void factorize(const Scalar& sigma)
+    {
+        SPECTRA_TRACE_SCOPE("SparseGenRealShiftSolve::set_shift");
+
+        SparseMatrix I(m_n, m_n);
+        I.setIdentity();
+
+        SparseMatrix mat = m_mat - sigma * I;
+        if (!m_analyzed)
+        {
+            Fac::analyze(m_solver, mat);
+            m_analyzed = true;
+        }
+        Fac::factorize(m_solver, mat);
+        if (!Fac::success(m_solver))
+            throw std::invalid_argument("SparseGenRealShiftSolve: factorization failed with the given shift");
+    }
 
 public:
     ///
@@ -58,7 +90,7 @@ public:
     ///
     template <typename Derived>
     SparseGenRealShiftSolve(const Eigen::SparseMatrixBase<Derived>& mat) :
-        m_mat(mat), m_n(mat.rows())
+        m_mat(mat), m_n(mat.rows()), m_analyzed(false)
     {
         static_assert(
             static_cast<int>(Derived::PlainObject::IsRowMajor) == static_cast<int>(SparseMatrix::IsRowMajor),
@@ -80,14 +112,30 @@ public:
     ///
     /// Set the real shift \f$\sigma\f$.
     ///
+    /// The symbolic analysis of \f$A-\sigma I\f$ is done only on the first call,
+    /// and is reused by later calls.
+    ///
     void set_shift(const Scalar& sigma)
     {
-        SparseMatrix I(m_n, m_n);
-        I.setIdentity();
+        // The factorization may have been launched by set_shift_async()
+        if (m_async.consume(sigma))
+            return;
+        m_async.wait();
+        factorize(sigma);
+    }
 
-        m_solver.compute(m_mat - sigma * I);
-        if (m_solver.info() != Eigen::Success)
-            throw std::invalid_argument("SparseGenRealShiftSolve: factorization failed with the given shift");
+    ///
+    /// Start factorizing \f$A-\sigma I\f$ on a background thread and return immediately.
+    /// The returned future becomes ready when the factorization finishes, and
+    /// rethrows the exception of a failed factorization in `get()`.
+    ///
+    /// A following call of set_shift() with the same \f$\sigma\f$, for example in the
+    /// constructor of the eigen solver, waits for this factorization instead of
+    /// computing it again. The operator must not be used in other ways until then.
+    ///
+    std::shared_future<void> set_shift_async(const Scalar& sigma)
+    {
+        return m_async.launch(sigma, [this, sigma]() { factorize(sigma); });
     }
 
     ///
@@ -101,7 +149,7 @@ public:
     {
         MapConstVec x(x_in, m_n);
         MapVec y(y_out, m_n);
-        y.noalias() = m_solver.solve(x);
+        Fac::solve(m_solver, x, y);
     }
 };
 
@@ -87,6 +87,15 @@ public:
         y.noalias() = m_mat.template selfadjointView<Uplo>() * x;
     }
 
+    ///
+    /// Perform the transposed multiplication operation \f$y=A'x\f$,
+    /// which is the same as perform_op() since \f$A\f$ is symmetric.
+    ///
+    void transpose_perform_op(const Scalar* x_in, Scalar* y_out) const
+    {
+        perform_op(x_in, y_out);
+    }
+
     ///
     /// Perform the matrix-matrix multiplication operation \f$y=Ax\f$.
     ///
@@ -11,10 +11,14 @@
 #include <Eigen/SparseCore>
 #include <Eigen/SparseLU>
 #include <stdexcept>
+#include <future>  // std::shared_future
 #include <type_traits>  // std::conditional, std::is_same
 
 #include "../LinAlg/BKLDLT.h"
 #include "../Util/CompInfo.h"
+#include "../Util/FacTraits.h"
+#include "../Util/Trace.h"
+#include "internal/AsyncShift.h"
 
 namespace Spectra {
 
@@ -26,42 +30,57 @@ template <bool AIsSparse, bool BIsSparse, int UploA, int UploB>
 class SymShiftInvertHelper
 {
 public:
-    template <typename Scalar, typename Fac, typename ArgA, typename ArgB>
-    static bool factorize(Fac& fac, const ArgA& A, const ArgB& B, const Scalar& sigma)
+    template <typename Scalar, typename Fac, typename Work, typename ArgA, typename ArgB>
+    static bool factorize(Fac& fac, bool& analyzed, Work&, const ArgA& A, const ArgB& B, const Scalar& sigma)
     {
         using SpMat = typename ArgA::PlainObject;
         SpMat matA = A.template selfadjointView<UploA>();
         SpMat matB = B.template selfadjointView<UploB>();
         SpMat mat = matA - sigma * matB;
-        // SparseLU solver
-        fac.isSymmetric(true);
-        fac.compute(mat);
+        // Sparse solver, SparseLU by default
+        // The sparsity pattern of mat does not depend on sigma, so the symbolic
+        // analysis is only done once
+        if (!analyzed)
+        {
+            FacTraits<Fac>::set_symmetric(fac, true);
+            FacTraits<Fac>::analyze(fac, mat);
+            analyzed = true;
+        }
+        FacTraits<Fac>::factorize(fac, mat);
         // Return true if successful
-        return fac.info() == Eigen::Success;
+        return FacTraits<Fac>::success(fac);
     }
 };
 
+// The dense cases compute the lower triangular part of A-sigma*B in a column-major
+// work matrix that is reused across shifts, and factorize it in place if the
+// backend supports it, so that no other copy of the matrix is made
+
 // A is dense, B is dense or sparse
 template <bool BIsSparse, int UploA, int UploB>
 class SymShiftInvertHelper<false, BIsSparse, UploA, UploB>
 {
 public:
-    template <typename Scalar, typename Fac, typename ArgA, typename ArgB>
-    static bool factorize(Fac& fac, const ArgA& A, const ArgB& B, const Scalar& sigma)
+    template <typename Scalar, typename Fac, typename Work, typename ArgA, typename ArgB>
+    static bool factorize(Fac& fac, bool&, Work& work, const ArgA& A, const ArgB& B, const Scalar& sigma)
     {
-        using Matrix = typename ArgA::PlainObject;
-        // Make a copy of the <UploA> triangular part of A
-        Matrix mat(A.rows(), A.cols());
-        mat.template triangularView<UploA>() = A;
-        // Update <UploA> triangular part of mat
-        if (UploA == UploB)
-            mat -= (B * sigma).template triangularView<UploA>();
+        // The strictly upper triangular part of work stays zero
+        if (work.rows() != A.rows())
+            work.setZero(A.rows(), A.cols());
+        // Copy the <UploA> triangular part of A to the lower triangular part of work
+        if (UploA == Eigen::Lower)
+            work.template triangularView<Eigen::Lower>() = A;
+        else
+            work.template triangularView<Eigen::Lower>() = A.transpose();
+        // Update the lower triangular part of work
+        if (UploB == Eigen::Lower)
+            work -= (B * sigma).template triangularView<Eigen::Lower>();
         else
-            mat -= (B * sigma).template triangularView<UploB>().transpose();
-        // BKLDLT solver
-        fac.compute(mat, UploA);
+            work -= (B * sigma).template triangularView<Eigen::Upper>().transpose();
+        // Dense solver, BKLDLT by default
+        FacTraits<Fac>::factorize_inplace(fac, work);
         // Return true if successful
-        return fac.info() == CompInfo::Successful;
+        return FacTraits<Fac>::success(fac);
     }
 };
 
@@ -70,22 +89,26 @@ template <int UploA, int UploB>
 class SymShiftInvertHelper<true, false, UploA, UploB>
 {
 public:
-    template <typename Scalar, typename Fac, typename ArgA, typename ArgB>
-    static bool factorize(Fac& fac, const ArgA& A, const ArgB& B, const Scalar& sigma)
+    template <typename Scalar, typename Fac, typename Work, typename ArgA, typename ArgB>
+    static bool factorize(Fac& fac, bool&, Work& work, const ArgA& A, const ArgB& B, const Scalar& sigma)
     {
-        using Matrix = typename ArgB::PlainObject;
-        // Construct the <UploB> triangular part of -sigma*B
-        Matrix mat(B.rows(), B.cols());
-        mat.template triangularView<UploB>() = -sigma * B;
-        // Update <UploB> triangular part of mat
-        if (UploA == UploB)
-            mat += A.template triangularView<UploB>();
+        // The strictly upper triangular part of work stays zero
+        if (work.rows() != B.rows())
+            work.setZero(B.rows(), B.cols());
+        // Construct the lower triangular part of -sigma*B
+        if (UploB == Eigen::Lower)
+            work.template triangularView<Eigen::Lower>() = -sigma * B;
         else
-            mat += A.template triangularView<UploA>().transpose();
-        // BKLDLT solver
-        fac.compute(mat, UploB);
+            work.template triangularView<Eigen::Lower>() = -sigma * B.transpose();
+        // Update the lower triangular part of work
+        if (UploA == Eigen::Lower)
+            work += A.template triangularView<Eigen::Lower>();
+        else
+            work += A.template triangularView<Eigen::Upper>().transpose();
+        // Dense solver, BKLDLT by default
+        FacTraits<Fac>::factorize_inplace(fac, work);
         // Return true if successful
-        return fac.info() == CompInfo::Successful;
+        return FacTraits<Fac>::success(fac);
     }
 };
 
@@ -119,11 +142,20 @@ public:
 ///                        is a sparse matrix.
 /// \tparam StorageIndexB  The storage index type of the \f$B\f$ matrix, only used when \f$B\f$
 ///                        is a sparse matrix.
+/// \tparam FacType_       The factorization backend for \f$A-\sigma B\f$. The default value
+///                        `void` selects `Eigen::SparseLU` if both \f$A\f$ and \f$B\f$ are
+///                        sparse, and BKLDLT otherwise. A sparse backend needs to follow
+///                        the interface of the **Eigen** sparse solvers, and a dense backend
+///                        is given a column-major matrix whose lower triangular part
+///                        contains \f$A-\sigma B\f$. This matrix is kept across shifts,
+///                        and backends providing `compute_inplace()`, such as BKLDLT,
+///                        factorize it without another copy. See FacTraits for details.
 ///
 template <typename Scalar_, typename TypeA = Eigen::Sparse, typename TypeB = Eigen::Sparse,
           int UploA = Eigen::Lower, int UploB = Eigen::Lower,
           int FlagsA = Eigen::ColMajor, int FlagsB = Eigen::ColMajor,
-          typename StorageIndexA = int, typename StorageIndexB = int>
+          typename StorageIndexA = int, typename StorageIndexB = int,
+          typename FacType_ = void>
 class SymShiftInvert
 {
 public:
@@ -164,10 +196,15 @@ private:
 
     // If both A and B are sparse, then the result A-sigma*B is sparse, so we use
     // sparseLU for factorization; otherwise A-sigma*B is dense, and we use BKLDLT
-    using FacType = typename std::conditional<
+    using DefaultFacType = typename std::conditional<
         ASparse::value && BSparse::value,
         Eigen::SparseLU<ResType>,
         BKLDLT<Scalar>>::type;
+    using FacType = typename std::conditional<
+        std::is_same<FacType_, void>::value,
+        DefaultFacType,
+        FacType_>::type;
+    using Fac = FacTraits<FacType>;
 
     using ConstGenericMatrixA = const Eigen::Ref<const MatrixA>;
     using ConstGenericMatrixB = const Eigen::Ref<const MatrixB>;
@@ -176,6 +213,24 @@ private:
     ConstGenericMatrixB m_matB;
     const Index m_n;
     FacType m_solver;
+    bool m_analyzed;  // whether the symbolic analysis has been done
+    // Work matrix for A - sigma * B if A or B is dense, reused across shifts
+    Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> m_work;
+
+    AsyncShift<Scalar> m_async;  // must be the last data member
+
+    // Factorize A - sigma * B
+    void factorize(const Scalar& sigma)
+    {
+        SPECTRA_TRACE_SCOPE("SymShiftInvert::set_shift");
+
+        constexpr bool AIsSparse = ASparse::value;
+        constexpr bool BIsSparse = BSparse::value;
+        using Helper = SymShiftInvertHelper<AIsSparse, BIsSparse, UploA, UploB>;
+        const bool success = Helper::factorize(m_solver, m_analyzed, m_work, m_matA, m_matB, sigma);
+        if (!success)
+            throw std::invalid_argument("SymShiftInvert: factorization failed with the given shift");
+    }
 
 public:
     ///
@@ -189,7 +244,7 @@ public:
     ///
     template <typename DerivedA, typename DerivedB>
     SymShiftInvert(const Eigen::EigenBase<DerivedA>& A, const Eigen::EigenBase<DerivedB>& B) :
-        m_matA(A.derived()), m_matB(B.derived()), m_n(A.rows())
+        m_matA(A.derived()), m_matB(B.derived()), m_n(A.rows()), m_analyzed(false)
     {
         static_assert(
             static_cast<int>(DerivedA::PlainObject::IsRowMajor) == static_cast<int>(MatrixA::IsRowMajor),
@@ -217,12 +272,39 @@ public:
     ///
     void set_shift(const Scalar& sigma)
     {
-        constexpr bool AIsSparse = ASparse::value;
-        constexpr bool BIsSparse = BSparse::value;
-        using Helper = SymShiftInvertHelper<AIsSparse, BIsSparse, UploA, UploB>;
-        const bool success = Helper::factorize(m_solver, m_matA, m_matB, sigma);
-        if (!success)
-            throw std::invalid_argument("SymShiftInvert: factorization failed with the given shift");
+        // The factorization may have been launched by set_shift_async()
+        if (m_async.consume(sigma))
+            return;
+        m_async.wait();
+        factorize(sigma);
+    }
+
+    ///
+    /// Start factorizing \f$A-\sigma B\f$ on a background thread and return immediately.
+    /// The returned future becomes ready when the factorization finishes, and
+    /// rethrows the exception of a failed factorization in `get()`.
+    ///
+    /// A following call of set_shift() with the same \f$\sigma\f$, for example in the
+    /// constructor of the eigen solver, waits for this factorization instead of
+    /// computing it again. The operator must not be used in other ways until then.
+    ///
+    std::shared_future<void> set_shift_async(const Scalar& sigma)
+    {
+        return m_async.launch(sigma, [this, sigma]() { factorize(sigma); });
+    }
+
+    ///
+    /// Return the inertia of \f$A-\sigma B\f$, i.e., the numbers of its positive,
+    /// negative, and zero eigenvalues, after set_shift() is called. This is only
+    /// available for factorization backends that provide the inertia, such as
+    /// BKLDLT and `Eigen::SimplicialLDLT`.
+    ///
+    /// By Sylvester's law of inertia, if \f$B\f$ is positive definite, `nneg` is the
+    /// number of generalized eigenvalues smaller than \f$\sigma\f$.
+    ///
+    void inertia(Index& npos, Index& nneg, Index& nzero) const
+    {
+        Fac::inertia(m_solver, npos, nneg, nzero);
     }
 
     ///
@@ -236,7 +318,7 @@ public:
     {
         MapConstVec x(x_in, m_n);
         MapVec y(y_out, m_n);
-        y.noalias() = m_solver.solve(x);
+        Fac::solve(m_solver, x, y);
     }
 };
 
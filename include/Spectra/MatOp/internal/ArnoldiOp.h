@@ -8,7 +8,11 @@
 #define SPECTRA_ARNOLDI_OP_H
 
 #include <Eigen/Core>
-#include <cmath>  // std::sqrt
+#include <cmath>        // std::sqrt
+#include <type_traits>  // std::true_type, std::false_type
+#include <utility>      // std::declval
+
+#include "../../Util/Trace.h"
 
 namespace Spectra {
 
@@ -23,6 +27,39 @@ namespace Spectra {
 /// Different types of operators.
 ///
 
+///
+/// \ingroup Operators
+///
+/// Calls `op.first_touch(data, rows, cols)` if the operator provides it, for example
+/// to place the rows of the Krylov vectors on the NUMA nodes of the threads that
+/// process them (see NumaSparseMatProd), and does nothing otherwise.
+///
+template <typename Scalar, typename OpType>
+class FirstTouch
+{
+private:
+    using Index = Eigen::Index;
+
+    template <typename T>
+    static auto test(int) -> decltype(std::declval<const T&>().first_touch(
+                                          std::declval<Scalar*>(), Index(0), Index(0)),
+                                      std::true_type());
+    template <typename T>
+    static std::false_type test(...);
+
+    static void apply(const OpType& op, Scalar* data, Index rows, Index cols, std::true_type)
+    {
+        op.first_touch(data, rows, cols);
+    }
+    static void apply(const OpType&, Scalar*, Index, Index, std::false_type) {}
+
+public:
+    static void apply(const OpType& op, Scalar* data, Index rows, Index cols)
+    {
+        apply(op, data, rows, cols, decltype(test<OpType>(0))());
+    }
+};
+
 ///
 /// \ingroup Operators
 ///
@@ -86,8 +123,15 @@ public:
     // The "A" operator to generate the Krylov subspace
     inline void perform_op(const Scalar* x_in, Scalar* y_out) const
     {
+        SPECTRA_TRACE_SCOPE("matvec");
         m_op.perform_op(x_in, y_out);
     }
+
+    // Place newly allocated Krylov vectors where the operator accesses them
+    void first_touch(Scalar* data, Index rows, Index cols) const
+    {
+        FirstTouch<Scalar, OpType>::apply(m_op, data, rows, cols);
+    }
 };
 
 ///
@@ -145,8 +189,15 @@ public:
     // The "A" operator to generate the Krylov subspace
     inline void perform_op(const Scalar* x_in, Scalar* y_out) const
     {
+        SPECTRA_TRACE_SCOPE("matvec");
         m_op.perform_op(x_in, y_out);
     }
+
+    // Place newly allocated Krylov vectors where the operator accesses them
+    void first_touch(Scalar* data, Index rows, Index cols) const
+    {
+        FirstTouch<Scalar, OpType>::apply(m_op, data, rows, cols);
+    }
 };
 
 ///
@@ -0,0 +1,83 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_ASYNC_SHIFT_H
+#define SPECTRA_ASYNC_SHIFT_H
+
+#include <future>   // std::async, std::shared_future
+#include <utility>  // std::forward, std::move
+
+namespace Spectra {
+
+///
+/// \ingroup Internals
+///
+/// State of the asynchronous factorization of a shift-solve operator.
+///
+/// The operator launches the factorization of \f$A-\sigma I\f$ on a background
+/// thread in `set_shift_async()`, and a later call of `set_shift()` with the same
+/// shift only waits for the result instead of factorizing the matrix again. This
+/// object must be the last data member of the operator, so that it is destroyed
+/// first and waits for the background thread before the other members go away.
+///
+template <typename Shift>
+class AsyncShift
+{
+private:
+    std::shared_future<void> m_future;  // pending factorization
+    Shift m_shift;                      // shift of the pending factorization
+
+public:
+    AsyncShift() :
+        m_shift()
+    {}
+
+    // Copies do not share the pending factorization
+    AsyncShift(const AsyncShift&) :
+        m_shift()
+    {}
+
+    AsyncShift& operator=(const AsyncShift&) = delete;
+
+    ~AsyncShift() { wait(); }
+
+    // Wait for the pending factorization, ignoring its result
+    void wait()
+    {
+        if (m_future.valid())
+        {
+            m_future.wait();
+            m_future = std::shared_future<void>();
+        }
+    }
+
+    // Run func() on a background thread, after the previous factorization finishes
+    template <typename Func>
+    std::shared_future<void> launch(const Shift& shift, Func&& func)
+    {
+        wait();
+        m_shift = shift;
+        m_future = std::async(std::launch::async, std::forward<Func>(func)).share();
+        return m_future;
+    }
+
+    // If a factorization with the given shift has been launched and not consumed,
+    // wait for it, rethrow its exception if any, and return true
+    bool consume(const Shift& shift)
+    {
+        if (!m_future.valid() || !(m_shift == shift))
+            return false;
+
+        std::shared_future<void> future = std::move(m_future);
+        m_future = std::shared_future<void>();
+        future.get();
+        return true;
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_ASYNC_SHIFT_H
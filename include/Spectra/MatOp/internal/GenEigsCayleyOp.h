@@ -0,0 +1,92 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_GEN_EIGS_CAYLEY_OP_H
+#define SPECTRA_GEN_EIGS_CAYLEY_OP_H
+
+#include <Eigen/Core>
+
+#include "../DenseGenRealShiftSolve.h"
+
+namespace Spectra {
+
+///
+/// \ingroup Operators
+///
+/// This class defines the matrix operation for the general eigen solver in the
+/// Cayley mode. It computes \f$y=(A-\sigma I)^{-1}(A-\mu I)x\f$ for any
+/// vector \f$x\f$, where \f$A\f$ is a general real matrix, and \f$\sigma\f$
+/// and \f$\mu\f$ are real shifts.
+/// This class is intended for internal use.
+///
+template <typename OpType = DenseGenRealShiftSolve<double>>
+class GenEigsCayleyOp
+{
+public:
+    using Scalar = typename OpType::Scalar;
+
+private:
+    using Index = Eigen::Index;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using MapConstVec = Eigen::Map<const Vector>;
+    using MapVec = Eigen::Map<Vector>;
+
+    OpType& m_op;
+    Scalar m_sigma;
+    Scalar m_mu;
+
+public:
+    ///
+    /// Constructor to create the matrix operation object.
+    ///
+    /// \param op   The \f$(A-\sigma I)^{-1}\f$ matrix operation object.
+    ///
+    GenEigsCayleyOp(OpType& op) :
+        m_op(op), m_sigma(0), m_mu(0)
+    {}
+
+    ///
+    /// Return the number of rows of the underlying matrix.
+    ///
+    Index rows() const { return m_op.rows(); }
+    ///
+    /// Return the number of columns of the underlying matrix.
+    ///
+    Index cols() const { return m_op.rows(); }
+
+    ///
+    /// Set the pole \f$\sigma\f$ and the zero \f$\mu\f$ of the transformation.
+    /// Only \f$A-\sigma I\f$ is factorized.
+    ///
+    void set_shift(const Scalar& sigma, const Scalar& mu)
+    {
+        m_op.set_shift(sigma);
+        m_sigma = sigma;
+        m_mu = mu;
+    }
+
+    ///
+    /// Perform the matrix operation \f$y=(A-\sigma I)^{-1}(A-\mu I)x\f$.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    // y_out = inv(A - sigma * I) * (A - mu * I) * x_in
+    void perform_op(const Scalar* x_in, Scalar* y_out) const
+    {
+        //   inv(A - sigma * I) * (A - mu * I) * x
+        // = inv(A - sigma * I) * (A - sigma * I + (sigma - mu) * I) * x
+        // = x + (sigma - mu) * inv(A - sigma * I) * x
+        m_op.perform_op(x_in, y_out);
+        MapConstVec x(x_in, this->rows());
+        MapVec y(y_out, this->rows());
+        y.noalias() = x + (m_sigma - m_mu) * y;
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_GEN_EIGS_CAYLEY_OP_H
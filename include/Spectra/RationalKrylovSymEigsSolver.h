@@ -0,0 +1,559 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_RATIONAL_KRYLOV_SYM_EIGS_SOLVER_H
+#define SPECTRA_RATIONAL_KRYLOV_SYM_EIGS_SOLVER_H
+
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <cmath>      // std::abs, std::sqrt
+#include <vector>     // std::vector
+#include <memory>     // std::unique_ptr
+#include <future>     // std::future
+#include <algorithm>  // std::min, std::max, std::sort, std::find, std::lower_bound
+#include <stdexcept>  // std::invalid_argument
+
+#include "Util/Version.h"
+#include "Util/TypeTraits.h"
+#include "Util/CompInfo.h"
+#include "Util/ConvergenceRule.h"
+#include "Util/SimpleRandom.h"
+#include "Util/ThreadPool.h"
+#include "Util/Trace.h"
+#include "MatOp/DenseSymShiftSolve.h"
+
+namespace Spectra {
+
+///
+/// \ingroup EigenSolver
+///
+/// This class implements a rational Krylov eigen solver for real symmetric matrices,
+/// which computes the eigenvalues closest to several shifts \f$\sigma_1,\ldots,\sigma_s\f$
+/// in one search subspace. It is an alternative to running one SymEigsShiftSolver per
+/// shift in spectrum slicing and multi-window interior problems.
+///
+/// Each shift has a shift-solve operator, for example DenseSymShiftSolve or
+/// SparseSymShiftSolve, that computes \f$(A-\sigma_jI)^{-1}x\f$. In each iteration, the
+/// subspace is expanded by one solve per shift that still has unconverged eigenvalues,
+/// and these solves are run in parallel. The Ritz pairs of all windows are then extracted
+/// from the same projected matrix, so an eigenvector found near one shift is never
+/// computed again near a neighbouring shift, and the vectors generated by one shift
+/// also improve the Ritz pairs of the others.
+///
+/// Since \f$(A-\sigma I)w=x\f$ for \f$w=(A-\sigma I)^{-1}x\f$, the product \f$Aw=x+\sigma w\f$
+/// is known without multiplying by \f$A\f$. Hence the solver only needs the shift-solve
+/// operators, and the residual norms of the Ritz pairs are computed exactly. The subspace
+/// is restarted with the wanted Ritz vectors when its dimension reaches `ncv`.
+///
+/// The solver calls `set_shift()` of each operator in the constructor. To factorize the
+/// shifted matrices in parallel, call `set_shift_async()` of the operators before
+/// constructing the solver, as the later `set_shift()` waits for these factorizations
+/// instead of computing them again.
+///
+/// \tparam OpType  The name of the shift-solve operation class, which has the same
+///                 requirements as in SymEigsShiftSolver. `perform_op()` is called on
+///                 different operators at the same time, so the operators must not
+///                 share mutable state.
+///
+/// Example:
+/// \code{.cpp}
+/// // Three eigenvalues closest to each of the shifts
+/// std::vector<double> shifts{ -1.0, 0.0, 1.0 };
+/// // The operators are not copyable, so they are created in place
+/// std::vector<std::unique_ptr<SparseSymShiftSolve<double>>> ops;
+/// std::vector<SparseSymShiftSolve<double>*> op_ptrs;
+/// for (int j = 0; j < 3; j++)
+/// {
+///     ops.emplace_back(new SparseSymShiftSolve<double>(A));
+///     ops[j]->set_shift_async(shifts[j]);
+///     op_ptrs.push_back(ops[j].get());
+/// }
+/// RationalKrylovSymEigsSolver<SparseSymShiftSolve<double>> eigs(op_ptrs, shifts, 3, 30);
+/// eigs.init();
+/// eigs.compute();
+/// // Eigenvalues in increasing order, and the shifts they belong to
+/// Eigen::VectorXd evals = eigs.eigenvalues();
+/// std::vector<Eigen::Index> windows = eigs.shift_indices();
+/// \endcode
+///
+template <typename OpType = DenseSymShiftSolve<double>>
+class RationalKrylovSymEigsSolver
+{
+private:
+    using Scalar = typename OpType::Scalar;
+    using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using Array = Eigen::Array<Scalar, Eigen::Dynamic, 1>;
+    using BoolArray = Eigen::Array<bool, Eigen::Dynamic, 1>;
+    using MapConstVec = Eigen::Map<const Vector>;
+
+    // clang-format off
+    std::vector<OpType*>        m_ops;       // shift-solve operators, one per shift
+    const std::vector<Scalar>   m_shifts;    // shifts
+    const Index                 m_n;         // dimension of matrix A
+    const Index                 m_nev;       // number of eigenvalues wanted per shift
+    const Index                 m_ncv;       // maximum dimension of the subspace
+    int                         m_nthread;   // number of threads
+    std::unique_ptr<ThreadPool> m_pool;      // thread pool, created on demand
+
+    Matrix                      m_V;         // orthonormal basis of the subspace, n x ncv
+    Matrix                      m_AV;        // A * V, n x ncv
+    Index                       m_k;         // current dimension of the subspace
+
+    Vector                      m_ritz_val;  // Ritz values of the current subspace, increasing
+    Matrix                      m_ritz_vec;  // eigenvectors of the projected matrix
+    std::vector<Index>          m_wanted;    // indices of the wanted Ritz pairs, increasing
+    std::vector<Index>          m_window;    // shift index of each wanted Ritz pair
+    std::vector<Index>          m_closest;   // indices of the nev Ritz pairs closest to each
+                                             // shift, stored shift by shift
+    Array                       m_resid;     // residual norms of the wanted Ritz pairs
+    BoolArray                   m_conv;      // convergence of the wanted Ritz pairs
+
+    Vector                      m_evals;     // converged eigenvalues, increasing
+    Matrix                      m_evecs;     // converged eigenvectors
+    std::vector<Index>          m_evals_shift;  // shift index of each converged eigenvalue
+
+    Index                       m_nmatop;    // number of shift-solve operations called
+    Index                       m_niter;     // number of iterations
+    Scalar                      m_op_norm;   // estimate of the operator norm, from the Ritz values
+    CompInfo                    m_info;      // status of the computation
+    // clang-format on
+
+    Index num_shifts() const { return Index(m_shifts.size()); }
+
+    // Rayleigh-Ritz procedure on the current subspace, followed by the selection of
+    // the wanted Ritz pairs and the computation of their residual norms
+    void rayleigh_ritz()
+    {
+        using std::abs;
+
+        // Symmetrize the projected matrix to remove rounding errors
+        Matrix H = m_V.leftCols(m_k).transpose() * m_AV.leftCols(m_k);
+        H = (H + H.transpose()) / Scalar(2);
+        Eigen::SelfAdjointEigenSolver<Matrix> eig(H);
+        m_ritz_val.noalias() = eig.eigenvalues();
+        m_ritz_vec.noalias() = eig.eigenvectors();
+        m_op_norm = (std::max)(m_op_norm, m_ritz_val.cwiseAbs().maxCoeff());
+
+        // For each shift, the nev Ritz values closest to it
+        // A Ritz pair selected by several shifts belongs to the closest one
+        const Index nsel = (std::min)(m_nev, m_k);
+        std::vector<Index> owner(m_k, -1);
+        std::vector<Index> ind(m_k);
+        m_closest.clear();
+        for (Index j = 0; j < num_shifts(); j++)
+        {
+            const Scalar sigma = m_shifts[j];
+            for (Index i = 0; i < m_k; i++)
+                ind[i] = i;
+            std::partial_sort(ind.begin(), ind.begin() + nsel, ind.end(), [this, sigma](Index a, Index b) {
+                return abs(m_ritz_val[a] - sigma) < abs(m_ritz_val[b] - sigma);
+            });
+            m_closest.insert(m_closest.end(), ind.begin(), ind.begin() + nsel);
+            for (Index l = 0; l < nsel; l++)
+            {
+                const Index i = ind[l];
+                if (owner[i] < 0 || abs(m_ritz_val[i] - sigma) < abs(m_ritz_val[i] - m_shifts[owner[i]]))
+                    owner[i] = j;
+            }
+        }
+
+        m_wanted.clear();
+        m_window.clear();
+        for (Index i = 0; i < m_k; i++)
+        {
+            if (owner[i] >= 0)
+            {
+                m_wanted.push_back(i);
+                m_window.push_back(owner[i]);
+            }
+        }
+
+        // Residual norms ||A * x - theta * x||, x = V * y
+        const Index nwanted = Index(m_wanted.size());
+        m_resid.resize(nwanted);
+        Vector r(m_n);
+        for (Index l = 0; l < nwanted; l++)
+        {
+            const Index i = m_wanted[l];
+            r.noalias() = m_AV.leftCols(m_k) * m_ritz_vec.col(i);
+            r.noalias() -= m_ritz_val[i] * (m_V.leftCols(m_k) * m_ritz_vec.col(i));
+            m_resid[l] = r.norm();
+        }
+    }
+
+    // Whether the nev Ritz pairs closest to every shift have converged
+    bool windows_converged() const
+    {
+        if (m_k < m_nev)
+            return false;
+        for (Index i : m_closest)
+        {
+            // m_wanted is increasing, and contains every index in m_closest
+            const Index l = Index(std::lower_bound(m_wanted.begin(), m_wanted.end(), i) - m_wanted.begin());
+            if (!m_conv[l])
+                return false;
+        }
+        return true;
+    }
+
+    // Calls func(j) for j = 0, ..., ntask - 1, in parallel if more than one thread is used
+    template <typename Func>
+    void parallel_for(Index ntask, Func&& func)
+    {
+        if (m_nthread <= 1 || ntask <= 1)
+        {
+            for (Index j = 0; j < ntask; j++)
+                func(j);
+            return;
+        }
+
+        if (!m_pool)
+            m_pool.reset(new ThreadPool(m_nthread));
+        std::vector<std::future<void>> res;
+        res.reserve(ntask);
+        for (Index j = 0; j < ntask; j++)
+            res.push_back(m_pool->submit([&func, j]() { func(j); }));
+        // get() rethrows the exceptions of the tasks
+        for (auto& r : res)
+            r.get();
+    }
+
+    // Replaces the basis by the Ritz vectors with the given indices
+    void restart(const std::vector<Index>& keep)
+    {
+        SPECTRA_TRACE_SCOPE("RationalKrylovSymEigs::restart");
+
+        const Index nkeep = Index(keep.size());
+        Matrix Y(m_k, nkeep);
+        for (Index l = 0; l < nkeep; l++)
+            Y.col(l).noalias() = m_ritz_vec.col(keep[l]);
+
+        Matrix tmp = m_V.leftCols(m_k) * Y;
+        m_V.leftCols(nkeep).noalias() = tmp;
+        tmp.noalias() = m_AV.leftCols(m_k) * Y;
+        m_AV.leftCols(nkeep).noalias() = tmp;
+        m_k = nkeep;
+    }
+
+    // Orthonormalizes w against the current basis, applying the same operations to Aw,
+    // and appends it to the basis. Returns false if w is numerically in the subspace
+    bool append(Vector& w, Vector& Aw)
+    {
+        using std::sqrt;
+
+        // Two passes of classical Gram-Schmidt for numerical stability
+        const Scalar wnorm0 = w.norm();
+        Vector c(m_k);
+        for (int pass = 0; pass < 2; pass++)
+        {
+            c.noalias() = m_V.leftCols(m_k).transpose() * w;
+            w.noalias() -= m_V.leftCols(m_k) * c;
+            Aw.noalias() -= m_AV.leftCols(m_k) * c;
+        }
+        const Scalar wnorm = w.norm();
+        if (!(wnorm > sqrt(TypeTraits<Scalar>::epsilon()) * wnorm0))
+            return false;
+
+        m_V.col(m_k).noalias() = w / wnorm;
+        m_AV.col(m_k).noalias() = Aw / wnorm;
+        m_k++;
+        return true;
+    }
+
+    // Expands the subspace with the shift-solves of the residuals of the wanted
+    // Ritz pairs, one per shift, computed in parallel
+    // Returns the number of new basis vectors
+    Index expand()
+    {
+        SPECTRA_TRACE_SCOPE("RationalKrylovSymEigs::expand");
+
+        // For each shift, the unconverged Ritz pair with the largest residual
+        const Index nwanted = Index(m_wanted.size());
+        std::vector<Index> pick(num_shifts(), -1);
+        for (Index l = 0; l < nwanted; l++)
+        {
+            Index& p = pick[m_window[l]];
+            if (!m_conv[l] && (p < 0 || m_resid[l] > m_resid[p]))
+                p = l;
+        }
+        std::vector<Index> shift_ind;
+        for (Index j = 0; j < num_shifts(); j++)
+        {
+            if (pick[j] >= 0)
+                shift_ind.push_back(j);
+        }
+        const Index nnew = Index(shift_ind.size());
+
+        // Normalized residuals r = A * x - theta * x, where x = V * y is the Ritz vector
+        // Since (A - sigma * I) * x = r + (theta - sigma) * x, the solve of r extends
+        // the subspace in the same way as the solve of x, but does not produce a large
+        // component in the direction of x that cancels in the orthogonalization
+        Matrix R(m_n, nnew);
+        for (Index t = 0; t < nnew; t++)
+        {
+            const Index l = pick[shift_ind[t]], i = m_wanted[l];
+            R.col(t).noalias() = m_AV.leftCols(m_k) * m_ritz_vec.col(i);
+            R.col(t).noalias() -= m_ritz_val[i] * (m_V.leftCols(m_k) * m_ritz_vec.col(i));
+            R.col(t) /= m_resid[l];
+        }
+
+        // Restart if there is no space for the new vectors
+        if (m_k + nnew > m_ncv)
+        {
+            // Keep the wanted Ritz vectors, and half of the remaining space is filled
+            // with the other Ritz vectors closest to the shifts
+            std::vector<Index> keep(m_wanted);
+            const Index nkeep = nwanted + (m_ncv - num_shifts() - nwanted) / 2;
+            std::vector<Index> rest;
+            for (Index i = 0; i < m_k; i++)
+            {
+                if (std::find(m_wanted.begin(), m_wanted.end(), i) == m_wanted.end())
+                    rest.push_back(i);
+            }
+            std::sort(rest.begin(), rest.end(), [this](Index a, Index b) {
+                return dist_to_shifts(m_ritz_val[a]) < dist_to_shifts(m_ritz_val[b]);
+            });
+            for (Index l = 0; l < Index(rest.size()) && Index(keep.size()) < nkeep; l++)
+                keep.push_back(rest[l]);
+            restart(keep);
+        }
+
+        // W = inv(A - sigma * I) * R, and A * W = R + sigma * W
+        Matrix W(m_n, nnew);
+        parallel_for(nnew, [this, &shift_ind, &R, &W](Index t) {
+            m_ops[shift_ind[t]]->perform_op(&R(0, t), &W(0, t));
+        });
+        m_nmatop += nnew;
+
+        Index added = 0;
+        Vector w(m_n), Aw(m_n);
+        for (Index t = 0; t < nnew; t++)
+        {
+            w.noalias() = W.col(t);
+            Aw.noalias() = R.col(t) + m_shifts[shift_ind[t]] * w;
+            if (append(w, Aw))
+                added++;
+        }
+        return added;
+    }
+
+    // Distance from x to the closest shift
+    Scalar dist_to_shifts(const Scalar& x) const
+    {
+        using std::abs;
+        Scalar res = abs(x - m_shifts[0]);
+        for (Index j = 1; j < num_shifts(); j++)
+            res = (std::min)(res, Scalar(abs(x - m_shifts[j])));
+        return res;
+    }
+
+public:
+    ///
+    /// Constructor to create a solver object.
+    ///
+    /// \param ops    Pointers to the shift-solve operators, one for each shift. The
+    ///               operators must be distinct objects and have the same dimension.
+    /// \param shifts The shifts \f$\sigma_1,\ldots,\sigma_s\f$. `set_shift(shifts[j])`
+    ///               is called on `ops[j]`.
+    /// \param nev    Number of eigenvalues requested for each shift. The eigenvalues
+    ///               closest to each shift are computed, and an eigenvalue requested by
+    ///               several shifts is only computed once.
+    /// \param ncv    Maximum dimension of the subspace. It must satisfy
+    ///               \f$(nev+1)s\le ncv\le n\f$, where \f$n\f$ is the size of matrix,
+    ///               and \f$s\f$ is the number of shifts. A value that leaves room for a
+    ///               few more vectors per shift than \f$nev\cdot s\f$ is recommended.
+    ///
+    RationalKrylovSymEigsSolver(const std::vector<OpType*>& ops, const std::vector<Scalar>& shifts,
+                                Index nev, Index ncv) :
+        m_ops(ops),
+        m_shifts(shifts),
+        m_n(ops.empty() ? 0 : ops[0]->rows()),
+        m_nev(nev),
+        m_ncv(ncv),
+        m_nthread((std::min)(ThreadPool::default_num_threads(), int(shifts.size()))),
+        m_k(0),
+        m_nmatop(0),
+        m_niter(0),
+        m_op_norm(0),
+        m_info(CompInfo::NotComputed)
+    {
+        if (shifts.empty())
+            throw std::invalid_argument("RationalKrylovSymEigsSolver: there must be at least one shift");
+        if (ops.size() != shifts.size())
+            throw std::invalid_argument("RationalKrylovSymEigsSolver: the numbers of operators and shifts do not match");
+        for (std::size_t j = 0; j < ops.size(); j++)
+        {
+            if (ops[j] == nullptr || ops[j]->rows() != m_n)
+                throw std::invalid_argument("RationalKrylovSymEigsSolver: the operators must have the same dimension");
+            if (std::find(ops.begin(), ops.begin() + j, ops[j]) != ops.begin() + j)
+                throw std::invalid_argument("RationalKrylovSymEigsSolver: the operators must be distinct objects");
+        }
+        if (nev < 1)
+            throw std::invalid_argument("nev must be greater than zero");
+        if (ncv < (nev + 1) * num_shifts() || ncv > m_n)
+            throw std::invalid_argument("ncv must satisfy (nev + 1) * s <= ncv <= n, s is the number of shifts and n is the size of matrix");
+
+        for (Index j = 0; j < num_shifts(); j++)
+            m_ops[j]->set_shift(m_shifts[j]);
+    }
+
+    ///
+    /// Sets the number of threads used to run the shift-solves of different shifts.
+    /// If it is not positive, the number of hardware threads is used.
+    ///
+    void set_num_threads(int nthread)
+    {
+        nthread = (nthread > 0) ? nthread : ThreadPool::default_num_threads();
+        if (nthread != m_nthread)
+            m_pool.reset();
+        m_nthread = nthread;
+    }
+
+    ///
+    /// Initializes the solver by providing an initial vector.
+    ///
+    /// \param init_vec Pointer to the initial vector, which must be nonzero.
+    ///
+    /// The first basis vector is the shift-solve of the initial vector with
+    /// the first shift.
+    ///
+    void init(const Scalar* init_vec)
+    {
+        MapConstVec v0(init_vec, m_n);
+        if (v0.norm() <= Scalar(0))
+            throw std::invalid_argument("RationalKrylovSymEigsSolver: initial vector cannot be zero");
+
+        m_V.resize(m_n, m_ncv);
+        m_AV.resize(m_n, m_ncv);
+        m_k = 0;
+        m_nmatop = 0;
+        m_niter = 0;
+        m_op_norm = Scalar(0);
+        m_evals.resize(0);
+        m_evecs.resize(0, 0);
+        m_evals_shift.clear();
+        m_info = CompInfo::NotComputed;
+
+        Vector w(m_n);
+        m_ops[0]->perform_op(v0.data(), w.data());
+        m_nmatop++;
+        Vector Aw = v0 + m_shifts[0] * w;
+        if (!append(w, Aw))
+            throw std::invalid_argument("RationalKrylovSymEigsSolver: initial vector cannot be zero");
+    }
+
+    ///
+    /// Initializes the solver by providing a random initial vector.
+    ///
+    /// This overloaded function generates a random initial vector
+    /// (with a fixed random seed) for the algorithm. Elements in the vector
+    /// follow independent Uniform(-0.5, 0.5) distribution.
+    ///
+    void init()
+    {
+        SimpleRandom<Scalar> rng(0);
+        Vector init_vec = rng.random_vec(m_n);
+        init(init_vec.data());
+    }
+
+    ///
+    /// Conducts the major computation procedure.
+    ///
+    /// \param maxit      Maximum number of iterations allowed in the algorithm.
+    /// \param tol        Precision parameter for the calculated eigenvalues.
+    /// \param criterion  Convergence criterion of the Ritz pairs, with the same meaning
+    ///                   as in SymEigsSolver. The residual norms \f$\|Ax-\theta x\|\f$
+    ///                   are computed exactly in this solver.
+    ///
+    /// \return Number of converged eigenvalues.
+    ///
+    Index compute(Index maxit = 1000, Scalar tol = 1e-10,
+                  const ConvergenceCriterion<Scalar>& criterion = ConvergenceRule::RitzValue)
+    {
+        SPECTRA_TRACE_SCOPE("RationalKrylovSymEigs::compute");
+
+        if (m_k < 1)
+            init();
+
+        Index i;
+        for (i = 0;; i++)
+        {
+            rayleigh_ritz();
+            Array theta_abs(m_wanted.size());
+            for (Index l = 0; l < theta_abs.size(); l++)
+                theta_abs[l] = std::abs(m_ritz_val[m_wanted[l]]);
+            // A zero residual means that the Ritz pair is exact
+            m_conv = criterion.converged(theta_abs, m_resid, m_op_norm, tol) || (m_resid == Scalar(0));
+
+            // Only the nev Ritz pairs closest to each shift are tested
+            if (windows_converged() || i >= maxit)
+                break;
+            // Stop if the subspace cannot be expanded further
+            if (expand() == 0)
+                break;
+        }
+        m_niter += i;
+
+        // Converged eigenpairs, in increasing order of eigenvalues
+        const Index nconv = m_conv.count();
+        m_evals.resize(nconv);
+        m_evecs.resize(m_n, nconv);
+        m_evals_shift.clear();
+        for (Index l = 0, c = 0; l < Index(m_wanted.size()); l++)
+        {
+            if (!m_conv[l])
+                continue;
+            const Index ind = m_wanted[l];
+            m_evals[c] = m_ritz_val[ind];
+            m_evecs.col(c).noalias() = m_V.leftCols(m_k) * m_ritz_vec.col(ind);
+            m_evals_shift.push_back(m_window[l]);
+            c++;
+        }
+
+        m_info = windows_converged() ? CompInfo::Successful : CompInfo::NotConverging;
+        return nconv;
+    }
+
+    ///
+    /// Returns the status of the computation.
+    /// The full list of enumeration values can be found in \ref Enumerations.
+    ///
+    CompInfo info() const { return m_info; }
+
+    ///
+    /// Returns the number of iterations used in the computation.
+    ///
+    Index num_iterations() const { return m_niter; }
+
+    ///
+    /// Returns the number of shift-solve operations used in the computation,
+    /// summed over all shifts.
+    ///
+    Index num_operations() const { return m_nmatop; }
+
+    ///
+    /// Returns the converged eigenvalues in increasing order.
+    ///
+    Vector eigenvalues() const { return m_evals; }
+
+    ///
+    /// Returns the eigenvectors associated with the converged eigenvalues,
+    /// normalized to unit length and orthogonal to each other.
+    ///
+    Matrix eigenvectors() const { return m_evecs; }
+
+    ///
+    /// Returns the index of the shift that each converged eigenvalue belongs to,
+    /// which is the closest shift among those that requested the eigenvalue.
+    ///
+    std::vector<Index> shift_indices() const { return m_evals_shift; }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_RATIONAL_KRYLOV_SYM_EIGS_SOLVER_H
@@ -9,20 +9,23 @@
 
 #include <Eigen/Core>
 #include <vector>     // std::vector
-#include <cmath>      // std::abs, std::pow
-#include <algorithm>  // std::min
-#include <stdexcept>  // std::invalid_argument
+#include <cmath>      // std::abs, std::pow, std::sqrt
+#include <algorithm>  // std::min, std::max
+#include <stdexcept>  // std::invalid_argument, std::logic_error
 #include <utility>    // std::move
 
 #include "Util/Version.h"
 #include "Util/TypeTraits.h"
 #include "Util/SelectionRule.h"
 #include "Util/CompInfo.h"
+#include "Util/ConvergenceRule.h"
 #include "Util/SimpleRandom.h"
+#include "Util/Trace.h"
 #include "MatOp/internal/ArnoldiOp.h"
 #include "LinAlg/UpperHessenbergQR.h"
 #include "LinAlg/TridiagEigen.h"
 #include "LinAlg/Lanczos.h"
+#include "LinAlg/KrylovFactorization.h"
 
 namespace Spectra {
 
@@ -68,8 +71,10 @@ protected:
     std::vector<OpType> m_op_container;
     const OpType& m_op;         // matrix operator for A
     const Index   m_n;          // dimension of matrix A
-    const Index   m_nev;        // number of eigenvalues requested
-    const Index   m_ncv;        // dimension of Krylov subspace in the Lanczos method
+    Index         m_nev;        // number of eigenvalues requested
+    Index         m_ncv;        // dimension of Krylov subspace in the Lanczos method
+    const Index   m_nev_init;   // nev and ncv given in the constructor, which are
+    const Index   m_ncv_init;   // restored by init() after compute_threshold()
     Index         m_nmatop;     // number of matrix operations called
     Index         m_niter;      // number of restarting iterations
 
@@ -81,6 +86,8 @@ private:
     Vector        m_ritz_est;   // last row of m_ritz_vec, also called the Ritz estimates
     BoolArray     m_ritz_conv;  // indicator of the convergence of Ritz values
     CompInfo      m_info;       // status of the computation
+    Scalar        m_op_norm;    // estimate of the operator norm, from the Ritz values
+    ConvergenceCriterion<Scalar> m_conv;  // convergence criterion used by compute()
     // clang-format on
 
     // Move rvalue object to the container
@@ -94,6 +101,8 @@ private:
     // Implicitly restarted Lanczos factorization
     void restart(Index k, SortRule selection)
     {
+        SPECTRA_TRACE_SCOPE("SymEigs::restart");
+
         using std::abs;
 
         if (k >= m_ncv)
@@ -137,22 +146,33 @@ private:
         retrieve_ritzpair(selection);
     }
 
-    // Calculates the number of converged Ritz values
-    Index num_converged(const Scalar& tol)
+    // Operators that apply A inexactly, e.g. IterativeSymShiftSolve, provide
+    // set_inner_tolerance() to let the eigen solver control the accuracy,
+    // which returns whether the tolerance is accepted
+    template <typename Op>
+    static auto set_op_tolerance(const Op& op, const Scalar& tol, int) -> decltype(bool(op.set_inner_tolerance(tol)))
     {
-        using std::pow;
+        return op.set_inner_tolerance(tol);
+    }
+    template <typename Op>
+    static bool set_op_tolerance(const Op&, const Scalar&, long) { return false; }
 
-        // The machine precision, ~= 1e-16 for the "double" type
-        const Scalar eps = TypeTraits<Scalar>::epsilon();
-        // std::pow() is not constexpr, so we do not declare eps23 to be constexpr
-        // But most compilers should be able to compute eps23 at compile time
-        const Scalar eps23 = pow(eps, Scalar(2) / 3);
+    // Rebuilds the Lanczos factorization from the wanted Ritz vectors
+    void restart_from_ritz_vectors(SortRule selection)
+    {
+        Vector v0 = m_fac.matrix_V() * m_ritz_vec.leftCols(m_nev).rowwise().sum();
+        MapConstVec v0_map(v0.data(), m_n);
+        m_fac.init(v0_map, m_nmatop);
+        m_fac.factorize_from(1, m_ncv, m_nmatop);
+        retrieve_ritzpair(selection);
+    }
 
-        // thresh = tol * max(eps23, abs(theta)), theta for Ritz value
-        Array thresh = tol * m_ritz_val.head(m_nev).array().abs().max(eps23);
-        Array resid = m_ritz_est.head(m_nev).array().abs() * m_fac.f_norm();
+    // Calculates the number of converged Ritz values
+    Index num_converged(const Scalar& tol)
+    {
+        const Array resid = m_ritz_est.head(m_nev).array().abs() * m_fac.f_norm();
         // Converged "wanted" Ritz values
-        m_ritz_conv = (resid < thresh);
+        m_ritz_conv = m_conv.converged(m_ritz_val.head(m_nev).array().abs(), resid, m_op_norm, tol);
 
         return m_ritz_conv.count();
     }
@@ -187,9 +207,11 @@ private:
     // Retrieves and sorts Ritz values and Ritz vectors
     void retrieve_ritzpair(SortRule selection)
     {
-        TridiagEigen<Scalar> decomp(m_fac.matrix_H());
+        // Only the last row of the eigenvectors is needed for the Ritz estimates
+        TridiagEigen<Scalar> decomp;
+        decomp.compute_last_row(m_fac.matrix_H());
         const Vector& evals = decomp.eigenvalues();
-        const Matrix& evecs = decomp.eigenvectors();
+        const Vector& last_row = decomp.last_row();
 
         // Sort Ritz values and put the wanted ones at the beginning
         std::vector<Index> ind = argsort(selection, evals, m_ncv);
@@ -198,14 +220,159 @@ private:
         for (Index i = 0; i < m_ncv; i++)
         {
             m_ritz_val[i] = evals[ind[i]];
-            m_ritz_est[i] = evecs(m_ncv - 1, ind[i]);
+            m_ritz_est[i] = last_row[ind[i]];
         }
-        for (Index i = 0; i < m_nev; i++)
+        // The largest magnitude of the Ritz values is a lower bound of the operator norm
+        m_op_norm = (std::max)(m_op_norm, Scalar(evals.cwiseAbs().maxCoeff()));
+        // Only the wanted Ritz vectors are computed. Their Ritz estimates are taken from
+        // the vectors themselves, which may differ from the last row for repeated Ritz values
+        m_ritz_vec.noalias() = decomp.eigenvectors(std::vector<Index>(ind.begin(), ind.begin() + m_nev));
+        m_ritz_est.head(m_nev).noalias() = m_ritz_vec.row(m_ncv - 1).transpose();
+    }
+
+    // Resets the Ritz pairs and the counters, and restores nev and ncv if they
+    // have been increased by compute_threshold()
+    void reset_state()
+    {
+        if (m_ncv != m_ncv_init)
+            m_fac.resize(m_ncv_init);
+        m_nev = m_nev_init;
+        m_ncv = m_ncv_init;
+
+        // Reset all matrices/vectors to zero
+        m_ritz_val.resize(m_ncv);
+        m_ritz_vec.resize(m_ncv, m_nev);
+        m_ritz_est.resize(m_ncv);
+        m_ritz_conv.resize(m_nev);
+
+        m_ritz_val.setZero();
+        m_ritz_vec.setZero();
+        m_ritz_est.setZero();
+        m_ritz_conv.setZero();
+
+        m_nmatop = 0;
+        m_niter = 0;
+        m_op_norm = Scalar(0);
+    }
+
+    // Resets the solver and initializes the Lanczos factorization with v0
+    // If to_range is true, v0 is first multiplied by the operator
+    void init_factorization(const Scalar* v0_data, bool to_range)
+    {
+        reset_state();
+
+        // Initialize the Lanczos factorization
+        MapConstVec v0(v0_data, m_n);
+        m_fac.init(v0, m_nmatop, to_range);
+    }
+
+    // Runs the restarted Lanczos iterations with the criterion in m_conv, until nev Ritz
+    // pairs converge or maxit restarts are used, and returns the number of converged ones
+    // The wanted Ritz pairs are left in the order of the selection rule
+    Index iterate(SortRule selection, Index maxit, const Scalar& tol)
+    {
+        // For operators that apply A inexactly, the iterations run in two stages, as
+        // in inexact shift-invert Lanczos methods. The first stage uses loose inner
+        // solves, and stops when the Ritz pairs are as accurate as the inner solves
+        // allow. The second stage restarts from the Ritz vectors and uses tight inner
+        // solves, since the Ritz estimates of a basis built with loose inner solves
+        // do not reflect the true residuals
+        using std::sqrt;
+        const Scalar tight_tol = Scalar(0.1) * tol;
+        const Scalar stage_tol = (std::max)(tol, sqrt(tol));
+        const Scalar loose_tol = Scalar(0.1) * stage_tol;
+        const bool inexact = set_op_tolerance(m_op, loose_tol, 0);
+        bool loose_stage = inexact;
+
+        // The m-step Lanczos factorization, which extends the current one if compute()
+        // is called again or the solver is initialized with a saved factorization
+        m_fac.factorize_from(m_fac.subspace_dim(), m_ncv, m_nmatop);
+        retrieve_ritzpair(selection);
+        // Restarting
+        Index i, nconv = 0, nev_adj;
+        for (i = 0; i < maxit; i++)
+        {
+            if (loose_stage)
+            {
+                nconv = num_converged(stage_tol);
+                if (nconv >= m_nev)
+                {
+                    set_op_tolerance(m_op, tight_tol, 0);
+                    loose_stage = false;
+                    restart_from_ritz_vectors(selection);
+                    continue;
+                }
+            }
+            else
+            {
+                nconv = num_converged(tol);
+                if (nconv >= m_nev)
+                    break;
+            }
+
+            nev_adj = nev_adjusted(nconv);
+            restart(nev_adj, selection);
+        }
+
+        if (inexact)
+        {
+            // If maxit is reached in the first stage, the Ritz estimates do not reflect
+            // the true residuals, so no Ritz pair is reported as converged. Right after
+            // switching to the second stage, the factorization has been rebuilt with
+            // tight inner solves, and the Ritz pairs are checked against tol
+            if (i >= maxit && loose_stage)
+            {
+                m_ritz_conv.setZero();
+                nconv = 0;
+            }
+            else if (i >= maxit)
+            {
+                nconv = num_converged(tol);
+            }
+            // Restore the tolerance set by the user for later operations
+            set_op_tolerance(m_op, Scalar(0), 0);
+        }
+
+        m_niter += i + 1;
+        return nconv;
+    }
+
+    // Whether a Ritz value lies beyond the threshold, in the direction of the selection rule
+    static bool beyond_threshold(const Scalar& val, const Scalar& threshold, SortRule selection)
+    {
+        using std::abs;
+
+        switch (selection)
         {
-            m_ritz_vec.col(i).noalias() = evecs.col(ind[i]);
+            case SortRule::LargestAlge:
+                return val > threshold;
+            case SortRule::SmallestAlge:
+                return val < threshold;
+            case SortRule::LargestMagn:
+                return abs(val) > threshold;
+            default:
+                return abs(val) < threshold;
         }
     }
 
+    // Increases nev and ncv, keeping the current Lanczos factorization, so that the
+    // next call of iterate() extends the Krylov subspace instead of starting over
+    void grow_subspace(Index nev, Index ncv)
+    {
+        m_fac.resize(ncv);
+        m_nev = nev;
+        m_ncv = ncv;
+
+        m_ritz_val.resize(m_ncv);
+        m_ritz_vec.resize(m_ncv, m_nev);
+        m_ritz_est.resize(m_ncv);
+        m_ritz_conv.resize(m_nev);
+        m_ritz_val.setZero();
+        m_ritz_vec.setZero();
+        m_ritz_est.setZero();
+        m_ritz_conv.setZero();
+    }
+
 protected:
     // Sorts the first nev Ritz pairs in the specified order
     // This is used to return the final results
@@ -242,10 +409,13 @@ public:
         m_n(op.rows()),
         m_nev(nev),
         m_ncv(ncv > m_n ? m_n : ncv),
+        m_nev_init(m_nev),
+        m_ncv_init(m_ncv),
         m_nmatop(0),
         m_niter(0),
         m_fac(ArnoldiOpType(op, Bop), m_ncv),
-        m_info(CompInfo::NotComputed)
+        m_info(CompInfo::NotComputed),
+        m_op_norm(0)
     {
         if (nev < 1 || nev > m_n - 1)
             throw std::invalid_argument("nev must satisfy 1 <= nev <= n - 1, n is the size of matrix");
@@ -261,10 +431,13 @@ public:
         m_n(m_op.rows()),
         m_nev(nev),
         m_ncv(ncv > m_n ? m_n : ncv),
+        m_nev_init(m_nev),
+        m_ncv_init(m_ncv),
         m_nmatop(0),
         m_niter(0),
         m_fac(ArnoldiOpType(m_op, Bop), m_ncv),
-        m_info(CompInfo::NotComputed)
+        m_info(CompInfo::NotComputed),
+        m_op_norm(0)
     {
         if (nev < 1 || nev > m_n - 1)
             throw std::invalid_argument("nev must satisfy 1 <= nev <= n - 1, n is the size of matrix");
@@ -291,23 +464,43 @@ public:
     ///
     void init(const Scalar* init_resid)
     {
-        // Reset all matrices/vectors to zero
-        m_ritz_val.resize(m_ncv);
-        m_ritz_vec.resize(m_ncv, m_nev);
-        m_ritz_est.resize(m_ncv);
-        m_ritz_conv.resize(m_nev);
+        init_factorization(init_resid, true);
+    }
 
-        m_ritz_val.setZero();
-        m_ritz_vec.setZero();
-        m_ritz_est.setZero();
-        m_ritz_conv.setZero();
+    ///
+    /// Initializes the solver by providing an approximation of the wanted eigenvectors.
+    ///
+    /// \param init_vec Pointer to the initial vector, typically a linear combination of
+    ///                 approximate eigenvectors, such as the one given by
+    ///                 MultilevelGraphInit::initial_vector().
+    ///
+    /// Different from init(const Scalar*), which first multiplies the initial residual
+    /// vector by the operator, this function uses `init_vec` as the first Lanczos vector
+    /// as it is. The multiplication would amplify the errors of approximate eigenvectors
+    /// associated with the smallest eigenvalues, and lose most of the warm start.
+    ///
+    void init_guess(const Scalar* init_vec)
+    {
+        init_factorization(init_vec, false);
+    }
 
-        m_nmatop = 0;
-        m_niter = 0;
+    ///
+    /// Initializes the solver with a saved Lanczos factorization of the same operator,
+    /// typically obtained from factorization() of another solver.
+    ///
+    /// The next call of compute() continues from the saved Krylov subspace, so a query
+    /// with a different selection rule or a different `nev` usually takes a few restarts
+    /// instead of a full computation. If the saved subspace is larger than `ncv`, its
+    /// leading `ncv`-dimensional part is used, so `ncv` should be at least
+    /// `fac.subspace_dim()` to keep all the information.
+    ///
+    void init(const KrylovFactorization<Scalar>& fac)
+    {
+        if (fac.rows() != m_n)
+            throw std::invalid_argument("the saved factorization does not match the size of the matrix");
 
-        // Initialize the Lanczos factorization
-        MapConstVec v0(init_resid, m_n);
-        m_fac.init(v0, m_nmatop);
+        reset_state();
+        m_fac.restore(fac.matrix_V(), fac.matrix_H(), fac.vector_f());
     }
 
     ///
@@ -327,6 +520,13 @@ public:
     ///
     /// Conducts the major computation procedure.
     ///
+    /// The computation starts from the current Lanczos factorization, which is the
+    /// one built by init() on the first call. If compute() is called again without
+    /// init(), for example with a different selection rule, the existing Krylov
+    /// subspace is restarted toward the new wanted eigenvalues instead of being rebuilt
+    /// from the initial vector, which differs from version 1.0.1 and earlier. Call
+    /// init() before compute() to start over from the initial vector.
+    ///
     /// \param selection  An enumeration value indicating the selection rule of
     ///                   the requested eigenvalues, for example `SortRule::LargestMagn`
     ///                   to retrieve eigenvalues with the largest magnitude.
@@ -344,40 +544,126 @@ public:
     ///                   (e.g. selecting the largest or smallest eigenvalues in the
     ///                   full spectrum) is specified by the parameter `selection`.
     ///
+    /// \param criterion  Convergence criterion of the Ritz pairs. It can be a
+    ///                   ConvergenceRule value, or a ConvergenceCriterion object
+    ///                   holding a user function. The default
+    ///                   `ConvergenceRule::RitzValue` is the criterion of **ARPACK**.
+    ///                   For eigenvalues close to zero, `ConvergenceRule::OperatorNorm`
+    ///                   avoids computing them to an unnecessarily high relative accuracy.
+    ///
     /// \return Number of converged eigenvalues.
     ///
     Index compute(SortRule selection = SortRule::LargestMagn, Index maxit = 1000,
-                  Scalar tol = 1e-10, SortRule sorting = SortRule::LargestAlge)
+                  Scalar tol = 1e-10, SortRule sorting = SortRule::LargestAlge,
+                  const ConvergenceCriterion<Scalar>& criterion = ConvergenceRule::RitzValue)
     {
-        // The m-step Lanczos factorization
-        m_fac.factorize_from(1, m_ncv, m_nmatop);
-        retrieve_ritzpair(selection);
-        // Restarting
-        Index i, nconv = 0, nev_adj;
-        for (i = 0; i < maxit; i++)
-        {
-            nconv = num_converged(tol);
-            if (nconv >= m_nev)
-                break;
+        SPECTRA_TRACE_SCOPE("SymEigs::compute");
+
+        m_conv = criterion;
+        const Index nconv = iterate(selection, maxit, tol);
 
-            nev_adj = nev_adjusted(nconv);
-            restart(nev_adj, selection);
-        }
         // Sorting results
         sort_ritzpair(sorting);
 
-        m_niter += i + 1;
         m_info = (nconv >= m_nev) ? CompInfo::Successful : CompInfo::NotConverging;
 
         return (std::min)(m_nev, nconv);
     }
 
+    ///
+    /// Computes all eigenvalues beyond a threshold, when their number is not known
+    /// in advance, for example all eigenvalues greater than 0.9.
+    ///
+    /// The computation starts with the `nev` and `ncv` given in the constructor. Once
+    /// `nev` Ritz values have converged and the last of them is still beyond the
+    /// threshold, `nev` is doubled and `ncv` grows accordingly, and the iterations
+    /// continue from the current Lanczos factorization, so the converged Ritz vectors
+    /// are kept in the subspace and the eigenvalues found so far are not recomputed.
+    /// The solver stops when a converged Ritz value crosses the threshold. The next
+    /// call of init() restores the `nev` and `ncv` given in the constructor.
+    ///
+    /// \param selection  The side of the threshold. `SortRule::LargestAlge` selects the
+    ///                   eigenvalues greater than `threshold`, `SortRule::SmallestAlge`
+    ///                   those less than it, and `SortRule::LargestMagn` and
+    ///                   `SortRule::SmallestMagn` compare the magnitudes of the
+    ///                   eigenvalues with it. Same as the selection rule in compute(), the
+    ///                   threshold applies to the eigenvalues of the operator, for example
+    ///                   \f$\nu=1/(\lambda-\sigma)\f$ in the shift-and-invert mode.
+    /// \param threshold  The threshold.
+    /// \param maxit      Maximum number of iterations, summed over all values of `nev`.
+    /// \param tol        Precision parameter for the calculated eigenvalues.
+    /// \param sorting    Rule to sort the eigenvalues and eigenvectors, same as in compute().
+    /// \param criterion  Convergence criterion of the Ritz pairs, same as in compute().
+    ///
+    /// \return Number of converged eigenvalues beyond the threshold, which are returned
+    ///         by eigenvalues() and eigenvectors(). `nev` is at most \f$n-1\f$, so
+    ///         `info()` returns `CompInfo::NotConverging` if all of the \f$n-1\f$
+    ///         eigenvalues are beyond the threshold.
+    ///
+    Index compute_threshold(SortRule selection, Scalar threshold, Index maxit = 1000,
+                            Scalar tol = 1e-10, SortRule sorting = SortRule::LargestAlge,
+                            const ConvergenceCriterion<Scalar>& criterion = ConvergenceRule::RitzValue)
+    {
+        SPECTRA_TRACE_SCOPE("SymEigs::compute_threshold");
+
+        if ((selection != SortRule::LargestAlge) && (selection != SortRule::LargestMagn) &&
+            (selection != SortRule::SmallestAlge) && (selection != SortRule::SmallestMagn))
+            throw std::invalid_argument("unsupported selection rule");
+
+        m_conv = criterion;
+        const Index niter0 = m_niter;
+        bool crossed = false;
+        for (;;)
+        {
+            const Index nconv = iterate(selection, maxit - (m_niter - niter0), tol);
+            if (nconv < m_nev)
+                break;
+            // The wanted Ritz values are in the order of the selection rule,
+            // so the last one is the closest to the threshold
+            if (!beyond_threshold(m_ritz_val[m_nev - 1], threshold, selection))
+            {
+                crossed = true;
+                break;
+            }
+            if (m_nev >= m_n - 1 || m_niter - niter0 >= maxit)
+                break;
+
+            const Index nev = (std::min)(2 * m_nev, m_n - 1);
+            const Index ncv = (std::min)(m_ncv + 2 * (nev - m_nev), m_n);
+            grow_subspace(nev, ncv);
+        }
+
+        // Only report the eigenvalues beyond the threshold
+        for (Index i = 0; i < m_nev; i++)
+            m_ritz_conv[i] = m_ritz_conv[i] && beyond_threshold(m_ritz_val[i], threshold, selection);
+        sort_ritzpair(sorting);
+
+        m_info = crossed ? CompInfo::Successful : CompInfo::NotConverging;
+        return m_ritz_conv.count();
+    }
+
     ///
     /// Returns the status of the computation.
     /// The full list of enumeration values can be found in \ref Enumerations.
     ///
     CompInfo info() const { return m_info; }
 
+    ///
+    /// Returns a copy of the current Lanczos factorization, which can be queried for Ritz
+    /// pairs under other selection rules, saved, or used to initialize another solver
+    /// with init(const KrylovFactorization&).
+    ///
+    KrylovFactorization<Scalar> factorization() const
+    {
+        const Index k = m_fac.subspace_dim();
+        if (k < 1)
+            throw std::logic_error("the solver has not been initialized");
+
+        return KrylovFactorization<Scalar>(m_fac.matrix_V().leftCols(k),
+                                           m_fac.matrix_H().topLeftCorner(k, k),
+                                           m_fac.vector_f());
+    }
+
     ///
     /// Returns the number of iterations used in the computation.
     ///
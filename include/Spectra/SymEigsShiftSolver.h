@@ -58,7 +58,9 @@ namespace Spectra {
 ///                 use the wrapper classes such as DenseSymShiftSolve and
 ///                 SparseSymShiftSolve, or define their own that implements the type
 ///                 definition `Scalar` and all the public member functions as in
-///                 DenseSymShiftSolve.
+///                 DenseSymShiftSolve. For matrices too large to be factorized,
+///                 IterativeSymShiftSolve solves the shifted systems iteratively,
+///                 with tolerances controlled by the eigen solver.
 ///
 /// Below is an example that illustrates the use of the shift-and-invert mode:
 ///
@@ -0,0 +1,149 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_CONVERGENCE_RULE_H
+#define SPECTRA_CONVERGENCE_RULE_H
+
+#include <Eigen/Core>
+#include <cmath>       // std::pow
+#include <algorithm>   // std::max
+#include <functional>  // std::function
+#include <utility>     // std::move
+#include <stdexcept>   // std::invalid_argument
+
+#include "TypeTraits.h"
+
+namespace Spectra {
+
+///
+/// \ingroup Enumerations
+///
+/// The enumeration of convergence criteria of Ritz pairs. In the descriptions below,
+/// \f$\theta\f$ is a Ritz value, \f$r\f$ is the residual norm of the Ritz pair estimated
+/// from the Krylov factorization, and \f$\epsilon\f$ is the machine precision.
+///
+enum class ConvergenceRule
+{
+    RitzValue,  ///< \f$r<\mathrm{tol}\cdot\max(\epsilon^{2/3},|\theta|)\f$, the ARPACK criterion.
+                ///< This is the default rule.
+
+    OperatorNorm,  ///< \f$r<\mathrm{tol}\cdot\max(\epsilon^{2/3},\widehat{\|A\|})\f$, where
+                   ///< \f$\widehat{\|A\|}\f$ is the largest magnitude of all Ritz values
+                   ///< computed so far, a lower bound of the norm of the operator.
+                   ///< Eigenvalues close to zero are then computed to the same absolute
+                   ///< accuracy as the others, rather than being oversolved.
+
+    Absolute,  ///< \f$r<\mathrm{tol}\f$.
+
+    Custom  ///< A user-supplied function, see ConvergenceCriterion.
+};
+
+///
+/// The convergence criterion used in the `compute()` member function of
+/// eigen solvers. It can be implicitly constructed from a ConvergenceRule value,
+/// or from a user function that decides whether one Ritz pair has converged.
+///
+/// Example:
+/// \code{.cpp}
+/// // Relative to the estimated operator norm
+/// eigs.compute(SortRule::LargestMagn, 1000, 1e-8, SortRule::LargestAlge,
+///              ConvergenceRule::OperatorNorm);
+///
+/// // A user function, with arguments |theta|, r, ||A|| estimate, and tol
+/// ConvergenceCriterion<double> crit([](double theta, double resid, double anorm, double tol) {
+///     return resid < tol * std::max(1.0, theta);
+/// });
+/// eigs.compute(SortRule::LargestMagn, 1000, 1e-8, SortRule::LargestAlge, crit);
+/// \endcode
+///
+template <typename Scalar>
+class ConvergenceCriterion
+{
+public:
+    ///
+    /// Type of the user function. The arguments are the magnitude of the Ritz value,
+    /// the residual norm estimate, the estimate of the operator norm, and the
+    /// tolerance passed to `compute()`. It returns whether the Ritz pair has converged.
+    ///
+    using Function = std::function<bool(const Scalar& theta_abs, const Scalar& resid,
+                                        const Scalar& op_norm, const Scalar& tol)>;
+
+private:
+    using Index = Eigen::Index;
+    using Array = Eigen::Array<Scalar, Eigen::Dynamic, 1>;
+    using BoolArray = Eigen::Array<bool, Eigen::Dynamic, 1>;
+
+    ConvergenceRule m_rule;
+    Function m_fun;
+
+public:
+    ///
+    /// Constructor from one of the built-in rules.
+    ///
+    ConvergenceCriterion(ConvergenceRule rule = ConvergenceRule::RitzValue) :
+        m_rule(rule)
+    {
+        if (rule == ConvergenceRule::Custom)
+            throw std::invalid_argument("ConvergenceCriterion: a custom rule requires a function");
+    }
+
+    ///
+    /// Constructor from a user function.
+    ///
+    ConvergenceCriterion(Function fun) :
+        m_rule(ConvergenceRule::Custom), m_fun(std::move(fun))
+    {
+        if (!m_fun)
+            throw std::invalid_argument("ConvergenceCriterion: the function is empty");
+    }
+
+    ///
+    /// The rule of this criterion.
+    ///
+    ConvergenceRule rule() const { return m_rule; }
+
+    ///
+    /// Tests the convergence of a set of Ritz pairs.
+    ///
+    /// \param theta_abs Magnitudes of the Ritz values.
+    /// \param resid     Residual norm estimates of the Ritz pairs.
+    /// \param op_norm   Estimate of the operator norm.
+    /// \param tol       Tolerance passed to `compute()`.
+    ///
+    BoolArray converged(const Array& theta_abs, const Array& resid,
+                        const Scalar& op_norm, const Scalar& tol) const
+    {
+        using std::pow;
+
+        // The machine precision, ~= 1e-16 for the "double" type
+        const Scalar eps = TypeTraits<Scalar>::epsilon();
+        // std::pow() is not constexpr, so we do not declare eps23 to be constexpr
+        // But most compilers should be able to compute eps23 at compile time
+        const Scalar eps23 = pow(eps, Scalar(2) / 3);
+
+        switch (m_rule)
+        {
+            case ConvergenceRule::OperatorNorm:
+                return resid < tol * (std::max)(eps23, op_norm);
+            case ConvergenceRule::Absolute:
+                return resid < tol;
+            case ConvergenceRule::Custom:
+            {
+                BoolArray res(theta_abs.size());
+                for (Index i = 0; i < theta_abs.size(); i++)
+                    res[i] = m_fun(theta_abs[i], resid[i], op_norm, tol);
+                return res;
+            }
+            default:
+                // thresh = tol * max(eps23, abs(theta)), theta for Ritz value
+                return resid < tol * theta_abs.max(eps23);
+        }
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_CONVERGENCE_RULE_H
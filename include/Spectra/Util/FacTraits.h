@@ -0,0 +1,295 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_FAC_TRAITS_H
+#define SPECTRA_FAC_TRAITS_H
+
+#include <Eigen/Core>
+#include <Eigen/SparseCholesky>
+#include <type_traits>  // std::true_type, std::false_type
+#include <utility>      // std::declval
+#include <stdexcept>    // std::runtime_error
+
+#include "CompInfo.h"
+
+namespace Spectra {
+
+/// \cond
+
+// Detect optional member functions of a factorization backend
+template <typename FacType>
+class FacMemberDetector
+{
+private:
+    template <typename T>
+    static auto test_is_symmetric(int) -> decltype(std::declval<T&>().isSymmetric(true), std::true_type());
+    template <typename T>
+    static std::false_type test_is_symmetric(...);
+
+    template <typename T, typename MatType>
+    static auto test_analyze(int) -> decltype(std::declval<T&>().analyzePattern(std::declval<const MatType&>()), std::true_type());
+    template <typename T, typename MatType>
+    static std::false_type test_analyze(...);
+
+    template <typename T, typename MatType>
+    static auto test_compute_uplo(int) -> decltype(std::declval<T&>().compute(std::declval<const MatType&>(), int(0)), std::true_type());
+    template <typename T, typename MatType>
+    static std::false_type test_compute_uplo(...);
+
+    template <typename T>
+    static auto test_inertia(int) -> decltype(std::declval<const T&>().inertia(std::declval<Eigen::Index&>(), std::declval<Eigen::Index&>(), std::declval<Eigen::Index&>()), std::true_type());
+    template <typename T>
+    static std::false_type test_inertia(...);
+
+    template <typename T, typename MatType>
+    static auto test_factorize(int) -> decltype(std::declval<T&>().factorize(std::declval<const MatType&>()), std::true_type());
+    template <typename T, typename MatType>
+    static std::false_type test_factorize(...);
+
+    template <typename T, typename MatType>
+    static auto test_compute_inplace(int) -> decltype(std::declval<T&>().compute_inplace(std::declval<MatType&>()), std::true_type());
+    template <typename T, typename MatType>
+    static std::false_type test_compute_inplace(...);
+
+public:
+    using HasIsSymmetric = decltype(test_is_symmetric<FacType>(0));
+    using HasInertia = decltype(test_inertia<FacType>(0));
+
+    template <typename MatType>
+    using HasAnalyzePattern = decltype(test_analyze<FacType, MatType>(0));
+
+    template <typename MatType>
+    using HasFactorize = decltype(test_factorize<FacType, MatType>(0));
+
+    template <typename MatType>
+    using HasComputeUplo = decltype(test_compute_uplo<FacType, MatType>(0));
+
+    template <typename MatType>
+    using HasComputeInplace = decltype(test_compute_inplace<FacType, MatType>(0));
+};
+
+template <typename T>
+struct FacAlwaysFalse : std::false_type
+{};
+
+// Default implementations of FacTraits, shared by its specializations
+template <typename FacType>
+class FacTraitsBase
+{
+private:
+    using Detector = FacMemberDetector<FacType>;
+
+    template <typename MatType>
+    static void analyze_impl(FacType& fac, const MatType& mat, std::true_type) { fac.analyzePattern(mat); }
+    template <typename MatType>
+    static void analyze_impl(FacType&, const MatType&, std::false_type) {}
+
+    template <typename MatType>
+    static void factorize_impl(FacType& fac, const MatType& mat, std::true_type) { fac.factorize(mat); }
+    template <typename MatType>
+    static void factorize_impl(FacType& fac, const MatType& mat, std::false_type) { fac.compute(mat); }
+
+    template <typename MatType>
+    static void factorize_uplo_impl(FacType& fac, const MatType& mat, int uplo, std::true_type) { fac.compute(mat, uplo); }
+    template <typename MatType>
+    static void factorize_uplo_impl(FacType& fac, const MatType& mat, int uplo, std::false_type)
+    {
+        if (uplo == Eigen::Lower)
+            factorize(fac, mat);
+        else
+            factorize(fac, mat.transpose());
+    }
+
+    template <typename MatType>
+    static void factorize_inplace_impl(FacType& fac, MatType& mat, std::true_type) { fac.compute_inplace(mat); }
+    template <typename MatType>
+    static void factorize_inplace_impl(FacType& fac, MatType& mat, std::false_type) { factorize(fac, mat, Eigen::Lower); }
+
+    static void set_symmetric_impl(FacType& fac, bool sym, std::true_type) { fac.isSymmetric(sym); }
+    static void set_symmetric_impl(FacType&, bool, std::false_type) {}
+
+    static bool is_success(Eigen::ComputationInfo info) { return info == Eigen::Success; }
+    static bool is_success(CompInfo info) { return info == CompInfo::Successful; }
+
+public:
+    // Hint that the matrix to be factorized is symmetric
+    static void set_symmetric(FacType& fac, bool sym)
+    {
+        set_symmetric_impl(fac, sym, typename Detector::HasIsSymmetric());
+    }
+
+    // Symbolic analysis, only depending on the sparsity pattern of mat
+    template <typename MatType>
+    static void analyze(FacType& fac, const MatType& mat)
+    {
+        analyze_impl(fac, mat, typename Detector::template HasAnalyzePattern<MatType>());
+    }
+
+    // Numeric factorization, assuming that analyze() has been called on a
+    // matrix with the same sparsity pattern
+    template <typename MatType>
+    static void factorize(FacType& fac, const MatType& mat)
+    {
+        factorize_impl(fac, mat, typename Detector::template HasFactorize<MatType>());
+    }
+
+    // Numeric factorization of a dense symmetric matrix, where only the lower
+    // (uplo = Eigen::Lower) or upper (uplo = Eigen::Upper) triangular part of mat
+    // is referenced
+    // Backends such as BKLDLT accept the uplo argument in compute(mat, uplo), and
+    // other backends are assumed to read the lower triangular part
+    template <typename MatType>
+    static void factorize(FacType& fac, const MatType& mat, int uplo)
+    {
+        factorize_uplo_impl(fac, mat, uplo, typename Detector::template HasComputeUplo<MatType>());
+    }
+
+    // Numeric factorization of a dense symmetric matrix stored in the lower triangular
+    // part of the column-major matrix mat, which may be overwritten by the factors
+    // Backends such as BKLDLT provide compute_inplace(mat) to avoid copying the matrix,
+    // and other backends fall back to factorize(fac, mat, Eigen::Lower)
+    template <typename MatType>
+    static void factorize_inplace(FacType& fac, MatType& mat)
+    {
+        factorize_inplace_impl(fac, mat, typename Detector::template HasComputeInplace<MatType>());
+    }
+
+    // Whether the last factorization was successful
+    static bool success(const FacType& fac) { return is_success(fac.info()); }
+
+    // x = inv(M) * b, where b can be a vector or a matrix
+    template <typename Rhs, typename Dest>
+    static void solve(const FacType& fac, const Rhs& b, Dest& x)
+    {
+        x.noalias() = fac.solve(b);
+    }
+
+    // For Cholesky backends, M = P' * L * L' * P
+    // x = inv(L) * P * b
+    template <typename Rhs, typename Dest>
+    static void lower_triangular_solve(const FacType& fac, const Rhs& b, Dest& x)
+    {
+        // The permutation is empty if no fill-reducing ordering is used
+        if (fac.permutationP().size() > 0)
+            x.noalias() = fac.permutationP() * b;
+        else
+            x.noalias() = b;
+        fac.matrixL().solveInPlace(x);
+    }
+
+    // x = P' * inv(L') * b
+    template <typename Rhs, typename Dest>
+    static void upper_triangular_solve(const FacType& fac, const Rhs& b, Dest& x)
+    {
+        x.noalias() = fac.matrixU().solve(b);
+        if (fac.permutationPinv().size() > 0)
+            x = fac.permutationPinv() * x;
+    }
+};
+
+/// \endcond
+
+///
+/// \ingroup Internals
+///
+/// Adaptor between the matrix operation classes and a matrix factorization backend.
+///
+/// Classes such as SparseSymShiftSolve, SparseGenRealShiftSolve, SparseGenComplexShiftSolve,
+/// SymShiftInvert, and SparseCholesky take the factorization backend as a template
+/// parameter `FacType`, and talk to it only through this class. The default
+/// implementation works for any backend that follows the interface of the **Eigen**
+/// solvers, for example `Eigen::SparseLU`, `Eigen::SimplicialLDLT`,
+/// `Eigen::PardisoLU`, `Eigen::CholmodSupernodalLLT`, and the dense `BKLDLT`:
+///
+/// - `analyzePattern(mat)` (optional): symbolic analysis. It is called only once,
+///   since all shifted matrices share the same sparsity pattern.
+/// - `factorize(mat)`: numeric factorization. If it does not exist, `compute(mat)` is used.
+/// - `info()`: returns `Eigen::Success` or `CompInfo::Successful` on success.
+/// - `solve(b)`: solves the linear system, where `b` can be a vector or a matrix with
+///   multiple right hand sides.
+/// - `isSymmetric(bool)` (optional): hint that the matrix is symmetric.
+///
+/// Cholesky backends used in SparseCholesky should additionally provide
+/// `permutationP()`, `permutationPinv()`, `matrixL()`, and `matrixU()`, as
+/// `Eigen::SimplicialLLT` does. Backends for symmetric matrices can report the
+/// inertia of the factorized matrix through a member function
+/// `inertia(npos, nneg, nzero)`, as `BKLDLT` does.
+///
+/// Backends with a different interface, such as an in-house direct solver,
+/// can be supported by specializing this class template.
+///
+template <typename FacType>
+class FacTraits : public FacTraitsBase<FacType>
+{
+private:
+    using Index = Eigen::Index;
+
+    static void inertia_impl(const FacType& fac, Index& npos, Index& nneg, Index& nzero, std::true_type)
+    {
+        fac.inertia(npos, nneg, nzero);
+    }
+    static void inertia_impl(const FacType&, Index&, Index&, Index&, std::false_type)
+    {
+        static_assert(FacAlwaysFalse<FacType>::value,
+                      "FacTraits: the factorization backend does not provide the inertia of the matrix");
+    }
+
+public:
+    // Number of positive, negative, and zero eigenvalues of the factorized matrix
+    static void inertia(const FacType& fac, Index& npos, Index& nneg, Index& nzero)
+    {
+        inertia_impl(fac, npos, nneg, nzero, typename FacMemberDetector<FacType>::HasInertia());
+    }
+};
+
+/// \cond
+
+// Eigen::SimplicialLDLT computes M = P' * L * D * L' * P, and the inertia
+// can be read from the signs of D
+template <typename MatrixType, int UpLo, typename Ordering>
+class FacTraits<Eigen::SimplicialLDLT<MatrixType, UpLo, Ordering>> :
+    public FacTraitsBase<Eigen::SimplicialLDLT<MatrixType, UpLo, Ordering>>
+{
+private:
+    using Index = Eigen::Index;
+    using FacType = Eigen::SimplicialLDLT<MatrixType, UpLo, Ordering>;
+
+public:
+    static void inertia(const FacType& fac, Index& npos, Index& nneg, Index& nzero)
+    {
+        const auto& D = fac.vectorD();
+        npos = (D.array() > 0).count();
+        nneg = (D.array() < 0).count();
+        nzero = D.size() - npos - nneg;
+    }
+};
+
+// A successful Cholesky factorization implies that the matrix is positive definite
+// A failed one only shows that the matrix is not, so the inertia is unknown
+template <typename MatrixType, int UpLo, typename Ordering>
+class FacTraits<Eigen::SimplicialLLT<MatrixType, UpLo, Ordering>> :
+    public FacTraitsBase<Eigen::SimplicialLLT<MatrixType, UpLo, Ordering>>
+{
+private:
+    using Index = Eigen::Index;
+    using FacType = Eigen::SimplicialLLT<MatrixType, UpLo, Ordering>;
+
+public:
+    static void inertia(const FacType& fac, Index& npos, Index& nneg, Index& nzero)
+    {
+        if (fac.info() != Eigen::Success)
+            throw std::runtime_error("FacTraits: the inertia is unknown after a failed Cholesky factorization");
+        npos = fac.rows();
+        nneg = 0;
+        nzero = 0;
+    }
+};
+
+/// \endcond
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_FAC_TRAITS_H
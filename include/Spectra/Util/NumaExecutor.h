@@ -0,0 +1,183 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_NUMA_EXECUTOR_H
+#define SPECTRA_NUMA_EXECUTOR_H
+
+#include <condition_variable>  // std::condition_variable
+#include <exception>           // std::exception_ptr
+#include <functional>          // std::function
+#include <mutex>               // std::mutex, std::unique_lock
+#include <stdexcept>           // std::invalid_argument
+#include <thread>              // std::thread
+#include <vector>              // std::vector
+
+#if defined(__linux__)
+#include <pthread.h>  // pthread_setaffinity_np
+#include <sched.h>    // cpu_set_t
+#endif
+
+#include "ThreadPool.h"
+
+namespace Spectra {
+
+///
+/// \ingroup Internals
+///
+/// A team of worker threads, each pinned to one CPU, that run the parts of a
+/// parallel region with a fixed assignment of parts to threads.
+///
+/// Unlike ThreadPool, where any worker may take any task, part \f$k\f$ of every
+/// call to run() is executed by worker \f$k\f$. Data that are allocated and first
+/// written by worker \f$k\f$ are placed by the operating system on the NUMA node
+/// of its CPU, and later accesses from the same worker stay node-local.
+///
+/// By default worker \f$k\f$ is pinned to CPU \f$k\f$, so that consecutive workers,
+/// and hence consecutive parts of the data, share a node when the CPUs of a node
+/// are numbered contiguously. A custom list of CPUs can be given otherwise.
+/// Pinning is only implemented on Linux, and is silently skipped on other platforms
+/// or if the CPU is not available to the process.
+///
+class NumaExecutor
+{
+private:
+    std::vector<std::thread> m_workers;
+    std::function<void(int)> m_task;  // the current parallel region
+    std::exception_ptr m_error;       // first exception thrown by the current region
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    unsigned long m_generation;  // number of regions started
+    int m_pending;               // workers still running the current region
+    bool m_stop;
+
+    static void pin_to_cpu(std::thread& thread, int cpu)
+    {
+#if defined(__linux__)
+        if (cpu < 0 || cpu >= CPU_SETSIZE)
+            return;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        // Failure, e.g. for a CPU outside of the affinity mask of the process, is ignored
+        pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &set);
+#else
+        (void) thread;
+        (void) cpu;
+#endif
+    }
+
+    void worker_loop(int id)
+    {
+        unsigned long seen = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_start.wait(lock, [this, seen] { return m_stop || m_generation != seen; });
+                if (m_stop)
+                    return;
+                seen = m_generation;
+            }
+
+            try
+            {
+                m_task(id);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_error)
+                    m_error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_pending == 0)
+                m_done.notify_one();
+        }
+    }
+
+    void start(const std::vector<int>& cpus)
+    {
+        m_workers.reserve(cpus.size());
+        for (std::size_t k = 0; k < cpus.size(); k++)
+        {
+            m_workers.emplace_back(&NumaExecutor::worker_loop, this, int(k));
+            pin_to_cpu(m_workers.back(), cpus[k]);
+        }
+    }
+
+public:
+    ///
+    /// Constructor to create workers pinned to CPUs \f$0,1,\ldots,n-1\f$.
+    ///
+    /// \param nthread Number of worker threads \f$n\f$. If it is not positive, the number
+    ///                of hardware threads is used.
+    ///
+    explicit NumaExecutor(int nthread = 0) :
+        m_generation(0), m_pending(0), m_stop(false)
+    {
+        if (nthread <= 0)
+            nthread = ThreadPool::default_num_threads();
+        std::vector<int> cpus(nthread);
+        for (int k = 0; k < nthread; k++)
+            cpus[k] = k % ThreadPool::default_num_threads();
+        start(cpus);
+    }
+
+    ///
+    /// Constructor to create one worker for each CPU in the list.
+    ///
+    explicit NumaExecutor(const std::vector<int>& cpus) :
+        m_generation(0), m_pending(0), m_stop(false)
+    {
+        if (cpus.empty())
+            throw std::invalid_argument("NumaExecutor: the list of CPUs must not be empty");
+        start(cpus);
+    }
+
+    NumaExecutor(const NumaExecutor&) = delete;
+    NumaExecutor& operator=(const NumaExecutor&) = delete;
+
+    ~NumaExecutor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_start.notify_all();
+        for (auto& worker : m_workers)
+            worker.join();
+    }
+
+    ///
+    /// Number of worker threads.
+    ///
+    int num_threads() const { return static_cast<int>(m_workers.size()); }
+
+    ///
+    /// Calls `func(k)` on worker \f$k\f$ for every worker, and waits for all of them.
+    /// The first exception thrown by the parts is rethrown. run() must not be
+    /// called concurrently, or from inside a part.
+    ///
+    void run(std::function<void(int)> func)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_task = std::move(func);
+        m_error = nullptr;
+        m_pending = num_threads();
+        m_generation++;
+        m_start.notify_all();
+        m_done.wait(lock, [this] { return m_pending == 0; });
+        m_task = nullptr;
+        if (m_error)
+            std::rethrow_exception(m_error);
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_NUMA_EXECUTOR_H
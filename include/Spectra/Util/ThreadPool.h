@@ -0,0 +1,134 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_THREAD_POOL_H
+#define SPECTRA_THREAD_POOL_H
+
+#include <condition_variable>  // std::condition_variable
+#include <deque>               // std::deque
+#include <functional>          // std::function
+#include <future>              // std::future, std::packaged_task
+#include <memory>              // std::make_shared
+#include <mutex>               // std::mutex, std::unique_lock
+#include <thread>              // std::thread
+#include <utility>             // std::forward, std::move, std::declval
+#include <vector>              // std::vector
+
+namespace Spectra {
+
+///
+/// \ingroup Internals
+///
+/// A fixed-size pool of worker threads executing tasks in FIFO order.
+///
+/// It is used by the classes that run independent pieces of work in parallel,
+/// for example the tree-parallel supernodal Cholesky factorization. Programs
+/// using it need to be linked with the threads library, e.g. `-pthread`.
+///
+class ThreadPool
+{
+private:
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    bool m_stop;
+
+    void worker_loop()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cond.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+                if (m_stop && m_tasks.empty())
+                    return;
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+public:
+    ///
+    /// Constructor to create the worker threads.
+    ///
+    /// \param nthread Number of worker threads. If it is not positive, the number
+    ///                of hardware threads is used.
+    ///
+    explicit ThreadPool(int nthread = 0) :
+        m_stop(false)
+    {
+        if (nthread <= 0)
+            nthread = default_num_threads();
+        m_workers.reserve(nthread);
+        for (int i = 0; i < nthread; i++)
+            m_workers.emplace_back(&ThreadPool::worker_loop, this);
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ///
+    /// The destructor finishes all queued tasks and joins the worker threads.
+    ///
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cond.notify_all();
+        for (auto& worker : m_workers)
+            worker.join();
+    }
+
+    ///
+    /// Number of hardware threads, or 1 if it cannot be detected.
+    ///
+    static int default_num_threads()
+    {
+        const unsigned int n = std::thread::hardware_concurrency();
+        return n > 0 ? static_cast<int>(n) : 1;
+    }
+
+    ///
+    /// Number of worker threads.
+    ///
+    int num_threads() const { return static_cast<int>(m_workers.size()); }
+
+    ///
+    /// Queue a task without tracking its result. The task must not throw.
+    ///
+    void post(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_cond.notify_one();
+    }
+
+    ///
+    /// Queue a task and return a future holding its result or exception.
+    ///
+    // std::result_of is removed in C++20, and std::invoke_result needs C++17
+    template <typename Func>
+    std::future<decltype(std::declval<Func&>()())> submit(Func&& func)
+    {
+        using Result = decltype(std::declval<Func&>()());
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+        std::future<Result> res = task->get_future();
+        post([task]() { (*task)(); });
+        return res;
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_THREAD_POOL_H
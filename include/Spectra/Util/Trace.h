@@ -0,0 +1,259 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_TRACE_H
+#define SPECTRA_TRACE_H
+
+// Timeline tracing of the eigen solvers
+//
+// Tracing is disabled by default, in which case the SPECTRA_TRACE_SCOPE() macro
+// expands to nothing and no tracing code is compiled. To enable it, define the
+// macro SPECTRA_ENABLE_TRACE before including any Spectra header, for example
+// by passing -DSPECTRA_ENABLE_TRACE to the compiler.
+//
+// When enabled, every traced scope (compute(), restarts, factorize_from(),
+// matrix operations, factorizations in set_shift(), etc.) records one
+// "complete" event with its begin time, duration, and the calling thread.
+// Each thread writes to its own fixed-size ring buffer, so recording an event
+// requires no locks and no memory allocation. The events can be exported in the
+// Chrome trace JSON format, which can be loaded by chrome://tracing or
+// https://ui.perfetto.dev, using Spectra::Trace::write_chrome_trace().
+
+#ifdef SPECTRA_ENABLE_TRACE
+
+#include <atomic>     // std::atomic
+#include <chrono>     // std::chrono::steady_clock
+#include <cstdint>    // std::uint64_t
+#include <cstdio>     // std::snprintf
+#include <memory>     // std::shared_ptr
+#include <mutex>      // std::mutex, std::lock_guard
+#include <ostream>    // std::ostream
+#include <vector>     // std::vector
+#include <algorithm>  // std::min
+
+// Number of events kept by each thread, must be a power of 2
+#ifndef SPECTRA_TRACE_BUFFER_SIZE
+#define SPECTRA_TRACE_BUFFER_SIZE 65536
+#endif
+
+namespace Spectra {
+
+/// \cond
+
+// A single traced span
+struct TraceEvent
+{
+    const char* name;     // name of the span, must be a string literal
+    std::uint64_t begin;  // begin time in nanoseconds, relative to the trace epoch
+    std::uint64_t end;    // end time in nanoseconds, relative to the trace epoch
+};
+
+// Single-producer ring buffer owned by one thread
+// Only the owner thread writes to the buffer, and the exporter reads the
+// published events through the atomic head counter
+class TraceBuffer
+{
+private:
+    static constexpr std::uint64_t m_capacity = SPECTRA_TRACE_BUFFER_SIZE;
+    static_assert((m_capacity & (m_capacity - 1)) == 0, "SPECTRA_TRACE_BUFFER_SIZE must be a power of 2");
+
+    const int m_tid;                    // sequential thread ID used in the exported trace
+    std::vector<TraceEvent> m_events;   // storage of the ring buffer
+    std::atomic<std::uint64_t> m_head;  // total number of events ever written
+
+public:
+    explicit TraceBuffer(int tid) :
+        m_tid(tid), m_events(m_capacity), m_head(0)
+    {}
+
+    int tid() const { return m_tid; }
+
+    // Called by the owner thread only
+    void push(const char* name, std::uint64_t begin, std::uint64_t end)
+    {
+        const std::uint64_t head = m_head.load(std::memory_order_relaxed);
+        TraceEvent& ev = m_events[head & (m_capacity - 1)];
+        ev.name = name;
+        ev.begin = begin;
+        ev.end = end;
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    // Copy the most recent events, oldest first
+    void snapshot(std::vector<TraceEvent>& out) const
+    {
+        const std::uint64_t head = m_head.load(std::memory_order_acquire);
+        const std::uint64_t len = (std::min)(head, std::uint64_t(m_capacity));
+        for (std::uint64_t i = head - len; i < head; i++)
+            out.push_back(m_events[i & (m_capacity - 1)]);
+    }
+
+    void clear() { m_head.store(0, std::memory_order_release); }
+};
+
+// Global registry of the per-thread buffers
+// The mutex is only taken when a thread records its first event and when
+// the trace is exported or cleared, never on the recording path
+class TraceRegistry
+{
+private:
+    using Clock = std::chrono::steady_clock;
+
+    const Clock::time_point m_epoch;
+    std::atomic<bool> m_enabled;
+    std::mutex m_mutex;
+    // Buffers are shared with the threads, so that events recorded by a
+    // thread that has already exited can still be exported
+    std::vector<std::shared_ptr<TraceBuffer>> m_buffers;
+
+public:
+    TraceRegistry() :
+        m_epoch(Clock::now()), m_enabled(true)
+    {}
+
+    static TraceRegistry& instance()
+    {
+        static TraceRegistry registry;
+        return registry;
+    }
+
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    void set_enabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+
+    std::uint64_t now() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_epoch).count();
+    }
+
+    std::shared_ptr<TraceBuffer> register_thread()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::shared_ptr<TraceBuffer> buffer = std::make_shared<TraceBuffer>(static_cast<int>(m_buffers.size()));
+        m_buffers.push_back(buffer);
+        return buffer;
+    }
+
+    // The buffer of the calling thread
+    static TraceBuffer& local_buffer()
+    {
+        thread_local std::shared_ptr<TraceBuffer> buffer = instance().register_thread();
+        return *buffer;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& buffer : m_buffers)
+            buffer->clear();
+    }
+
+    // Timestamps in the Chrome trace format are in microseconds
+    static void write_microseconds(std::ostream& os, std::uint64_t ns)
+    {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%llu.%03llu",
+                      static_cast<unsigned long long>(ns / 1000),
+                      static_cast<unsigned long long>(ns % 1000));
+        os << buf;
+    }
+
+    void write_chrome_trace(std::ostream& os)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<TraceEvent> events;
+
+        os << "{\"traceEvents\":[";
+        bool first = true;
+        for (auto& buffer : m_buffers)
+        {
+            events.clear();
+            buffer->snapshot(events);
+            for (const TraceEvent& ev : events)
+            {
+                if (!first)
+                    os << ",";
+                first = false;
+                os << "\n{\"name\":\"" << ev.name << "\",\"cat\":\"spectra\",\"ph\":\"X\",\"ts\":";
+                write_microseconds(os, ev.begin);
+                os << ",\"dur\":";
+                write_microseconds(os, ev.end - ev.begin);
+                os << ",\"pid\":0,\"tid\":" << buffer->tid() << "}";
+            }
+        }
+        os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+};
+
+// RAII object that records a span from its construction to its destruction
+class TraceScope
+{
+private:
+    const char* m_name;
+    std::uint64_t m_begin;
+
+public:
+    explicit TraceScope(const char* name) :
+        m_name(TraceRegistry::instance().enabled() ? name : nullptr),
+        m_begin(m_name ? TraceRegistry::instance().now() : 0)
+    {}
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    ~TraceScope()
+    {
+        if (m_name)
+            TraceRegistry::local_buffer().push(m_name, m_begin, TraceRegistry::instance().now());
+    }
+};
+
+/// \endcond
+
+///
+/// \ingroup Internals
+///
+/// Functions to control the timeline tracing of the eigen solvers. They are only
+/// available when the macro `SPECTRA_ENABLE_TRACE` is defined before including
+/// the **Spectra** headers.
+///
+namespace Trace {
+
+///
+/// Turn the recording of events on or off at run time. Recording is on by default.
+///
+inline void set_enabled(bool enabled) { TraceRegistry::instance().set_enabled(enabled); }
+
+///
+/// Discard all recorded events.
+/// Should be called when no traced computation is running.
+///
+inline void clear() { TraceRegistry::instance().clear(); }
+
+///
+/// Write all recorded events to a stream in the Chrome trace JSON format.
+/// Should be called when no traced computation is running. Each thread keeps
+/// its most recent `SPECTRA_TRACE_BUFFER_SIZE` events.
+///
+inline void write_chrome_trace(std::ostream& os) { TraceRegistry::instance().write_chrome_trace(os); }
+
+}  // namespace Trace
+
+}  // namespace Spectra
+
+#define SPECTRA_TRACE_CONCAT_IMPL(x, y) x##y
+#define SPECTRA_TRACE_CONCAT(x, y)      SPECTRA_TRACE_CONCAT_IMPL(x, y)
+#define SPECTRA_TRACE_SCOPE(name)       ::Spectra::TraceScope SPECTRA_TRACE_CONCAT(spectra_trace_scope_, __LINE__)(name)
+
+#else
+
+#define SPECTRA_TRACE_SCOPE(name) \
+    do                            \
+    {                             \
+    } while (false)
+
+#endif  // SPECTRA_ENABLE_TRACE
+
+#endif  // SPECTRA_TRACE_H
@@ -0,0 +1,300 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_MULTILEVEL_INIT_H
+#define SPECTRA_MULTILEVEL_INIT_H
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/Eigenvalues>  // Eigen::SelfAdjointEigenSolver
+#include <Eigen/QR>           // Eigen::HouseholderQR
+#include <vector>             // std::vector
+#include <cmath>              // std::abs, std::sqrt
+#include <algorithm>          // std::max
+#include <utility>            // std::move
+#include <stdexcept>          // std::invalid_argument
+
+#include "../Util/SimpleRandom.h"
+
+namespace Spectra {
+
+///
+/// This class computes initial guesses of the eigenvectors associated with the
+/// smallest eigenvalues of a graph Laplacian, or more generally a sparse symmetric
+/// matrix whose off-diagonal elements describe the edges of a graph.
+///
+/// Smooth low-frequency eigenvectors are slow to resolve by Krylov methods starting
+/// from a random vector. This class uses the multilevel approach:
+///
+/// 1. The graph is coarsened repeatedly by heavy-edge matching, where each vertex
+///    is merged with the unmatched neighbor connected by the heaviest edge,
+///    until the number of vertices is at most `coarse_size`. The coarse operators are
+///    the Galerkin projections \f$A_{c}=P'AP\f$, where the prolongation \f$P\f$ has
+///    orthonormal columns.
+/// 2. The coarsest eigenproblem is solved by a dense eigen solver.
+/// 3. The eigenvectors are prolongated level by level, and each time they are
+///    smoothed by a few damped Jacobi sweeps on \f$(A-\theta I)x=0\f$, followed by
+///    a Rayleigh--Ritz projection.
+///
+/// The result can be used to warm-start the eigen solvers at the finest level, either
+/// as a block through initial_block(), or combined into a single vector through
+/// initial_vector(), which can be passed to the `init_guess()` function of SymEigsSolver.
+///
+/// \tparam Scalar_      The element type of the matrix, for example,
+///                      `float`, `double`, and `long double`.
+/// \tparam Flags        Either `Eigen::ColMajor` or `Eigen::RowMajor`, indicating
+///                      the storage format of the input matrix.
+/// \tparam StorageIndex The type of the indices for the sparse matrix.
+///
+/// Below is an example that demonstrates the usage of this class.
+///
+/// \code{.cpp}
+/// #include <Eigen/SparseCore>
+/// #include <Spectra/SymEigsSolver.h>
+/// #include <Spectra/MatOp/SparseSymMatProd.h>
+/// #include <Spectra/contrib/MultilevelInit.h>
+///
+/// using namespace Spectra;
+///
+/// void smallest_eigs(const Eigen::SparseMatrix<double>& laplacian)
+/// {
+///     // Initial guesses of the four smallest eigenvectors
+///     MultilevelGraphInit<double> ml(laplacian, 4);
+///     ml.compute();
+///     Eigen::VectorXd v0 = ml.initial_vector();
+///
+///     SparseSymMatProd<double> op(laplacian);
+///     SymEigsSolver<SparseSymMatProd<double>> eigs(op, 4, 20);
+///     eigs.init_guess(v0.data());
+///     eigs.compute(SortRule::SmallestAlge);
+/// }
+/// \endcode
+///
+template <typename Scalar_ = double, int Flags = Eigen::ColMajor, typename StorageIndex = int>
+class MultilevelGraphInit
+{
+public:
+    ///
+    /// Element type of the matrix.
+    ///
+    using Scalar = Scalar_;
+
+private:
+    using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using SparseMatrix = Eigen::SparseMatrix<Scalar, Flags, StorageIndex>;
+    using ColMajorSparse = Eigen::SparseMatrix<Scalar, Eigen::ColMajor, StorageIndex>;
+    using Triplet = Eigen::Triplet<Scalar, StorageIndex>;
+
+    const Index m_n;                    // dimension of the matrix
+    const Index m_nev;                  // number of eigenvectors wanted
+    const Index m_coarse_size;          // maximum size of the coarsest level
+    const Index m_max_levels;           // maximum number of levels
+    std::vector<ColMajorSparse> m_ops;  // operators of all levels, the finest first
+    std::vector<ColMajorSparse> m_pro;  // prolongations from level i + 1 to level i
+    Matrix m_block;                     // initial guesses at the finest level
+    Vector m_theta;                     // Rayleigh quotients of the initial guesses
+    Index m_nmatop;                     // number of matrix-vector products at the finest level
+
+    // Heavy-edge matching of the graph defined by the off-diagonal elements of A
+    // Returns the prolongation P with orthonormal columns
+    static ColMajorSparse coarsen(const ColMajorSparse& A)
+    {
+        using std::abs;
+        using std::sqrt;
+
+        const Index n = A.rows();
+        std::vector<Index> agg(n, -1);
+        Index nc = 0;
+        for (Index j = 0; j < n; j++)
+        {
+            if (agg[j] >= 0)
+                continue;
+
+            // Find the unmatched neighbor with the heaviest edge
+            Index best = -1;
+            Scalar best_w = Scalar(0);
+            for (typename ColMajorSparse::InnerIterator it(A, j); it; ++it)
+            {
+                const Index i = it.row();
+                const Scalar w = abs(it.value());
+                if (i != j && agg[i] < 0 && w > best_w)
+                {
+                    best = i;
+                    best_w = w;
+                }
+            }
+            agg[j] = nc;
+            if (best >= 0)
+                agg[best] = nc;
+            nc++;
+        }
+
+        std::vector<Index> size(nc, 0);
+        for (Index i = 0; i < n; i++)
+            size[agg[i]]++;
+
+        std::vector<Triplet> trip;
+        trip.reserve(n);
+        for (Index i = 0; i < n; i++)
+            trip.emplace_back(i, agg[i], Scalar(1) / sqrt(Scalar(size[agg[i]])));
+
+        ColMajorSparse P(n, nc);
+        P.setFromTriplets(trip.begin(), trip.end());
+        return P;
+    }
+
+    // Rayleigh--Ritz projection of the block X onto the operator A
+    // On exit, X has orthonormal columns, and theta contains the Ritz values in increasing order
+    static void rayleigh_ritz(const ColMajorSparse& A, Matrix& X, Vector& theta)
+    {
+        const Index n = X.rows(), k = X.cols();
+        Eigen::HouseholderQR<Matrix> qr(X);
+        X.noalias() = qr.householderQ() * Matrix::Identity(n, k);
+
+        const Matrix AX = A * X;
+        const Matrix G = X.transpose() * AX;
+        Eigen::SelfAdjointEigenSolver<Matrix> eig(G);
+        theta.noalias() = eig.eigenvalues();
+        X = X * eig.eigenvectors();
+    }
+
+public:
+    ///
+    /// Constructor to create the initializer.
+    ///
+    /// \param mat          The sparse symmetric matrix \f$A\f$, for example a graph Laplacian,
+    ///                     with both triangular parts stored. Its off-diagonal elements
+    ///                     define the weights of the graph edges.
+    /// \param nev          Number of eigenvectors wanted. This should satisfy \f$1\le nev < n\f$,
+    ///                     where \f$n\f$ is the size of matrix.
+    /// \param coarse_size  The graph is coarsened until it has at most `coarse_size` vertices.
+    ///                     It is increased to \f$2\cdot nev\f$ if it is smaller than that.
+    /// \param max_levels   Maximum number of levels, including the finest one.
+    ///
+    MultilevelGraphInit(const SparseMatrix& mat, Index nev, Index coarse_size = 200, Index max_levels = 30) :
+        m_n(mat.rows()),
+        m_nev(nev),
+        m_coarse_size((std::max)(coarse_size, 2 * nev)),
+        m_max_levels(max_levels),
+        m_nmatop(0)
+    {
+        if (mat.rows() != mat.cols())
+            throw std::invalid_argument("MultilevelGraphInit: matrix must be square");
+        if (nev < 1 || nev >= m_n)
+            throw std::invalid_argument("MultilevelGraphInit: nev must satisfy 1 <= nev < n, n is the size of matrix");
+        if (max_levels < 1)
+            throw std::invalid_argument("MultilevelGraphInit: max_levels must be positive");
+
+        m_ops.emplace_back(mat);
+    }
+
+    ///
+    /// Builds the hierarchy and computes the initial guesses.
+    ///
+    /// \param smooth_steps  Number of damped Jacobi sweeps on each level.
+    /// \param omega         Damping factor of the Jacobi sweeps.
+    ///
+    void compute(Index smooth_steps = 3, Scalar omega = Scalar(2) / Scalar(3))
+    {
+        using std::abs;
+
+        // Coarsening, which stops if the matching no longer reduces the graph size
+        m_ops.resize(1);
+        m_pro.clear();
+        while (Index(m_ops.size()) < m_max_levels && m_ops.back().rows() > m_coarse_size)
+        {
+            const ColMajorSparse& A = m_ops.back();
+            ColMajorSparse P = coarsen(A);
+            if (P.cols() > A.rows() * 9 / 10 || P.cols() < m_nev)
+                break;
+
+            ColMajorSparse AP = A * P;
+            ColMajorSparse Ac = P.transpose() * AP;
+            m_pro.push_back(std::move(P));
+            m_ops.push_back(std::move(Ac));
+        }
+
+        // Dense eigen solver on the coarsest level
+        const Index nlevel = m_ops.size();
+        Matrix X;
+        if (nlevel > 1)
+        {
+            const Matrix Ac = m_ops.back();
+            Eigen::SelfAdjointEigenSolver<Matrix> eig(Ac);
+            X.noalias() = eig.eigenvectors().leftCols(m_nev);
+            m_theta.noalias() = eig.eigenvalues().head(m_nev);
+        }
+        else
+        {
+            // The matrix is too small or cannot be coarsened, so we start from random vectors
+            SimpleRandom<Scalar> rng(0);
+            X.resize(m_n, m_nev);
+            for (Index j = 0; j < m_nev; j++)
+                X.col(j).noalias() = rng.random_vec(m_n);
+            rayleigh_ritz(m_ops[0], X, m_theta);
+        }
+
+        // Prolongation and smoothing, from level nlevel - 2 to level 0
+        m_nmatop = 0;
+        for (Index l = nlevel - 2; l >= 0; l--)
+        {
+            const ColMajorSparse& A = m_ops[l];
+            X = m_pro[l] * X;
+
+            Vector dinv = A.diagonal();
+            for (Index i = 0; i < dinv.size(); i++)
+                dinv[i] = (abs(dinv[i]) > Scalar(0)) ? Scalar(1) / dinv[i] : Scalar(0);
+
+            for (Index s = 0; s < smooth_steps; s++)
+            {
+                // x <- x - omega * D^{-1} * (A * x - theta * x)
+                Matrix R = A * X;
+                R -= X * m_theta.asDiagonal();
+                X.noalias() -= omega * (dinv.asDiagonal() * R);
+                rayleigh_ritz(A, X, m_theta);
+            }
+            if (l == 0)
+                m_nmatop += 2 * smooth_steps * m_nev;
+        }
+
+        m_block.swap(X);
+    }
+
+    ///
+    /// Returns the number of levels in the hierarchy, including the finest one.
+    ///
+    Index num_levels() const { return m_ops.size(); }
+
+    ///
+    /// Returns the number of matrix-vector products conducted on the finest level.
+    ///
+    Index num_operations() const { return m_nmatop; }
+
+    ///
+    /// Returns the initial guesses of the eigenvectors, an \f$n\times nev\f$ matrix
+    /// with orthonormal columns, ordered by increasing Rayleigh quotients.
+    ///
+    const Matrix& initial_block() const { return m_block; }
+
+    ///
+    /// Returns the Rayleigh quotients of the initial guesses, in increasing order.
+    ///
+    const Vector& ritz_values() const { return m_theta; }
+
+    ///
+    /// Returns a single initial vector, the sum of the columns of initial_block(),
+    /// which can be passed to the `init_guess()` function of SymEigsSolver.
+    /// A Krylov subspace started from this vector contains all the initial guesses
+    /// after \f$nev\f$ steps, up to the accuracy of the guesses.
+    ///
+    Vector initial_vector() const { return m_block.rowwise().sum(); }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_MULTILEVEL_INIT_H
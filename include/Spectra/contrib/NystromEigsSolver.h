@@ -0,0 +1,568 @@
+// Copyright (C) 2023 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef SPECTRA_NYSTROM_EIGS_SOLVER_H
+#define SPECTRA_NYSTROM_EIGS_SOLVER_H
+
+#include <Eigen/Core>
+#include <Eigen/Cholesky>     // Eigen::LLT
+#include <Eigen/Eigenvalues>  // Eigen::SelfAdjointEigenSolver
+#include <Eigen/QR>           // Eigen::HouseholderQR
+#include <vector>             // std::vector
+#include <memory>             // std::unique_ptr
+#include <future>             // std::future
+#include <cmath>              // std::abs, std::sqrt
+#include <algorithm>          // std::max, std::min, std::sort
+#include <stdexcept>          // std::invalid_argument
+
+#include "../Util/CompInfo.h"
+#include "../Util/TypeTraits.h"
+#include "../Util/SimpleRandom.h"
+#include "../Util/ThreadPool.h"
+#include "../Util/Trace.h"
+
+namespace Spectra {
+
+///
+/// \ingroup Enumerations
+///
+/// The enumeration of the landmark sampling methods in NystromEigsSolver.
+///
+enum class LandmarkSampling
+{
+    ///
+    /// Landmarks are sampled uniformly without replacement.
+    ///
+    Uniform,
+
+    ///
+    /// Landmarks are sampled by the k-means++ seeding rule in the feature space
+    /// of the kernel, where each new landmark is drawn with probability proportional
+    /// to its squared kernel distance \f$k(i,i)+k(l,l)-2k(i,l)\f$ to the nearest
+    /// existing landmark \f$l\f$.
+    ///
+    KMeansPP,
+
+    ///
+    /// Landmarks are sampled with probabilities proportional to the approximate
+    /// ridge leverage scores \f$[K(K+\lambda I)^{-1}]_{ii}\f$, which are estimated
+    /// from a preliminary uniform Nyström approximation.
+    ///
+    RidgeLeverage
+};
+
+///
+/// \ingroup EigenSolver
+///
+/// This class computes approximate eigenpairs associated with the largest eigenvalues
+/// of a symmetric positive semi-definite kernel matrix \f$K\f$ by the Nyström method.
+///
+/// Even a matrix-free product \f$Kx\f$ costs \f$O(n^2)\f$ kernel evaluations, which is
+/// prohibitive for large \f$n\f$. The Nyström method selects \f$m\ll n\f$ landmarks \f$S\f$,
+/// and approximates \f$K\f$ by \f$\tilde{K}=CW^{+}C'\f$, where \f$C=K_{:,S}\f$ is the
+/// \f$n\times m\f$ cross-kernel and \f$W=K_{S,S}\f$. The eigenpairs of \f$\tilde{K}\f$ are
+/// computed exactly in \f$O(nm^2)\f$ operations, by forming \f$B=CU\Lambda^{-1/2}\f$ from
+/// the eigen decomposition \f$W=U\Lambda U'\f$ and diagonalizing the \f$m\times m\f$ matrix
+/// \f$B'B\f$. The cross-kernel and the products with it are computed in tiles of rows,
+/// which are processed in parallel on a thread pool. Since \f$K-\tilde{K}\f$ is positive
+/// semi-definite, the approximate eigenvalues never exceed the exact ones.
+///
+/// The result can optionally be refined by a few iterations of block subspace iteration
+/// with the exact operator, warm-started from the Nyström eigenvectors. See refine().
+///
+/// \tparam KernelType  The name of the kernel class. It should implement the type
+///                     definition `Scalar`, and the public member functions
+///                     `Index rows() const`, returning \f$n\f$, and
+///                     `Scalar operator()(Index i, Index j) const`, returning the element
+///                     \f$K_{ij}\f$. The latter is called concurrently from multiple threads.
+///
+/// Below is an example that computes the leading eigenpairs of a Gaussian kernel matrix.
+///
+/// \code{.cpp}
+/// #include <Eigen/Core>
+/// #include <Spectra/contrib/NystromEigsSolver.h>
+/// #include <cmath>
+///
+/// using namespace Spectra;
+///
+/// // Gaussian kernel of the columns of a d x n data matrix
+/// class GaussianKernel
+/// {
+/// private:
+///     const Eigen::MatrixXd& m_x;
+///
+/// public:
+///     using Scalar = double;
+///     GaussianKernel(const Eigen::MatrixXd& x) : m_x(x) {}
+///     Eigen::Index rows() const { return m_x.cols(); }
+///     double operator()(Eigen::Index i, Eigen::Index j) const
+///     {
+///         return std::exp(-0.5 * (m_x.col(i) - m_x.col(j)).squaredNorm());
+///     }
+/// };
+///
+/// int main()
+/// {
+///     Eigen::MatrixXd x = Eigen::MatrixXd::Random(3, 100000);
+///     GaussianKernel kernel(x);
+///
+///     // Five leading eigenpairs from 500 landmarks
+///     NystromEigsSolver<GaussianKernel> eigs(kernel, 5, 500);
+///     eigs.compute(LandmarkSampling::KMeansPP);
+///     if (eigs.info() == CompInfo::Successful)
+///         Eigen::VectorXd evalues = eigs.eigenvalues();
+///
+///     return 0;
+/// }
+/// \endcode
+///
+template <typename KernelType>
+class NystromEigsSolver
+{
+public:
+    ///
+    /// Element type of the kernel matrix.
+    ///
+    using Scalar = typename KernelType::Scalar;
+
+private:
+    using Index = Eigen::Index;
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+    // clang-format off
+    const KernelType&           m_kernel;   // kernel function
+    const Index                 m_n;        // dimension of the kernel matrix
+    const Index                 m_nev;      // number of eigenpairs requested
+    const Index                 m_nland;    // number of landmarks
+    const Index                 m_nblock;   // number of Nyström eigenvectors kept, used by refine()
+    Index                       m_tile;     // number of rows in a tile
+    int                         m_nthread;  // number of threads
+    std::unique_ptr<ThreadPool> m_pool;     // thread pool, created on demand
+
+    std::vector<Index>          m_land;     // indices of the landmarks
+    Vector                      m_diag;     // diagonal of K
+    Matrix                      m_C;        // cross-kernel K(:, landmarks), n x m
+    Index                       m_rank;     // numerical rank of W
+    Vector                      m_evals;    // approximate eigenvalues, in decreasing order
+    Matrix                      m_evecs;    // approximate eigenvectors, n x m_nblock
+    Index                       m_nmatop;   // number of matrix operations in refine()
+    Index                       m_niter;    // number of iterations in refine()
+    CompInfo                    m_info;     // status of the computation
+    // clang-format on
+
+    // A uniform random number in [0, 1)
+    static Scalar uniform(SimpleRandom<Scalar>& rng)
+    {
+        const Scalar u = rng.random() + Scalar(0.5);
+        return (std::min)((std::max)(u, Scalar(0)), Scalar(1) - TypeTraits<Scalar>::epsilon());
+    }
+
+    // Calls func(begin, end) on the tiles of rows [begin, end), in parallel if
+    // more than one thread is used
+    template <typename Func>
+    void for_each_tile(Func&& func)
+    {
+        const Index ntile = (m_n + m_tile - 1) / m_tile;
+        if (m_nthread <= 1 || ntile <= 1)
+        {
+            for (Index t = 0; t < ntile; t++)
+                func(t * m_tile, (std::min)(m_n, (t + 1) * m_tile));
+            return;
+        }
+
+        if (!m_pool)
+            m_pool.reset(new ThreadPool(m_nthread));
+        std::vector<std::future<void>> res;
+        res.reserve(ntile);
+        for (Index t = 0; t < ntile; t++)
+        {
+            const Index begin = t * m_tile, end = (std::min)(m_n, (t + 1) * m_tile);
+            res.push_back(m_pool->submit([&func, begin, end]() { func(begin, end); }));
+        }
+        // get() rethrows the exceptions of the tasks
+        for (auto& r : res)
+            r.get();
+    }
+
+    // Computes the diagonal of K
+    void compute_diag()
+    {
+        m_diag.resize(m_n);
+        for_each_tile([this](Index begin, Index end) {
+            for (Index i = begin; i < end; i++)
+                m_diag[i] = m_kernel(i, i);
+        });
+    }
+
+    // Computes the columns [j0, j1) of the cross-kernel, C(:, j) = K(:, landmark j)
+    void compute_columns(Index j0, Index j1)
+    {
+        SPECTRA_TRACE_SCOPE("NystromEigs::cross_kernel");
+
+        for_each_tile([this, j0, j1](Index begin, Index end) {
+            for (Index j = j0; j < j1; j++)
+            {
+                const Index l = m_land[j];
+                for (Index i = begin; i < end; i++)
+                    m_C(i, j) = m_kernel(i, l);
+            }
+        });
+    }
+
+    // Samples m_nland indices without replacement, uniformly
+    void sample_uniform(SimpleRandom<Scalar>& rng)
+    {
+        // Partial Fisher-Yates shuffle
+        std::vector<Index> perm(m_n);
+        for (Index i = 0; i < m_n; i++)
+            perm[i] = i;
+        for (Index j = 0; j < m_nland; j++)
+        {
+            const Index k = j + (std::min)(Index(uniform(rng) * Scalar(m_n - j)), m_n - j - 1);
+            std::swap(perm[j], perm[k]);
+        }
+        m_land.assign(perm.begin(), perm.begin() + m_nland);
+    }
+
+    // Draws an index with probability proportional to the nonnegative weights,
+    // and zeroes its weight. If all weights are zero, an unchosen index is drawn uniformly
+    static Index sample_weighted(SimpleRandom<Scalar>& rng, Vector& weights, std::vector<bool>& chosen)
+    {
+        const Index n = weights.size();
+        const Scalar total = weights.sum();
+        Index ind = -1;
+        if (total > Scalar(0))
+        {
+            const Scalar target = uniform(rng) * total;
+            Scalar cum = Scalar(0);
+            for (Index i = 0; i < n; i++)
+            {
+                if (weights[i] <= Scalar(0))
+                    continue;
+                ind = i;
+                cum += weights[i];
+                if (cum > target)
+                    break;
+            }
+        }
+        if (ind < 0)
+        {
+            Index k = (std::min)(Index(uniform(rng) * Scalar(n)), n - 1);
+            while (chosen[k])
+                k = (k + 1) % n;
+            ind = k;
+        }
+        weights[ind] = Scalar(0);
+        chosen[ind] = true;
+        return ind;
+    }
+
+    // k-means++ seeding, which computes the cross-kernel along the way
+    void sample_kmeanspp(SimpleRandom<Scalar>& rng)
+    {
+        std::vector<bool> chosen(m_n, false);
+        const Index first = (std::min)(Index(uniform(rng) * Scalar(m_n)), m_n - 1);
+        chosen[first] = true;
+        m_land.assign(1, first);
+        compute_columns(0, 1);
+
+        // Squared distance to the nearest landmark in the feature space
+        Vector dist(m_n);
+        for (Index j = 0;; j++)
+        {
+            const Index l = m_land[j];
+            for_each_tile([this, &dist, &chosen, j, l](Index begin, Index end) {
+                for (Index i = begin; i < end; i++)
+                {
+                    Scalar d = m_diag[i] + m_diag[l] - Scalar(2) * m_C(i, j);
+                    d = chosen[i] ? Scalar(0) : (std::max)(d, Scalar(0));
+                    dist[i] = (j == 0) ? d : (std::min)(dist[i], d);
+                }
+            });
+            if (j + 1 == m_nland)
+                break;
+
+            m_land.push_back(sample_weighted(rng, dist, chosen));
+            compute_columns(j + 1, j + 2);
+        }
+    }
+
+    // Ridge leverage score sampling, using a preliminary uniform Nyström approximation
+    void sample_ridge_leverage(SimpleRandom<Scalar>& rng, Scalar ridge)
+    {
+        sample_uniform(rng);
+        compute_columns(0, m_nland);
+        if (ridge <= Scalar(0))
+            ridge = m_diag.sum() / Scalar(m_nland);
+
+        // tau_i ~= (K_ii - c_i' (W + ridge * I)^{-1} c_i) / ridge
+        Matrix W(m_nland, m_nland);
+        for (Index j = 0; j < m_nland; j++)
+            W.row(j) = m_C.row(m_land[j]);
+        W.diagonal().array() += ridge;
+        Eigen::LLT<Matrix> llt(W.template selfadjointView<Eigen::Lower>());
+        if (llt.info() != Eigen::Success)
+            throw std::runtime_error("NystromEigsSolver: the ridge parameter is too small");
+
+        Vector score(m_n);
+        for_each_tile([this, &llt, &score, ridge](Index begin, Index end) {
+            const Matrix Z = llt.matrixL().solve(m_C.middleRows(begin, end - begin).transpose());
+            for (Index i = begin; i < end; i++)
+                score[i] = (std::max)(m_diag[i] - Z.col(i - begin).squaredNorm(), Scalar(0)) / ridge;
+        });
+
+        std::vector<bool> chosen(m_n, false);
+        for (Index j = 0; j < m_nland; j++)
+            m_land[j] = sample_weighted(rng, score, chosen);
+        compute_columns(0, m_nland);
+    }
+
+public:
+    ///
+    /// Constructor to create a solver object.
+    ///
+    /// \param kernel  The kernel object, whose type is described in the class documentation.
+    /// \param nev     Number of eigenpairs requested. This should satisfy \f$1\le nev\le m\f$.
+    /// \param nland   Number of landmarks \f$m\f$, which should satisfy \f$nev\le m\le n\f$.
+    ///                The accuracy improves with \f$m\f$, and the cost is \f$O(nm^2)\f$.
+    ///
+    NystromEigsSolver(const KernelType& kernel, Index nev, Index nland) :
+        m_kernel(kernel),
+        m_n(kernel.rows()),
+        m_nev(nev),
+        m_nland(nland),
+        m_nblock((std::min)(2 * nev, nland)),
+        m_tile(1024),
+        m_nthread(ThreadPool::default_num_threads()),
+        m_rank(0),
+        m_nmatop(0),
+        m_niter(0),
+        m_info(CompInfo::NotComputed)
+    {
+        if (nev < 1)
+            throw std::invalid_argument("nev must be greater than zero");
+        if (nland < nev || nland > m_n)
+            throw std::invalid_argument("nland must satisfy nev <= nland <= n, n is the size of matrix");
+    }
+
+    ///
+    /// Sets the number of threads used to compute the cross-kernel and the
+    /// products with it. If it is not positive, the number of hardware threads is used.
+    ///
+    void set_num_threads(int nthread)
+    {
+        nthread = (nthread > 0) ? nthread : ThreadPool::default_num_threads();
+        if (nthread != m_nthread)
+            m_pool.reset();
+        m_nthread = nthread;
+    }
+
+    ///
+    /// Sets the number of rows in a tile, the unit of work of the parallel passes.
+    ///
+    void set_tile_size(Index tile)
+    {
+        if (tile < 1)
+            throw std::invalid_argument("NystromEigsSolver: tile size must be positive");
+        m_tile = tile;
+    }
+
+    ///
+    /// Selects the landmarks and computes the approximate eigenpairs.
+    ///
+    /// \param sampling  The landmark sampling method. See LandmarkSampling for details.
+    /// \param ridge     The regularization parameter \f$\lambda\f$ of the ridge leverage
+    ///                  scores, only used by `LandmarkSampling::RidgeLeverage`. If it is not
+    ///                  positive, \f$\mathrm{tr}(K)/m\f$ is used.
+    /// \param seed      Seed of the random number generator used in the sampling.
+    ///
+    /// \return Number of approximate eigenpairs computed, which is less than `nev`
+    ///         if the landmark kernel matrix \f$W\f$ has a lower numerical rank.
+    ///
+    Index compute(LandmarkSampling sampling = LandmarkSampling::Uniform, Scalar ridge = Scalar(0),
+                  unsigned long seed = 0)
+    {
+        SPECTRA_TRACE_SCOPE("NystromEigs::compute");
+
+        using std::sqrt;
+
+        SimpleRandom<Scalar> rng(seed);
+        m_C.resize(m_n, m_nland);
+        m_nmatop = 0;
+        m_niter = 0;
+
+        // Landmarks and the cross-kernel
+        if (sampling == LandmarkSampling::Uniform)
+        {
+            sample_uniform(rng);
+            std::sort(m_land.begin(), m_land.end());
+            compute_columns(0, m_nland);
+        }
+        else
+        {
+            compute_diag();
+            if (sampling == LandmarkSampling::KMeansPP)
+                sample_kmeanspp(rng);
+            else
+                sample_ridge_leverage(rng, ridge);
+        }
+
+        // W = U * Lambda * U', ignoring the numerically zero eigenvalues
+        Matrix W(m_nland, m_nland);
+        for (Index j = 0; j < m_nland; j++)
+            W.row(j) = m_C.row(m_land[j]);
+        Eigen::SelfAdjointEigenSolver<Matrix> eigw(W);
+        const Vector& lambda = eigw.eigenvalues();
+        const Scalar thresh = TypeTraits<Scalar>::epsilon() * Scalar(m_nland) *
+            (std::max)(lambda.cwiseAbs().maxCoeff(), TypeTraits<Scalar>::min());
+        Index r = 0;
+        while (r < m_nland && lambda[m_nland - 1 - r] > thresh)
+            r++;
+        m_rank = r;
+
+        // B = C * U_r * Lambda_r^{-1/2}, which overwrites the first r columns of C,
+        // and then B'B is accumulated over the tiles
+        Matrix T = eigw.eigenvectors().rightCols(r);
+        for (Index j = 0; j < r; j++)
+            T.col(j) /= sqrt(lambda[m_nland - r + j]);
+        const Index ntile = (m_n + m_tile - 1) / m_tile;
+        std::vector<Matrix> gram(ntile);
+        for_each_tile([this, &T, &gram, r](Index begin, Index end) {
+            const Matrix B = m_C.middleRows(begin, end - begin) * T;
+            m_C.block(begin, 0, end - begin, r).noalias() = B;
+            gram[begin / m_tile].noalias() = B.transpose() * B;
+        });
+        Matrix BtB = Matrix::Zero(r, r);
+        for (auto& g : gram)
+            BtB += g;
+
+        // B'B = Q * Sigma * Q', and the eigenvectors of C * W^+ * C' are B * Q * Sigma^{-1/2}
+        Eigen::SelfAdjointEigenSolver<Matrix> eigb(BtB);
+        const Index nblock = (std::min)(m_nblock, r);
+        m_evals = eigb.eigenvalues().reverse().head(nblock);
+        Matrix S = eigb.eigenvectors().rowwise().reverse().leftCols(nblock);
+        for (Index j = 0; j < nblock; j++)
+            S.col(j) /= sqrt((std::max)(m_evals[j], TypeTraits<Scalar>::min()));
+        m_evecs.resize(m_n, nblock);
+        for_each_tile([this, &S, r](Index begin, Index end) {
+            m_evecs.middleRows(begin, end - begin).noalias() = m_C.block(begin, 0, end - begin, r) * S;
+        });
+        m_C.resize(0, 0);
+
+        m_info = (nblock >= m_nev) ? CompInfo::Successful : CompInfo::NumericalIssue;
+        return (std::min)(m_nev, nblock);
+    }
+
+    ///
+    /// Refines the approximate eigenpairs by block subspace iteration with the exact operator,
+    /// warm-started from the Nyström eigenvectors. The block contains \f$\min(2\cdot nev, m)\f$
+    /// vectors, and each iteration applies the operator to all of them and conducts
+    /// a Rayleigh--Ritz projection.
+    ///
+    /// \param op     The exact matrix operation object, for example DenseSymMatProd,
+    ///               or a user-defined class that implements `rows()` and `perform_op()`.
+    /// \param maxit  Maximum number of iterations.
+    /// \param tol    Precision parameter. The iteration stops when the residual norms of the
+    ///               first `nev` Ritz pairs are at most `tol` times the largest Ritz value.
+    ///
+    /// \return Number of converged eigenpairs.
+    ///
+    template <typename OpType>
+    Index refine(const OpType& op, Index maxit = 10, Scalar tol = 1e-10)
+    {
+        SPECTRA_TRACE_SCOPE("NystromEigs::refine");
+
+        if (m_info == CompInfo::NotComputed)
+            throw std::logic_error("NystromEigsSolver: compute() must be called before refine()");
+        if (op.rows() != m_n)
+            throw std::invalid_argument("NystromEigsSolver: the operator has a different size from the kernel");
+
+        const Index p = m_evecs.cols();
+        const Index nev = (std::min)(m_nev, p);
+        Eigen::HouseholderQR<Matrix> qr(m_evecs);
+        Matrix X = qr.householderQ() * Matrix::Identity(m_n, p);
+        Matrix Y(m_n, p);
+        Index nconv = 0;
+        for (m_niter = 0; m_niter < maxit; m_niter++)
+        {
+            for (Index j = 0; j < p; j++)
+                op.perform_op(X.col(j).data(), Y.col(j).data());
+            m_nmatop += p;
+
+            // Rayleigh--Ritz projection, with the Ritz values in decreasing order
+            const Matrix G = X.transpose() * Y;
+            Eigen::SelfAdjointEigenSolver<Matrix> eig(G);
+            const Matrix Q = eig.eigenvectors().rowwise().reverse();
+            m_evals.noalias() = eig.eigenvalues().reverse();
+            m_evecs.noalias() = X * Q;
+            X.noalias() = Y * Q;
+
+            const Scalar thresh = tol * (std::max)(m_evals.cwiseAbs().maxCoeff(), TypeTraits<Scalar>::min());
+            nconv = 0;
+            for (Index j = 0; j < nev; j++)
+                nconv += ((X.col(j) - m_evals[j] * m_evecs.col(j)).norm() <= thresh);
+            if (nconv >= nev)
+            {
+                m_niter++;
+                break;
+            }
+
+            // Next subspace span(A * X), orthonormalized
+            qr.compute(X);
+            X.noalias() = qr.householderQ() * Matrix::Identity(m_n, p);
+        }
+
+        m_info = (nconv >= m_nev) ? CompInfo::Successful : CompInfo::NotConverging;
+        return nconv;
+    }
+
+    ///
+    /// Returns the status of the computation.
+    /// The full list of enumeration values can be found in \ref Enumerations.
+    ///
+    CompInfo info() const { return m_info; }
+
+    ///
+    /// Returns the indices of the selected landmarks.
+    ///
+    const std::vector<Index>& landmarks() const { return m_land; }
+
+    ///
+    /// Returns the numerical rank of the kernel matrix of the landmarks.
+    ///
+    Index rank() const { return m_rank; }
+
+    ///
+    /// Returns the number of iterations used in refine().
+    ///
+    Index num_iterations() const { return m_niter; }
+
+    ///
+    /// Returns the number of matrix operations used in refine().
+    ///
+    Index num_operations() const { return m_nmatop; }
+
+    ///
+    /// Returns the approximate eigenvalues in decreasing order.
+    ///
+    Vector eigenvalues() const
+    {
+        return m_evals.head((std::min)(m_nev, Index(m_evals.size())));
+    }
+
+    ///
+    /// Returns the approximate eigenvectors, with unit norms.
+    ///
+    Matrix eigenvectors() const
+    {
+        return m_evecs.leftCols((std::min)(m_nev, Index(m_evecs.cols())));
+    }
+};
+
+}  // namespace Spectra
+
+#endif  // SPECTRA_NYSTROM_EIGS_SOLVER_H
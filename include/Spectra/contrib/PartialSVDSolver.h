@@ -161,10 +161,30 @@ public:
     {
         m_eigs->init();
         m_nconv = m_eigs->compute(SortRule::LargestAlge, maxit, tol);
+        m_evecs.resize(0, 0);
 
         return m_nconv;
     }
 
+    // Computation of all singular values greater than sv_cutoff, starting with ncomp
+    // components and increasing it until the cutoff is crossed
+    Index compute_cutoff(Scalar sv_cutoff, Index maxit = 1000, Scalar tol = 1e-10)
+    {
+        m_eigs->init();
+        // Eigenvalues of A'A or AA' are the squared singular values
+        m_nconv = m_eigs->compute_threshold(SortRule::LargestAlge, sv_cutoff * sv_cutoff, maxit, tol);
+        m_evecs.resize(0, 0);
+
+        return m_nconv;
+    }
+
+    // Status of the computation
+    CompInfo info() const { return m_eigs->info(); }
+
+    // Number of restarting iterations and matrix operations of the eigen solver
+    Index num_iterations() const { return m_eigs->num_iterations(); }
+    Index num_operations() const { return m_eigs->num_operations(); }
+
     // The converged singular values
     Vector singular_values() const
     {
@@ -0,0 +1,190 @@
+// Test ../include/Spectra/MatOp/ShiftSolvePipeline.h
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
+#include <Eigen/Eigenvalues>
+#include <atomic>  // std::atomic
+#include <iostream>
+#include <random>  // Requires C++ 11
+#include <vector>
+
+#include <Spectra/SymEigsShiftSolver.h>
+#include <Spectra/GenEigsRealShiftSolver.h>
+#include <Spectra/MatOp/DenseSymShiftSolve.h>
+#include <Spectra/MatOp/SparseSymShiftSolve.h>
+#include <Spectra/MatOp/DenseGenRealShiftSolve.h>
+#include <Spectra/MatOp/ShiftSolvePipeline.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+using SpMatrix = Eigen::SparseMatrix<double>;
+
+// Generate random sparse symmetric matrix
+SpMatrix gen_sparse_sym_data(int n, double prob = 0.1)
+{
+    SpMatrix mat(n, n);
+    std::default_random_engine gen;
+    gen.seed(0);
+    std::uniform_real_distribution<double> distr(0.0, 1.0);
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j <= i; j++)
+        {
+            if (distr(gen) < prob || i == j)
+            {
+                const double val = distr(gen) - 0.5;
+                mat.insert(i, j) = val;
+                if (i != j)
+                    mat.insert(j, i) = val;
+            }
+        }
+    }
+    mat.makeCompressed();
+    return mat;
+}
+
+// Sparse LDLT that counts the numeric factorizations
+class CountingLDLT : public Eigen::SimplicialLDLT<SpMatrix>
+{
+public:
+    static std::atomic<int> nfactorize;
+
+    void factorize(const SpMatrix& mat)
+    {
+        Eigen::SimplicialLDLT<SpMatrix>::factorize(mat);
+        nfactorize++;
+    }
+};
+
+std::atomic<int> CountingLDLT::nfactorize(0);
+
+TEST_CASE("Asynchronous factorization of a single shift", "[AsyncShift]")
+{
+    const SpMatrix A = gen_sparse_sym_data(200);
+    const double sigma = 0.1;
+
+    using OpType = SparseSymShiftSolve<double, Eigen::Lower, Eigen::ColMajor, int, CountingLDLT>;
+    OpType op(A);
+    CountingLDLT::nfactorize = 0;
+
+    std::shared_future<void> future = op.set_shift_async(sigma);
+    // The solver constructor waits for the factorization instead of repeating it
+    SymEigsShiftSolver<OpType> eigs(op, 5, 20, sigma);
+    REQUIRE(future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    REQUIRE(CountingLDLT::nfactorize == 1);
+
+    eigs.init();
+    eigs.compute(SortRule::LargestMagn);
+    REQUIRE(eigs.info() == CompInfo::Successful);
+
+    const Vector evals = eigs.eigenvalues();
+    const Matrix evecs = eigs.eigenvectors();
+    const Matrix resid = A * evecs - evecs * evals.asDiagonal();
+    REQUIRE(resid.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-9));
+
+    // A different shift is factorized again
+    op.set_shift_async(0.2);
+    op.set_shift(0.3);
+    REQUIRE(CountingLDLT::nfactorize == 3);
+}
+
+TEST_CASE("Pipelined factorizations over a sequence of shifts", "[AsyncShift]")
+{
+    const SpMatrix A = gen_sparse_sym_data(200);
+    const std::vector<double> shifts{-0.3, -0.1, 0.0, 0.1, 0.3};
+    const int nev = 3;
+
+    // Reference results computed one shift at a time
+    std::vector<Vector> ref;
+    for (double sigma : shifts)
+    {
+        SparseSymShiftSolve<double> op(A);
+        SymEigsShiftSolver<SparseSymShiftSolve<double>> eigs(op, nev, 15, sigma);
+        eigs.init();
+        eigs.compute(SortRule::LargestMagn);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        ref.push_back(eigs.eigenvalues());
+    }
+
+    for (Eigen::Index depth = 1; depth <= 3; depth++)
+    {
+        ShiftSolvePipeline<SparseSymShiftSolve<double>> pipeline(shifts, depth, A);
+        REQUIRE(pipeline.size() == Eigen::Index(shifts.size()));
+        REQUIRE_THROWS_AS(pipeline.shift(), std::logic_error);
+
+        while (pipeline.has_next())
+        {
+            SparseSymShiftSolve<double>& op = pipeline.next();
+            REQUIRE(pipeline.shift() == shifts[pipeline.index()]);
+
+            SymEigsShiftSolver<SparseSymShiftSolve<double>> eigs(op, nev, 15, pipeline.shift());
+            eigs.init();
+            eigs.compute(SortRule::LargestMagn);
+            REQUIRE(eigs.info() == CompInfo::Successful);
+            INFO("depth = " << depth << ", shift = " << pipeline.shift());
+            REQUIRE((eigs.eigenvalues() - ref[pipeline.index()]).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-10));
+        }
+        REQUIRE_THROWS_AS(pipeline.next(), std::logic_error);
+    }
+
+    REQUIRE_THROWS_AS((ShiftSolvePipeline<SparseSymShiftSolve<double>>(shifts, 0, A)), std::invalid_argument);
+}
+
+TEST_CASE("Dense operators and failed factorizations", "[AsyncShift]")
+{
+    std::srand(123);
+    const Matrix M = Matrix::Random(50, 50);
+    const Matrix A = M + M.transpose();
+
+    // Dense general operator
+    {
+        DenseGenRealShiftSolve<double> op(M);
+        op.set_shift_async(0.5).get();
+        GenEigsRealShiftSolver<DenseGenRealShiftSolve<double>> eigs(op, 3, 10, 0.5);
+        eigs.init();
+        eigs.compute(SortRule::LargestMagn);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        const Eigen::VectorXcd evals = eigs.eigenvalues();
+        const Eigen::MatrixXcd evecs = eigs.eigenvectors();
+        const Eigen::MatrixXcd resid = M * evecs - evecs * evals.asDiagonal();
+        REQUIRE(resid.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-9));
+    }
+
+    // A singular shift: the exception is rethrown by the future and by set_shift()
+    {
+        const Matrix D = Vector::LinSpaced(50, 1.0, 50.0).asDiagonal();
+        DenseSymShiftSolve<double> op(D);
+        std::shared_future<void> future = op.set_shift_async(3.0);
+        REQUIRE_THROWS_AS(future.get(), std::invalid_argument);
+        REQUIRE_THROWS_AS(op.set_shift(3.0), std::invalid_argument);
+        // The operator can be used again with another shift
+        op.set_shift(3.5);
+        const Vector x = Vector::Ones(50);
+        Vector y(50);
+        op.perform_op(x.data(), y.data());
+        REQUIRE((D * y - 3.5 * y - x).norm() == Approx(0.0).margin(1e-12));
+    }
+
+    // Pipeline over dense symmetric operators
+    {
+        const std::vector<double> shifts{0.5, 1.5, 2.5};
+        ShiftSolvePipeline<DenseSymShiftSolve<double>> pipeline(shifts, 2, A);
+        Eigen::SelfAdjointEigenSolver<Matrix> es(A);
+        while (pipeline.has_next())
+        {
+            DenseSymShiftSolve<double>& op = pipeline.next();
+            SymEigsShiftSolver<DenseSymShiftSolve<double>> eigs(op, 1, 10, pipeline.shift());
+            eigs.init();
+            eigs.compute(SortRule::LargestMagn);
+            REQUIRE(eigs.info() == CompInfo::Successful);
+            // The eigenvalue closest to the shift
+            Eigen::Index i;
+            (es.eigenvalues().array() - pipeline.shift()).abs().minCoeff(&i);
+            REQUIRE(eigs.eigenvalues()[0] == Approx(es.eigenvalues()[i]));
+        }
+    }
+}
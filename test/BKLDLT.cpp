@@ -30,6 +30,16 @@ void run_test(const Matrix& A, const Vector& b, double s)
     Vector resid = A * solL - s * solL - b;
     INFO("||(A - s * I)x - b||_inf = " << resid.cwiseAbs().maxCoeff());
     REQUIRE(resid.cwiseAbs().maxCoeff() == Approx(0.0).margin(tol));
+
+    // Test in-place decomposition on the lower triangular part of a copy of A,
+    // with the upper triangular part set to garbage
+    Matrix work = A;
+    work.triangularView<Eigen::StrictlyUpper>().setConstant(123.0);
+    BKLDLT<double> decompI;
+    decompI.compute_inplace(work, s);
+    REQUIRE(decompI.info() == CompInfo::Successful);
+    REQUIRE((decompI.solve(b) - solL).cwiseAbs().maxCoeff() == Approx(0.0).margin(tol));
+    REQUIRE((work.triangularView<Eigen::StrictlyUpper>().toDenseMatrix().array() == 123.0).count() == A.rows() * (A.rows() - 1) / 2);
 }
 
 TEST_CASE("BKLDLT decomposition of symmetric real matrix [10x10]", "[BKLDLT]")
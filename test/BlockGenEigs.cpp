@@ -0,0 +1,169 @@
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/SVD>
+#include <iostream>
+#include <type_traits>
+#include <random>  // Requires C++ 11
+
+#include <Spectra/BlockGenEigsSolver.h>
+#include <Spectra/MatOp/DenseGenMatProd.h>
+#include <Spectra/MatOp/SparseGenMatProd.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+using ComplexMatrix = Eigen::MatrixXcd;
+using ComplexVector = Eigen::VectorXcd;
+using SpMatrix = Eigen::SparseMatrix<double>;
+
+// Generate random sparse matrix
+SpMatrix gen_sparse_data(int n, double prob = 0.5)
+{
+    SpMatrix mat(n, n);
+    std::default_random_engine gen;
+    gen.seed(0);
+    std::uniform_real_distribution<double> distr(0.0, 1.0);
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            if (distr(gen) < prob)
+                mat.insert(i, j) = distr(gen) - 0.5;
+        }
+    }
+    return mat;
+}
+
+template <typename MatType, typename Solver>
+void run_test(const MatType& mat, Solver& eigs, SortRule selection)
+{
+    eigs.init();
+    int nconv = eigs.compute(selection, 300);
+    int niter = eigs.num_iterations();
+    int nops = eigs.num_operations();
+
+    INFO("nconv = " << nconv);
+    INFO("niter = " << niter);
+    INFO("nops  = " << nops);
+    REQUIRE(eigs.info() == CompInfo::Successful);
+
+    ComplexVector evals = eigs.eigenvalues();
+    ComplexMatrix evecs = eigs.eigenvectors();
+
+    ComplexMatrix resid = mat * evecs - evecs * evals.asDiagonal();
+    const double err = resid.array().abs().maxCoeff();
+
+    INFO("||AU - UD||_inf = " << err);
+    REQUIRE(err == Approx(0.0).margin(1e-9));
+}
+
+template <typename MatType>
+void run_test_sets(const MatType& A, int k, int m, int b)
+{
+    constexpr bool is_dense = std::is_same<MatType, Matrix>::value;
+    using DenseOp = DenseGenMatProd<double>;
+    using SparseOp = SparseGenMatProd<double>;
+    using OpType = typename std::conditional<is_dense, DenseOp, SparseOp>::type;
+
+    OpType op(A);
+    BlockGenEigsSolver<OpType> eigs(op, k, m, b);
+
+    SECTION("Largest Magnitude")
+    {
+        run_test(A, eigs, SortRule::LargestMagn);
+    }
+    SECTION("Largest Real Part")
+    {
+        run_test(A, eigs, SortRule::LargestReal);
+    }
+    SECTION("Largest Imaginary Part")
+    {
+        run_test(A, eigs, SortRule::LargestImag);
+    }
+    SECTION("Smallest Real Part")
+    {
+        run_test(A, eigs, SortRule::SmallestReal);
+    }
+}
+
+TEST_CASE("Block eigensolver of general real matrix [100x100]", "[eigs_block_gen]")
+{
+    std::srand(123);
+
+    const Matrix A = Matrix::Random(100, 100);
+    run_test_sets(A, 10, 30, 2);
+}
+
+TEST_CASE("Block eigensolver of general real matrix [1000x1000]", "[eigs_block_gen]")
+{
+    std::srand(123);
+
+    const Matrix A = Matrix::Random(1000, 1000);
+    run_test_sets(A, 20, 80, 4);
+}
+
+TEST_CASE("Block eigensolver of sparse real matrix [1000x1000]", "[eigs_block_gen]")
+{
+    std::srand(123);
+
+    const SpMatrix A = gen_sparse_data(1000, 0.01);
+    run_test_sets(A, 20, 60, 2);
+}
+
+TEST_CASE("Block eigensolver with block size one", "[eigs_block_gen]")
+{
+    std::srand(123);
+
+    const Matrix A = Matrix::Random(200, 200);
+    DenseGenMatProd<double> op(A);
+    BlockGenEigsSolver<DenseGenMatProd<double>> eigs(op, 6, 20, 1);
+    run_test(A, eigs, SortRule::LargestMagn);
+}
+
+TEST_CASE("Eigenvalues with multiplicity [400x400]", "[eigs_block_gen]")
+{
+    std::srand(123);
+
+    // A = X * D * X^{-1}, where the largest eigenvalue 5 has multiplicity 2,
+    // and the next one 4.9 has multiplicity 3
+    const int n = 400;
+    Vector d = Vector::LinSpaced(n, -3.0, 3.0);
+    d[n - 1] = d[n - 2] = 5.0;
+    d[n - 3] = d[n - 4] = d[n - 5] = 4.9;
+    const Matrix X = Matrix::Identity(n, n) + 0.1 * Matrix::Random(n, n);
+    const Matrix A = X * d.asDiagonal() * X.inverse();
+
+    DenseGenMatProd<double> op(A);
+    BlockGenEigsSolver<DenseGenMatProd<double>> eigs(op, 5, 30, 3);
+    run_test(A, eigs, SortRule::LargestReal);
+
+    const ComplexVector evals = eigs.eigenvalues();
+    REQUIRE(evals.size() == 5);
+    for (int i = 0; i < 5; i++)
+    {
+        REQUIRE(evals[i].imag() == Approx(0.0).margin(1e-8));
+        REQUIRE(evals[i].real() == Approx(i < 2 ? 5.0 : 4.9).epsilon(1e-8));
+    }
+
+    // The eigenvectors of each multiple eigenvalue are linearly independent
+    const ComplexMatrix evecs = eigs.eigenvectors();
+    Eigen::JacobiSVD<ComplexMatrix> svd(evecs);
+    REQUIRE(svd.singularValues().minCoeff() > 1e-3);
+}
+
+TEST_CASE("Invalid arguments of BlockGenEigsSolver", "[eigs_block_gen]")
+{
+    const Matrix A = Matrix::Identity(20, 20);
+    DenseGenMatProd<double> op(A);
+    using Solver = BlockGenEigsSolver<DenseGenMatProd<double>>;
+
+    REQUIRE_THROWS_AS(Solver(op, 0, 10, 2), std::invalid_argument);
+    REQUIRE_THROWS_AS(Solver(op, 3, 10, 0), std::invalid_argument);
+    // ncv < nev + block_size + 1
+    REQUIRE_THROWS_AS(Solver(op, 3, 5, 2), std::invalid_argument);
+    // ncv > n - block_size
+    REQUIRE_THROWS_AS(Solver(op, 3, 19, 2), std::invalid_argument);
+}
@@ -0,0 +1,185 @@
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/Eigenvalues>
+#include <iostream>
+#include <memory>
+#include <random>  // Requires C++ 11
+#include <vector>
+
+#include <Spectra/ContourSymEigsSolver.h>
+#include <Spectra/MatOp/DenseSymMatProd.h>
+#include <Spectra/MatOp/DenseGenComplexShiftSolve.h>
+#include <Spectra/MatOp/SparseSymMatProd.h>
+#include <Spectra/MatOp/SparseGenComplexShiftSolve.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+using ComplexMatrix = Eigen::MatrixXcd;
+using SpMatrix = Eigen::SparseMatrix<double>;
+using Index = Eigen::Index;
+
+// Generate a random sparse symmetric matrix
+SpMatrix gen_sparse_sym(int n, double prob = 0.1)
+{
+    // Eigen solver only uses the lower triangle of mat,
+    // so we don't need to make mat symmetric here.
+    SpMatrix mat(n, n);
+    std::default_random_engine gen;
+    gen.seed(0);
+    std::uniform_real_distribution<double> distr(0.0, 1.0);
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            if (distr(gen) < prob)
+                mat.insert(i, j) = distr(gen) - 0.5;
+        }
+    }
+    return mat;
+}
+
+// Exact eigenvalues in the interval, in increasing order
+Vector exact_in(const Vector& exact, double lower, double upper)
+{
+    std::vector<double> res;
+    for (Index i = 0; i < exact.size(); i++)
+    {
+        if (exact[i] >= lower && exact[i] <= upper)
+            res.push_back(exact[i]);
+    }
+    return Eigen::Map<Vector>(res.data(), res.size());
+}
+
+template <typename MatType, typename Solver>
+void check_result(const MatType& mat, const Vector& exact, double lower, double upper, Solver& eigs)
+{
+    INFO("niter = " << eigs.num_iterations());
+    INFO("nops  = " << eigs.num_operations());
+    REQUIRE(eigs.info() == CompInfo::Successful);
+
+    const Vector evals = eigs.eigenvalues();
+    const Matrix evecs = eigs.eigenvectors();
+    const Vector ref = exact_in(exact, lower, upper);
+    REQUIRE(evals.size() == ref.size());
+    for (Index i = 0; i < ref.size(); i++)
+        REQUIRE(evals[i] == Approx(ref[i]).epsilon(1e-10));
+
+    const Matrix resid = mat * evecs - evecs * evals.asDiagonal();
+    REQUIRE(resid.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-8));
+    const Matrix I = Matrix::Identity(evals.size(), evals.size());
+    REQUIRE((evecs.transpose() * evecs - I).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-10));
+}
+
+TEST_CASE("Contour integral solver with sparse matrix", "[contour]")
+{
+    const int n = 400;
+    const SpMatrix A0 = gen_sparse_sym(n, 0.05);
+    const SpMatrix A = A0 + SpMatrix(A0.transpose());
+    Eigen::SelfAdjointEigenSolver<Matrix> eig{Matrix(A), Eigen::EigenvaluesOnly};
+    const Vector exact = eig.eigenvalues();
+
+    // Interval in the interior of the spectrum, whose ends are away from the eigenvalues
+    const double lower = 0.5 * (exact[220] + exact[221]);
+    const double upper = 0.5 * (exact[245] + exact[246]);
+
+    const int nnode = 8;
+    using ShiftOp = SparseGenComplexShiftSolve<double>;
+    std::vector<std::unique_ptr<ShiftOp>> shift_ops;
+    std::vector<ShiftOp*> ptrs;
+    for (int j = 0; j < nnode; j++)
+    {
+        shift_ops.emplace_back(new ShiftOp(A));
+        ptrs.push_back(shift_ops.back().get());
+    }
+    SparseSymMatProd<double> op(A);
+
+    SECTION("Enough vectors")
+    {
+        ContourSymEigsSolver<SparseSymMatProd<double>, ShiftOp> eigs(op, ptrs, lower, upper, 40);
+        eigs.compute();
+        check_result(A, exact, lower, upper, eigs);
+        // The stochastic estimate of the eigenvalue count is roughly accurate
+        REQUIRE(eigs.count_estimate() > 10.0);
+        REQUIRE(eigs.count_estimate() < 45.0);
+    }
+
+    SECTION("Subspace growing from a small initial dimension")
+    {
+        ContourSymEigsSolver<SparseSymMatProd<double>, ShiftOp> eigs(op, ptrs, lower, upper, 5);
+        eigs.set_num_threads(3);
+        eigs.compute();
+        check_result(A, exact, lower, upper, eigs);
+        REQUIRE(eigs.subspace_dim() > 26);
+    }
+
+    SECTION("Block shift-solve")
+    {
+        const double sr = 0.5 * (lower + upper), si = 0.5 * (upper - lower);
+        ptrs[0]->set_shift(sr, si);
+        const Matrix X = Matrix::Random(n, 3);
+        ComplexMatrix Y(n, 3);
+        ptrs[0]->perform_block_op(X.data(), 3, Y.data());
+        ComplexMatrix M = Matrix(A).cast<std::complex<double>>();
+        M.diagonal().array() -= std::complex<double>(sr, si);
+        REQUIRE((M * Y - X.cast<std::complex<double>>()).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-10));
+
+        // The real part agrees with perform_op()
+        Vector y(n);
+        ptrs[0]->perform_op(X.data(), y.data());
+        REQUIRE((y - Y.col(0).real()).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-12));
+    }
+}
+
+TEST_CASE("Contour integral solver with dense matrix", "[contour]")
+{
+    std::srand(123);
+    const int n = 200;
+    const Matrix R = Matrix::Random(n, n);
+    const Matrix A = R + R.transpose();
+    Eigen::SelfAdjointEigenSolver<Matrix> eig(A, Eigen::EigenvaluesOnly);
+    const Vector exact = eig.eigenvalues();
+
+    // The largest eigenvalues, with an interval that extends beyond the spectrum
+    const double lower = 0.5 * (exact[n - 13] + exact[n - 12]);
+    const double upper = exact[n - 1] + 1.0;
+
+    using ShiftOp = DenseGenComplexShiftSolve<double>;
+    std::vector<std::unique_ptr<ShiftOp>> shift_ops;
+    std::vector<ShiftOp*> ptrs;
+    for (int j = 0; j < 6; j++)
+    {
+        shift_ops.emplace_back(new ShiftOp(A));
+        ptrs.push_back(shift_ops.back().get());
+    }
+    DenseSymMatProd<double> op(A);
+
+    ContourSymEigsSolver<DenseSymMatProd<double>, ShiftOp> eigs(op, ptrs, lower, upper, 20);
+    eigs.set_num_threads(4);
+    eigs.compute();
+    check_result(A, exact, lower, upper, eigs);
+}
+
+TEST_CASE("Contour integral solver with invalid arguments", "[contour]")
+{
+    const int n = 50;
+    const SpMatrix A0 = gen_sparse_sym(n, 0.2);
+    const SpMatrix A = A0 + SpMatrix(A0.transpose());
+    SparseSymMatProd<double> op(A);
+    using ShiftOp = SparseGenComplexShiftSolve<double>;
+    using Solver = ContourSymEigsSolver<SparseSymMatProd<double>, ShiftOp>;
+
+    ShiftOp sop1(A), sop2(A);
+    std::vector<ShiftOp*> ptrs{&sop1, &sop2};
+    std::vector<ShiftOp*> none;
+    std::vector<ShiftOp*> dup{&sop1, &sop1};
+
+    REQUIRE_THROWS_AS(Solver(op, none, -1.0, 1.0, 10), std::invalid_argument);
+    REQUIRE_THROWS_AS(Solver(op, dup, -1.0, 1.0, 10), std::invalid_argument);
+    REQUIRE_THROWS_AS(Solver(op, ptrs, 1.0, -1.0, 10), std::invalid_argument);
+    REQUIRE_THROWS_AS(Solver(op, ptrs, -1.0, 1.0, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(Solver(op, ptrs, -1.0, 1.0, n + 1), std::invalid_argument);
+}
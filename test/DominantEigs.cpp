@@ -0,0 +1,160 @@
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <Eigen/SparseCore>
+#include <iostream>
+#include <random>  // Requires C++ 11
+
+#include <Spectra/DominantEigsSolver.h>
+#include <Spectra/MatOp/DenseSymMatProd.h>
+#include <Spectra/MatOp/DenseGenMatProd.h>
+#include <Spectra/MatOp/SparseGenMatProd.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+using SpMatrix = Eigen::SparseMatrix<double>;
+
+// Column-stochastic matrix of a random directed graph with a damping factor,
+// as in the PageRank model, whose dominant eigenvalue is 1
+SpMatrix gen_pagerank(int n, double prob, double damping)
+{
+    std::default_random_engine gen;
+    gen.seed(0);
+    std::uniform_real_distribution<double> distr(0.0, 1.0);
+
+    // Adjacency matrix, with a cycle to make sure every node has an out-link
+    SpMatrix adj(n, n);
+    for (int j = 0; j < n; j++)
+    {
+        adj.insert((j + 1) % n, j) = 1.0;
+        for (int i = 0; i < n; i++)
+        {
+            if (i != (j + 1) % n && distr(gen) < prob)
+                adj.insert(i, j) = 1.0;
+        }
+    }
+
+    // Each column is normalized to sum to one, and the teleportation
+    // is applied as a rank-one update in DenseGenMatProd below
+    Vector colsum = Vector::Ones(n).transpose() * adj;
+    SpMatrix mat = adj * colsum.cwiseInverse().asDiagonal();
+    return damping * mat;
+}
+
+template <typename MatType, typename Solver>
+void run_test(const MatType& mat, Solver& eigs, SortRule selection, double expected)
+{
+    eigs.init();
+    int nconv = eigs.compute(selection, 1000, 1e-10);
+    int niter = eigs.num_iterations();
+    int nops = eigs.num_operations();
+
+    INFO("nconv = " << nconv);
+    INFO("niter = " << niter);
+    INFO("nops  = " << nops);
+    REQUIRE(eigs.info() == CompInfo::Successful);
+    REQUIRE(nconv == 1);
+
+    const double eval = eigs.eigenvalue();
+    const Vector evec = eigs.eigenvector();
+    REQUIRE(evec.norm() == Approx(1.0));
+
+    const double err = (mat * evec - eval * evec).cwiseAbs().maxCoeff();
+    INFO("||Ax - lambda * x||_inf = " << err);
+    REQUIRE(err == Approx(0.0).margin(1e-8));
+    REQUIRE(eval == Approx(expected).epsilon(1e-10));
+}
+
+TEST_CASE("Extreme eigenpairs of symmetric matrix [200x200]", "[dominant_eigs]")
+{
+    std::srand(123);
+
+    const Matrix M = Matrix::Random(200, 200);
+    const Matrix A = M + M.transpose();
+    Eigen::SelfAdjointEigenSolver<Matrix> es(A, Eigen::EigenvaluesOnly);
+    const Vector evals = es.eigenvalues();
+
+    DenseSymMatProd<double> op(A);
+    DominantEigsSolver<DenseSymMatProd<double>> eigs(op);
+
+    SECTION("Largest Magnitude")
+    {
+        // Make the largest eigenvalue clearly dominant
+        const Matrix B = A + 10.0 * Matrix::Identity(200, 200);
+        DenseSymMatProd<double> bop(B);
+        DominantEigsSolver<DenseSymMatProd<double>> beigs(bop);
+        run_test(B, beigs, SortRule::LargestMagn, evals[199] + 10.0);
+    }
+    SECTION("Largest Value")
+    {
+        run_test(A, eigs, SortRule::LargestAlge, evals[199]);
+    }
+    SECTION("Smallest Value")
+    {
+        run_test(A, eigs, SortRule::SmallestAlge, evals[0]);
+    }
+}
+
+TEST_CASE("Leading principal component [500x50]", "[dominant_eigs]")
+{
+    std::srand(123);
+
+    // Data with a dominant direction
+    Matrix X = Matrix::Random(500, 50);
+    X.col(0) *= 5.0;
+    const Matrix cov = X.transpose() * X / 500.0;
+    Eigen::SelfAdjointEigenSolver<Matrix> es(cov, Eigen::EigenvaluesOnly);
+
+    DenseSymMatProd<double> op(cov);
+    DominantEigsSolver<DenseSymMatProd<double>> eigs(op);
+    run_test(cov, eigs, SortRule::LargestMagn, es.eigenvalues()[49]);
+}
+
+TEST_CASE("Stationary vector of a Markov chain [1000x1000]", "[dominant_eigs]")
+{
+    const int n = 1000;
+    const double damping = 0.85;
+    const SpMatrix P = gen_pagerank(n, 0.01, damping);
+    // Dense Google matrix, including the teleportation term
+    const Matrix G = Matrix(P).array() + (1.0 - damping) / n;
+
+    DenseGenMatProd<double> op(G);
+    DominantEigsSolver<DenseGenMatProd<double>> eigs(op);
+    run_test(G, eigs, SortRule::LargestMagn, 1.0);
+
+    // The stationary vector has entries of the same sign
+    const Vector x = eigs.eigenvector();
+    REQUIRE((x.array() * x[0] > 0.0).all());
+}
+
+TEST_CASE("Nonsymmetric sparse matrix with a real dominant eigenvalue [1000x1000]", "[dominant_eigs]")
+{
+    const int n = 1000;
+    const SpMatrix P = gen_pagerank(n, 0.01, 1.0);
+
+    SparseGenMatProd<double> op(P);
+    DominantEigsSolver<SparseGenMatProd<double>> eigs(op);
+    run_test(P, eigs, SortRule::LargestMagn, 1.0);
+}
+
+TEST_CASE("Invalid arguments of DominantEigsSolver", "[dominant_eigs]")
+{
+    const Matrix A = Matrix::Identity(10, 10);
+    DenseSymMatProd<double> op(A);
+    DominantEigsSolver<DenseSymMatProd<double>> eigs(op);
+    REQUIRE_THROWS_AS(eigs.compute(SortRule::SmallestMagn), std::invalid_argument);
+
+    const Vector zero = Vector::Zero(10);
+    REQUIRE_THROWS_AS(eigs.init(zero.data()), std::invalid_argument);
+
+    // An eigenvector as the initial vector converges immediately
+    Vector e1 = Vector::Zero(10);
+    e1[0] = 1.0;
+    eigs.init(e1.data());
+    REQUIRE(eigs.compute() == 1);
+    REQUIRE(eigs.num_operations() == 1);
+    REQUIRE(eigs.eigenvalue() == Approx(1.0));
+}
@@ -35,6 +35,14 @@ TEST_CASE("Eigen decomposition of upper Hessenberg matrix", "[Eigen]")
     INFO("||HU - UD||_inf = " << err.cwiseAbs().maxCoeff());
     REQUIRE(err.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-12));
 
+    // The last row and selected eigenvectors agree with the full eigenvectors
+    ComplexVector last_row = decomp.last_row();
+    REQUIRE((last_row - evecs.row(n - 1).transpose()).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-12));
+    std::vector<Eigen::Index> ind{ 5, 0, n - 1, 17, 18, 42 };
+    ComplexMatrix sub = decomp.eigenvectors(ind);
+    for (std::size_t j = 0; j < ind.size(); j++)
+        REQUIRE((sub.col(j) - evecs.col(ind[j])).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-12));
+
     clock_t t1, t2;
     t1 = clock();
     for (int i = 0; i < 100; i++)
@@ -92,6 +100,19 @@ TEST_CASE("Eigen decomposition of symmetric tridiagonal matrix", "[Eigen]")
     std::cout << "elapsed time for TridiagEigen: "
               << double(t2 - t1) / CLOCKS_PER_SEC << " secs\n";
 
+    // Ten eigenvectors from the last row and inverse iteration
+    std::vector<Eigen::Index> ind{ 3, 7, 11, 20, 35, 50, 64, 71, 88, 99 };
+    t1 = clock();
+    for (int i = 0; i < 100; i++)
+    {
+        TridiagEigen<double> decomp;
+        decomp.compute_last_row(H);
+        Matrix evecs = decomp.eigenvectors(ind);
+    }
+    t2 = clock();
+    std::cout << "elapsed time for TridiagEigen with ten eigenvectors: "
+              << double(t2 - t1) / CLOCKS_PER_SEC << " secs\n";
+
     t1 = clock();
     for (int i = 0; i < 100; i++)
     {
@@ -103,3 +124,94 @@ TEST_CASE("Eigen decomposition of symmetric tridiagonal matrix", "[Eigen]")
     std::cout << "elapsed time for Eigen::SelfAdjointEigenSolver: "
               << double(t2 - t1) / CLOCKS_PER_SEC << " secs\n";
 }
+
+void check_last_row(const Matrix& H, const std::vector<Eigen::Index>& ind, bool distinct)
+{
+    const Eigen::Index k = ind.size();
+    TridiagEigen<double> full(H);
+    TridiagEigen<double> decomp;
+    decomp.compute_last_row(H);
+    const Vector evals = decomp.eigenvalues();
+    REQUIRE((evals - full.eigenvalues()).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-12));
+    REQUIRE((decomp.last_row() - full.last_row()).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-12));
+    REQUIRE_THROWS_AS(decomp.eigenvectors(), std::logic_error);
+
+    const Matrix evecs = decomp.eigenvectors(ind);
+    Vector sub_evals(k);
+    for (Eigen::Index j = 0; j < k; j++)
+    {
+        sub_evals[j] = evals[ind[j]];
+        // Eigenvectors of distinct eigenvalues agree with the last row, including the sign
+        if (distinct)
+            REQUIRE(evecs(H.rows() - 1, j) == Approx(decomp.last_row()[ind[j]]).margin(1e-12));
+    }
+    Matrix err = H * evecs - evecs * sub_evals.asDiagonal();
+    INFO("||HU - UD||_inf = " << err.cwiseAbs().maxCoeff());
+    REQUIRE(err.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-12));
+    Matrix I = Matrix::Identity(k, k);
+    REQUIRE((evecs.transpose() * evecs - I).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-12));
+}
+
+TEST_CASE("Selected eigenvectors of symmetric tridiagonal matrix", "[Eigen]")
+{
+    std::srand(123);
+    const int n = 100;
+
+    SECTION("Random matrix")
+    {
+        Matrix M = Matrix::Random(n, n);
+        Matrix H = Matrix::Zero(n, n);
+        H.diagonal() = M.diagonal();
+        H.diagonal(-1) = M.diagonal(-1);
+        H.diagonal(1) = M.diagonal(-1);
+        check_last_row(H, std::vector<Eigen::Index>{ 0, 1, 2, 50, 98, 99 }, true);
+    }
+
+    SECTION("Repeated eigenvalues")
+    {
+        // Three copies of the same block, followed by a zero block
+        const int nb = 20;
+        Matrix M = Matrix::Random(nb, nb);
+        Matrix H = Matrix::Zero(n, n);
+        for (int b = 0; b < 3; b++)
+        {
+            H.diagonal().segment(b * nb, nb) = M.diagonal();
+            H.diagonal(-1).segment(b * nb, nb - 1) = M.diagonal(-1);
+            H.diagonal(1).segment(b * nb, nb - 1) = M.diagonal(-1);
+        }
+        std::vector<Eigen::Index> ind;
+        for (Eigen::Index i = 0; i < n; i += 3)
+            ind.push_back(i);
+        check_last_row(H, ind, false);
+    }
+
+    SECTION("Graded matrix")
+    {
+        // The small eigenvalues are at the level of rounding errors relative to the norm,
+        // so inverse iteration cannot separate their eigenvectors, and the QR iterations
+        // are used instead
+        Matrix H = Matrix::Zero(n, n);
+        H.diagonal() = Vector::LinSpaced(n, 0.0, double(n - 1));
+        H(0, 0) = 1e18;
+        H.diagonal(-1).setConstant(0.25);
+        H.diagonal(1).setConstant(0.25);
+        const Vector evals = TridiagEigen<double>(H).eigenvalues();
+        std::vector<Eigen::Index> ind;
+        for (Eigen::Index i = 0; i < n; i++)
+        {
+            if (evals[i] < 3.5)
+                ind.push_back(i);
+        }
+        REQUIRE(ind.size() == 3);
+
+        TridiagEigen<double> decomp;
+        decomp.compute_last_row(H);
+        const Matrix evecs = decomp.eigenvectors(ind);
+        const Matrix full_evecs = TridiagEigen<double>(H).eigenvectors();
+        for (std::size_t j = 0; j < ind.size(); j++)
+        {
+            INFO("j = " << j);
+            REQUIRE((evecs.col(j) - full_evecs.col(ind[j])).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-12));
+        }
+    }
+}
@@ -0,0 +1,278 @@
+// Test ../include/Spectra/Util/FacTraits.h
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseQR>
+#include <Eigen/Eigenvalues>
+#include <algorithm>  // std::sort
+#include <iostream>
+#include <random>  // Requires C++ 11
+
+#include <Spectra/SymEigsShiftSolver.h>
+#include <Spectra/GenEigsRealShiftSolver.h>
+#include <Spectra/SymGEigsSolver.h>
+#include <Spectra/SymGEigsShiftSolver.h>
+#include <Spectra/MatOp/SparseSymShiftSolve.h>
+#include <Spectra/MatOp/SparseGenRealShiftSolve.h>
+#include <Spectra/MatOp/SparseSymMatProd.h>
+#include <Spectra/MatOp/SparseCholesky.h>
+#include <Spectra/MatOp/SymShiftInvert.h>
+#include <Spectra/MatOp/DenseSymMatProd.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+using SpMatrix = Eigen::SparseMatrix<double>;
+using Index = Eigen::Index;
+
+// Generate random sparse symmetric matrix
+SpMatrix gen_sparse_sym_data(int n, double prob = 0.1)
+{
+    SpMatrix mat(n, n);
+    std::default_random_engine gen;
+    gen.seed(0);
+    std::uniform_real_distribution<double> distr(0.0, 1.0);
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j <= i; j++)
+        {
+            if (distr(gen) < prob || i == j)
+            {
+                const double val = distr(gen) - 0.5;
+                mat.insert(i, j) = val;
+                if (i != j)
+                    mat.insert(j, i) = val;
+            }
+        }
+    }
+    mat.makeCompressed();
+    return mat;
+}
+
+// A factorization backend with a non-Eigen interface, adapted through a
+// specialization of FacTraits
+class CountingLDLT
+{
+public:
+    Eigen::SimplicialLDLT<SpMatrix> ldlt;
+    static int nanalyze;
+    static int nfactorize;
+
+    void symbolic(const SpMatrix& mat)
+    {
+        ldlt.analyzePattern(mat);
+        nanalyze++;
+    }
+    bool numeric(const SpMatrix& mat)
+    {
+        ldlt.factorize(mat);
+        nfactorize++;
+        return ldlt.info() == Eigen::Success;
+    }
+};
+
+int CountingLDLT::nanalyze = 0;
+int CountingLDLT::nfactorize = 0;
+
+namespace Spectra {
+
+template <>
+class FacTraits<CountingLDLT>
+{
+public:
+    static void set_symmetric(CountingLDLT&, bool) {}
+    static void analyze(CountingLDLT& fac, const SpMatrix& mat) { fac.symbolic(mat); }
+    static void factorize(CountingLDLT& fac, const SpMatrix& mat) { fac.numeric(mat); }
+    static bool success(const CountingLDLT& fac) { return fac.ldlt.info() == Eigen::Success; }
+    template <typename Rhs, typename Dest>
+    static void solve(const CountingLDLT& fac, const Rhs& b, Dest& x)
+    {
+        x.noalias() = fac.ldlt.solve(b);
+    }
+    static void inertia(const CountingLDLT& fac, Index& npos, Index& nneg, Index& nzero)
+    {
+        FacTraits<Eigen::SimplicialLDLT<SpMatrix>>::inertia(fac.ldlt, npos, nneg, nzero);
+    }
+};
+
+}  // namespace Spectra
+
+// Number of eigenvalues of a symmetric matrix smaller than sigma
+Index count_smaller(const Vector& evals, double sigma)
+{
+    return (evals.array() < sigma).count();
+}
+
+TEST_CASE("Sparse shift-solve with alternative backends", "[FacTraits]")
+{
+    const int n = 100;
+    const SpMatrix A = gen_sparse_sym_data(n);
+    const double sigma = 0.1;
+
+    const Matrix Adense = A;
+    Eigen::SelfAdjointEigenSolver<Matrix> es(Adense);
+    const Vector true_evals = es.eigenvalues();
+
+    // Default backend
+    SparseSymShiftSolve<double> op_default(A);
+    SymEigsShiftSolver<SparseSymShiftSolve<double>> eigs_default(op_default, 5, 20, sigma);
+    eigs_default.init();
+    eigs_default.compute(SortRule::LargestMagn);
+    REQUIRE(eigs_default.info() == CompInfo::Successful);
+
+    // Eigen::SimplicialLDLT backend
+    using LDLTOp = SparseSymShiftSolve<double, Eigen::Lower, Eigen::ColMajor, int, Eigen::SimplicialLDLT<SpMatrix>>;
+    LDLTOp op_ldlt(A);
+    SymEigsShiftSolver<LDLTOp> eigs_ldlt(op_ldlt, 5, 20, sigma);
+    eigs_ldlt.init();
+    eigs_ldlt.compute(SortRule::LargestMagn);
+    REQUIRE(eigs_ldlt.info() == CompInfo::Successful);
+    REQUIRE((eigs_ldlt.eigenvalues() - eigs_default.eigenvalues()).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-9));
+
+    // The inertia of A - sigma * I
+    Index npos, nneg, nzero;
+    op_ldlt.inertia(npos, nneg, nzero);
+    REQUIRE(nneg == count_smaller(true_evals, sigma));
+    REQUIRE(npos == n - nneg);
+    REQUIRE(nzero == 0);
+
+    // Custom backend, the symbolic analysis is reused across shifts
+    using CountingOp = SparseSymShiftSolve<double, Eigen::Lower, Eigen::ColMajor, int, CountingLDLT>;
+    CountingOp op_count(A);
+    SymEigsShiftSolver<CountingOp> eigs_count(op_count, 5, 20, sigma);
+    eigs_count.init();
+    eigs_count.compute(SortRule::LargestMagn);
+    REQUIRE(eigs_count.info() == CompInfo::Successful);
+    REQUIRE((eigs_count.eigenvalues() - eigs_default.eigenvalues()).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-9));
+    op_count.set_shift(-0.2);
+    op_count.set_shift(0.3);
+    REQUIRE(CountingLDLT::nanalyze == 1);
+    REQUIRE(CountingLDLT::nfactorize == 3);
+    op_count.inertia(npos, nneg, nzero);
+    REQUIRE(nneg == count_smaller(true_evals, 0.3));
+
+    // Eigen::SparseQR backend for general matrices
+    using QROp = SparseGenRealShiftSolve<double, Eigen::ColMajor, int,
+                                         Eigen::SparseQR<SpMatrix, Eigen::COLAMDOrdering<int>>>;
+    QROp op_qr(A);
+    GenEigsRealShiftSolver<QROp> eigs_qr(op_qr, 5, 20, sigma);
+    eigs_qr.init();
+    eigs_qr.compute(SortRule::LargestMagn);
+    REQUIRE(eigs_qr.info() == CompInfo::Successful);
+    REQUIRE((eigs_qr.eigenvalues().real() - eigs_default.eigenvalues()).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-9));
+}
+
+TEST_CASE("Inertia of the generalized shift-invert operator", "[FacTraits]")
+{
+    std::srand(123);
+    const int n = 50;
+    Matrix M = Matrix::Random(n, n);
+    const Matrix A = M + M.transpose();
+    Matrix B = M.transpose() * M;
+    B.diagonal().array() += 1.0;
+
+    Eigen::GeneralizedSelfAdjointEigenSolver<Matrix> es(A, B);
+    const Vector true_evals = es.eigenvalues();
+    const double sigma = 0.5 * (true_evals[10] + true_evals[11]);
+
+    Index npos, nneg, nzero;
+
+    // BKLDLT backend, lower and upper triangular parts
+    SymShiftInvert<double, Eigen::Dense, Eigen::Dense> op_lower(A, B);
+    op_lower.set_shift(sigma);
+    op_lower.inertia(npos, nneg, nzero);
+    REQUIRE(nneg == 11);
+    REQUIRE(npos == n - 11);
+    REQUIRE(nzero == 0);
+
+    SymShiftInvert<double, Eigen::Dense, Eigen::Dense, Eigen::Upper, Eigen::Upper> op_upper(A, B);
+    op_upper.set_shift(sigma);
+    op_upper.inertia(npos, nneg, nzero);
+    REQUIRE(nneg == 11);
+
+    // Eigen::SimplicialLDLT backend for sparse matrices
+    const SpMatrix As = A.sparseView();
+    const SpMatrix Bs = B.sparseView();
+    using LDLTOp = SymShiftInvert<double, Eigen::Sparse, Eigen::Sparse, Eigen::Lower, Eigen::Lower,
+                                  Eigen::ColMajor, Eigen::ColMajor, int, int, Eigen::SimplicialLDLT<SpMatrix>>;
+    using BOp = SparseSymMatProd<double>;
+    LDLTOp op_sparse(As, Bs);
+    op_sparse.set_shift(sigma);
+    op_sparse.inertia(npos, nneg, nzero);
+    REQUIRE(nneg == 11);
+
+    BOp opB(Bs);
+    SymGEigsShiftSolver<LDLTOp, BOp, GEigsMode::ShiftInvert> geigs(op_sparse, opB, 3, 10, sigma);
+    geigs.init();
+    geigs.compute(SortRule::LargestMagn);
+    REQUIRE(geigs.info() == CompInfo::Successful);
+    // The three eigenvalues closest to sigma
+    Vector dist = (true_evals.array() - sigma).abs();
+    std::sort(dist.data(), dist.data() + n);
+    Vector found = (geigs.eigenvalues().array() - sigma).abs();
+    std::sort(found.data(), found.data() + found.size());
+    REQUIRE((found - dist.head(3)).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-8));
+}
+
+TEST_CASE("Sparse Cholesky with an alternative backend", "[FacTraits]")
+{
+    std::srand(123);
+    const int n = 50;
+    Matrix M = Matrix::Random(n, n);
+    const Matrix A = M + M.transpose();
+    Matrix B = M.transpose() * M;
+    B.diagonal().array() += 1.0;
+    const SpMatrix Bs = B.sparseView();
+
+    using NatLLT = Eigen::SimplicialLLT<SpMatrix, Eigen::Lower, Eigen::NaturalOrdering<int>>;
+    SparseCholesky<double> chol_default(Bs);
+    SparseCholesky<double, Eigen::Lower, Eigen::ColMajor, int, NatLLT> chol_natural(Bs);
+    REQUIRE(chol_default.info() == CompInfo::Successful);
+    REQUIRE(chol_natural.info() == CompInfo::Successful);
+
+    // inv(L') * inv(L) = inv(B) for both factorizations
+    const Vector x = Vector::Random(n);
+    Vector y1(n), z1(n), y2(n), z2(n);
+    chol_default.lower_triangular_solve(x.data(), y1.data());
+    chol_default.upper_triangular_solve(y1.data(), z1.data());
+    chol_natural.lower_triangular_solve(x.data(), y2.data());
+    chol_natural.upper_triangular_solve(y2.data(), z2.data());
+    const Vector z = B.llt().solve(x);
+    REQUIRE((z1 - z).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-8));
+    REQUIRE((z2 - z).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-8));
+
+    // Generalized eigen solver in the Cholesky mode
+    DenseSymMatProd<double> opA(A);
+    using BOp = SparseCholesky<double, Eigen::Lower, Eigen::ColMajor, int, NatLLT>;
+    SymGEigsSolver<DenseSymMatProd<double>, BOp, GEigsMode::Cholesky> geigs(opA, chol_natural, 3, 10);
+    geigs.init();
+    geigs.compute(SortRule::LargestAlge);
+    REQUIRE(geigs.info() == CompInfo::Successful);
+    Eigen::GeneralizedSelfAdjointEigenSolver<Matrix> es(A, B);
+    REQUIRE((geigs.eigenvalues() - es.eigenvalues().tail(3).reverse()).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-8));
+}
+
+TEST_CASE("Inertia from a Cholesky factorization", "[FacTraits]")
+{
+    const int n = 50;
+    Matrix A = Matrix::Identity(n, n);
+    A.diagonal().head(5).setConstant(-1.0);
+    const SpMatrix As = A.sparseView();
+    using LLTTraits = FacTraits<Eigen::SimplicialLLT<SpMatrix>>;
+    Index npos, nneg, nzero;
+
+    // A successful factorization implies that the matrix is positive definite
+    Eigen::SimplicialLLT<SpMatrix> llt_spd(SpMatrix(Matrix::Identity(n, n).sparseView()));
+    LLTTraits::inertia(llt_spd, npos, nneg, nzero);
+    REQUIRE(npos == n);
+    REQUIRE(nneg == 0);
+    REQUIRE(nzero == 0);
+
+    // The inertia of an indefinite matrix is not reported as zero
+    Eigen::SimplicialLLT<SpMatrix> llt_indef(As);
+    REQUIRE(llt_indef.info() != Eigen::Success);
+    REQUIRE_THROWS_AS(LLTTraits::inertia(llt_indef, npos, nneg, nzero), std::runtime_error);
+}
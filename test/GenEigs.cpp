@@ -1,5 +1,6 @@
 #include <Eigen/Core>
 #include <Eigen/SparseCore>
+#include <Eigen/Eigenvalues>
 #include <iostream>
 #include <type_traits>
 #include <random>  // Requires C++ 11
@@ -71,6 +72,42 @@ void run_test(const MatType& mat, Solver& eigs, SortRule selection, bool allow_f
     REQUIRE(err == Approx(0.0).margin(1e-9));
 }
 
+// Tests the partial Schur form returned by the solver
+template <typename MatType, typename Solver>
+void check_schur(const MatType& mat, const Solver& eigs)
+{
+    const ComplexVector evals = eigs.eigenvalues();
+    const Matrix Q = eigs.schur_vectors();
+    const Matrix T = eigs.schur_form();
+    const int p = Q.cols();
+    REQUIRE(T.rows() == p);
+    REQUIRE(T.cols() == p);
+    REQUIRE(p >= evals.size());
+
+    // T is quasi-upper-triangular
+    Matrix lowerT = T.triangularView<Eigen::StrictlyLower>();
+    lowerT.diagonal(-1).setZero();
+    REQUIRE(lowerT.cwiseAbs().maxCoeff() == 0.0);
+    for (int i = 0; i < p - 2; i++)
+        REQUIRE((T(i + 1, i) == 0.0 || T(i + 2, i + 1) == 0.0));
+
+    const Matrix resid1 = Q.transpose() * Q - Matrix::Identity(p, p);
+    INFO("||Q'Q - I||_inf = " << resid1.cwiseAbs().maxCoeff());
+    REQUIRE(resid1.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-12));
+    const Matrix resid2 = mat * Q - Q * T;
+    INFO("||AQ - QT||_inf = " << resid2.cwiseAbs().maxCoeff());
+    REQUIRE(resid2.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-9));
+
+    // The converged eigenvalues are the eigenvalues of T
+    Eigen::EigenSolver<Matrix> es(T, false);
+    for (int i = 0; i < evals.size(); i++)
+    {
+        const double dist = (es.eigenvalues().array() - evals[i]).abs().minCoeff();
+        INFO("eigenvalue = " << evals[i]);
+        REQUIRE(dist == Approx(0.0).margin(1e-9));
+    }
+}
+
 template <typename MatType>
 void run_test_sets(const MatType& A, int k, int m)
 {
@@ -173,3 +210,81 @@ TEST_CASE("Eigensolver of sparse real matrix [1000x1000]", "[eigs_gen]")
 
     run_test_sets(A, k, m);
 }
+
+TEST_CASE("Convergence criteria of the general eigen solver", "[eigs_gen]")
+{
+    // Upper bidiagonal matrix whose smallest eigenvalue is close to zero
+    const int n = 400;
+    SpMatrix A(n, n);
+    for (int i = 0; i < n; i++)
+    {
+        A.insert(i, i) = 1e-7 + 0.01 * i;
+        if (i < n - 1)
+            A.insert(i, i + 1) = 0.001;
+    }
+    const double tol = 1e-8;
+
+    SparseGenMatProd<double> op(A);
+    GenEigsSolver<SparseGenMatProd<double>> eigs(op, 4, 20);
+
+    eigs.init();
+    eigs.compute(SortRule::SmallestReal, 2000, tol, SortRule::SmallestReal);
+    REQUIRE(eigs.info() == CompInfo::Successful);
+    const int nops_ritz = eigs.num_operations();
+
+    eigs.init();
+    eigs.compute(SortRule::SmallestReal, 2000, tol, SortRule::SmallestReal, ConvergenceRule::OperatorNorm);
+    REQUIRE(eigs.info() == CompInfo::Successful);
+    const int nops_norm = eigs.num_operations();
+
+    const ComplexVector evals = eigs.eigenvalues();
+    const ComplexMatrix evecs = eigs.eigenvectors();
+    const ComplexMatrix resid = A * evecs - evecs * evals.asDiagonal();
+    INFO("nops: RitzValue = " << nops_ritz << ", OperatorNorm = " << nops_norm);
+    REQUIRE(evals[0].real() == Approx(1e-7).margin(1e-9));
+    REQUIRE(resid.colwise().norm().maxCoeff() < 5 * tol);
+    REQUIRE(nops_norm < nops_ritz);
+}
+
+TEST_CASE("Partial Schur form of general real matrix", "[eigs_gen]")
+{
+    std::srand(123);
+
+    const Matrix A = Matrix::Random(100, 100);
+    DenseGenMatProd<double> op(A);
+    GenEigsSolver<DenseGenMatProd<double>> eigs(op, 10, 30);
+
+    SECTION("Largest Magnitude")
+    {
+        eigs.init();
+        eigs.compute(SortRule::LargestMagn);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        check_schur(A, eigs);
+    }
+    SECTION("Largest Real Part")
+    {
+        eigs.init();
+        eigs.compute(SortRule::LargestReal);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        check_schur(A, eigs);
+    }
+    SECTION("Cached Schur form after a new computation")
+    {
+        eigs.init();
+        eigs.compute(SortRule::LargestMagn);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        check_schur(A, eigs);
+        eigs.init();
+        eigs.compute(SortRule::LargestReal);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        check_schur(A, eigs);
+    }
+
+    const SpMatrix S = gen_sparse_data(1000, 0.01);
+    SparseGenMatProd<double> sop(S);
+    GenEigsSolver<SparseGenMatProd<double>> seigs(sop, 20, 50);
+    seigs.init();
+    seigs.compute(SortRule::LargestImag);
+    REQUIRE(seigs.info() == CompInfo::Successful);
+    check_schur(S, seigs);
+}
@@ -0,0 +1,147 @@
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <Eigen/SparseCore>
+#include <iostream>
+#include <type_traits>
+#include <random>  // Requires C++ 11
+
+#include <Spectra/GenEigsCayleySolver.h>
+#include <Spectra/GenEigsSolver.h>
+#include <Spectra/MatOp/DenseGenRealShiftSolve.h>
+#include <Spectra/MatOp/SparseGenRealShiftSolve.h>
+#include <Spectra/MatOp/SparseGenMatProd.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+using ComplexMatrix = Eigen::MatrixXcd;
+using ComplexVector = Eigen::VectorXcd;
+using SpMatrix = Eigen::SparseMatrix<double>;
+
+// Generate random sparse matrix
+SpMatrix gen_sparse_data(int n, double prob = 0.5)
+{
+    SpMatrix mat(n, n);
+    std::default_random_engine gen;
+    gen.seed(0);
+    std::uniform_real_distribution<double> distr(0.0, 1.0);
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            if (distr(gen) < prob)
+                mat.insert(i, j) = distr(gen) - 0.5;
+        }
+    }
+    return mat;
+}
+
+// Block upper bidiagonal matrix with 2x2 diagonal blocks [a, 1; -1, a],
+// so the eigenvalues are a +/- i, with a = 0, -0.1, -0.2, ...
+SpMatrix gen_block_bidiag(int n)
+{
+    SpMatrix mat(n, n);
+    for (int i = 0; i < n; i += 2)
+    {
+        const double a = -0.05 * i;
+        mat.insert(i, i) = a;
+        mat.insert(i, i + 1) = 1.0;
+        mat.insert(i + 1, i) = -1.0;
+        mat.insert(i + 1, i + 1) = a;
+        if (i + 2 < n)
+        {
+            mat.insert(i, i + 2) = 0.1;
+            mat.insert(i + 1, i + 3) = 0.1;
+        }
+    }
+    return mat;
+}
+
+template <typename MatType, typename Solver>
+void run_test(const MatType& mat, Solver& eigs, double rightmost)
+{
+    eigs.init();
+    int nconv = eigs.compute(SortRule::LargestMagn, 500, 1e-10, SortRule::LargestReal);
+    int niter = eigs.num_iterations();
+    int nops = eigs.num_operations();
+
+    INFO("nconv = " << nconv);
+    INFO("niter = " << niter);
+    INFO("nops  = " << nops);
+    REQUIRE(eigs.info() == CompInfo::Successful);
+
+    ComplexVector evals = eigs.eigenvalues();
+    ComplexMatrix evecs = eigs.eigenvectors();
+
+    ComplexMatrix resid = mat * evecs - evecs * evals.asDiagonal();
+    const double err = resid.array().abs().maxCoeff();
+
+    INFO("||AU - UD||_inf = " << err);
+    REQUIRE(err == Approx(0.0).margin(1e-8));
+
+    // The eigenvalues are sorted by the real parts, and the first one
+    // should be the rightmost eigenvalue
+    INFO("rightmost eigenvalue found = " << evals[0]);
+    REQUIRE(evals[0].real() == Approx(rightmost).margin(1e-8));
+
+    // The partial Schur form is transformed back to the original problem
+    const Matrix Q = eigs.schur_vectors();
+    const Matrix T = eigs.schur_form();
+    const Matrix schur_resid = mat * Q - Q * T;
+    INFO("||AQ - QT||_inf = " << schur_resid.cwiseAbs().maxCoeff());
+    REQUIRE(schur_resid.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-8));
+}
+
+TEST_CASE("Rightmost eigenvalues of general real matrix [100x100]", "[eigs_gen]")
+{
+    std::srand(123);
+
+    const Matrix A = Matrix::Random(100, 100);
+    const double rightmost = Eigen::EigenSolver<Matrix>(A, false).eigenvalues().real().maxCoeff();
+
+    DenseGenRealShiftSolve<double> op(A);
+    GenEigsCayleySolver<DenseGenRealShiftSolve<double>> eigs(op, 5, 20, rightmost + 1.0, rightmost - 3.0);
+    run_test(A, eigs, rightmost);
+}
+
+TEST_CASE("Rightmost eigenvalues of sparse real matrix [1000x1000]", "[eigs_gen]")
+{
+    std::srand(123);
+
+    const SpMatrix A = gen_sparse_data(1000, 0.01);
+    const double rightmost = Eigen::EigenSolver<Matrix>(Matrix(A), false).eigenvalues().real().maxCoeff();
+
+    SparseGenRealShiftSolve<double> op(A);
+    GenEigsCayleySolver<SparseGenRealShiftSolve<double>> eigs(op, 10, 30, rightmost + 0.5, rightmost - 1.5);
+    run_test(A, eigs, rightmost);
+}
+
+TEST_CASE("Cayley mode and LargestReal selection [1000x1000]", "[eigs_gen]")
+{
+    const SpMatrix A = gen_block_bidiag(1000);
+
+    SparseGenRealShiftSolve<double> op(A);
+    GenEigsCayleySolver<SparseGenRealShiftSolve<double>> eigs(op, 4, 20, 1.0, -1.5);
+    run_test(A, eigs, 0.0);
+
+    // The same problem with the regular mode converges much more slowly,
+    // since the rightmost eigenvalues are clustered
+    SparseGenMatProd<double> prod(A);
+    GenEigsSolver<SparseGenMatProd<double>> reg(prod, 4, 20);
+    reg.init();
+    reg.compute(SortRule::LargestReal, 500, 1e-10);
+    INFO("Cayley mode: nops = " << eigs.num_operations());
+    INFO("Regular mode: nops = " << reg.num_operations());
+    REQUIRE(eigs.num_operations() < reg.num_operations());
+}
+
+TEST_CASE("Cayley mode with invalid shifts", "[eigs_gen]")
+{
+    const SpMatrix A = gen_block_bidiag(100);
+    SparseGenRealShiftSolve<double> op(A);
+    REQUIRE_THROWS_AS((GenEigsCayleySolver<SparseGenRealShiftSolve<double>>(op, 3, 20, 1.0, 1.0)),
+                      std::invalid_argument);
+}
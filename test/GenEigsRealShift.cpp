@@ -1,5 +1,6 @@
 #include <Eigen/Core>
 #include <Eigen/SparseCore>
+#include <Eigen/Eigenvalues>
 #include <iostream>
 #include <type_traits>
 #include <random>  // Requires C++ 11
@@ -179,3 +180,27 @@ TEST_CASE("Eigensolver of sparse real matrix [1000x1000]", "[eigs_gen]")
 
     run_test_sets(A, k, m, sigma);
 }
+
+TEST_CASE("Partial Schur form in the shift-and-invert mode [100x100]", "[eigs_gen]")
+{
+    std::srand(123);
+
+    const Matrix A = Matrix::Random(100, 100);
+    DenseGenRealShiftSolve<double> op(A);
+    GenEigsRealShiftSolver<DenseGenRealShiftSolve<double>> eigs(op, 6, 20, 0.5);
+    eigs.init();
+    eigs.compute(SortRule::LargestMagn);
+    REQUIRE(eigs.info() == CompInfo::Successful);
+
+    // The Schur form is transformed back to the original problem
+    const Matrix Q = eigs.schur_vectors();
+    const Matrix T = eigs.schur_form();
+    const Matrix resid = A * Q - Q * T;
+    INFO("||AQ - QT||_inf = " << resid.cwiseAbs().maxCoeff());
+    REQUIRE(resid.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-9));
+
+    const ComplexVector evals = eigs.eigenvalues();
+    Eigen::EigenSolver<Matrix> es(T, false);
+    for (int i = 0; i < evals.size(); i++)
+        REQUIRE((es.eigenvalues().array() - evals[i]).abs().minCoeff() == Approx(0.0).margin(1e-9));
+}
@@ -0,0 +1,172 @@
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <random>  // Requires C++ 11
+
+#include <Spectra/SymEigsSolver.h>
+#include <Spectra/SymEigsShiftSolver.h>
+#include <Spectra/MatOp/HODLRSymMatProd.h>
+#include <Spectra/MatOp/HODLRSymShiftSolve.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+
+// Kernel matrix of sorted random points on [0, 1]
+class KernelEntry
+{
+private:
+    Vector m_x;
+
+public:
+    KernelEntry(int n)
+    {
+        std::default_random_engine gen;
+        gen.seed(123);
+        std::uniform_real_distribution<double> distr(0.0, 1.0);
+        m_x.resize(n);
+        for (int i = 0; i < n; i++)
+            m_x[i] = distr(gen);
+        std::sort(m_x.data(), m_x.data() + n);
+    }
+
+    double operator()(Eigen::Index i, Eigen::Index j) const
+    {
+        const double d = m_x[i] - m_x[j];
+        return std::exp(-5.0 * std::abs(d)) + 1.0 / (1.0 + 50.0 * d * d);
+    }
+
+    Matrix dense() const
+    {
+        const int n = m_x.size();
+        Matrix A(n, n);
+        for (int j = 0; j < n; j++)
+            for (int i = 0; i < n; i++)
+                A(i, j) = operator()(i, j);
+        return A;
+    }
+};
+
+TEST_CASE("HODLR matrix-vector product [2000x2000]", "[hodlr]")
+{
+    const int n = 2000;
+    const KernelEntry entry(n);
+    const Matrix A = entry.dense();
+
+    HODLRMatrix<double> H(64, 1e-10);
+    H.compute(n, entry);
+    INFO("max rank = " << H.max_rank() << ", storage = " << H.storage_size());
+    REQUIRE(H.levels().size() == 6);
+    REQUIRE(H.max_rank() < 30);
+    REQUIRE(H.storage_size() < n * n / 4);
+
+    std::srand(123);
+    const Matrix X = Matrix::Random(n, 3);
+    HODLRSymMatProd<double> op(H);
+    const Matrix Y = op * X;
+    const Matrix Y0 = A * X;
+    REQUIRE((Y - Y0).norm() / Y0.norm() == Approx(0.0).margin(1e-9));
+
+    Vector y(n);
+    op.perform_op(X.col(0).data(), y.data());
+    REQUIRE((y - Y0.col(0)).norm() / Y0.col(0).norm() == Approx(0.0).margin(1e-9));
+
+    // Results do not depend on the number of threads
+    HODLRMatrix<double> H1(64, 1e-10);
+    H1.set_num_threads(1);
+    H1.compute(n, entry);
+    H.set_num_threads(4);
+    Matrix Y1(n, 3), Y4(n, 3);
+    H1.multiply(X, Y1);
+    H.multiply(X, Y4);
+    REQUIRE((Y1 - Y4).cwiseAbs().maxCoeff() == 0.0);
+}
+
+TEST_CASE("HODLR shift-solve [2000x2000]", "[hodlr]")
+{
+    const int n = 2000;
+    const KernelEntry entry(n);
+    const Matrix A = entry.dense();
+
+    HODLRMatrix<double> H(64, 1e-10);
+    H.compute(n, entry);
+    HODLRSymShiftSolve<double> op(H);
+
+    std::srand(123);
+    const Vector x = Vector::Random(n);
+    Vector y(n);
+    // The shifted matrix is indefinite
+    for (double sigma : {-1.0, 0.5, 3.0})
+    {
+        op.set_shift(sigma);
+        op.perform_op(x.data(), y.data());
+        INFO("sigma = " << sigma);
+
+        // The factorization solves the compressed system accurately
+        Matrix Hy(n, 1);
+        H.multiply(y, Hy);
+        const Vector r = Hy.col(0) - sigma * y - x;
+        REQUIRE(r.norm() / x.norm() == Approx(0.0).margin(1e-10));
+
+        // and the original system up to the compression error
+        const Vector r0 = A * y - sigma * y - x;
+        REQUIRE(r0.norm() / (A.norm() * y.norm()) == Approx(0.0).margin(1e-10));
+    }
+}
+
+TEST_CASE("Eigen solvers with HODLR operators [1500x1500]", "[hodlr]")
+{
+    const int n = 1500;
+    const KernelEntry entry(n);
+    const Matrix A = entry.dense();
+    Eigen::SelfAdjointEigenSolver<Matrix> eig(A, Eigen::EigenvaluesOnly);
+    const Vector exact = eig.eigenvalues();
+
+    HODLRMatrix<double> H(64, 1e-12);
+    H.compute(n, entry);
+
+    SECTION("Largest eigenvalues")
+    {
+        HODLRSymMatProd<double> op(H);
+        SymEigsSolver<HODLRSymMatProd<double>> eigs(op, 5, 15);
+        eigs.init();
+        eigs.compute(SortRule::LargestAlge);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        const Vector evals = eigs.eigenvalues();
+        for (int i = 0; i < 5; i++)
+            REQUIRE(evals[i] == Approx(exact[n - 1 - i]).epsilon(1e-10));
+    }
+    SECTION("Interior eigenvalues")
+    {
+        // Eigenvalues closest to sigma, computed with the dense solution
+        const double sigma = 0.5 * (exact[n - 10] + exact[n - 11]);
+        Vector dist = (exact.array() - sigma).abs();
+        std::sort(dist.data(), dist.data() + n);
+
+        HODLRSymShiftSolve<double> op(H);
+        SymEigsShiftSolver<HODLRSymShiftSolve<double>> eigs(op, 4, 12, sigma);
+        eigs.init();
+        eigs.compute(SortRule::LargestMagn);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        Vector evals = (eigs.eigenvalues().array() - sigma).abs();
+        std::sort(evals.data(), evals.data() + 4);
+        for (int i = 0; i < 4; i++)
+            REQUIRE(evals[i] == Approx(dist[i]).epsilon(1e-8));
+    }
+}
+
+TEST_CASE("Invalid arguments of HODLRMatrix", "[hodlr]")
+{
+    REQUIRE_THROWS_AS(HODLRMatrix<double>(0), std::invalid_argument);
+    REQUIRE_THROWS_AS(HODLRMatrix<double>(64, 0.0), std::invalid_argument);
+
+    HODLRMatrix<double> H;
+    const Matrix X = Matrix::Ones(10, 1);
+    Matrix Y(10, 1);
+    REQUIRE_THROWS_AS(H.multiply(X, Y), std::logic_error);
+}
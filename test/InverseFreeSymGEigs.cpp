@@ -0,0 +1,128 @@
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/Eigenvalues>
+#include <Eigen/IterativeLinearSolvers>
+#include <iostream>
+#include <vector>
+
+#include <Spectra/InverseFreeSymGEigsSolver.h>
+#include <Spectra/MatOp/SparseSymMatProd.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+using SpMatrix = Eigen::SparseMatrix<double>;
+using Index = Eigen::Index;
+
+// Stiffness and mass matrices of bilinear finite elements on a k x k grid,
+// with a varying coefficient so that the eigenvalues are simple
+void fem_matrices(int k, SpMatrix& A, SpMatrix& B)
+{
+    const int n = k * k;
+    std::vector<Eigen::Triplet<double>> ta, tb;
+    for (int i = 0; i < k; i++)
+    {
+        for (int j = 0; j < k; j++)
+        {
+            const int p = i * k + j;
+            const double c = 1.0 + 0.5 * double(i) / k + 0.2 * double(j * j) / (k * k);
+            ta.push_back(Eigen::Triplet<double>(p, p, 4.0 * c));
+            tb.push_back(Eigen::Triplet<double>(p, p, 4.0 / 9.0));
+            if (j + 1 < k)
+            {
+                ta.push_back(Eigen::Triplet<double>(p, p + 1, -c));
+                ta.push_back(Eigen::Triplet<double>(p + 1, p, -c));
+                tb.push_back(Eigen::Triplet<double>(p, p + 1, 1.0 / 9.0));
+                tb.push_back(Eigen::Triplet<double>(p + 1, p, 1.0 / 9.0));
+            }
+            if (i + 1 < k)
+            {
+                ta.push_back(Eigen::Triplet<double>(p, p + k, -c));
+                ta.push_back(Eigen::Triplet<double>(p + k, p, -c));
+                tb.push_back(Eigen::Triplet<double>(p, p + k, 1.0 / 9.0));
+                tb.push_back(Eigen::Triplet<double>(p + k, p, 1.0 / 9.0));
+            }
+        }
+    }
+    A.resize(n, n);
+    B.resize(n, n);
+    A.setFromTriplets(ta.begin(), ta.end());
+    B.setFromTriplets(tb.begin(), tb.end());
+}
+
+template <typename Solver>
+void check_result(const SpMatrix& A, const SpMatrix& B, const Vector& exact, int nev, Solver& eigs)
+{
+    INFO("niter = " << eigs.num_iterations());
+    INFO("nops  = " << eigs.num_operations());
+    REQUIRE(eigs.info() == CompInfo::Successful);
+
+    const Vector evals = eigs.eigenvalues();
+    const Matrix evecs = eigs.eigenvectors();
+    REQUIRE(evals.size() == nev);
+    for (int i = 0; i < nev; i++)
+        REQUIRE(evals[i] == Approx(exact[i]).epsilon(1e-10));
+
+    const Matrix resid = A * evecs - B * evecs * evals.asDiagonal();
+    REQUIRE(resid.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-8));
+    const Matrix I = Matrix::Identity(nev, nev);
+    REQUIRE((evecs.transpose() * B * evecs - I).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-10));
+}
+
+TEST_CASE("Inverse-free Krylov solver for generalized eigenvalues", "[ifree]")
+{
+    SpMatrix A, B;
+    fem_matrices(20, A, B);
+    const Index n = A.rows();
+    Eigen::GeneralizedSelfAdjointEigenSolver<Matrix> eig(Matrix(A), Matrix(B), Eigen::EigenvaluesOnly);
+    const Vector exact = eig.eigenvalues();
+
+    using SolverType = InverseFreeSymGEigsSolver<SparseSymMatProd<double>, SparseSymMatProd<double>>;
+    SparseSymMatProd<double> op(A), Bop(B);
+
+    // Incomplete Cholesky factorization of A as the preconditioner
+    Eigen::IncompleteCholesky<double> ichol(A);
+    auto precond = [&ichol, n](const double* x, double* y) {
+        Eigen::Map<Vector>(y, n) = ichol.solve(Eigen::Map<const Vector>(x, n));
+    };
+
+    SECTION("Single vector")
+    {
+        SolverType eigs(op, Bop, 1, 1, 8);
+        eigs.init();
+        eigs.compute(1000, 1e-12);
+        check_result(A, B, exact, 1, eigs);
+    }
+
+    SECTION("Block with preconditioning")
+    {
+        SolverType plain(op, Bop, 4, 6, 4);
+        plain.init();
+        plain.compute(1000, 1e-12);
+        check_result(A, B, exact, 4, plain);
+
+        SolverType eigs(op, Bop, 4, 6, 4);
+        eigs.set_preconditioner(precond);
+        eigs.init();
+        eigs.compute(1000, 1e-12);
+        check_result(A, B, exact, 4, eigs);
+
+        INFO("without preconditioner = " << plain.num_operations() << ", with = " << eigs.num_operations());
+        REQUIRE(eigs.num_operations() < plain.num_operations());
+    }
+
+    SECTION("Invalid arguments")
+    {
+        REQUIRE_THROWS_AS(SolverType(op, Bop, 0, 2, 4), std::invalid_argument);
+        REQUIRE_THROWS_AS(SolverType(op, Bop, 3, 2, 4), std::invalid_argument);
+        REQUIRE_THROWS_AS(SolverType(op, Bop, 2, 2, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(SolverType(op, Bop, 2, 100, 4), std::invalid_argument);
+
+        SolverType eigs(op, Bop, 2, 2, 4);
+        const Matrix X0 = Matrix::Ones(n, 2);
+        REQUIRE_THROWS_AS(eigs.init(X0.data()), std::invalid_argument);
+    }
+}
@@ -0,0 +1,209 @@
+// Test ../include/Spectra/MatOp/IterativeSymShiftSolve.h
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
+#include <iostream>
+#include <vector>
+
+#include <Spectra/SymEigsShiftSolver.h>
+#include <Spectra/MatOp/SparseSymShiftSolve.h>
+#include <Spectra/MatOp/IterativeSymShiftSolve.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+using SpMatrix = Eigen::SparseMatrix<double>;
+using Index = Eigen::Index;
+
+// Finite difference Laplacian on an m x m x m grid, with a slightly
+// perturbed diagonal to split the multiple eigenvalues
+SpMatrix gen_laplacian(int m)
+{
+    const int n = m * m * m;
+    std::vector<Eigen::Triplet<double>> trip;
+    auto id = [m](int i, int j, int k) { return (i * m + j) * m + k; };
+    for (int i = 0; i < m; i++)
+    {
+        for (int j = 0; j < m; j++)
+        {
+            for (int k = 0; k < m; k++)
+            {
+                const int r = id(i, j, k);
+                trip.emplace_back(r, r, 6.0 + 0.01 * ((r * 7919) % 13));
+                if (i > 0)
+                    trip.emplace_back(r, id(i - 1, j, k), -1.0);
+                if (j > 0)
+                    trip.emplace_back(r, id(i, j - 1, k), -1.0);
+                if (k > 0)
+                    trip.emplace_back(r, id(i, j, k - 1), -1.0);
+            }
+        }
+    }
+    SpMatrix lower(n, n);
+    lower.setFromTriplets(trip.begin(), trip.end());
+    SpMatrix mat = lower.selfadjointView<Eigen::Lower>();
+    return mat;
+}
+
+template <typename OpType>
+Vector run_shift_solve(OpType& op, double sigma, double tol, const SpMatrix& A)
+{
+    SymEigsShiftSolver<OpType> eigs(op, 4, 12, sigma);
+    eigs.init();
+    const int nconv = eigs.compute(SortRule::LargestMagn, 1000, tol);
+    REQUIRE(nconv == 4);
+    REQUIRE(eigs.info() == CompInfo::Successful);
+
+    const Vector evals = eigs.eigenvalues();
+    const Matrix evecs = eigs.eigenvectors();
+    const Matrix resid = A * evecs - evecs * evals.asDiagonal();
+    INFO("Residual = " << resid.cwiseAbs().maxCoeff());
+    REQUIRE(resid.cwiseAbs().maxCoeff() == Approx(0.0).margin(1000 * tol));
+    return evals;
+}
+
+TEST_CASE("Iterative shift-solve on a single vector", "[IterativeSymShiftSolve]")
+{
+    const SpMatrix A = gen_laplacian(6);
+    const int n = A.rows();
+    const Vector b = Vector::Random(n);
+    const double sigma = 2.0;
+    const SpMatrix K = A - sigma * SpMatrix(Matrix::Identity(n, n).sparseView());
+
+    IterativeSymShiftSolve<double> op(A);
+    op.set_shift(sigma);
+    op.set_tolerance(1e-12);
+    Vector y(n);
+    op.perform_op(b.data(), y.data());
+    REQUIRE(op.info() == CompInfo::Successful);
+    REQUIRE((K * y - b).norm() == Approx(0.0).margin(1e-10 * b.norm()));
+    REQUIRE(op.num_solves() == 1);
+
+    // Warm start from the previous solution
+    const Index niter = op.num_iterations();
+    const Vector b2 = 2.0 * b;
+    op.perform_op(b2.data(), y.data());
+    REQUIRE((K * y - b2).norm() == Approx(0.0).margin(1e-10 * b2.norm()));
+    REQUIRE(op.num_iterations() - niter < niter / 2);
+
+    // Jacobi preconditioner
+    const Vector diag = K.diagonal().cwiseAbs();
+    op.set_preconditioner([&diag](const double* x_in, double* y_out) {
+        Eigen::Map<Vector>(y_out, diag.size()) = Eigen::Map<const Vector>(x_in, diag.size()).cwiseQuotient(diag);
+    });
+    op.set_warm_start(0);
+    op.perform_op(b.data(), y.data());
+    REQUIRE((K * y - b).norm() == Approx(0.0).margin(1e-10 * b.norm()));
+
+    // CG requires a positive definite shifted matrix
+    IterativeSymShiftSolve<double> op_cg(A, IterativeMethod::CG);
+    op_cg.set_shift(sigma);
+    REQUIRE_THROWS_AS(op_cg.perform_op(b.data(), y.data()), std::invalid_argument);
+    op_cg.set_shift(0.1);
+    op_cg.perform_op(b.data(), y.data());
+    REQUIRE(((A * y - 0.1 * y) - b).norm() == Approx(0.0).margin(1e-10 * b.norm()));
+
+    REQUIRE_THROWS_AS(op.set_tolerance(0.0), std::invalid_argument);
+    REQUIRE_THROWS_AS(op.set_max_iterations(0), std::invalid_argument);
+}
+
+TEST_CASE("Eigenvalues with iterative shift-solve", "[IterativeSymShiftSolve]")
+{
+    const SpMatrix A = gen_laplacian(8);
+
+    SECTION("CG, shift below the spectrum")
+    {
+        const double sigma = 0.1;
+        SparseSymShiftSolve<double> ref_op(A);
+        const Vector ref = run_shift_solve(ref_op, sigma, 1e-10, A);
+
+        IterativeSymShiftSolve<double> op(A, IterativeMethod::CG);
+        const Vector evals = run_shift_solve(op, sigma, 1e-10, A);
+        REQUIRE((evals - ref).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-10));
+    }
+
+    SECTION("MINRES, interior shift")
+    {
+        const double sigma = 3.0;
+        SparseSymShiftSolve<double> ref_op(A);
+        const Vector ref = run_shift_solve(ref_op, sigma, 1e-10, A);
+
+        IterativeSymShiftSolve<double> op(A);
+        const Vector evals = run_shift_solve(op, sigma, 1e-10, A);
+        REQUIRE((evals - ref).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-10));
+    }
+
+    SECTION("Tolerances controlled by the eigen solver")
+    {
+        const double sigma = 0.1, tol = 1e-6;
+
+        IterativeSymShiftSolve<double> op_fixed(A, IterativeMethod::CG);
+        op_fixed.set_adaptive_tolerance(false);
+        const Vector evals_fixed = run_shift_solve(op_fixed, sigma, tol, A);
+
+        IterativeSymShiftSolve<double> op(A, IterativeMethod::CG);
+        const Vector evals = run_shift_solve(op, sigma, tol, A);
+        REQUIRE((evals - evals_fixed).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-6));
+
+        INFO("Inner iterations: adaptive = " << op.num_iterations() << ", fixed = " << op_fixed.num_iterations());
+        REQUIRE(op.num_iterations() < op_fixed.num_iterations());
+    }
+
+    SECTION("Small maxit")
+    {
+        // The solver may stop right after switching from loose to tight inner solves,
+        // and then it must not report the Ritz pairs of the loose stage as converged
+        const int n = 200;
+        SpMatrix D(n, n);
+        for (int i = 0; i < n; i++)
+            D.insert(i, i) = 1.0 + 0.01 * i;
+
+        for (int maxit = 1; maxit <= 6; maxit++)
+        {
+            INFO("maxit = " << maxit);
+            IterativeSymShiftSolve<double> op(D);
+            SymEigsShiftSolver<IterativeSymShiftSolve<double>> eigs(op, 3, 20, 0.0);
+            eigs.init();
+            const int nconv = eigs.compute(SortRule::LargestMagn, maxit, 1e-10);
+            REQUIRE((eigs.info() == CompInfo::Successful) == (nconv == 3));
+            REQUIRE(eigs.eigenvalues().size() == nconv);
+            if (maxit == 3)
+                REQUIRE(eigs.info() == CompInfo::NotConverging);
+            if (nconv > 0)
+            {
+                const Vector evals = eigs.eigenvalues();
+                const Matrix evecs = eigs.eigenvectors();
+                const Matrix resid = D * evecs - evecs * evals.asDiagonal();
+                REQUIRE(resid.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-8));
+            }
+        }
+    }
+
+    SECTION("Tolerance after compute()")
+    {
+        // The eigen solver tightens the inner solves, and restores the tolerance
+        // given by set_tolerance() when it returns
+        const double sigma = 0.1;
+        const Vector b = Vector::Random(A.rows());
+        Vector x(A.rows());
+        IterativeSymShiftSolve<double> ref(A, IterativeMethod::CG);
+        ref.set_tolerance(1e-4);
+        ref.set_warm_start(0);
+        ref.set_shift(sigma);
+        ref.perform_op(b.data(), x.data());
+
+        IterativeSymShiftSolve<double> op(A, IterativeMethod::CG);
+        op.set_tolerance(1e-4);
+        op.set_warm_start(0);
+        SymEigsShiftSolver<IterativeSymShiftSolve<double>> eigs(op, 4, 12, sigma);
+        eigs.init();
+        eigs.compute(SortRule::LargestMagn, 1000, 1e-10);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        op.reset_counters();
+        op.perform_op(b.data(), x.data());
+        REQUIRE(op.num_iterations() == ref.num_iterations());
+    }
+}
@@ -0,0 +1,165 @@
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <iostream>
+#include <sstream>
+
+#include <Spectra/SymEigsSolver.h>
+#include <Spectra/MatOp/DenseSymMatProd.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+using Index = Eigen::Index;
+using OpType = DenseSymMatProd<double>;
+using SolverType = SymEigsSolver<OpType>;
+
+// Checks the first nev eigenvalues against the exact ones, sorted in increasing order
+void check_evals(const Vector& evals, const Vector& exact, bool largest)
+{
+    const Index n = exact.size();
+    const Index nev = evals.size();
+    for (Index i = 0; i < nev; i++)
+    {
+        // compute() sorts the eigenvalues in decreasing order by default
+        const double expected = largest ? exact[n - 1 - i] : exact[nev - 1 - i];
+        REQUIRE(evals[i] == Approx(expected).epsilon(1e-10));
+    }
+}
+
+TEST_CASE("Saved Lanczos factorization", "[krylov_fac]")
+{
+    std::srand(123);
+    const int n = 400;
+    const Matrix R = Matrix::Random(n, n);
+    const Matrix A = R + R.transpose();
+    Eigen::SelfAdjointEigenSolver<Matrix> eig(A, Eigen::EigenvaluesOnly);
+    const Vector exact = eig.eigenvalues();
+
+    OpType op(A);
+    SolverType eigs(op, 5, 20);
+    REQUIRE_THROWS_AS(eigs.factorization(), std::logic_error);
+    eigs.init();
+    eigs.compute(SortRule::LargestAlge);
+    REQUIRE(eigs.info() == CompInfo::Successful);
+    check_evals(eigs.eigenvalues(), exact, true);
+
+    const KrylovFactorization<double> fac = eigs.factorization();
+    REQUIRE(fac.rows() == n);
+    REQUIRE(fac.subspace_dim() == 20);
+
+    SECTION("Factorization and Ritz pairs")
+    {
+        const Matrix& V = fac.matrix_V();
+        const Matrix& H = fac.matrix_H();
+        Matrix resid = A * V - V * H;
+        resid.col(19) -= fac.vector_f();
+        REQUIRE(resid.norm() == Approx(0.0).margin(1e-10 * A.norm()));
+        REQUIRE((V.transpose() * V - Matrix::Identity(20, 20)).norm() == Approx(0.0).margin(1e-12));
+
+        // Queries without operator multiplications
+        const Vector vals = fac.ritz_values(SortRule::LargestAlge, 5);
+        const Matrix vecs = fac.ritz_vectors(SortRule::LargestAlge, 5);
+        const Vector res = fac.ritz_residuals(SortRule::LargestAlge, 5);
+        check_evals(vals, exact, true);
+        for (int i = 0; i < 5; i++)
+        {
+            const double r = (A * vecs.col(i) - vals[i] * vecs.col(i)).norm();
+            REQUIRE(r == Approx(res[i]).margin(1e-10));
+            REQUIRE(res[i] < 1e-8);
+        }
+        // The smallest Ritz values are available too, though less accurate
+        const Vector small = fac.ritz_values(SortRule::SmallestAlge, 3);
+        REQUIRE(small[0] <= small[1]);
+        REQUIRE(small[0] >= exact[0] - 1e-10);
+    }
+
+    SECTION("Other selection rules and nev")
+    {
+        // Fresh solves for reference
+        SolverType fresh_small(op, 5, 20);
+        fresh_small.init();
+        fresh_small.compute(SortRule::SmallestAlge);
+        REQUIRE(fresh_small.info() == CompInfo::Successful);
+        SolverType fresh_large(op, 10, 30);
+        fresh_large.init();
+        fresh_large.compute(SortRule::LargestAlge);
+        REQUIRE(fresh_large.info() == CompInfo::Successful);
+
+        // The other end of the spectrum
+        SolverType small(op, 5, 20);
+        small.init(fac);
+        small.compute(SortRule::SmallestAlge);
+        REQUIRE(small.info() == CompInfo::Successful);
+        check_evals(small.eigenvalues(), exact, false);
+        REQUIRE(small.num_operations() < fresh_small.num_operations());
+
+        // More eigenvalues with a larger subspace, which extends the saved one
+        SolverType large(op, 10, 30);
+        large.init(fac);
+        large.compute(SortRule::LargestAlge);
+        REQUIRE(large.info() == CompInfo::Successful);
+        check_evals(large.eigenvalues(), exact, true);
+        REQUIRE(large.num_operations() < fresh_large.num_operations());
+
+        // A smaller subspace keeps the leading part of the factorization
+        SolverType trunc(op, 3, 12);
+        trunc.init(fac);
+        trunc.compute(SortRule::LargestAlge);
+        REQUIRE(trunc.info() == CompInfo::Successful);
+        check_evals(trunc.eigenvalues(), exact, true);
+    }
+
+    SECTION("Repeated compute() on the same solver")
+    {
+        SolverType fresh(op, 5, 20);
+        fresh.init();
+        fresh.compute(SortRule::SmallestAlge);
+        REQUIRE(fresh.info() == CompInfo::Successful);
+
+        // The counter is not reset, and the new run starts from the saved subspace
+        const Index nop = eigs.num_operations();
+        eigs.compute(SortRule::SmallestAlge);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        check_evals(eigs.eigenvalues(), exact, false);
+        REQUIRE(eigs.num_operations() - nop < fresh.num_operations());
+    }
+
+    SECTION("Saving and loading")
+    {
+        std::stringstream buf;
+        fac.save(buf);
+        KrylovFactorization<double> loaded;
+        loaded.load(buf);
+        REQUIRE(loaded.subspace_dim() == 20);
+        REQUIRE(loaded.matrix_V() == fac.matrix_V());
+        REQUIRE(loaded.matrix_H() == fac.matrix_H());
+        REQUIRE(loaded.vector_f() == fac.vector_f());
+
+        SolverType small(op, 5, 20);
+        small.init(loaded);
+        small.compute(SortRule::SmallestAlge);
+        REQUIRE(small.info() == CompInfo::Successful);
+        check_evals(small.eigenvalues(), exact, false);
+
+        std::stringstream bad("not a factorization");
+        REQUIRE_THROWS_AS(loaded.load(bad), std::runtime_error);
+        std::stringstream buf2;
+        fac.save(buf2);
+        const std::string truncated = buf2.str().substr(0, 1000);
+        std::stringstream bad2(truncated);
+        REQUIRE_THROWS_AS(loaded.load(bad2), std::runtime_error);
+    }
+
+    SECTION("Invalid factorizations")
+    {
+        const Matrix B = A.topLeftCorner(100, 100);
+        OpType opB(B);
+        SolverType eigsB(opB, 5, 20);
+        REQUIRE_THROWS_AS(eigsB.init(fac), std::invalid_argument);
+        REQUIRE_THROWS_AS(KrylovFactorization<double>(fac.matrix_V(), fac.matrix_H().topRows(10), fac.vector_f()),
+                          std::invalid_argument);
+    }
+}
@@ -0,0 +1,126 @@
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <iostream>
+#include <vector>
+
+#include <Spectra/SymEigsSolver.h>
+#include <Spectra/MatOp/SparseSymMatProd.h>
+#include <Spectra/contrib/MultilevelInit.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+using SpMatrix = Eigen::SparseMatrix<double>;
+
+// Laplacian of the nx x ny grid graph, where the horizontal edges have weight
+// one and the vertical edges have weight `wy`
+SpMatrix gen_grid_laplacian(int nx, int ny, double wy)
+{
+    const int n = nx * ny;
+    std::vector<Eigen::Triplet<double>> trip;
+    Vector deg = Vector::Zero(n);
+    auto add_edge = [&](int i, int j, double w) {
+        trip.emplace_back(i, j, -w);
+        trip.emplace_back(j, i, -w);
+        deg[i] += w;
+        deg[j] += w;
+    };
+    for (int y = 0; y < ny; y++)
+    {
+        for (int x = 0; x < nx; x++)
+        {
+            const int i = y * nx + x;
+            if (x + 1 < nx)
+                add_edge(i, i + 1, 1.0);
+            if (y + 1 < ny)
+                add_edge(i, i + nx, wy);
+        }
+    }
+    for (int i = 0; i < n; i++)
+        trip.emplace_back(i, i, deg[i]);
+
+    SpMatrix mat(n, n);
+    mat.setFromTriplets(trip.begin(), trip.end());
+    return mat;
+}
+
+// Returns the number of matrix operations used by SymEigsSolver
+int run_smallest(const SpMatrix& L, int nev, const double* init_vec)
+{
+    SparseSymMatProd<double> op(L);
+    SymEigsSolver<SparseSymMatProd<double>> eigs(op, nev, 20);
+    if (init_vec)
+        eigs.init_guess(init_vec);
+    else
+        eigs.init();
+    eigs.compute(SortRule::SmallestAlge, 2000, 1e-8, SortRule::SmallestAlge, ConvergenceRule::OperatorNorm);
+
+    INFO("nops = " << eigs.num_operations());
+    REQUIRE(eigs.info() == CompInfo::Successful);
+
+    const Vector evals = eigs.eigenvalues();
+    const Matrix evecs = eigs.eigenvectors();
+    const Matrix resid = L * evecs - evecs * evals.asDiagonal();
+    INFO("||AU - UD||_inf = " << resid.cwiseAbs().maxCoeff());
+    REQUIRE(resid.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-6));
+    // The smallest eigenvalue of a connected graph Laplacian is zero
+    REQUIRE(evals[0] == Approx(0.0).margin(1e-6));
+
+    return eigs.num_operations();
+}
+
+TEST_CASE("Multilevel initial guesses of grid Laplacian [6300x6300]", "[multilevel]")
+{
+    const SpMatrix L = gen_grid_laplacian(90, 70, 1.0);
+    const int nev = 4;
+
+    MultilevelGraphInit<double> ml(L, nev);
+    ml.compute();
+    REQUIRE(ml.num_levels() > 3);
+
+    // The initial guesses are orthonormal and have small Rayleigh quotients
+    const Matrix& X = ml.initial_block();
+    REQUIRE(X.rows() == L.rows());
+    REQUIRE(X.cols() == nev);
+    const Matrix XtX = X.transpose() * X - Matrix::Identity(nev, nev);
+    REQUIRE(XtX.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-10));
+    const Vector rq = (X.transpose() * (L * X)).diagonal();
+    REQUIRE(rq.maxCoeff() < 0.05);
+
+    const Vector v0 = ml.initial_vector();
+    const int nops_random = run_smallest(L, nev, nullptr);
+    const int nops_ml = run_smallest(L, nev, v0.data());
+    INFO("nops: random = " << nops_random << ", multilevel = " << nops_ml + ml.num_operations());
+    REQUIRE(nops_ml + ml.num_operations() < nops_random);
+}
+
+TEST_CASE("Multilevel initial guesses of anisotropic grid Laplacian [4000x4000]", "[multilevel]")
+{
+    const SpMatrix L = gen_grid_laplacian(100, 40, 0.1);
+    const int nev = 4;
+
+    MultilevelGraphInit<double> ml(L, nev);
+    ml.compute();
+
+    const Vector v0 = ml.initial_vector();
+    const int nops_random = run_smallest(L, nev, nullptr);
+    const int nops_ml = run_smallest(L, nev, v0.data());
+    INFO("nops: random = " << nops_random << ", multilevel = " << nops_ml + ml.num_operations());
+    REQUIRE(nops_ml + ml.num_operations() < nops_random);
+}
+
+TEST_CASE("Multilevel initializer on small graphs", "[multilevel]")
+{
+    // The graph is not coarsened, and the result is still a valid initial block
+    const SpMatrix L = gen_grid_laplacian(5, 4, 1.0);
+    MultilevelGraphInit<double> ml(L, 3);
+    ml.compute();
+    REQUIRE(ml.num_levels() == 1);
+    REQUIRE(ml.initial_block().cols() == 3);
+
+    REQUIRE_THROWS_AS(MultilevelGraphInit<double>(L, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(MultilevelGraphInit<double>(L, 20), std::invalid_argument);
+}
@@ -0,0 +1,206 @@
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/Eigenvalues>
+#include <iostream>
+#include <thread>
+#include <stdexcept>
+#include <random>  // Requires C++ 11
+
+#if defined(__linux__)
+#include <sched.h>  // sched_getcpu
+#endif
+
+#include <Spectra/SymEigsSolver.h>
+#include <Spectra/GenEigsSolver.h>
+#include <Spectra/MatOp/NumaSparseMatProd.h>
+#include <Spectra/MatOp/SparseSymMatProd.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+using SpMatrix = Eigen::SparseMatrix<double>;
+using Triplet = Eigen::Triplet<double>;
+
+SpMatrix gen_sparse(int n, double prob, bool symmetric)
+{
+    std::default_random_engine gen;
+    gen.seed(123);
+    std::uniform_real_distribution<double> distr(0.0, 1.0);
+
+    std::vector<Triplet> triplets;
+    for (int j = 0; j < n; j++)
+    {
+        for (int i = symmetric ? j : 0; i < n; i++)
+        {
+            // Denser rows at the top, so that the blocks have different sizes
+            if (distr(gen) < prob * (i < n / 4 ? 4.0 : 1.0))
+            {
+                const double v = distr(gen) - 0.5;
+                triplets.push_back(Triplet(i, j, v));
+                if (symmetric && i != j)
+                    triplets.push_back(Triplet(j, i, v));
+            }
+        }
+    }
+    SpMatrix mat(n, n);
+    mat.setFromTriplets(triplets.begin(), triplets.end());
+    return mat;
+}
+
+template <typename OpType>
+void check_product(const OpType& op, const SpMatrix& mat)
+{
+    REQUIRE(op.rows() == mat.rows());
+    REQUIRE(op.cols() == mat.cols());
+
+    const Matrix X = Matrix::Random(mat.cols(), 3);
+    const Matrix Y0 = mat * X;
+    const Matrix Y = op * X;
+    REQUIRE((Y - Y0).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-12));
+
+    Vector y(mat.rows());
+    op.perform_op(X.col(2).data(), y.data());
+    REQUIRE((y - Y0.col(2)).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-12));
+}
+
+TEST_CASE("Pinned executor", "[numa]")
+{
+    NumaExecutor exec(4);
+    REQUIRE(exec.num_threads() == 4);
+
+    // Part k always runs on the same worker
+    std::vector<std::thread::id> ids1(4), ids2(4);
+    exec.run([&ids1](int k) { ids1[k] = std::this_thread::get_id(); });
+    exec.run([&ids2](int k) { ids2[k] = std::this_thread::get_id(); });
+    for (int k = 0; k < 4; k++)
+    {
+        REQUIRE(ids1[k] == ids2[k]);
+        REQUIRE(ids1[k] != std::this_thread::get_id());
+        for (int l = 0; l < k; l++)
+            REQUIRE(ids1[k] != ids1[l]);
+    }
+
+    // Exceptions are passed to the caller, and the workers keep running
+    REQUIRE_THROWS_AS(exec.run([](int k) { if (k == 2) throw std::runtime_error("error"); }),
+                      std::runtime_error);
+    std::vector<int> parts(4, 0);
+    exec.run([&parts](int k) { parts[k]++; });
+    REQUIRE(parts == std::vector<int>(4, 1));
+
+#if defined(__linux__)
+    // Workers pinned to CPU 0, which every process can use
+    NumaExecutor exec0(std::vector<int>{ 0, 0 });
+    std::vector<int> cpus(2, -1);
+    exec0.run([&cpus](int k) { cpus[k] = sched_getcpu(); });
+    REQUIRE(cpus == std::vector<int>(2, 0));
+#endif
+
+    REQUIRE_THROWS_AS(NumaExecutor(std::vector<int>()), std::invalid_argument);
+}
+
+TEST_CASE("NUMA-partitioned sparse products", "[numa]")
+{
+    std::srand(123);
+    const int n = 1000;
+    const SpMatrix A = gen_sparse(n, 0.01, false);
+    const SpMatrix S = gen_sparse(n, 0.01, true);
+    const SpMatrix L = S.triangularView<Eigen::Lower>();
+    const SpMatrix U = S.triangularView<Eigen::Upper>();
+
+    for (int nthread : { 1, 3, 4 })
+    {
+        INFO("nthread = " << nthread);
+        NumaSparseMatProd<double> op(A, nthread);
+        REQUIRE(op.num_threads() == nthread);
+        check_product(op, A);
+        check_product(NumaSparseMatProd<double, Eigen::Lower>(L, nthread), S);
+        check_product(NumaSparseMatProd<double, Eigen::Upper>(U, nthread), S);
+
+        // The blocks cover all rows, with balanced numbers of nonzero elements
+        const auto& part = op.partition();
+        REQUIRE(part.size() == std::size_t(nthread + 1));
+        REQUIRE(part.front() == 0);
+        REQUIRE(part.back() == n);
+        const Eigen::SparseMatrix<double, Eigen::RowMajor> Ar = A;
+        for (int k = 0; k < nthread; k++)
+        {
+            REQUIRE(part[k] <= part[k + 1]);
+            const double nnz = Ar.outerIndexPtr()[part[k + 1]] - Ar.outerIndexPtr()[part[k]];
+            REQUIRE(nnz == Approx(double(A.nonZeros()) / nthread).epsilon(0.1));
+        }
+
+        Matrix V = Matrix::Constant(n, 3, 1.0);
+        op.first_touch(V.data(), n, 3);
+        REQUIRE(V.cwiseAbs().maxCoeff() == 0.0);
+    }
+
+    // Row-major input and an explicit list of CPUs
+    const Eigen::SparseMatrix<double, Eigen::RowMajor> Ar = A;
+    check_product(NumaSparseMatProd<double>(Ar, std::vector<int>{ 0, 0, 0 }), A);
+}
+
+// Records the calls of the first_touch() hook
+class TouchCounter : public NumaSparseMatProd<double, Eigen::Lower>
+{
+public:
+    mutable int count = 0;
+    mutable Eigen::Index touched_cols = 0;
+
+    TouchCounter(const SpMatrix& mat) :
+        NumaSparseMatProd<double, Eigen::Lower>(mat, 2)
+    {}
+
+    void first_touch(double* data, Eigen::Index rows, Eigen::Index cols) const
+    {
+        count++;
+        touched_cols += cols;
+        NumaSparseMatProd<double, Eigen::Lower>::first_touch(data, rows, cols);
+    }
+};
+
+TEST_CASE("Eigen solvers with NUMA-partitioned operators", "[numa]")
+{
+    std::srand(123);
+    const int n = 1000;
+
+    SECTION("Symmetric")
+    {
+        const SpMatrix S = gen_sparse(n, 0.01, true);
+        Eigen::SelfAdjointEigenSolver<Matrix> eig{ Matrix(S), Eigen::EigenvaluesOnly };
+
+        TouchCounter op(S.triangularView<Eigen::Lower>());
+        SymEigsSolver<TouchCounter> eigs(op, 5, 20);
+        eigs.init();
+        eigs.compute(SortRule::LargestAlge);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        const Vector evals = eigs.eigenvalues();
+        for (int i = 0; i < 5; i++)
+            REQUIRE(evals[i] == Approx(eig.eigenvalues()[n - 1 - i]).epsilon(1e-10));
+
+        // The Krylov basis and the residual vector were placed by the operator
+        REQUIRE(op.count == 2);
+        REQUIRE(op.touched_cols == 21);
+
+        // A second initialization reuses the same memory, which is not touched again
+        eigs.init();
+        eigs.compute(SortRule::LargestAlge);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        REQUIRE(op.count == 2);
+    }
+    SECTION("General")
+    {
+        const SpMatrix A = gen_sparse(n, 0.01, false);
+        Eigen::EigenSolver<Matrix> eig(Matrix(A), false);
+        const double rho = eig.eigenvalues().cwiseAbs().maxCoeff();
+
+        NumaSparseMatProd<double> op(A, 3);
+        GenEigsSolver<NumaSparseMatProd<double>> eigs(op, 4, 20);
+        eigs.init();
+        eigs.compute(SortRule::LargestMagn);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        REQUIRE(std::abs(eigs.eigenvalues()[0]) == Approx(rho).epsilon(1e-10));
+    }
+}
@@ -0,0 +1,163 @@
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <iostream>
+#include <cmath>
+#include <random>  // Requires C++ 11
+
+#include <Spectra/contrib/NystromEigsSolver.h>
+#include <Spectra/MatOp/DenseSymMatProd.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+
+// Gaussian kernel of the columns of a d x n data matrix
+class GaussianKernel
+{
+private:
+    const Matrix& m_x;
+    const double m_gamma;
+
+public:
+    using Scalar = double;
+
+    GaussianKernel(const Matrix& x, double gamma) :
+        m_x(x), m_gamma(gamma)
+    {}
+
+    Eigen::Index rows() const { return m_x.cols(); }
+
+    double operator()(Eigen::Index i, Eigen::Index j) const
+    {
+        return std::exp(-m_gamma * (m_x.col(i) - m_x.col(j)).squaredNorm());
+    }
+};
+
+// Points drawn from a mixture of Gaussian clusters of different sizes in 3D
+Matrix gen_clustered_points(int n, int nclust)
+{
+    std::default_random_engine gen;
+    gen.seed(123);
+    std::normal_distribution<double> distr(0.0, 1.0);
+    std::uniform_int_distribution<int> cluster(0, nclust - 1);
+
+    Matrix centers(3, nclust);
+    for (int k = 0; k < nclust; k++)
+        for (int d = 0; d < 3; d++)
+            centers(d, k) = 3.0 * distr(gen);
+
+    Matrix x(3, n);
+    for (int i = 0; i < n; i++)
+    {
+        const int k = (i < n / 2) ? 0 : cluster(gen);
+        for (int d = 0; d < 3; d++)
+            x(d, i) = centers(d, k) + 0.5 * distr(gen);
+    }
+    return x;
+}
+
+Matrix kernel_matrix(const GaussianKernel& kernel)
+{
+    const int n = kernel.rows();
+    Matrix K(n, n);
+    for (int j = 0; j < n; j++)
+        for (int i = 0; i < n; i++)
+            K(i, j) = kernel(i, j);
+    return K;
+}
+
+void run_test(const GaussianKernel& kernel, const Matrix& K, const Vector& exact,
+              LandmarkSampling sampling, int nev, int nland)
+{
+    NystromEigsSolver<GaussianKernel> eigs(kernel, nev, nland);
+    eigs.set_num_threads(2);
+    eigs.set_tile_size(128);
+    const int nconv = eigs.compute(sampling);
+    REQUIRE(nconv == nev);
+    REQUIRE(eigs.info() == CompInfo::Successful);
+    REQUIRE(int(eigs.landmarks().size()) == nland);
+
+    // Nyström eigenvalues are close to and never exceed the exact ones
+    const Vector evals = eigs.eigenvalues();
+    const Vector relerr = (exact.head(nev) - evals).cwiseQuotient(exact.head(nev));
+    INFO("relative errors = " << relerr.transpose());
+    REQUIRE(relerr.minCoeff() > -1e-10);
+    REQUIRE(relerr.maxCoeff() < 1e-2);
+
+    // Eigenvectors are orthonormal
+    const Matrix evecs = eigs.eigenvectors();
+    const Matrix XtX = evecs.transpose() * evecs - Matrix::Identity(nev, nev);
+    REQUIRE(XtX.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-8));
+
+    // Refinement with the exact operator
+    DenseSymMatProd<double> op(K);
+    const int nref = eigs.refine(op, 50, 1e-10);
+    INFO("refinement iterations = " << eigs.num_iterations());
+    REQUIRE(nref == nev);
+    REQUIRE(eigs.info() == CompInfo::Successful);
+    REQUIRE(eigs.num_operations() == eigs.num_iterations() * 2 * nev);
+
+    const Vector revals = eigs.eigenvalues();
+    const Matrix revecs = eigs.eigenvectors();
+    const Matrix resid = K * revecs - revecs * revals.asDiagonal();
+    INFO("||AU - UD||_inf = " << resid.cwiseAbs().maxCoeff());
+    REQUIRE(resid.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-8));
+    REQUIRE((revals - exact.head(nev)).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-8));
+}
+
+TEST_CASE("Nystrom eigen solver of Gaussian kernel matrix [1500x1500]", "[eigs_nystrom]")
+{
+    const Matrix x = gen_clustered_points(1500, 6);
+    const GaussianKernel kernel(x, 0.5);
+    const Matrix K = kernel_matrix(kernel);
+    Eigen::SelfAdjointEigenSolver<Matrix> eig(K, Eigen::EigenvaluesOnly);
+    const Vector exact = eig.eigenvalues().reverse();
+
+    SECTION("Uniform")
+    {
+        run_test(kernel, K, exact, LandmarkSampling::Uniform, 5, 150);
+    }
+    SECTION("k-means++")
+    {
+        run_test(kernel, K, exact, LandmarkSampling::KMeansPP, 5, 150);
+    }
+    SECTION("Ridge leverage scores")
+    {
+        run_test(kernel, K, exact, LandmarkSampling::RidgeLeverage, 5, 150);
+    }
+}
+
+TEST_CASE("Nystrom results are independent of the number of threads", "[eigs_nystrom]")
+{
+    const Matrix x = gen_clustered_points(1000, 4);
+    const GaussianKernel kernel(x, 0.5);
+
+    NystromEigsSolver<GaussianKernel> eigs1(kernel, 4, 100), eigs4(kernel, 4, 100);
+    eigs1.set_num_threads(1);
+    eigs4.set_num_threads(4);
+    eigs4.set_tile_size(100);
+    eigs1.compute(LandmarkSampling::KMeansPP, 0.0, 42);
+    eigs4.compute(LandmarkSampling::KMeansPP, 0.0, 42);
+
+    REQUIRE(eigs1.landmarks() == eigs4.landmarks());
+    REQUIRE((eigs1.eigenvalues() - eigs4.eigenvalues()).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-10));
+}
+
+TEST_CASE("Invalid arguments of NystromEigsSolver", "[eigs_nystrom]")
+{
+    const Matrix x = gen_clustered_points(50, 2);
+    const GaussianKernel kernel(x, 0.5);
+    using Solver = NystromEigsSolver<GaussianKernel>;
+
+    REQUIRE_THROWS_AS(Solver(kernel, 0, 10), std::invalid_argument);
+    REQUIRE_THROWS_AS(Solver(kernel, 5, 4), std::invalid_argument);
+    REQUIRE_THROWS_AS(Solver(kernel, 5, 51), std::invalid_argument);
+
+    Solver eigs(kernel, 2, 10);
+    const Matrix K = kernel_matrix(kernel);
+    DenseSymMatProd<double> op(K);
+    REQUIRE_THROWS_AS(eigs.refine(op), std::logic_error);
+}
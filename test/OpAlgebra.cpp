@@ -0,0 +1,226 @@
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/Eigenvalues>
+#include <Eigen/QR>
+#include <Eigen/SVD>
+#include <iostream>
+#include <type_traits>
+
+#include <Spectra/SymEigsSolver.h>
+#include <Spectra/GenEigsSolver.h>
+#include <Spectra/BlockGenEigsSolver.h>
+#include <Spectra/MatOp/DenseGenMatProd.h>
+#include <Spectra/MatOp/DenseSymMatProd.h>
+#include <Spectra/MatOp/SparseSymMatProd.h>
+#include <Spectra/MatOp/OpAlgebra.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+using SpMatrix = Eigen::SparseMatrix<double>;
+
+// Checks the operator against its dense equivalent, in both directions
+template <typename OpType>
+void check_op(const OpType& op, const Matrix& M)
+{
+    REQUIRE(op.rows() == M.rows());
+    REQUIRE(op.cols() == M.cols());
+
+    const Matrix X = Matrix::Random(M.cols(), 3);
+    const Matrix Y = op * X;
+    REQUIRE((Y - M * X).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-10));
+
+    const Vector x = Vector::Random(M.rows());
+    Vector y(M.cols());
+    op.transpose_perform_op(x.data(), y.data());
+    REQUIRE((y - M.transpose() * x).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-10));
+}
+
+// A user-defined operator without transpose_perform_op()
+class DiagonalOp
+{
+private:
+    const Vector& m_d;
+
+public:
+    using Scalar = double;
+    DiagonalOp(const Vector& d) :
+        m_d(d)
+    {}
+    Eigen::Index rows() const { return m_d.size(); }
+    Eigen::Index cols() const { return m_d.size(); }
+    void perform_op(const double* x_in, double* y_out) const
+    {
+        for (Eigen::Index i = 0; i < m_d.size(); i++)
+            y_out[i] = m_d[i] * x_in[i];
+    }
+};
+
+TEST_CASE("Operator expressions", "[op_algebra]")
+{
+    std::srand(123);
+    const int n = 50, p = 30;
+    const Matrix A = Matrix::Random(n, n);
+    const Matrix B = Matrix::Random(n, n);
+    const Matrix C = Matrix::Random(n, p);
+    const Vector dl = Vector::Random(n);
+    const Vector dr = Vector::Random(p);
+    const Matrix Y = Eigen::HouseholderQR<Matrix>(Matrix::Random(n, 4)).householderQ() * Matrix::Identity(n, 4);
+    const Matrix P = Matrix::Identity(n, n) - Y * Y.transpose();
+
+    DenseGenMatProd<double> opA(A), opB(B), opC(C);
+
+    SECTION("Scale")
+    {
+        check_op(op_scale(opA, 2.5), 2.5 * A);
+    }
+    SECTION("Sum")
+    {
+        check_op(op_sum(opA, opB), A + B);
+        check_op(op_sum(opA, opB, 2.0, -0.5), 2.0 * A - 0.5 * B);
+    }
+    SECTION("Shift")
+    {
+        check_op(op_shift(opA, 0.3), A - 0.3 * Matrix::Identity(n, n));
+    }
+    SECTION("Product and transpose")
+    {
+        check_op(op_product(opA, opC), A * C);
+        check_op(op_transpose(opC), C.transpose());
+        check_op(op_product(op_transpose(opC), opC), C.transpose() * C);
+    }
+    SECTION("Diagonal scaling")
+    {
+        check_op(op_diag_scale(opC, dl, dr), dl.asDiagonal() * C * dr.asDiagonal());
+    }
+    SECTION("Projection")
+    {
+        check_op(op_project(opA, Y), P * A * P);
+    }
+    SECTION("Nested expressions")
+    {
+        // 2 * (A + 3B)' * (A - 0.5I) - B, where every level passes the scalings down
+        const auto e1 = op_sum(opA, opB, 1.0, 3.0);
+        const auto e2 = op_product(op_transpose(e1), op_shift(opA, 0.5));
+        const auto e3 = op_sum(op_scale(e2, 2.0), opB, 1.0, -1.0);
+        const Matrix M = 2.0 * (A + 3.0 * B).transpose() * (A - 0.5 * Matrix::Identity(n, n)) - B;
+        check_op(e3, M);
+        check_op(op_project(op_diag_scale(e3, dl, dl), Y), P * dl.asDiagonal() * M * dl.asDiagonal() * P);
+    }
+    SECTION("User-defined operators")
+    {
+        const Vector d = Vector::LinSpaced(n, 1.0, 2.0);
+        DiagonalOp opD(d);
+        const auto e = op_sum(opA, opD, 1.0, 2.0);
+        const Matrix X = Matrix::Random(n, 2);
+        const Matrix M = A + 2.0 * Matrix(d.asDiagonal());
+        REQUIRE(((e * X) - M * X).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-10));
+    }
+
+    // Expressions are composed without virtual functions
+    REQUIRE(!std::is_polymorphic<OpSum<OpScale<DenseGenMatProd<double>>, DenseGenMatProd<double>>>::value);
+}
+
+TEST_CASE("Eigen solvers with operator expressions", "[op_algebra]")
+{
+    std::srand(123);
+
+    SECTION("Normalized graph Laplacian")
+    {
+        // Path graph with random weights, D^{-1/2} * W * D^{-1/2}
+        const int n = 500;
+        SpMatrix W(n, n);
+        Vector deg = Vector::Zero(n);
+        for (int i = 0; i < n - 1; i++)
+        {
+            const double w = 1.0 + 0.5 * std::sin(double(i));
+            W.insert(i, i + 1) = w;
+            W.insert(i + 1, i) = w;
+            deg[i] += w;
+            deg[i + 1] += w;
+        }
+        const Vector dinv = deg.cwiseSqrt().cwiseInverse();
+        const Matrix M = dinv.asDiagonal() * Matrix(W) * dinv.asDiagonal();
+        Eigen::SelfAdjointEigenSolver<Matrix> eig(M, Eigen::EigenvaluesOnly);
+
+        SparseSymMatProd<double> opW(W);
+        auto op = op_diag_scale(opW, dinv, dinv);
+        SymEigsSolver<decltype(op)> eigs(op, 5, 20);
+        eigs.init();
+        eigs.compute(SortRule::LargestAlge);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        const Vector evals = eigs.eigenvalues();
+        for (int i = 0; i < 5; i++)
+            REQUIRE(evals[i] == Approx(eig.eigenvalues()[n - 1 - i]).epsilon(1e-10));
+    }
+    SECTION("Singular values through A'A")
+    {
+        const Matrix A = Matrix::Random(300, 100);
+        Eigen::JacobiSVD<Matrix> svd(A);
+        DenseGenMatProd<double> opA(A);
+        auto op = op_product(op_transpose(opA), opA);
+        SymEigsSolver<decltype(op)> eigs(op, 4, 12);
+        eigs.init();
+        eigs.compute(SortRule::LargestAlge);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        const Vector sv = eigs.eigenvalues().cwiseSqrt();
+        for (int i = 0; i < 4; i++)
+            REQUIRE(sv[i] == Approx(svd.singularValues()[i]).epsilon(1e-10));
+    }
+    SECTION("Deflation by projection")
+    {
+        // Eigenvalues of a symmetric matrix after projecting out the leading eigenvectors
+        const Matrix R = Matrix::Random(200, 200);
+        const Matrix S = R + R.transpose();
+        Eigen::SelfAdjointEigenSolver<Matrix> eig(S);
+        const Matrix Y = eig.eigenvectors().rightCols(3);
+        DenseSymMatProd<double> opS(S);
+        auto op = op_project(opS, Y);
+        SymEigsSolver<decltype(op)> eigs(op, 3, 20);
+        eigs.init();
+        eigs.compute(SortRule::LargestAlge);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        const Vector evals = eigs.eigenvalues();
+        for (int i = 0; i < 3; i++)
+            REQUIRE(evals[i] == Approx(eig.eigenvalues()[196 - i]).epsilon(1e-10));
+    }
+    SECTION("General and block solvers")
+    {
+        const Matrix A = Matrix::Random(200, 200);
+        const Matrix B = Matrix::Random(200, 200);
+        DenseGenMatProd<double> opA(A), opB(B);
+        auto op = op_sum(opA, opB, 1.0, 0.5);
+        Eigen::EigenSolver<Matrix> eig(A + 0.5 * B, false);
+        const double rho = eig.eigenvalues().cwiseAbs().maxCoeff();
+
+        using OpType = decltype(op);
+        GenEigsSolver<OpType> eigs(op, 4, 15);
+        eigs.init();
+        eigs.compute(SortRule::LargestMagn);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        REQUIRE(std::abs(eigs.eigenvalues()[0]) == Approx(rho).epsilon(1e-10));
+
+        BlockGenEigsSolver<OpType> beigs(op, 4, 20, 2);
+        beigs.init();
+        beigs.compute(SortRule::LargestMagn);
+        REQUIRE(beigs.info() == CompInfo::Successful);
+        REQUIRE(std::abs(beigs.eigenvalues()[0]) == Approx(rho).epsilon(1e-10));
+    }
+}
+
+TEST_CASE("Invalid operator expressions", "[op_algebra]")
+{
+    const Matrix A = Matrix::Identity(10, 10);
+    const Matrix C = Matrix::Identity(10, 5);
+    const Vector d = Vector::Ones(5);
+    DenseGenMatProd<double> opA(A), opC(C);
+
+    REQUIRE_THROWS_AS(op_sum(opA, opC), std::invalid_argument);
+    REQUIRE_THROWS_AS(op_shift(opC, 1.0), std::invalid_argument);
+    REQUIRE_THROWS_AS(op_product(opC, opA), std::invalid_argument);
+    REQUIRE_THROWS_AS(op_diag_scale(opA, d, d), std::invalid_argument);
+    REQUIRE_THROWS_AS(op_project(opC, C), std::invalid_argument);
+}
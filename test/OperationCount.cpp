@@ -0,0 +1,326 @@
+// Regression tests on the number of matrix operations and restarts of the solvers
+//
+// The test matrices are generated by SimpleRandom, which gives the same numbers
+// on every platform, so the counts below are deterministic. Each bound is the count
+// at the time of recording plus about 10%, to absorb the differences in floating
+// point rounding across compilers. A change that makes a solver converge more
+// slowly fails these tests, and a change that makes it faster should lower the
+// bounds accordingly.
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <iostream>
+#include <vector>
+
+#include <Spectra/SymEigsSolver.h>
+#include <Spectra/SymEigsShiftSolver.h>
+#include <Spectra/GenEigsSolver.h>
+#include <Spectra/GenEigsRealShiftSolver.h>
+#include <Spectra/GenEigsComplexShiftSolver.h>
+#include <Spectra/GenEigsCayleySolver.h>
+#include <Spectra/BlockGenEigsSolver.h>
+#include <Spectra/SymGEigsSolver.h>
+#include <Spectra/SymGEigsShiftSolver.h>
+#include <Spectra/DavidsonSymEigsSolver.h>
+#include <Spectra/DominantEigsSolver.h>
+#include <Spectra/MatOp/DenseSymMatProd.h>
+#include <Spectra/MatOp/DenseGenMatProd.h>
+#include <Spectra/MatOp/SparseSymMatProd.h>
+#include <Spectra/MatOp/DenseSymShiftSolve.h>
+#include <Spectra/MatOp/SparseSymShiftSolve.h>
+#include <Spectra/MatOp/DenseGenRealShiftSolve.h>
+#include <Spectra/MatOp/DenseGenComplexShiftSolve.h>
+#include <Spectra/MatOp/DenseCholesky.h>
+#include <Spectra/MatOp/SparseRegularInverse.h>
+#include <Spectra/MatOp/SymShiftInvert.h>
+#include <Spectra/contrib/PartialSVDSolver.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+using SpMatrix = Eigen::SparseMatrix<double>;
+using Index = Eigen::Index;
+
+// General random matrix
+Matrix gen_general(Index m, Index n, unsigned long seed)
+{
+    SimpleRandom<double> rng(seed);
+    Matrix mat(m, n);
+    for (Index j = 0; j < n; j++)
+        mat.col(j).noalias() = rng.random_vec(m);
+    return mat;
+}
+
+// Symmetric random matrix
+Matrix gen_symmetric(Index n, unsigned long seed)
+{
+    const Matrix mat = gen_general(n, n, seed);
+    return mat + mat.transpose();
+}
+
+// Symmetric positive definite matrix
+Matrix gen_spd(Index n, unsigned long seed)
+{
+    const Matrix mat = gen_general(n, n, seed);
+    Matrix res = mat.transpose() * mat / double(n);
+    res.diagonal().array() += 1.0;
+    return res;
+}
+
+// Symmetric banded sparse matrix, with an increasing diagonal plus `diag_shift`
+SpMatrix gen_banded(Index n, Index bandwidth, double diag_shift, unsigned long seed)
+{
+    SimpleRandom<double> rng(seed);
+    std::vector<Eigen::Triplet<double>> trip;
+    for (Index j = 0; j < n; j++)
+    {
+        const Vector val = rng.random_vec(bandwidth + 1);
+        trip.emplace_back(j, j, diag_shift + double(j) / double(n) + val[0]);
+        for (Index k = 1; k <= bandwidth && j + k < n; k++)
+        {
+            trip.emplace_back(j + k, j, val[k]);
+            trip.emplace_back(j, j + k, val[k]);
+        }
+    }
+    SpMatrix mat(n, n);
+    mat.setFromTriplets(trip.begin(), trip.end());
+    return mat;
+}
+
+// Checks a finished run against the recorded upper bounds of its cost
+template <typename Solver>
+void check_cost(const Solver& eigs, Index max_ops, Index max_iter)
+{
+    INFO("num_operations() = " << eigs.num_operations() << ", bound = " << max_ops);
+    INFO("num_iterations() = " << eigs.num_iterations() << ", bound = " << max_iter);
+    REQUIRE(eigs.info() == CompInfo::Successful);
+    REQUIRE(eigs.num_operations() <= max_ops);
+    REQUIRE(eigs.num_iterations() <= max_iter);
+}
+
+TEST_CASE("Operation counts of SymEigsSolver", "[op_count]")
+{
+    const Matrix A = gen_symmetric(300, 1);
+    DenseSymMatProd<double> op(A);
+    SymEigsSolver<DenseSymMatProd<double>> eigs(op, 10, 30);
+
+    struct Case
+    {
+        SortRule rule;
+        Index max_ops, max_iter;
+    };
+    const std::vector<Case> cases{
+        {SortRule::LargestMagn, 149, 8},
+        {SortRule::LargestAlge, 164, 9},
+        {SortRule::SmallestAlge, 178, 10},
+        {SortRule::SmallestMagn, 5267, 269},
+        {SortRule::BothEnds, 150, 8}};
+    for (const Case& c : cases)
+    {
+        INFO("selection = " << int(c.rule));
+        eigs.init();
+        eigs.compute(c.rule);
+        check_cost(eigs, c.max_ops, c.max_iter);
+    }
+
+    const SpMatrix S = gen_banded(1000, 2, 0.0, 2);
+    SparseSymMatProd<double> sop(S);
+    SymEigsSolver<SparseSymMatProd<double>> seigs(sop, 10, 30);
+    seigs.init();
+    seigs.compute(SortRule::LargestAlge);
+    check_cost(seigs, 202, 11);
+}
+
+TEST_CASE("Operation counts of SymEigsShiftSolver", "[op_count]")
+{
+    const Matrix A = gen_symmetric(300, 1);
+    DenseSymShiftSolve<double> op(A);
+    SymEigsShiftSolver<DenseSymShiftSolve<double>> eigs(op, 10, 30, 0.5);
+    eigs.init();
+    eigs.compute(SortRule::LargestMagn);
+    check_cost(eigs, 48, 3);
+
+    const SpMatrix S = gen_banded(1000, 2, 0.0, 2);
+    SparseSymShiftSolve<double> sop(S);
+    SymEigsShiftSolver<SparseSymShiftSolve<double>> seigs(sop, 10, 30, 0.5);
+    seigs.init();
+    seigs.compute(SortRule::LargestMagn);
+    check_cost(seigs, 49, 3);
+}
+
+TEST_CASE("Operation counts of GenEigsSolver", "[op_count]")
+{
+    const Matrix M = gen_general(300, 300, 3);
+    DenseGenMatProd<double> op(M);
+    GenEigsSolver<DenseGenMatProd<double>> eigs(op, 10, 30);
+
+    struct Case
+    {
+        SortRule rule;
+        Index max_ops, max_iter;
+    };
+    const std::vector<Case> cases{
+        {SortRule::LargestMagn, 480, 29},
+        {SortRule::LargestReal, 560, 39},
+        {SortRule::LargestImag, 360, 19},
+        {SortRule::SmallestReal, 569, 36}};
+    for (const Case& c : cases)
+    {
+        INFO("selection = " << int(c.rule));
+        eigs.init();
+        eigs.compute(c.rule);
+        check_cost(eigs, c.max_ops, c.max_iter);
+    }
+}
+
+TEST_CASE("Operation counts of BlockGenEigsSolver", "[op_count]")
+{
+    const Matrix M = gen_general(300, 300, 3);
+    DenseGenMatProd<double> op(M);
+    BlockGenEigsSolver<DenseGenMatProd<double>> eigs(op, 10, 40, 2);
+    eigs.init();
+    eigs.compute(SortRule::LargestMagn);
+    check_cost(eigs, 826, 30);
+}
+
+TEST_CASE("Operation counts of shift-invert general solvers", "[op_count]")
+{
+    const Matrix M = gen_general(300, 300, 3);
+
+    DenseGenRealShiftSolve<double> op(M);
+    GenEigsRealShiftSolver<DenseGenRealShiftSolve<double>> eigs(op, 10, 30, 0.5);
+    eigs.init();
+    eigs.compute(SortRule::LargestMagn);
+    check_cost(eigs, 68, 4);
+
+    DenseGenComplexShiftSolve<double> cop(M);
+    GenEigsComplexShiftSolver<DenseGenComplexShiftSolve<double>> ceigs(cop, 10, 30, 0.5, 0.3);
+    ceigs.init();
+    ceigs.compute(SortRule::LargestMagn);
+    check_cost(ceigs, 82, 5);
+
+    DenseGenRealShiftSolve<double> yop(M);
+    GenEigsCayleySolver<DenseGenRealShiftSolve<double>> yeigs(yop, 10, 30, 6.0, 2.0);
+    yeigs.init();
+    yeigs.compute(SortRule::LargestMagn);
+    check_cost(yeigs, 102, 6);
+}
+
+TEST_CASE("Operation counts of generalized eigen solvers", "[op_count]")
+{
+    const Matrix A = gen_symmetric(300, 1);
+    const Matrix B = gen_spd(300, 4);
+    const double sigma = 0.5;
+
+    SECTION("Cholesky")
+    {
+        DenseSymMatProd<double> op(A);
+        DenseCholesky<double> Bop(B);
+        SymGEigsSolver<DenseSymMatProd<double>, DenseCholesky<double>, GEigsMode::Cholesky> eigs(op, Bop, 10, 30);
+        eigs.init();
+        eigs.compute(SortRule::LargestMagn);
+        check_cost(eigs, 163, 9);
+    }
+    SECTION("Regular inverse")
+    {
+        const SpMatrix S = gen_banded(1000, 2, 0.0, 2);
+        const SpMatrix SB = gen_banded(1000, 1, 3.0, 5);
+        SparseSymMatProd<double> op(S);
+        SparseRegularInverse<double> Bop(SB);
+        SymGEigsSolver<SparseSymMatProd<double>, SparseRegularInverse<double>, GEigsMode::RegularInverse> eigs(op, Bop, 10, 30);
+        eigs.init();
+        eigs.compute(SortRule::LargestMagn);
+        check_cost(eigs, 192, 11);
+    }
+
+    using OpType = SymShiftInvert<double, Eigen::Dense, Eigen::Dense>;
+    using BOpType = DenseSymMatProd<double>;
+    SECTION("Shift-invert")
+    {
+        OpType op(A, B);
+        BOpType Bop(B);
+        SymGEigsShiftSolver<OpType, BOpType, GEigsMode::ShiftInvert> eigs(op, Bop, 10, 30, sigma);
+        eigs.init();
+        eigs.compute(SortRule::LargestMagn);
+        check_cost(eigs, 49, 3);
+    }
+    SECTION("Buckling")
+    {
+        // K = B is positive definite, and KG = A
+        OpType op(B, A);
+        BOpType Bop(B);
+        SymGEigsShiftSolver<OpType, BOpType, GEigsMode::Buckling> eigs(op, Bop, 10, 30, sigma);
+        eigs.init();
+        eigs.compute(SortRule::LargestMagn);
+        check_cost(eigs, 48, 3);
+    }
+    SECTION("Cayley")
+    {
+        OpType op(A, B);
+        BOpType Bop(B);
+        SymGEigsShiftSolver<OpType, BOpType, GEigsMode::Cayley> eigs(op, Bop, 10, 30, sigma);
+        eigs.init();
+        eigs.compute(SortRule::LargestMagn);
+        check_cost(eigs, 62, 4);
+    }
+}
+
+TEST_CASE("Operation counts of other solvers", "[op_count]")
+{
+    SECTION("Davidson")
+    {
+        // Davidson methods are efficient for diagonally dominant matrices
+        Matrix A = 0.01 * gen_symmetric(300, 6);
+        A.diagonal() += Vector::LinSpaced(300, 1.0, 300.0);
+        DenseSymMatProd<double> op(A);
+        DavidsonSymEigsSolver<DenseSymMatProd<double>> eigs(op, 5);
+        eigs.compute(SortRule::LargestAlge);
+        INFO("num_iterations() = " << eigs.num_iterations());
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        REQUIRE(eigs.num_iterations() <= 5);
+    }
+    SECTION("Dominant eigenpair")
+    {
+        const Matrix A = gen_symmetric(300, 1);
+        DenseSymMatProd<double> op(A);
+        DominantEigsSolver<DenseSymMatProd<double>> eigs(op);
+        eigs.init();
+        eigs.compute(SortRule::LargestAlge);
+        check_cost(eigs, 199, 198);
+
+        const Matrix B = gen_spd(300, 4);
+        DenseSymMatProd<double> bop(B);
+        DominantEigsSolver<DenseSymMatProd<double>> beigs(bop);
+        beigs.init();
+        beigs.compute(SortRule::LargestMagn);
+        check_cost(beigs, 131, 130);
+
+        // SymEigsSolver with nev = 1 and ncv = 4 keeps four basis vectors, the
+        // residual, and a work vector, so it uses more memory than the five vectors of
+        // DominantEigsSolver, and it still needs more matrix operations
+        SymEigsSolver<DenseSymMatProd<double>> keigs(op, 1, 4);
+        keigs.init();
+        keigs.compute(SortRule::LargestAlge);
+        INFO("SymEigsSolver: " << keigs.num_operations() << ", DominantEigsSolver: " << eigs.num_operations());
+        REQUIRE(keigs.info() == CompInfo::Successful);
+        REQUIRE(eigs.num_operations() < keigs.num_operations());
+
+        SymEigsSolver<DenseSymMatProd<double>> kbeigs(bop, 1, 4);
+        kbeigs.init();
+        kbeigs.compute(SortRule::LargestMagn);
+        INFO("SymEigsSolver: " << kbeigs.num_operations() << ", DominantEigsSolver: " << beigs.num_operations());
+        REQUIRE(kbeigs.info() == CompInfo::Successful);
+        REQUIRE(beigs.num_operations() < kbeigs.num_operations());
+    }
+    SECTION("Partial SVD")
+    {
+        const Matrix M = gen_general(400, 200, 7);
+        PartialSVDSolver<Matrix> svds(M, 5, 20);
+        svds.compute();
+        INFO("num_operations() = " << svds.num_operations() << ", num_iterations() = " << svds.num_iterations());
+        REQUIRE(svds.num_operations() <= 97);
+        REQUIRE(svds.num_iterations() <= 7);
+    }
+}
@@ -0,0 +1,174 @@
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/Eigenvalues>
+#include <iostream>
+#include <algorithm>
+#include <random>  // Requires C++ 11
+#include <vector>
+
+#include <Spectra/RationalKrylovSymEigsSolver.h>
+#include <Spectra/SymEigsShiftSolver.h>
+#include <Spectra/MatOp/DenseSymShiftSolve.h>
+#include <Spectra/MatOp/SparseSymShiftSolve.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+using SpMatrix = Eigen::SparseMatrix<double>;
+using Index = Eigen::Index;
+
+// The union of the nev eigenvalues closest to each shift, in increasing order
+std::vector<Index> closest_union(const Vector& exact, const std::vector<double>& shifts, int nev)
+{
+    std::vector<Index> res;
+    for (double sigma : shifts)
+    {
+        std::vector<Index> ind(exact.size());
+        for (Index i = 0; i < exact.size(); i++)
+            ind[i] = i;
+        std::partial_sort(ind.begin(), ind.begin() + nev, ind.end(), [&exact, sigma](Index a, Index b) {
+            return std::abs(exact[a] - sigma) < std::abs(exact[b] - sigma);
+        });
+        res.insert(res.end(), ind.begin(), ind.begin() + nev);
+    }
+    std::sort(res.begin(), res.end());
+    res.erase(std::unique(res.begin(), res.end()), res.end());
+    return res;
+}
+
+template <typename MatType, typename Solver>
+void check_result(const MatType& mat, const Vector& exact, const std::vector<double>& shifts, int nev,
+                  Solver& eigs)
+{
+    INFO("niter = " << eigs.num_iterations());
+    INFO("nops  = " << eigs.num_operations());
+    REQUIRE(eigs.info() == CompInfo::Successful);
+
+    const Vector evals = eigs.eigenvalues();
+    const Matrix evecs = eigs.eigenvectors();
+    const std::vector<Index> windows = eigs.shift_indices();
+
+    // Each eigenvalue appears once, even if it is close to several shifts
+    const std::vector<Index> ind = closest_union(exact, shifts, nev);
+    REQUIRE(evals.size() == Index(ind.size()));
+    REQUIRE(windows.size() == ind.size());
+    for (std::size_t l = 0; l < ind.size(); l++)
+    {
+        REQUIRE(evals[l] == Approx(exact[ind[l]]).epsilon(1e-10));
+        // The eigenvalue belongs to its closest shift
+        for (std::size_t j = 0; j < shifts.size(); j++)
+            REQUIRE(std::abs(evals[l] - shifts[windows[l]]) <= std::abs(evals[l] - shifts[j]));
+    }
+
+    const Matrix resid = mat * evecs - evecs * evals.asDiagonal();
+    REQUIRE(resid.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-9));
+    const Matrix I = Matrix::Identity(evals.size(), evals.size());
+    REQUIRE((evecs.transpose() * evecs - I).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-10));
+}
+
+TEST_CASE("Rational Krylov with dense shift-solves", "[rks]")
+{
+    std::srand(123);
+    const int n = 300;
+    const Matrix R = Matrix::Random(n, n);
+    const Matrix A = R + R.transpose();
+    Eigen::SelfAdjointEigenSolver<Matrix> eig(A, Eigen::EigenvaluesOnly);
+    const Vector exact = eig.eigenvalues();
+
+    DenseSymShiftSolve<double> op0(A), op1(A), op2(A);
+    std::vector<DenseSymShiftSolve<double>*> ops{ &op0, &op1, &op2 };
+
+    SECTION("Separated windows")
+    {
+        const std::vector<double> shifts{ -10.0, 0.5, 12.0 };
+        RationalKrylovSymEigsSolver<DenseSymShiftSolve<double>> eigs(ops, shifts, 4, 30);
+        eigs.init();
+        const Index nconv = eigs.compute();
+        REQUIRE(nconv == 12);
+        check_result(A, exact, shifts, 4, eigs);
+
+        // Separate shift-and-invert solvers for the same windows
+        Index nops = 0;
+        for (double sigma : shifts)
+        {
+            DenseSymShiftSolve<double> op(A);
+            SymEigsShiftSolver<DenseSymShiftSolve<double>> single(op, 4, 10, sigma);
+            single.init();
+            single.compute(SortRule::LargestMagn);
+            REQUIRE(single.info() == CompInfo::Successful);
+            nops += single.num_operations();
+        }
+        INFO("separate solves = " << nops << ", rational Krylov = " << eigs.num_operations());
+        REQUIRE(eigs.num_operations() < nops);
+    }
+
+    SECTION("Overlapping windows")
+    {
+        // The windows share most of their eigenvalues, which are only computed once
+        const std::vector<double> shifts{ 1.0, 1.05, 1.1 };
+        RationalKrylovSymEigsSolver<DenseSymShiftSolve<double>> eigs(ops, shifts, 5, 24);
+        eigs.set_num_threads(3);
+        eigs.init();
+        const Index nconv = eigs.compute();
+        REQUIRE(nconv < 15);
+        check_result(A, exact, shifts, 5, eigs);
+    }
+
+    SECTION("Invalid arguments")
+    {
+        using SolverType = RationalKrylovSymEigsSolver<DenseSymShiftSolve<double>>;
+        const std::vector<double> shifts{ 0.0, 1.0, 2.0 };
+        REQUIRE_THROWS_AS(SolverType(ops, std::vector<double>{ 0.0, 1.0 }, 3, 20), std::invalid_argument);
+        REQUIRE_THROWS_AS(SolverType(std::vector<DenseSymShiftSolve<double>*>{ &op0, &op1, &op0 }, shifts, 3, 20),
+                          std::invalid_argument);
+        REQUIRE_THROWS_AS(SolverType(ops, shifts, 0, 20), std::invalid_argument);
+        REQUIRE_THROWS_AS(SolverType(ops, shifts, 3, 11), std::invalid_argument);
+        REQUIRE_THROWS_AS(SolverType(ops, shifts, 3, n + 1), std::invalid_argument);
+
+        SolverType eigs(ops, shifts, 3, 20);
+        const Vector zero = Vector::Zero(n);
+        REQUIRE_THROWS_AS(eigs.init(zero.data()), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Rational Krylov with sparse shift-solves", "[rks]")
+{
+    // Sparse symmetric matrix
+    const int n = 500;
+    std::default_random_engine gen;
+    gen.seed(123);
+    std::uniform_real_distribution<double> distr(0.0, 1.0);
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int j = 0; j < n; j++)
+    {
+        triplets.push_back(Eigen::Triplet<double>(j, j, distr(gen) * n / 50.0));
+        for (int i = j + 1; i < n; i++)
+        {
+            if (distr(gen) < 0.01)
+            {
+                const double v = distr(gen) - 0.5;
+                triplets.push_back(Eigen::Triplet<double>(i, j, v));
+                triplets.push_back(Eigen::Triplet<double>(j, i, v));
+            }
+        }
+    }
+    SpMatrix A(n, n);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    Eigen::SelfAdjointEigenSolver<Matrix> eig(Matrix(A), Eigen::EigenvaluesOnly);
+    const Vector exact = eig.eigenvalues();
+
+    // Factorize the shifted matrices in parallel
+    const std::vector<double> shifts{ 2.0, 4.0, 6.0, 8.0 };
+    SparseSymShiftSolve<double> op0(A), op1(A), op2(A), op3(A);
+    std::vector<SparseSymShiftSolve<double>*> ops{ &op0, &op1, &op2, &op3 };
+    for (std::size_t j = 0; j < ops.size(); j++)
+        ops[j]->set_shift_async(shifts[j]);
+
+    RationalKrylovSymEigsSolver<SparseSymShiftSolve<double>> eigs(ops, shifts, 3, 28);
+    eigs.init();
+    eigs.compute();
+    check_result(A, exact, shifts, 3, eigs);
+}
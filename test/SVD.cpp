@@ -109,3 +109,38 @@ TEST_CASE("Partial SVD of wide sparse matrix [1000x100]", "[svds_sparse_wide]")
 
     run_test<SpMatrix>(A, k, m);
 }
+
+TEST_CASE("Partial SVD with a singular value cutoff", "[svds_cutoff]")
+{
+    std::srand(123);
+
+    // Known singular values 1 / (1 + 0.1 * i), i = 0, ..., 99
+    Eigen::HouseholderQR<Matrix> qr1(Matrix::Random(300, 100)), qr2(Matrix::Random(100, 100));
+    const Matrix U0 = qr1.householderQ() * Matrix::Identity(300, 100);
+    const Matrix V0 = qr2.householderQ();
+    Vector s(100);
+    for (int i = 0; i < 100; i++)
+        s[i] = 1.0 / (1.0 + 0.1 * i);
+    const Matrix A = U0 * s.asDiagonal() * V0.transpose();
+
+    // 13 singular values are greater than 0.45
+    PartialSVDSolver<Matrix> svds(A, 2, 6);
+    const int nconv = svds.compute_cutoff(0.45);
+    REQUIRE(svds.info() == CompInfo::Successful);
+    REQUIRE(nconv == 13);
+
+    const Vector svals = svds.singular_values();
+    REQUIRE(svals.size() == 13);
+    for (int i = 0; i < 13; i++)
+        REQUIRE(svals[i] == Approx(s[i]).epsilon(1e-8));
+
+    const Matrix U = svds.matrix_U(13);
+    const Matrix V = svds.matrix_V(13);
+    REQUIRE((A * V - U * svals.asDiagonal()).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-8));
+
+    // A later compute() uses ncomp given in the constructor
+    REQUIRE(svds.compute() == 2);
+    REQUIRE(svds.singular_values().size() == 2);
+    REQUIRE(svds.singular_values()[1] == Approx(s[1]).epsilon(1e-8));
+    REQUIRE(svds.matrix_U(2).cols() == 2);
+}
@@ -1,6 +1,8 @@
 // Test ../include/Spectra/LinAlg/UpperHessenbergSchur.h
 #include <iostream>
+#include <vector>
 #include <Eigen/Core>
+#include <Eigen/Eigenvalues>
 #include <Spectra/LinAlg/UpperHessenbergSchur.h>
 
 using namespace Spectra;
@@ -67,3 +69,53 @@ TEST_CASE("Schur decomposition of upper Hessenberg matrix [500x500]", "[Schur]")
     Matrix A = gen_upper_hessenberg_mat(500);
     run_test(A);
 }
+
+TEST_CASE("Reordering of the Schur decomposition [100x100]", "[Schur]")
+{
+    const int n = 100;
+    Matrix A = gen_upper_hessenberg_mat(n);
+    UpperHessenbergSchur<double> decomp(A);
+
+    // Select the blocks whose eigenvalues have a positive real part
+    std::vector<bool> select(n, false);
+    int nsel = 0;
+    const Matrix T0 = decomp.matrix_T();
+    for (int k = 0; k < n; k++)
+    {
+        const bool two_by_two = (k + 1 < n && T0(k + 1, k) != 0.0);
+        const double re = two_by_two ? 0.5 * (T0(k, k) + T0(k + 1, k + 1)) : T0(k, k);
+        if (re > 0.0)
+        {
+            select[k] = true;
+            nsel += two_by_two ? 2 : 1;
+        }
+        if (two_by_two)
+            k++;
+    }
+    REQUIRE(nsel > 0);
+    REQUIRE(nsel < n);
+
+    decomp.reorder(select);
+    const Matrix& matT = decomp.matrix_T();
+    const Matrix& matU = decomp.matrix_U();
+
+    Matrix lowerT = matT.triangularView<Eigen::StrictlyLower>();
+    lowerT.diagonal(-1).setZero();
+    REQUIRE(lowerT.cwiseAbs().maxCoeff() == 0.0);
+    // The selected part is decoupled from the rest
+    REQUIRE(matT(nsel, nsel - 1) == 0.0);
+
+    constexpr double tol = 1e-12;
+    Matrix resid1 = matU.transpose() * matU - Matrix::Identity(n, n);
+    INFO("||U'U - I||_inf = " << resid1.cwiseAbs().maxCoeff());
+    REQUIRE(resid1.cwiseAbs().maxCoeff() == Approx(0.0).margin(tol));
+    Matrix resid2 = A * matU - matU * matT;
+    INFO("||AU - UT||_inf = " << resid2.cwiseAbs().maxCoeff());
+    REQUIRE(resid2.cwiseAbs().maxCoeff() == Approx(0.0).margin(tol));
+
+    // The leading diagonal blocks contain the selected eigenvalues
+    Eigen::EigenSolver<Matrix> es(matT.topLeftCorner(nsel, nsel), false);
+    REQUIRE((es.eigenvalues().real().array() > 0.0).all());
+    Eigen::EigenSolver<Matrix> es2(matT.bottomRightCorner(n - nsel, n - nsel), false);
+    REQUIRE((es2.eigenvalues().real().array() <= 0.0).all());
+}
@@ -0,0 +1,214 @@
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/Eigenvalues>
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>  // Requires C++ 11
+
+#include <Spectra/SymEigsSolver.h>
+#include <Spectra/MatOp/SparseAutoMatProd.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+using SpMatrix = Eigen::SparseMatrix<double>;
+using Triplet = Eigen::Triplet<double>;
+
+// Random sparse matrix with rows of varying lengths, randomly permuted
+SpMatrix gen_sparse(int m, int n, bool pattern, bool symmetric)
+{
+    std::default_random_engine gen;
+    gen.seed(123);
+    std::uniform_real_distribution<double> distr(-1.0, 1.0);
+    std::uniform_int_distribution<int> col(0, n - 1);
+
+    std::vector<Triplet> triplets;
+    for (int i = 0; i < m; i++)
+    {
+        const int len = (i % 17 == 0) ? 40 : 1 + i % 5;
+        for (int k = 0; k < len; k++)
+        {
+            const int j = col(gen);
+            if (symmetric && j == i)
+                continue;
+            const double v = pattern ? 1.0 : distr(gen);
+            triplets.push_back(Triplet(i, j, v));
+            if (symmetric)
+                triplets.push_back(Triplet(j, i, v));
+        }
+    }
+    SpMatrix mat(m, n);
+    // Duplicates are overwritten so that the pattern matrix keeps equal values
+    mat.setFromTriplets(triplets.begin(), triplets.end(), [](const double&, const double& b) { return b; });
+    return mat;
+}
+
+template <typename OpType>
+void check_product(const OpType& op, const SpMatrix& mat)
+{
+    REQUIRE(op.rows() == mat.rows());
+    REQUIRE(op.cols() == mat.cols());
+
+    const Matrix X = Matrix::Random(mat.cols(), 3);
+    const Matrix Y0 = mat * X;
+    const Matrix Y = op * X;
+    REQUIRE((Y - Y0).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-12));
+
+    Vector y(mat.rows());
+    op.perform_op(X.col(1).data(), y.data());
+    REQUIRE((y - Y0.col(1)).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-12));
+}
+
+TEST_CASE("Sparse kernels in all formats", "[sparse_auto]")
+{
+    std::srand(123);
+    const SpMatrix A = gen_sparse(1003, 1003, false, false);
+    const SpMatrix R = gen_sparse(501, 777, false, false);
+    const SpMatrix G = gen_sparse(1003, 1003, true, true);
+    REQUIRE(SparseKernel<double>::is_pattern(G));
+    REQUIRE(!SparseKernel<double>::is_pattern(A));
+
+    for (int nthread : { 1, 3 })
+    {
+        INFO("nthread = " << nthread);
+        check_product(SparseAutoMatProd<double>(A, SparseFormat::CSR, nthread), A);
+        check_product(SparseAutoMatProd<double>(A, SparseFormat::SELL, nthread), A);
+        check_product(SparseAutoMatProd<double>(A, SparseFormat::Reordered, nthread), A);
+        check_product(SparseAutoMatProd<double>(R, SparseFormat::CSR, nthread), R);
+        check_product(SparseAutoMatProd<double>(R, SparseFormat::SELL, nthread), R);
+        check_product(SparseAutoMatProd<double>(G, SparseFormat::Pattern, nthread), G);
+        check_product(SparseAutoMatProd<double>(G, SparseFormat::Reordered, nthread), G);
+    }
+
+    // Row-major input and an empty matrix
+    const Eigen::SparseMatrix<double, Eigen::RowMajor> Ar = A;
+    check_product(SparseAutoMatProd<double>(Ar, SparseFormat::SELL, 2), A);
+    const SpMatrix E(10, 10);
+    check_product(SparseAutoMatProd<double>(E, SparseFormat::CSR, 2), E);
+
+    REQUIRE_THROWS_AS(SparseAutoMatProd<double>(A, SparseFormat::Pattern), std::invalid_argument);
+    REQUIRE_THROWS_AS(SparseAutoMatProd<double>(R, SparseFormat::Reordered), std::invalid_argument);
+}
+
+TEST_CASE("Padding of the SELL format", "[sparse_auto]")
+{
+    // Rows of different lengths, and only the first row references x[0]
+    const int n = 100;
+    std::vector<Triplet> triplets;
+    triplets.push_back(Triplet(0, 0, 1.0));
+    for (int i = 1; i < n; i++)
+    {
+        for (int k = 0; k <= i % 4; k++)
+            triplets.push_back(Triplet(i, 1 + (i + k) % (n - 1), 1.0));
+    }
+    SpMatrix A(n, n);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+
+    // Padded elements are skipped, so an infinite x[0] only affects the first row
+    Vector x = Vector::Ones(n);
+    x[0] = std::numeric_limits<double>::infinity();
+    Vector y(n);
+    SparseAutoMatProd<double>(A, SparseFormat::SELL, 2).perform_op(x.data(), y.data());
+    REQUIRE(std::isinf(y[0]));
+    REQUIRE(y.tail(n - 1).allFinite());
+    REQUIRE((y.tail(n - 1) - (A * Vector::Ones(n)).tail(n - 1)).cwiseAbs().maxCoeff() == 0.0);
+}
+
+TEST_CASE("Reverse Cuthill-McKee reordering", "[sparse_auto]")
+{
+    // A randomly permuted path graph, a single long component
+    const int n = 500;
+    std::vector<int> perm(n);
+    for (int i = 0; i < n; i++)
+        perm[i] = i;
+    std::shuffle(perm.begin(), perm.end(), std::default_random_engine(123));
+    std::vector<Triplet> triplets;
+    for (int i = 0; i < n - 1; i++)
+    {
+        triplets.push_back(Triplet(perm[i], perm[i + 1], 1.0));
+        triplets.push_back(Triplet(perm[i + 1], perm[i], 1.0));
+    }
+    SpMatrix P(n, n);
+    P.setFromTriplets(triplets.begin(), triplets.end());
+    check_product(SparseAutoMatProd<double>(P, SparseFormat::Reordered, 1), P);
+}
+
+TEST_CASE("Autotuning and the cache file", "[sparse_auto]")
+{
+    std::srand(123);
+    const SpMatrix A = gen_sparse(2000, 2000, false, false);
+    const SpMatrix G = gen_sparse(2000, 2000, true, true);
+    const std::string cache = "sparse_auto_cache.txt";
+    std::remove(cache.c_str());
+
+    SparseAutoMatProd<double> op(A, 0.05, cache, 4);
+    REQUIRE(!op.from_cache());
+    REQUIRE(op.candidates().size() >= 1);
+    REQUIRE(op.candidates()[0].format == SparseFormat::CSR);
+    REQUIRE(op.candidates()[0].nthread == 1);
+    for (const auto& c : op.candidates())
+    {
+        REQUIRE(c.format != SparseFormat::Pattern);
+        REQUIRE(c.nthread <= 4);
+    }
+    check_product(op, A);
+
+    // The decision is read back for the same pattern, even with different values
+    const SpMatrix A2 = 2.0 * A;
+    SparseAutoMatProd<double> op2(A2, 0.05, cache, 4);
+    REQUIRE(op2.from_cache());
+    REQUIRE(op2.fingerprint() == op.fingerprint());
+    REQUIRE(op2.format() == op.format());
+    REQUIRE(op2.num_threads() == op.num_threads());
+    REQUIRE(op2.candidates().empty());
+    check_product(op2, A2);
+
+    // Different patterns or thread limits are tuned again
+    SparseAutoMatProd<double> op3(G, 0.05, cache, 4);
+    REQUIRE(!op3.from_cache());
+    REQUIRE(op3.fingerprint() != op.fingerprint());
+    check_product(op3, G);
+    SparseAutoMatProd<double> op4(A, 0.05, cache, 2);
+    REQUIRE(!op4.from_cache());
+
+    // Invalid lines are skipped
+    {
+        std::ofstream out(cache, std::ios::app);
+        out << "garbage line\n"
+            << "0123 CSR\n";
+    }
+    SparseAutoMatProd<double> op5(A, 0.05, cache, 4);
+    REQUIRE(op5.from_cache());
+    std::remove(cache.c_str());
+
+    // A zero budget only times the serial CSR kernel
+    SparseAutoMatProd<double> op6(A, 0.0);
+    REQUIRE(op6.candidates().size() == 1);
+    REQUIRE(op6.format() == SparseFormat::CSR);
+    REQUIRE(op6.num_threads() == 1);
+
+    REQUIRE_THROWS_AS(SparseAutoMatProd<double>(A, -1.0), std::invalid_argument);
+}
+
+TEST_CASE("Eigen solver with an autotuned operator", "[sparse_auto]")
+{
+    std::srand(123);
+    const SpMatrix G = gen_sparse(1000, 1000, false, true);
+    Eigen::SelfAdjointEigenSolver<Matrix> eig{ Matrix(G), Eigen::EigenvaluesOnly };
+
+    SparseAutoMatProd<double> op(G, 0.05);
+    SymEigsSolver<SparseAutoMatProd<double>> eigs(op, 5, 20);
+    eigs.init();
+    eigs.compute(SortRule::LargestAlge);
+    REQUIRE(eigs.info() == CompInfo::Successful);
+    const Vector evals = eigs.eigenvalues();
+    for (int i = 0; i < 5; i++)
+        REQUIRE(evals[i] == Approx(eig.eigenvalues()[999 - i]).epsilon(1e-10));
+}
@@ -0,0 +1,190 @@
+// Test ../include/Spectra/LinAlg/SupernodalCholesky.h
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
+#include <Eigen/Eigenvalues>
+#include <iostream>
+#include <random>  // Requires C++ 11
+#include <vector>
+
+#include <Spectra/LinAlg/SupernodalCholesky.h>
+#include <Spectra/SymGEigsSolver.h>
+#include <Spectra/MatOp/SparseSymMatProd.h>
+#include <Spectra/MatOp/SparseCholesky.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+using Vector = Eigen::VectorXd;
+using SpMatrix = Eigen::SparseMatrix<double>;
+
+// Finite difference Laplacian on an m x m x m grid, plus a random
+// positive diagonal and a few random long-range couplings
+SpMatrix gen_spd_data(int m, unsigned int seed = 0)
+{
+    const int n = m * m * m;
+    std::default_random_engine gen;
+    gen.seed(seed);
+    std::uniform_real_distribution<double> distr(0.0, 1.0);
+
+    std::vector<Eigen::Triplet<double>> trip;
+    auto id = [m](int i, int j, int k) { return (i * m + j) * m + k; };
+    for (int i = 0; i < m; i++)
+    {
+        for (int j = 0; j < m; j++)
+        {
+            for (int k = 0; k < m; k++)
+            {
+                const int r = id(i, j, k);
+                trip.emplace_back(r, r, 6.0 + distr(gen));
+                if (i > 0)
+                    trip.emplace_back(r, id(i - 1, j, k), -1.0);
+                if (j > 0)
+                    trip.emplace_back(r, id(i, j - 1, k), -1.0);
+                if (k > 0)
+                    trip.emplace_back(r, id(i, j, k - 1), -1.0);
+            }
+        }
+    }
+    for (int l = 0; l < n / 10; l++)
+    {
+        const int r = int(distr(gen) * n), c = int(distr(gen) * n);
+        if (r > c)
+            trip.emplace_back(r, c, 0.1 * (distr(gen) - 0.5));
+    }
+    SpMatrix lower(n, n);
+    lower.setFromTriplets(trip.begin(), trip.end());
+    SpMatrix mat = lower.selfadjointView<Eigen::Lower>();
+    return mat;
+}
+
+void check_solve(const SupernodalCholesky<double>& chol, const SpMatrix& A)
+{
+    REQUIRE(chol.info() == CompInfo::Successful);
+    const int n = A.rows();
+
+    // Single and multiple right hand sides
+    const Vector b = Vector::Random(n);
+    const Vector x = chol.solve(b);
+    INFO("Residual = " << (A * x - b).norm());
+    REQUIRE((A * x - b).norm() == Approx(0.0).margin(1e-10 * b.norm()));
+
+    const Matrix B = Matrix::Random(n, 7);
+    const Matrix X = chol.solve(B);
+    REQUIRE((A * X - B).norm() == Approx(0.0).margin(1e-10 * B.norm()));
+    REQUIRE((X.col(3) - chol.solve(Vector(B.col(3)))).norm() == Approx(0.0).margin(1e-12));
+}
+
+TEST_CASE("Supernodal Cholesky factorization", "[SupernodalCholesky]")
+{
+    std::srand(123);
+    const SpMatrix A = gen_spd_data(12);
+    const int n = A.rows();
+
+    Eigen::SimplicialLLT<SpMatrix> simplicial(A);
+
+    SECTION("Sequential")
+    {
+        SupernodalCholesky<double> chol;
+        chol.set_num_threads(1);
+        chol.compute(A);
+        check_solve(chol, A);
+        REQUIRE(chol.supernodes() < n / 2);
+        // Amalgamation adds explicit zeros, but the fill of AMD is kept
+        REQUIRE(chol.nonzeros() >= SpMatrix(simplicial.matrixL()).nonZeros());
+    }
+
+    SECTION("Tree-parallel")
+    {
+        SupernodalCholesky<double> chol;
+        chol.set_num_threads(4);
+        chol.compute(A);
+        check_solve(chol, A);
+    }
+
+    SECTION("Upper triangular input")
+    {
+        const SpMatrix U = A.triangularView<Eigen::Upper>();
+        SupernodalCholesky<double, Eigen::Upper> chol(U);
+        REQUIRE(chol.info() == CompInfo::Successful);
+        const Vector b = Vector::Random(n);
+        REQUIRE((A * chol.solve(b) - b).norm() == Approx(0.0).margin(1e-10 * b.norm()));
+    }
+
+    SECTION("Reuse of the symbolic analysis")
+    {
+        SupernodalCholesky<double> chol;
+        chol.set_num_threads(3);
+        chol.analyzePattern(A);
+        chol.factorize(A);
+        check_solve(chol, A);
+
+        SpMatrix A2 = A;
+        for (int i = 0; i < n; i++)
+            A2.coeffRef(i, i) += 10.0;
+        chol.factorize(A2);
+        check_solve(chol, A2);
+
+        // Not positive definite
+        SpMatrix A3 = A;
+        for (int i = 0; i < n; i++)
+            A3.coeffRef(i, i) -= 20.0;
+        chol.factorize(A3);
+        REQUIRE(chol.info() == CompInfo::NumericalIssue);
+        // The inertia is unknown, and is not reported as zero
+        Eigen::Index npos, nneg, nzero;
+        REQUIRE_THROWS_AS((FacTraits<SupernodalCholesky<double>>::inertia(chol, npos, nneg, nzero)),
+                          std::runtime_error);
+
+        // Different sparsity pattern
+        SpMatrix A4 = A;
+        A4.coeffRef(n - 1, 0) = 0.01;
+        A4.coeffRef(0, n - 1) = 0.01;
+        REQUIRE_THROWS_AS(chol.factorize(A4), std::invalid_argument);
+    }
+
+    SECTION("Triangular solves on blocks of vectors")
+    {
+        SupernodalCholesky<double> chol(A);
+        const Matrix B = Matrix::Random(n, 5);
+        Matrix Y = chol.permutationP() * B;
+        chol.solve_lower_inplace(Y);
+        // ||inv(L) * P * b||^2 = b' * inv(A) * b
+        const Matrix ref = B.transpose() * simplicial.solve(B);
+        REQUIRE((Y.transpose() * Y - ref).norm() == Approx(0.0).margin(1e-10 * ref.norm()));
+    }
+}
+
+TEST_CASE("Supernodal Cholesky as the SparseCholesky backend", "[SupernodalCholesky]")
+{
+    const SpMatrix B = gen_spd_data(6, 1);
+    const int n = B.rows();
+    std::default_random_engine gen;
+    gen.seed(2);
+    std::uniform_real_distribution<double> distr(-1.0, 1.0);
+    SpMatrix A(n, n);
+    for (int i = 0; i < n; i++)
+    {
+        A.insert(i, i) = distr(gen);
+        if (i > 0)
+            A.insert(i, i - 1) = distr(gen);
+    }
+    A = SpMatrix(A.selfadjointView<Eigen::Lower>());
+
+    using OpType = SparseSymMatProd<double>;
+    using BOpType = SparseCholesky<double, Eigen::Lower, Eigen::ColMajor, int, SupernodalCholesky<double>>;
+    OpType op(A);
+    BOpType Bop(B);
+    REQUIRE(Bop.info() == CompInfo::Successful);
+
+    SymGEigsSolver<OpType, BOpType, GEigsMode::Cholesky> eigs(op, Bop, 5, 20);
+    eigs.init();
+    eigs.compute(SortRule::LargestAlge);
+    REQUIRE(eigs.info() == CompInfo::Successful);
+
+    Eigen::GeneralizedSelfAdjointEigenSolver<Matrix> es{Matrix(A), Matrix(B)};
+    const Vector true_evals = es.eigenvalues().tail(5).reverse();
+    REQUIRE((eigs.eigenvalues() - true_evals).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-8));
+}
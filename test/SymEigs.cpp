@@ -1,8 +1,12 @@
 #include <Eigen/Core>
 #include <Eigen/SparseCore>
+#include <Eigen/QR>
 #include <iostream>
 #include <type_traits>
 #include <random>  // Requires C++ 11
+#include <limits>
+#include <cmath>
+#include <algorithm>
 
 #include <Spectra/SymEigsSolver.h>
 #include <Spectra/MatOp/DenseSymMatProd.h>
@@ -166,3 +170,176 @@ TEST_CASE("Eigensolver of sparse symmetric real matrix [1000x1000]", "[eigs_sym]
 
     run_test_sets(A, k, m);
 }
+
+TEST_CASE("Convergence criteria of the symmetric eigen solver", "[eigs_sym]")
+{
+    // The smallest eigenvalue is close to zero, and ||A|| is close to 4
+    const int n = 400;
+    SpMatrix A(n, n);
+    for (int i = 0; i < n; i++)
+        A.insert(i, i) = 1e-7 + 0.01 * i;
+    const double tol = 1e-8;
+    const int k = 4, m = 20, maxit = 2000;
+
+    SparseSymMatProd<double> op(A);
+    SymEigsSolver<SparseSymMatProd<double>> eigs(op, k, m);
+
+    // Runs the solver and returns the number of matrix operations
+    auto run = [&](const ConvergenceCriterion<double>& crit, double resid_tol) -> int {
+        eigs.init();
+        eigs.compute(SortRule::SmallestAlge, maxit, tol, SortRule::SmallestAlge, crit);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+
+        const Vector evals = eigs.eigenvalues();
+        const Matrix evecs = eigs.eigenvectors();
+        const Matrix resid = A.selfadjointView<Eigen::Lower>() * evecs - evecs * evals.asDiagonal();
+        REQUIRE(evals[0] == Approx(1e-7).margin(1e-9));
+        REQUIRE(resid.colwise().norm().maxCoeff() < resid_tol);
+        return eigs.num_operations();
+    };
+
+    const int nops_ritz = run(ConvergenceRule::RitzValue, 1e-9);
+    const int nops_norm = run(ConvergenceRule::OperatorNorm, 5 * tol);
+    const int nops_abs = run(ConvergenceRule::Absolute, 1.5 * tol);
+    INFO("nops: RitzValue = " << nops_ritz << ", OperatorNorm = " << nops_norm << ", Absolute = " << nops_abs);
+    REQUIRE(nops_norm < nops_ritz);
+    REQUIRE(nops_abs < nops_ritz);
+
+    // A user function that reproduces the default rule
+    const double eps23 = std::pow(std::numeric_limits<double>::epsilon(), 2.0 / 3.0);
+    ConvergenceCriterion<double> crit([eps23](double theta, double resid, double, double tol) {
+        return resid < tol * std::max(eps23, theta);
+    });
+    REQUIRE(crit.rule() == ConvergenceRule::Custom);
+    REQUIRE(run(crit, 1e-9) == nops_ritz);
+
+    REQUIRE_THROWS_AS(ConvergenceCriterion<double>(ConvergenceRule::Custom), std::invalid_argument);
+}
+
+TEST_CASE("Eigenvalues beyond a threshold with growing nev", "[eigs_sym]")
+{
+    std::srand(123);
+
+    // Known eigenvalues 0.01, 0.02, ..., 3.00 with random eigenvectors
+    const int n = 300;
+    Eigen::HouseholderQR<Matrix> qr(Matrix::Random(n, n));
+    const Matrix Q = qr.householderQ();
+    const Vector d = Vector::LinSpaced(n, 0.01, 3.0);
+    const Matrix A = Q * d.asDiagonal() * Q.transpose();
+
+    SECTION("Largest")
+    {
+        // The 40 eigenvalues greater than 2.605, starting with nev = 3
+        DenseSymMatProd<double> op(A);
+        SymEigsSolver<DenseSymMatProd<double>> eigs(op, 3, 10);
+        eigs.init();
+        const int nconv = eigs.compute_threshold(SortRule::LargestAlge, 2.605);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        REQUIRE(nconv == 40);
+
+        const Vector evals = eigs.eigenvalues();
+        const Matrix evecs = eigs.eigenvectors();
+        REQUIRE(evals.size() == 40);
+        REQUIRE(evecs.cols() == 40);
+        for (int i = 0; i < 40; i++)
+            REQUIRE(evals[i] == Approx(d[n - 1 - i]).epsilon(1e-10));
+        const Matrix resid = A * evecs - evecs * evals.asDiagonal();
+        REQUIRE(resid.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-9));
+
+        // init() restores nev and ncv given in the constructor
+        eigs.init();
+        REQUIRE(eigs.compute(SortRule::LargestAlge) == 3);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        REQUIRE(eigs.eigenvalues().size() == 3);
+        REQUIRE(eigs.eigenvalues()[0] == Approx(d[n - 1]).epsilon(1e-10));
+    }
+
+    SECTION("Smallest")
+    {
+        // The 9 eigenvalues less than 0.095, sorted in increasing order
+        DenseSymMatProd<double> op(A);
+        SymEigsSolver<DenseSymMatProd<double>> eigs(op, 2, 8);
+        eigs.init();
+        const int nconv = eigs.compute_threshold(SortRule::SmallestAlge, 0.095, 1000, 1e-10, SortRule::SmallestAlge);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        REQUIRE(nconv == 9);
+        const Vector evals = eigs.eigenvalues();
+        for (int i = 0; i < 9; i++)
+            REQUIRE(evals[i] == Approx(d[i]).epsilon(1e-8));
+    }
+
+    SECTION("Invalid selection rule")
+    {
+        DenseSymMatProd<double> op(A);
+        SymEigsSolver<DenseSymMatProd<double>> eigs(op, 3, 10);
+        eigs.init();
+        REQUIRE_THROWS_AS(eigs.compute_threshold(SortRule::BothEnds, 1.0), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Eigensolver of low-rank symmetric operators", "[eigs_sym]")
+{
+    std::srand(123);
+
+    // A = Q * diag(5, -3, 2) * Q', rank 3
+    const int n = 200;
+    Eigen::HouseholderQR<Matrix> qr(Matrix::Random(n, n));
+    const Matrix Q = qr.householderQ() * Matrix::Identity(n, 3);
+    const Vector d = (Vector(3) << 5.0, -3.0, 2.0).finished();
+    const Matrix A = Q * d.asDiagonal() * Q.transpose();
+
+    for (int nev : { 2, 5 })
+    {
+        INFO("nev = " << nev);
+        DenseSymMatProd<double> op(A);
+        SymEigsSolver<DenseSymMatProd<double>> eigs(op, nev, 20);
+        eigs.init();
+        const int nconv = eigs.compute(SortRule::LargestMagn);
+        REQUIRE(eigs.info() == CompInfo::Successful);
+        REQUIRE(nconv == nev);
+
+        // The Krylov subspace is invariant after three steps, and the rest of the basis
+        // is filled with vectors in the null space, without wasting matrix operations
+        // One operation verifies that the random vectors are in the null space
+        REQUIRE(eigs.num_operations() <= 7);
+
+        const Vector evals = eigs.eigenvalues();
+        const Matrix evecs = eigs.eigenvectors();
+        REQUIRE(evals[0] == Approx(5.0));
+        if (nev == 2)
+        {
+            REQUIRE(evals[1] == Approx(-3.0));
+        }
+        else
+        {
+            REQUIRE(evals[1] == Approx(2.0));
+            REQUIRE(evals[2] == Approx(0.0).margin(1e-12));
+            REQUIRE(evals[3] == Approx(0.0).margin(1e-12));
+            REQUIRE(evals[4] == Approx(-3.0));
+        }
+        const Matrix resid = A * evecs - evecs * evals.asDiagonal();
+        REQUIRE(resid.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-12));
+        const Matrix I = Matrix::Identity(nev, nev);
+        REQUIRE((evecs.transpose() * evecs - I).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-12));
+    }
+    // A full-rank but ill-conditioned operator, whose small eigenvalues are at the level
+    // of rounding errors relative to ||A||, must not be treated as a low-rank one
+    const int n2 = 100;
+    Vector d2 = Vector::LinSpaced(n2, 0.0, double(n2 - 1));
+    d2[0] = 1e18;
+    const Matrix A2 = d2.asDiagonal();
+    DenseSymMatProd<double> op2(A2);
+    SymEigsSolver<DenseSymMatProd<double>> eigs2(op2, 3, 20);
+    const Vector e1 = Vector::Unit(n2, 0);
+    eigs2.init(e1.data());
+    const int nconv2 = eigs2.compute(SortRule::SmallestAlge);
+    REQUIRE(eigs2.info() == CompInfo::Successful);
+    REQUIRE(nconv2 == 3);
+    const Vector evals2 = eigs2.eigenvalues();
+    const Matrix evecs2 = eigs2.eigenvectors();
+    REQUIRE(evals2[0] == Approx(3.0));
+    REQUIRE(evals2[1] == Approx(2.0));
+    REQUIRE(evals2[2] == Approx(1.0));
+    const Matrix resid2 = A2 * evecs2 - evecs2 * evals2.asDiagonal();
+    REQUIRE(resid2.cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-8));
+}
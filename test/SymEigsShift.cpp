@@ -3,6 +3,7 @@
 #include <iostream>
 #include <type_traits>
 #include <random>  // Requires C++ 11
+#include <vector>
 
 #include <Spectra/SymEigsShiftSolver.h>
 #include <Spectra/MatOp/DenseSymShiftSolve.h>
@@ -184,3 +185,57 @@ TEST_CASE("Eigensolver of sparse symmetric real matrix [1000x1000]", "[eigs_sym]
 
     run_test_sets(A, k, m, sigma);
 }
+
+// The storage of the input matrix is reused for all shifts
+template <typename OpType>
+void run_inplace_test(const Matrix& A, OpType& op, int k, int m,
+                      const std::vector<double>& shifts, const std::vector<Vector>& ref)
+{
+    for (std::size_t i = 0; i < shifts.size(); i++)
+    {
+        SymEigsShiftSolver<OpType> eigs(op, k, m, shifts[i]);
+        run_test(A, eigs, SortRule::LargestMagn);
+        REQUIRE((eigs.eigenvalues() - ref[i]).cwiseAbs().maxCoeff() == Approx(0.0).margin(1e-10));
+    }
+}
+
+TEST_CASE("Eigensolver with in-place dense shift-solve", "[eigs_sym]")
+{
+    std::srand(123);
+    const Matrix A = gen_dense_data(100);
+    const int k = 5, m = 15;
+    const std::vector<double> shifts{1.0, -2.0, 0.5};
+
+    // Reference results
+    std::vector<Vector> ref;
+    for (double sigma : shifts)
+    {
+        DenseSymShiftSolve<double> op(A);
+        SymEigsShiftSolver<DenseSymShiftSolve<double>> eigs(op, k, m, sigma);
+        run_test(A, eigs, SortRule::LargestMagn);
+        ref.push_back(eigs.eigenvalues());
+    }
+
+    SECTION("Lower triangular part")
+    {
+        Matrix work = A;
+        work.triangularView<Eigen::StrictlyUpper>().setZero();
+        DenseSymShiftSolve<double> op(work, true);
+        run_inplace_test(A, op, k, m, shifts, ref);
+    }
+    SECTION("Upper triangular part")
+    {
+        Matrix work = A;
+        work.triangularView<Eigen::StrictlyLower>().setZero();
+        DenseSymShiftSolve<double, Eigen::Upper> op(work, true);
+        run_inplace_test(A, op, k, m, shifts, ref);
+    }
+    SECTION("Row-major block")
+    {
+        using RowMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+        RowMatrix big = RowMatrix::Zero(120, 110);
+        big.block(10, 5, 100, 100) = A;
+        DenseSymShiftSolve<double, Eigen::Lower, Eigen::RowMajor> op(big.block(10, 5, 100, 100), true);
+        run_inplace_test(A, op, k, m, shifts, ref);
+    }
+}
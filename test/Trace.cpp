@@ -0,0 +1,82 @@
+// Test ../include/Spectra/Util/Trace.h
+#define SPECTRA_ENABLE_TRACE
+
+#include <Eigen/Core>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <Spectra/SymEigsSolver.h>
+#include <Spectra/SymEigsShiftSolver.h>
+#include <Spectra/MatOp/DenseSymMatProd.h>
+#include <Spectra/MatOp/DenseSymShiftSolve.h>
+
+using namespace Spectra;
+
+#include "catch.hpp"
+
+using Matrix = Eigen::MatrixXd;
+
+// Number of non-overlapping occurrences of a pattern
+int count_substr(const std::string& str, const std::string& pattern)
+{
+    int count = 0;
+    for (std::size_t pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + pattern.size()))
+        count++;
+    return count;
+}
+
+TEST_CASE("Trace of symmetric eigen solvers", "[Trace]")
+{
+    std::srand(123);
+    Matrix M = Matrix::Random(100, 100);
+    const Matrix A = M + M.transpose();
+
+    Trace::clear();
+
+    DenseSymMatProd<double> op(A);
+    SymEigsSolver<DenseSymMatProd<double>> eigs(op, 5, 15);
+    eigs.init();
+    eigs.compute(SortRule::LargestAlge);
+    REQUIRE(eigs.info() == CompInfo::Successful);
+
+    // Run a shift-and-invert solver on another thread
+    Eigen::Index nops_shift = 0, niter_shift = 0;
+    std::thread worker([&A, &nops_shift, &niter_shift]() {
+        DenseSymShiftSolve<double> op_shift(A);
+        SymEigsShiftSolver<DenseSymShiftSolve<double>> eigs_shift(op_shift, 5, 15, 1.0);
+        eigs_shift.init();
+        eigs_shift.compute(SortRule::LargestMagn);
+        nops_shift = eigs_shift.num_operations();
+        niter_shift = eigs_shift.num_iterations();
+    });
+    worker.join();
+
+    std::ostringstream os;
+    Trace::write_chrome_trace(os);
+    const std::string json = os.str();
+
+    REQUIRE(json.find("{\"traceEvents\":[") == 0);
+    REQUIRE(count_substr(json, "\"name\":\"SymEigs::compute\"") == 2);
+    // The last iteration of each solver does not restart
+    REQUIRE(count_substr(json, "\"name\":\"SymEigs::restart\"") == eigs.num_iterations() + niter_shift - 2);
+    REQUIRE(count_substr(json, "\"name\":\"Lanczos::factorize_from\"") >= 2);
+    REQUIRE(count_substr(json, "\"name\":\"DenseSymShiftSolve::set_shift\"") == 1);
+    // Every matrix operation is recorded
+    REQUIRE(count_substr(json, "\"name\":\"matvec\"") == eigs.num_operations() + nops_shift);
+    // Two different threads
+    REQUIRE(count_substr(json, "\"tid\":0") > 0);
+    REQUIRE(count_substr(json, "\"tid\":1") > 0);
+
+    // Disable recording
+    Trace::clear();
+    Trace::set_enabled(false);
+    eigs.init();
+    eigs.compute(SortRule::LargestAlge);
+    Trace::set_enabled(true);
+
+    std::ostringstream os_empty;
+    Trace::write_chrome_trace(os_empty);
+    REQUIRE(count_substr(os_empty.str(), "\"name\"") == 0);
+}